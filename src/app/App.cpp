@@ -23,6 +23,10 @@
 //---------------------------------------------------------------------------------------
 
 #include <functional>
+#include <future>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include <QDockWidget>
 #include <QToolBox>
@@ -33,6 +37,7 @@
 #include <di/core/Filesystem.h>
 #include <di/core/StringUtils.h>
 
+#include <di/algorithms/DataInject.h>
 #include <di/algorithms/SurfaceLIC.h>
 #include <di/algorithms/RenderTriangles.h>
 #include <di/algorithms/RenderLines.h>
@@ -42,9 +47,20 @@
 #include <di/algorithms/Voxelize.h>
 #include <di/algorithms/Dilatate.h>
 #include <di/algorithms/GaussSmooth.h>
+#include <di/algorithms/MeshLIC.h>
+#include <di/algorithms/SurfaceStreamlines.h>
+#include <di/algorithms/RegionBoundaries.h>
+#include <di/algorithms/ExtractSingularities.h>
+
+#include <di/commands/WriteImage.h>
 
 #include <di/io/RegionLabelReader.h>
 #include <di/io/PlyReader.h>
+#include <di/io/ImageWriter.h>
+
+#include <di/gfx/GPUProfiler.h>
+#include <di/gfx/HeadlessContext.h>
+#include <di/gfx/HeadlessRenderer.h>
 
 #include <di/gui/ViewWidget.h>
 #include <di/gui/AlgorithmStrategies.h>
@@ -53,6 +69,7 @@
 #include <di/gui/DataWidget.h>
 #include <di/gui/FileWidget.h>
 #include <di/gui/MainWindow.h>
+#include <di/gui/OGLWidget.h>
 
 #include <di/core/Logger.h>
 #define LogTag "app/App"
@@ -90,10 +107,72 @@ namespace di
                 }
                 else if( argument.find( "--screenshot-path=" ) != std::string::npos )
                 {
+                    // NOTE: use the original arg. Paths are case sensitive.
                     auto len = std::string( "--screenshot-path=" ).length();
-                    m_screenShotPath = argument.substr( len, argument.length() - len );
+                    m_screenShotPath = arg.substr( len, arg.length() - len );
                     LogD << "Commandline: screenshot-path set to \"" << m_screenShotPath << "\"." << LogEnd;
                 }
+                else if( argument == "--headless" )
+                {
+                    // Headless mode only makes sense for screenshots.
+                    setHeadless();
+                    m_screenShotMode = true;
+                    LogD << "Commandline: headless mode activated." << LogEnd;
+                }
+                else if( argument.find( "--screenshot-resolution=" ) != std::string::npos )
+                {
+                    auto len = std::string( "--screenshot-resolution=" ).length();
+                    auto resolution = argument.substr( len, argument.length() - len );
+                    auto separator = resolution.find( 'x' );
+                    try
+                    {
+                        m_screenShotWidth = std::stoi( resolution.substr( 0, separator ) );
+                        m_screenShotHeight = std::stoi( resolution.substr( separator + 1 ) );
+                    }
+                    catch( const std::exception& )
+                    {
+                        m_screenShotWidth = 0;
+                    }
+                    if( ( separator == std::string::npos ) || ( m_screenShotWidth <= 0 ) || ( m_screenShotHeight <= 0 ) )
+                    {
+                        LogE << "Commandline: invalid screenshot resolution \"" << resolution << "\". Use WIDTHxHEIGHT." << LogEnd;
+                        return false;
+                    }
+                    LogD << "Commandline: screenshot resolution set to " << m_screenShotWidth << "x" << m_screenShotHeight << "." << LogEnd;
+                }
+                else if( argument.find( "--screenshot-samples=" ) != std::string::npos )
+                {
+                    auto len = std::string( "--screenshot-samples=" ).length();
+                    try
+                    {
+                        m_screenShotSamples = std::stoi( argument.substr( len, argument.length() - len ) );
+                    }
+                    catch( const std::exception& )
+                    {
+                        m_screenShotSamples = 0;
+                    }
+                    if( m_screenShotSamples <= 0 )
+                    {
+                        LogE << "Commandline: invalid number of screenshot samples." << LogEnd;
+                        return false;
+                    }
+                    LogD << "Commandline: screenshot samples set to " << m_screenShotSamples << "." << LogEnd;
+                }
+                else if( argument == "--screenshot-all-views" )
+                {
+                    m_screenShotAllViews = true;
+                    LogD << "Commandline: rendering all default views." << LogEnd;
+                }
+                else if( argument == "--lic" )
+                {
+                    m_headlessLIC = true;
+                    LogD << "Commandline: using surface LIC in headless mode." << LogEnd;
+                }
+                else if( argument == "--profile-gpu" )
+                {
+                    di::core::GPUProfiler::getInstance().setEnabled( true );
+                    LogD << "Commandline: GPU profiling enabled." << LogEnd;
+                }
                 else
                 {
                     // We assume all arguments to be filenames
@@ -185,7 +264,7 @@ namespace di
             m_labelFile = new di::gui::FileWidget( std::make_shared< di::io::RegionLabelReader >(),
                                                    "Region Labels",
                                                    QIcon( QPixmap( iconLabels_xpm ) ),
-                                                   QString( "Region Labels File (*.labels)" ) );
+                                                   QString( "Region Labels File (*.labels *.annot *.gii)" ) );
             m_dataWidget->addFileWidget( m_labelFile );
 
             // Load Label Order List
@@ -211,6 +290,45 @@ namespace di
             s = m_algorithmStrategies->addStrategy( new di::gui::AlgorithmStrategy( "Surface LIC" ) );
             auto lic = s->addAlgorithm( new di::gui::AlgorithmWidget( SPtr< di::algorithms::SurfaceLIC >( new di::algorithms::SurfaceLIC ) ) );
 
+            // Strategy 3:
+            s = m_algorithmStrategies->addStrategy( new di::gui::AlgorithmStrategy( "Surface Streamlines" ) );
+            auto renderSurface = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::RenderTriangles ) )
+            );
+            auto streamlines = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::SurfaceStreamlines ) )
+            );
+            auto renderStreamlines = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::RenderLines ) )
+            );
+            auto singularities = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::ExtractSingularities ) )
+            );
+            auto renderSingularities = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::RenderPoints ) )
+            );
+
+            // Strategy 4:
+            s = m_algorithmStrategies->addStrategy( new di::gui::AlgorithmStrategy( "Mesh LIC" ) );
+            auto meshLIC = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::MeshLIC ) )
+            );
+            auto renderMeshLIC = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::RenderTriangles ) )
+            );
+
+            // Strategy 5:
+            s = m_algorithmStrategies->addStrategy( new di::gui::AlgorithmStrategy( "Region Boundary Lines" ) );
+            auto renderRegionSurface = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::RenderTriangles ) )
+            );
+            auto regionBoundaries = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::RegionBoundaries ) )
+            );
+            auto renderRegionBoundaries = s->addAlgorithm(
+                new di::gui::AlgorithmWidget( SPtr< di::core::Algorithm >( new di::algorithms::RenderLines ) )
+            );
+
             // Tell the data widget that the processing network is ready.
             m_dataWidget->prepareProcessingNetwork();
             m_extractRegions->prepareProcessingNetwork();
@@ -239,6 +357,24 @@ namespace di
 
             getProcessingNetwork()->connectAlgorithms( m_extractRegions->getAlgorithm(), "Directionality", lic->getAlgorithm(), "Directions" );
 
+            getProcessingNetwork()->connectAlgorithms( m_meshFile->getDataInject(), "Data", renderSurface->getAlgorithm(), "Triangle Mesh" );
+            getProcessingNetwork()->connectAlgorithms( m_extractRegions->getAlgorithm(), "Directionality",
+                                                       streamlines->getAlgorithm(), "Directions" );
+            getProcessingNetwork()->connectAlgorithms( streamlines->getAlgorithm(), "Streamlines", renderStreamlines->getAlgorithm(), "Lines" );
+            getProcessingNetwork()->connectAlgorithms( m_extractRegions->getAlgorithm(), "Directionality",
+                                                       singularities->getAlgorithm(), "Directions" );
+            getProcessingNetwork()->connectAlgorithms( singularities->getAlgorithm(), "Singularities",
+                                                       renderSingularities->getAlgorithm(), "Points" );
+
+            getProcessingNetwork()->connectAlgorithms( m_extractRegions->getAlgorithm(), "Directionality", meshLIC->getAlgorithm(), "Directions" );
+            getProcessingNetwork()->connectAlgorithms( meshLIC->getAlgorithm(), "LIC", renderMeshLIC->getAlgorithm(), "Triangle Mesh" );
+
+            getProcessingNetwork()->connectAlgorithms( m_meshFile->getDataInject(), "Data", renderRegionSurface->getAlgorithm(), "Triangle Mesh" );
+            getProcessingNetwork()->connectAlgorithms( m_meshFile->getDataInject(), "Data", regionBoundaries->getAlgorithm(), "Triangle Mesh" );
+            getProcessingNetwork()->connectAlgorithms( m_labelFile->getDataInject(), "Data", regionBoundaries->getAlgorithm(), "Labels" );
+            getProcessingNetwork()->connectAlgorithms( regionBoundaries->getAlgorithm(), "Boundaries",
+                                                       renderRegionBoundaries->getAlgorithm(), "Lines" );
+
             // END:
             // Hard-coded processing network ... ugly but working for now. The optimal solution would be a generic UI which provides this to the user
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -249,7 +385,7 @@ namespace di
             for( auto filename : m_deferLoad )
             {
                 auto ext = di::core::toLower( di::core::getFileExtension( filename ) );
-                if( ext == "project" )
+                if( ( ext == "project" ) || ( ext == "bproject" ) )
                 {
                     loadProject( QString::fromStdString( filename ) );
                     continue;
@@ -291,6 +427,163 @@ namespace di
             }
         }
 
+        /**
+         * Wait until the network processed all commands issued so far.
+         *
+         * \param network the network
+         */
+        static void waitForNetwork( SPtr< di::core::ProcessingNetwork > network )
+        {
+            std::promise< void > done;
+            network->callback( [ &done ]()
+                {
+                    done.set_value();
+                }
+            );
+            done.get_future().wait();
+        }
+
+        int App::runHeadless()
+        {
+            if( !di::core::HeadlessContext::isAvailable() )
+            {
+                LogE << "Headless rendering is not available in this build. EGL or OSMesa is required." << LogEnd;
+                return 1;
+            }
+
+            auto network = getProcessingNetwork();
+
+            // The same network as built by prepareNetwork. Only the visualization to render is added.
+            auto meshInject = std::make_shared< di::algorithms::DataInject >();
+            auto labelInject = std::make_shared< di::algorithms::DataInject >();
+            auto labelOrderInject = std::make_shared< di::algorithms::DataInject >();
+            SPtr< di::core::Algorithm > extractRegions( new di::algorithms::ExtractRegions );
+            SPtr< di::core::Algorithm > vis;
+            if( m_headlessLIC )
+            {
+                vis = SPtr< di::core::Algorithm >( new di::algorithms::SurfaceLIC );
+            }
+            else
+            {
+                vis = SPtr< di::core::Algorithm >( new di::algorithms::RenderIllustrativeLines );
+            }
+
+            network->addAlgorithm( meshInject );
+            network->addAlgorithm( labelInject );
+            network->addAlgorithm( labelOrderInject );
+            network->addAlgorithm( extractRegions );
+            network->addAlgorithm( vis );
+
+            network->connectAlgorithms( meshInject, "Data", extractRegions, "Triangle Mesh" );
+            network->connectAlgorithms( labelInject, "Data", extractRegions, "Triangle Labels" );
+            network->connectAlgorithms( labelOrderInject, "Data", extractRegions, "Label Ordering" );
+            network->connectAlgorithms( meshInject, "Data", vis, "Triangle Mesh" );
+            network->connectAlgorithms( extractRegions, "Directionality", vis, "Directions" );
+            if( !m_headlessLIC )
+            {
+                network->connectAlgorithms( labelInject, "Data", vis, "Labels" );
+            }
+
+            // Collect the files. Projects provide the files, the parameters and the camera. Files given explicitly take precedence.
+            glm::mat4 orientation = di::gui::OGLWidget::getOrientationMatrixAlongPosX();
+            di::core::State parameters;
+            std::string meshFile;
+            std::string labelFile;
+            std::string labelOrderFile;
+            for( auto filename : m_deferLoad )
+            {
+                auto ext = di::core::toLower( di::core::getFileExtension( filename ) );
+                if( ( ext == "project" ) || ( ext == "bproject" ) )
+                {
+                    auto project = di::core::State::fromFile( filename );
+                    orientation = project.getState( "view1" ).getValue< glm::mat4 >( "Arcball Matrix", orientation );
+                    parameters = project.getState( "parameters" );
+
+                    auto files = project.getState( "files" );
+                    meshFile = files.getState( "Mesh" ).getValue( "Filename", meshFile );
+                    labelFile = files.getState( "Region Labels" ).getValue( "Filename", labelFile );
+                    labelOrderFile = files.getState( "Label Ordering" ).getValue( "Filename", labelOrderFile );
+                }
+                else if( ext == "labelorder" )
+                {
+                    labelOrderFile = filename;
+                }
+                else if( ext == "labels" )
+                {
+                    labelFile = filename;
+                }
+                else if( ext == "ply" )
+                {
+                    meshFile = filename;
+                }
+            }
+
+            if( meshFile.empty() || labelFile.empty() || labelOrderFile.empty() )
+            {
+                LogE << "Headless mode requires a mesh, a label and a label order file, or a project referencing them." << LogEnd;
+                return 1;
+            }
+
+            // The parameters can only be set once the algorithms are in the network.
+            waitForNetwork( network );
+            network->setState( parameters );
+
+            network->loadFile( std::make_shared< di::io::PlyReader >(), meshFile, meshInject );
+            network->loadFile( std::make_shared< di::io::RegionLabelReader >(), labelFile, labelInject );
+            network->loadFile( std::make_shared< di::io::RegionLabelReader >(), labelOrderFile, labelOrderInject );
+            network->runNetwork();
+            waitForNetwork( network );
+
+            // The views to render. Same as the medical default views of the view widget.
+            std::vector< std::tuple< glm::mat4, std::string > > views;
+            views.push_back( std::make_tuple( orientation, "User Camera" ) );
+            if( m_screenShotAllViews )
+            {
+                views.push_back( std::make_tuple( di::gui::OGLWidget::getOrientationMatrixAlongNegY(), "Anterior" ) );
+                views.push_back( std::make_tuple( di::gui::OGLWidget::getOrientationMatrixAlongPosY(), "Posterior" ) );
+                views.push_back( std::make_tuple( di::gui::OGLWidget::getOrientationMatrixAlongPosX(), "Left" ) );
+                views.push_back( std::make_tuple( di::gui::OGLWidget::getOrientationMatrixAlongNegX(), "Right" ) );
+                views.push_back( std::make_tuple( di::gui::OGLWidget::getOrientationMatrixAlongNegZ(), "Superior" ) );
+                views.push_back( std::make_tuple( di::gui::OGLWidget::getOrientationMatrixAlongPosZ(), "Inferior" ) );
+            }
+
+            std::string path = m_screenShotPath.empty() ? "." : m_screenShotPath;
+            int retVal = 0;
+            try
+            {
+                di::core::HeadlessContext context;
+                di::core::HeadlessRenderer renderer( network );
+                renderer.prepare();
+
+                // The images are written in the background while the next view renders.
+                std::vector< SPtr< di::commands::WriteImage > > writes;
+                for( auto view : views )
+                {
+                    auto pixels = renderer.render( glm::ivec2( m_screenShotWidth, m_screenShotHeight ), std::get< 0 >( view ), m_screenShotSamples );
+                    writes.push_back(
+                        di::io::ImageWriter::getInstance().write( pixels, path + "/Screenshot_" + std::get< 1 >( view ) + ".png" )
+                    );
+                }
+                renderer.finalize();
+
+                di::io::ImageWriter::getInstance().wait();
+                for( auto write : writes )
+                {
+                    if( write->isFailed() )
+                    {
+                        retVal = 1;
+                    }
+                }
+            }
+            catch( const std::exception& e )
+            {
+                LogE << "Headless rendering failed: " << e.what() << LogEnd;
+                return 1;
+            }
+
+            return retVal;
+        }
+
         void App::close()
         {
             LogD << "Shutdown. Bye!" << LogEnd;
@@ -339,8 +632,15 @@ namespace di
                 main.set( "files", filesState );
             }
 
-            // Done collecting data. Save ...
-            main.toFile( filename.toStdString() );
+            // Done collecting data. Save ... Binary projects also embed pre-computed results.
+            if( filename.endsWith( ".bproject" ) )
+            {
+                main.toBinaryFile( filename.toStdString() );
+            }
+            else
+            {
+                main.toFile( filename.toStdString() );
+            }
         }
     }
 }
@@ -131,6 +131,13 @@ namespace di
              */
             virtual bool handleCommandLine( const std::vector< std::string >& arguments, int argc, char** argv );
 
+            /**
+             * Build the same network as \ref prepareNetwork, without any widget, and render the screenshots using a headless OpenGL context.
+             *
+             * \return 0 on success.
+             */
+            virtual int runHeadless() override;
+
         private:
             /**
              * The data-handling widget.
@@ -186,6 +193,31 @@ namespace di
              * The path where to store the screenshots. Needs to be absolute.
              */
             std::string m_screenShotPath;
+
+            /**
+             * Screenshot width in headless mode.
+             */
+            int m_screenShotWidth = 2048;
+
+            /**
+             * Screenshot height in headless mode.
+             */
+            int m_screenShotHeight = 1536;
+
+            /**
+             * Number of samples for anti-aliasing in headless mode.
+             */
+            int m_screenShotSamples = 4;
+
+            /**
+             * If true, headless mode also renders the medical default views.
+             */
+            bool m_screenShotAllViews = false;
+
+            /**
+             * If true, headless mode uses the surface LIC instead of the arrows.
+             */
+            bool m_headlessLIC = false;
         };
     }
 }
@@ -35,12 +35,18 @@
 #include <thread>
 #include <chrono>
 #include <iostream>
+#include <limits>
 
 #include <di/core/data/TriangleDataSet.h>
 #include <di/core/data/LineDataSet.h>
 #include <di/core/data/PointDataSet.h>
 #include <di/core/data/Points.h>
 #include <di/core/data/Lines.h>
+#include <di/core/data/ConjugateGradient.h>
+#include <di/core/data/MeshGradient.h>
+#include <di/core/data/MeshLaplacian.h>
+#include <di/core/data/SparseMatrix.h>
+#include <di/core/Hash.h>
 
 #include "ExtractRegions.h"
 
@@ -88,6 +94,19 @@ namespace di
                     "If enabled, the directionality of the arrows will be inverted.",
                     true
             );
+
+            m_harmonicInterpolation = addParameter< bool >(
+                    "Harmonic Interpolation",
+                    "If enabled, the directions between the region borders are interpolated by solving a Laplace equation. This is smooth and "
+                    "handles large meshes well. Otherwise, the directions are spread ring by ring.",
+                    false
+            );
+
+            m_cotangentWeights = addParameter< bool >(
+                    "Cotangent Weights",
+                    "If enabled, the harmonic interpolation accounts for the shape of the triangles. Otherwise, all edges are weighted equally.",
+                    true
+            );
         }
 
         ExtractRegions::~ExtractRegions()
@@ -142,6 +161,20 @@ namespace di
                 LogE << "Number of labels needs to match the number of vertices in the triangle mesh." << LogEnd;
             }
 
+            // Results restored from a project can be used as long as the inputs did not change.
+            uint64_t fingerprint = calculateFingerprint( triangles, labels, labelOrders );
+            {
+                std::unique_lock< std::mutex > lock( m_resultMutex );
+                auto restored = m_restoredVectors;
+                if( restored && ( m_restoredFingerprint == fingerprint ) && ( restored->size() == triangles->getNumVertices() ) )
+                {
+                    lock.unlock();
+                    LogD << "Using pre-computed directionality. Skipping computation." << LogEnd;
+                    setResult( triangles, restored, fingerprint );
+                    return;
+                }
+            }
+
             // Debug Code
             if( labelOrders )
             {
@@ -167,53 +200,25 @@ namespace di
                 // DATA: Used to store the direction at each vertex
                 auto vectorAttribute = std::make_shared< di::Vec3Array >( triangles->getNumVertices() );
 
-                // This case is mostly trivial. Calculate a direction for each vertex of the mesh:
-                for( size_t vertexID = 0; vertexID < triangles->getNumVertices(); ++vertexID )
+                // The direction is the surface gradient of the labels. The operator only depends on the mesh. Build it once per mesh.
+                if( m_gradientMesh != triangles )
                 {
-                    // Get neighbours
-                    auto neighbours = triangles->getNeighbourVertices( vertexID );
-
-                    // Accumulate direction in here
-                    auto direction = glm::vec3( 0.0 );
-
-                    // The vertex itself
-                    auto vertex = triangles->getVertex( vertexID );
-                    auto vertexValue = static_cast< float >( labels->at( vertexID ) );
-
-                    // Iterate all neighbours.
-                    for( auto neighbourID : neighbours )
-                    {
-                        // Well, the neighbour function includes the source vertex too. Skip the source vertex.
-                        if( vertexID == neighbourID )
-                        {
-                            continue;
-                        }
-
-                        // Neighbour vertex and value:
-                        auto neighbourVertex = triangles->getVertex( neighbourID );
-                        auto neighbourValue = static_cast< float >( labels->at( neighbourID ) );
-
-                        // Distance:
-                        auto dist = glm::distance( neighbourVertex, vertex );
-
-                        // The weight of this direction is defined by a distance-normalized value
-                        auto weight = ( neighbourValue - vertexValue ) / dist;
-
-                        // Now use the direction to this vertex and scale by weight:
-                        direction += weight * glm::normalize( neighbourVertex - vertex );
-                    }
-
-
-                    // But allow the user to change it again
-                    direction *= m_enableDirectionSwitch->get() ? -1.0f : 1.0f;
+                    m_gradient = std::make_shared< core::MeshGradient >( *triangles );
+                    m_gradientMesh = triangles;
+                }
+                m_gradient->apply( *labels, *vectorAttribute );
 
-                    // Store
-                    vectorAttribute->at( vertexID ) = glm::normalize( direction );
+                // But allow the user to change it again
+                auto sign = m_enableDirectionSwitch->get() ? -1.0f : 1.0f;
+                for( auto& direction : *vectorAttribute )
+                {
+                    auto length = glm::length( direction );
+                    direction = ( length > 0.0f ) ? ( sign / length ) * direction : glm::vec3( 0.0f );
                 }
 
                 // Update outputs
                 LogD << "Done. Updating output." << LogEnd;
-                m_vectorOutput->setData( std::make_shared< di::core::TriangleVectorField >( "Directionality", triangles, vectorAttribute ) );
+                setResult( triangles, vectorAttribute, fingerprint );
 
                 // Case 1 finished. Stop here.
                 return;
@@ -463,8 +468,15 @@ namespace di
             //
             //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+            // Solve for all vertices at once if requested. The spreading below is skipped then.
+            bool harmonic = m_harmonicInterpolation->get();
+            if( harmonic )
+            {
+                interpolateHarmonic( triangles, vertexIgnore, vectorAttributeSet, *vectorAttribute );
+            }
+
             // This is an iterative process to spread the values in to each vertex by using its neighbours
-            bool keepRunning = true;
+            bool keepRunning = !harmonic;
             while( keepRunning )
             {
                 auto nowSet = vectorAttributeSet;
@@ -617,7 +629,153 @@ namespace di
 
             // Update outputs
             LogD << "Done. Updating output." << LogEnd;
-            m_vectorOutput->setData( std::make_shared< di::core::TriangleVectorField >( "Directionality", triangles, vectorAttribute ) );
+            setResult( triangles, vectorAttribute, fingerprint );
+        }
+
+        void ExtractRegions::setResult( ConstSPtr< core::TriangleMesh > triangles, ConstSPtr< di::Vec3Array > vectors, uint64_t fingerprint )
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_resultMutex );
+                m_resultVectors = vectors;
+                m_resultFingerprint = fingerprint;
+            }
+            m_vectorOutput->setData( std::make_shared< di::core::TriangleVectorField >( "Directionality", triangles, vectors ) );
+        }
+
+        void ExtractRegions::interpolateHarmonic( ConstSPtr< core::TriangleMesh > triangles, const std::vector< bool >& vertexIgnore,
+                                                  const std::vector< bool >& vectorAttributeSet, di::Vec3Array& vectors ) const
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            // Number the unknowns.
+            const size_t unknown = std::numeric_limits< size_t >::max();
+            std::vector< size_t > unknownIndex( triangles->getNumVertices(), unknown );
+            std::vector< size_t > unknownVertices;
+            for( size_t vertexID = 0; vertexID < triangles->getNumVertices(); ++vertexID )
+            {
+                if( !vertexIgnore[ vertexID ] && !vectorAttributeSet[ vertexID ] )
+                {
+                    unknownIndex[ vertexID ] = unknownVertices.size();
+                    unknownVertices.push_back( vertexID );
+                }
+            }
+            if( unknownVertices.empty() )
+            {
+                return;
+            }
+
+            auto laplacian = core::calculateLaplacian( *triangles, m_cotangentWeights->get() ? core::LaplacianWeights::Cotangent :
+                                                                                               core::LaplacianWeights::Uniform );
+
+            // Restrict the Laplacian to the unknowns. Known neighbours move to the right hand side. Ignored neighbours are left out, which
+            // makes the border to them a free (Neumann) boundary.
+            const auto& rowOffsets = laplacian.getRowOffsets();
+            const auto& columns = laplacian.getColumns();
+            const auto& values = laplacian.getValues();
+            std::vector< core::SparseMatrix::Entry > entries;
+            std::vector< std::vector< double > > rhs( 3, std::vector< double >( unknownVertices.size(), 0.0 ) );
+            for( size_t row = 0; row < unknownVertices.size(); ++row )
+            {
+                auto vertexID = unknownVertices[ row ];
+                double diagonal = 0.0;
+                for( size_t i = rowOffsets[ vertexID ]; i < rowOffsets[ vertexID + 1 ]; ++i )
+                {
+                    auto neighbourID = columns[ i ];
+                    if( ( neighbourID == vertexID ) || vertexIgnore[ neighbourID ] )
+                    {
+                        continue;
+                    }
+
+                    double weight = -values[ i ];
+                    diagonal += weight;
+                    if( unknownIndex[ neighbourID ] != unknown )
+                    {
+                        entries.push_back( core::SparseMatrix::Entry( row, unknownIndex[ neighbourID ], -weight ) );
+                    }
+                    else
+                    {
+                        for( int c = 0; c < 3; ++c )
+                        {
+                            rhs[ c ][ row ] += weight * vectors[ neighbourID ][ c ];
+                        }
+                    }
+                }
+
+                // Isolated vertices keep a zero vector.
+                entries.push_back( core::SparseMatrix::Entry( row, row, ( diagonal > 0.0 ) ? diagonal : 1.0 ) );
+            }
+            core::SparseMatrix system( unknownVertices.size(), unknownVertices.size(), entries );
+
+            std::vector< double > solution[ 3 ];
+            for( int c = 0; c < 3; ++c )
+            {
+                auto result = core::solveConjugateGradient( system, rhs[ c ], solution[ c ], 1e-6, 10 * unknownVertices.size() );
+                LogD << "Harmonic interpolation, component " << c << ": " << result.m_iterations << " iterations, relative residual "
+                     << result.m_relativeResidual << "." << LogEnd;
+                if( !result.m_converged )
+                {
+                    LogW << "Harmonic interpolation did not converge. Relative residual: " << result.m_relativeResidual << "." << LogEnd;
+                }
+            }
+
+            // Keep the vectors on the surface.
+            for( size_t row = 0; row < unknownVertices.size(); ++row )
+            {
+                auto vertexID = unknownVertices[ row ];
+                auto vec = glm::vec3( solution[ 0 ][ row ], solution[ 1 ][ row ], solution[ 2 ][ row ] );
+                auto normal = triangles->getNormal( vertexID );
+                if( glm::length( normal ) > 0.0f )
+                {
+                    normal = glm::normalize( normal );
+                    vec -= glm::dot( vec, normal ) * normal;
+                }
+                vectors[ vertexID ] = vec;
+            }
+
+            auto duration = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - start );
+            LogD << "Interpolated " << unknownVertices.size() << " vertices in " << duration.count() << "ms." << LogEnd;
+        }
+
+        uint64_t ExtractRegions::calculateFingerprint( ConstSPtr< core::TriangleMesh > triangles,
+                                                       ConstSPtr< di::io::RegionLabelReader::AttributeType > labels,
+                                                       ConstSPtr< di::io::RegionLabelReader::AttributeType > labelOrders ) const
+        {
+            uint64_t hash = core::hashArray( triangles->getVertices() );
+            hash = core::hashArray( triangles->getTriangles(), hash );
+            hash = core::hashArray( *labels, hash );
+            if( labelOrders )
+            {
+                hash = core::hashArray( *labelOrders, hash );
+            }
+
+            bool parameters[ 3 ] = { m_enableDirectionSwitch->get(), m_harmonicInterpolation->get(), m_cotangentWeights->get() };
+            return core::hashBytes( parameters, sizeof( parameters ), hash );
+        }
+
+        core::State ExtractRegions::getResultState() const
+        {
+            core::State state;
+
+            std::lock_guard< std::mutex > lock( m_resultMutex );
+            if( m_resultVectors )
+            {
+                state.set( "fingerprint", m_resultFingerprint );
+                state.setBlob( "directionality", *m_resultVectors );
+            }
+            return state;
+        }
+
+        void ExtractRegions::setResultState( const core::State& state )
+        {
+            auto vectors = std::make_shared< di::Vec3Array >();
+            if( !state.isSet( "fingerprint" ) || !state.getBlob( "directionality", *vectors ) )
+            {
+                return;
+            }
+
+            std::lock_guard< std::mutex > lock( m_resultMutex );
+            m_restoredFingerprint = state.getValue< uint64_t >( "fingerprint", 0 );
+            m_restoredVectors = vectors;
         }
     }
 }
@@ -25,17 +25,24 @@
 #ifndef DI_EXTRACTREGIONS_H
 #define DI_EXTRACTREGIONS_H
 
+#include <cstdint>
 #include <mutex>
 #include <set>
 #include <vector>
 
 #include <di/core/Algorithm.h>
+#include <di/core/State.h>
 #include <di/core/data/DataSetTypes.h>
 #include <di/io/RegionLabelReader.h>
 #include <di/core/ParameterTypes.h>
 
 namespace di
 {
+    namespace core
+    {
+        class MeshGradient;
+    }
+
     namespace algorithms
     {
         /**
@@ -59,6 +66,22 @@ namespace di
              */
             virtual void process();
 
+            /**
+             * Provides the computed directionality and a fingerprint of the inputs used to compute it. This allows embedding the result into
+             * binary project files.
+             *
+             * \return the state describing the results.
+             */
+            virtual core::State getResultState() const override;
+
+            /**
+             * Restore a previously computed directionality. It is used instead of re-computing as long as the fingerprint of the inputs
+             * matches.
+             *
+             * \param state the result state
+             */
+            virtual void setResultState( const core::State& state ) override;
+
             /**
              * Associate each region with its neighbours. The size_t is the region index.
              */
@@ -86,11 +109,55 @@ namespace di
 
         protected:
         private:
+            /**
+             * Calculate a fingerprint of the given inputs and the parameters.
+             *
+             * \param triangles the mesh
+             * \param labels the labels
+             * \param labelOrders the label ordering. Can be nullptr.
+             *
+             * \return the fingerprint
+             */
+            uint64_t calculateFingerprint( ConstSPtr< core::TriangleMesh > triangles,
+                                           ConstSPtr< di::io::RegionLabelReader::AttributeType > labels,
+                                           ConstSPtr< di::io::RegionLabelReader::AttributeType > labelOrders ) const;
+
+            /**
+             * Publish the result and remember it for \ref getResultState.
+             *
+             * \param triangles the mesh the vectors are defined on
+             * \param vectors the vectors
+             * \param fingerprint the fingerprint of the inputs
+             */
+            void setResult( ConstSPtr< core::TriangleMesh > triangles, ConstSPtr< di::Vec3Array > vectors, uint64_t fingerprint );
+
+            /**
+             * Interpolate the vectors of all unset vertices by solving the Laplace equation with the set vertices as constraints. Each vector
+             * component is solved separately. The results are projected to the tangent plane of their vertex.
+             *
+             * \param triangles the mesh
+             * \param vertexIgnore vertices excluded from the interpolation. They do not influence their neighbours.
+             * \param vectorAttributeSet vertices with a known vector
+             * \param vectors the vectors. The unset ones get replaced.
+             */
+            void interpolateHarmonic( ConstSPtr< core::TriangleMesh > triangles, const std::vector< bool >& vertexIgnore,
+                                      const std::vector< bool >& vectorAttributeSet, di::Vec3Array& vectors ) const;
+
             /**
              * True to switch directions
              */
             core::ParamBool m_enableDirectionSwitch;
 
+            /**
+             * True to interpolate the directions by solving a Laplace equation instead of spreading them ring by ring.
+             */
+            core::ParamBool m_harmonicInterpolation;
+
+            /**
+             * True to use cotangent weights for the harmonic interpolation. Uniform weights otherwise.
+             */
+            core::ParamBool m_cotangentWeights;
+
             /**
              * The region mesh
              */
@@ -117,6 +184,41 @@ namespace di
              */
             SPtr< di::core::Connector< di::io::RegionLabelReader::DataSetType > > m_dataLabelOrderingInput;
 
+            /**
+             * The mesh \ref m_gradient was built for.
+             */
+            ConstSPtr< core::TriangleMesh > m_gradientMesh = nullptr;
+
+            /**
+             * Gradient operator of the current mesh. Re-used as long as the mesh stays the same.
+             */
+            SPtr< core::MeshGradient > m_gradient = nullptr;
+
+            /**
+             * Protects the result members. They are accessed by the processing thread and during state queries.
+             */
+            mutable std::mutex m_resultMutex;
+
+            /**
+             * The last computed directionality.
+             */
+            ConstSPtr< di::Vec3Array > m_resultVectors = nullptr;
+
+            /**
+             * Fingerprint of the inputs of \ref m_resultVectors.
+             */
+            uint64_t m_resultFingerprint = 0;
+
+            /**
+             * Directionality restored from a project. Used instead of computing if the fingerprint matches.
+             */
+            ConstSPtr< di::Vec3Array > m_restoredVectors = nullptr;
+
+            /**
+             * Fingerprint of the inputs of \ref m_restoredVectors.
+             */
+            uint64_t m_restoredFingerprint = 0;
+
         };
     }
 }
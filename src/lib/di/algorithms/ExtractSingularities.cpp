@@ -0,0 +1,140 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <vector>
+
+#include <di/core/data/Points.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/core/data/VectorFieldSingularities.h>
+
+#include "ExtractSingularities.h"
+
+#include <di/core/Logger.h>
+#define LogTag "algorithms/ExtractSingularities"
+
+namespace di
+{
+    namespace algorithms
+    {
+        ExtractSingularities::ExtractSingularities():
+            Algorithm( "Extract Singularities",
+                       "Find the sources, sinks, saddles and centers of a vector field on a triangle mesh." )
+        {
+            // 1: the output
+            m_singularitiesOutput = addOutput< di::core::PointDataSet >(
+                    "Singularities",
+                    "The critical points of the field, colored by their kind."
+            );
+
+            // 2: the input
+            m_vectorInput = addInput< di::core::TriangleVectorField >(
+                    "Directions",
+                    "The per-vertex vectors."
+            );
+
+            m_sourceColor = addParameter< di::Color >(
+                    "Source Color",
+                    "The color of points where the field points away in all directions.",
+                    di::Color( 1.0, 0.0, 0.0, 1.0 )
+            );
+
+            m_sinkColor = addParameter< di::Color >(
+                    "Sink Color",
+                    "The color of points where the field points towards the point from all directions.",
+                    di::Color( 0.0, 0.0, 1.0, 1.0 )
+            );
+
+            m_saddleColor = addParameter< di::Color >(
+                    "Saddle Color",
+                    "The color of saddle points.",
+                    di::Color( 0.0, 0.7, 0.0, 1.0 )
+            );
+
+            m_centerColor = addParameter< di::Color >(
+                    "Center Color",
+                    "The color of points the field rotates around.",
+                    di::Color( 1.0, 0.8, 0.0, 1.0 )
+            );
+        }
+
+        ExtractSingularities::~ExtractSingularities()
+        {
+            // nothing to clean up so far
+        }
+
+        void ExtractSingularities::process()
+        {
+            typedef di::core::VectorFieldSingularities::Type Type;
+
+            auto vectorDataSet = m_vectorInput->getData();
+            if( !vectorDataSet )
+            {
+                return;
+            }
+
+            auto mesh = vectorDataSet->getGrid();
+            auto vectors = vectorDataSet->getAttributes< 0 >();
+            if( vectors->size() != mesh->getNumVertices() )
+            {
+                LogE << "Number of vectors needs to match the number of vertices in the triangle mesh." << LogEnd;
+                return;
+            }
+
+            di::core::VectorFieldSingularities singularities( *mesh, *vectors );
+            LogD << "Found " << singularities.getNumSingularities( Type::Source ) << " sources, "
+                             << singularities.getNumSingularities( Type::Sink ) << " sinks, "
+                             << singularities.getNumSingularities( Type::Saddle ) << " saddles and "
+                             << singularities.getNumSingularities( Type::Center ) << " centers. Index sum: "
+                             << singularities.getIndexSum() << "." << LogEnd;
+
+            Vec3Array positions;
+            auto colors = std::make_shared< RGBAArray >();
+            positions.reserve( singularities.getSingularities().size() );
+            colors->reserve( singularities.getSingularities().size() );
+            for( const auto& singularity : singularities.getSingularities() )
+            {
+                positions.push_back( singularity.m_position );
+                switch( singularity.m_type )
+                {
+                    case Type::Source:
+                        colors->push_back( m_sourceColor->get() );
+                        break;
+                    case Type::Sink:
+                        colors->push_back( m_sinkColor->get() );
+                        break;
+                    case Type::Saddle:
+                        colors->push_back( m_saddleColor->get() );
+                        break;
+                    case Type::Center:
+                        colors->push_back( m_centerColor->get() );
+                        break;
+                }
+            }
+
+            auto points = std::make_shared< di::core::Points >();
+            points->setVertices( std::move( positions ) );
+            m_singularitiesOutput->setData( std::make_shared< di::core::PointDataSet >( "Singularities", points, colors ) );
+        }
+    }
+}
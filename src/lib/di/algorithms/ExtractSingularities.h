@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_EXTRACTSINGULARITIES_H
+#define DI_EXTRACTSINGULARITIES_H
+
+#include <di/core/Algorithm.h>
+#include <di/core/ParameterTypes.h>
+#include <di/core/data/DataSetTypes.h>
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * Find the sources, sinks, saddles and centers of a vector field on a triangle mesh. See
+         * \ref di::core::VectorFieldSingularities. The result is a point set, colored by the kind of each point.
+         */
+        class ExtractSingularities: public di::core::Algorithm
+        {
+        public:
+            /**
+             * Constructor. Initialize all inputs, outputs and parameters.
+             */
+            ExtractSingularities();
+
+            /**
+             * Destructor. Clean up if needed.
+             */
+            virtual ~ExtractSingularities();
+
+            /**
+             * Find the critical points.
+             */
+            virtual void process();
+
+        protected:
+        private:
+            /**
+             * The vector field.
+             */
+            SPtr< di::core::Connector< di::core::TriangleVectorField > > m_vectorInput;
+
+            /**
+             * The critical points.
+             */
+            SPtr< di::core::Connector< di::core::PointDataSet > > m_singularitiesOutput;
+
+            /**
+             * Color of sources.
+             */
+            core::ParamColor m_sourceColor;
+
+            /**
+             * Color of sinks.
+             */
+            core::ParamColor m_sinkColor;
+
+            /**
+             * Color of saddles.
+             */
+            core::ParamColor m_saddleColor;
+
+            /**
+             * Color of centers.
+             */
+            core::ParamColor m_centerColor;
+        };
+    }
+}
+
+#endif  // DI_EXTRACTSINGULARITIES_H
+
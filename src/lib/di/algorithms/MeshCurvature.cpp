@@ -0,0 +1,111 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <vector>
+
+#include <di/core/data/PrincipalCurvatures.h>
+#include <di/core/data/TriangleMesh.h>
+
+#include "MeshCurvature.h"
+
+#include <di/core/Logger.h>
+#define LogTag "algorithms/MeshCurvature"
+
+namespace di
+{
+    namespace algorithms
+    {
+        MeshCurvature::MeshCurvature():
+            Algorithm( "Mesh Curvature",
+                       "Compute the principal curvatures and directions of a triangle mesh." )
+        {
+            // 1: the outputs
+            m_meanCurvatureOutput = addOutput< di::core::TriangleScalarField >(
+                    "Mean Curvature",
+                    "The mean of the principal curvatures at each vertex. Positive where the surface bends away from the normal."
+            );
+
+            m_gaussianCurvatureOutput = addOutput< di::core::TriangleScalarField >(
+                    "Gaussian Curvature",
+                    "The product of the principal curvatures at each vertex. Negative on saddles."
+            );
+
+            m_principalDirectionsOutput = addOutput< di::core::TriangleVectorField >(
+                    "Principal Directions",
+                    "The unit direction of maximum curvature at each vertex."
+            );
+
+            // 2: the input
+            m_meshInput = addInput< di::core::TriangleDataSet >(
+                    "Triangle Mesh",
+                    "The triangle mesh."
+            );
+        }
+
+        MeshCurvature::~MeshCurvature()
+        {
+            // nothing to clean up so far
+        }
+
+        void MeshCurvature::process()
+        {
+            auto meshDataSet = m_meshInput->getData();
+            if( !meshDataSet )
+            {
+                return;
+            }
+
+            auto mesh = meshDataSet->getGrid();
+            if( mesh->getNumNormals() != mesh->getNumVertices() )
+            {
+                LogE << "The triangle mesh needs one normal per vertex." << LogEnd;
+                return;
+            }
+
+            auto curvatures = meshDataSet->getDerivedData< di::core::PrincipalCurvatures >(
+                [ & ]()
+                {
+                    LogD << "Computing the curvatures of " << mesh->getNumVertices() << " vertices." << LogEnd;
+                    return std::make_shared< di::core::PrincipalCurvatures >( *mesh );
+                }
+            );
+
+            auto mean = std::make_shared< std::vector< double > >( mesh->getNumVertices() );
+            auto gaussian = std::make_shared< std::vector< double > >( mesh->getNumVertices() );
+            for( size_t vertexID = 0; vertexID < mesh->getNumVertices(); ++vertexID )
+            {
+                ( *mean )[ vertexID ] = curvatures->getMeanCurvature( vertexID );
+                ( *gaussian )[ vertexID ] = curvatures->getGaussianCurvature( vertexID );
+            }
+
+            auto directions = std::make_shared< Vec3Array >( curvatures->getMaxDirections() );
+
+            m_meanCurvatureOutput->setData( std::make_shared< di::core::TriangleScalarField >( "Mean Curvature", mesh, mean ) );
+            m_gaussianCurvatureOutput->setData( std::make_shared< di::core::TriangleScalarField >( "Gaussian Curvature", mesh, gaussian ) );
+            m_principalDirectionsOutput->setData(
+                std::make_shared< di::core::TriangleVectorField >( "Principal Directions", mesh, directions )
+            );
+        }
+    }
+}
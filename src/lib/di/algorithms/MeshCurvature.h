@@ -0,0 +1,83 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MESHCURVATURE_H
+#define DI_MESHCURVATURE_H
+
+#include <di/core/Algorithm.h>
+#include <di/core/data/DataSetTypes.h>
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * Provide the curvature of a triangle mesh, see \ref di::core::PrincipalCurvatures. The curvatures are cached on the mesh dataset
+         * and shared with all other users of the same dataset.
+         */
+        class MeshCurvature: public di::core::Algorithm
+        {
+        public:
+            /**
+             * Constructor. Initialize all inputs, outputs and parameters.
+             */
+            MeshCurvature();
+
+            /**
+             * Destructor. Clean up if needed.
+             */
+            virtual ~MeshCurvature();
+
+            /**
+             * Compute the curvatures.
+             */
+            virtual void process();
+
+        protected:
+        private:
+            /**
+             * The triangle mesh.
+             */
+            SPtr< di::core::Connector< di::core::TriangleDataSet > > m_meshInput;
+
+            /**
+             * The mean curvature of each vertex.
+             */
+            SPtr< di::core::Connector< di::core::TriangleScalarField > > m_meanCurvatureOutput;
+
+            /**
+             * The Gaussian curvature of each vertex.
+             */
+            SPtr< di::core::Connector< di::core::TriangleScalarField > > m_gaussianCurvatureOutput;
+
+            /**
+             * The direction of maximum curvature of each vertex.
+             */
+            SPtr< di::core::Connector< di::core::TriangleVectorField > > m_principalDirectionsOutput;
+        };
+    }
+}
+
+#endif  // DI_MESHCURVATURE_H
+
@@ -0,0 +1,311 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/gfx/NoiseTextureCache.h>
+#include <di/MathTypes.h>
+
+#include "MeshLIC.h"
+
+#include <di/core/Logger.h>
+#define LogTag "algorithms/MeshLIC"
+
+/**
+ * Seed of the noise. Fixed to get the same image for the same input each time.
+ */
+static const uint64_t g_noiseSeed = 42;
+
+/**
+ * Number of vertices per tile. Tiles are the unit of parallel work.
+ */
+static const size_t g_tileSize = 1024;
+
+/**
+ * Streamlines are traced this many kernel lengths in each direction from the seed. Longer lines are re-used for more vertices.
+ */
+static const double g_streamlineReuse = 4.0;
+
+/**
+ * A sample contributes to the closest vertex of its triangle if the barycentric coordinate of that vertex is at least this value.
+ */
+static const double g_vertexProximity = 0.6;
+
+/**
+ * The intensities are stretched to map this many standard deviations around the mean to the full range.
+ */
+static const double g_contrastDeviations = 2.5;
+
+namespace di
+{
+    namespace algorithms
+    {
+        MeshLIC::MeshLIC():
+            Algorithm( "Mesh LIC",
+                       "Line integral convolution on the vertices of the mesh. Computed on the CPU, independent of the view." )
+        {
+            // 1: the output
+            m_licOutput = addOutput< di::core::TriangleDataSet >(
+                    "LIC",
+                    "The mesh with the LIC intensity as vertex color."
+            );
+
+            // 2: the input
+            m_vectorInput = addInput< di::core::TriangleVectorField >(
+                    "Directions",
+                    "The per-vertex vectors to convolve along."
+            );
+
+            m_kernelLength = addParameter< double >(
+                    "Kernel Length",
+                    "Half length of the convolution kernel, relative to the mean edge length of the mesh.",
+                    10.0
+            );
+            m_kernelLength->setRangeHint( 1.0, 50.0 );
+
+            m_stepSize = addParameter< double >(
+                    "Step Size",
+                    "The integration step size, relative to the mean edge length of the mesh.",
+                    0.5
+            );
+            m_stepSize->setRangeHint( 0.1, 1.0 );
+
+            m_minHits = addParameter< int >(
+                    "Minimum Hits",
+                    "Vertices that were passed by less streamlines than this start their own streamline. Higher values reduce the noise "
+                    "at the cost of more streamlines.",
+                    2
+            );
+            m_minHits->setRangeHint( 1, 10 );
+        }
+
+        MeshLIC::~MeshLIC()
+        {
+            // nothing to clean up so far
+        }
+
+        /**
+         * Apply a box filter to samples along a line. The samples may be spaced irregularly, so each one is weighted by the length of line it
+         * represents. The window is moved along the line and its sums are updated incrementally.
+         *
+         * \param arcLength the arc length at each sample. Non-decreasing.
+         * \param values the value at each sample
+         * \param kernelLength half the length of the box
+         * \param result the filtered values
+         */
+        static void convolveLine( const std::vector< double >& arcLength, const std::vector< double >& values, double kernelLength,
+                                  std::vector< double >& result )
+        {
+            size_t size = arcLength.size();
+            result.assign( size, 0.0 );
+            if( size == 1 )
+            {
+                result[ 0 ] = values[ 0 ];
+                return;
+            }
+
+            auto weight = [ & ]( size_t i )
+            {
+                return 0.5 * ( arcLength[ std::min( i + 1, size - 1 ) ] - arcLength[ ( i > 0 ) ? i - 1 : 0 ] );
+            };
+
+            double weightSum = 0.0;
+            double valueSum = 0.0;
+            size_t low = 0;
+            size_t high = 0;
+            for( size_t i = 0; i < size; ++i )
+            {
+                while( ( high < size ) && ( arcLength[ high ] <= arcLength[ i ] + kernelLength ) )
+                {
+                    weightSum += weight( high );
+                    valueSum += weight( high ) * values[ high ];
+                    ++high;
+                }
+                while( arcLength[ low ] < arcLength[ i ] - kernelLength )
+                {
+                    weightSum -= weight( low );
+                    valueSum -= weight( low ) * values[ low ];
+                    ++low;
+                }
+                result[ i ] = ( weightSum > 0.0 ) ? valueSum / weightSum : values[ i ];
+            }
+        }
+
+        void MeshLIC::process()
+        {
+            auto vectorDataSet = m_vectorInput->getData();
+            if( !vectorDataSet )
+            {
+                return;
+            }
+
+            auto mesh = vectorDataSet->getGrid();
+            auto vectors = vectorDataSet->getAttributes< 0 >();
+            if( vectors->size() != mesh->getNumVertices() )
+            {
+                LogE << "Number of vectors needs to match the number of vertices in the triangle mesh." << LogEnd;
+                return;
+            }
+
+            if( !m_tracer || ( m_tracer->getMesh() != mesh ) )
+            {
+                m_tracer = std::make_shared< di::core::MeshStreamlineTracer >( mesh );
+            }
+
+            const auto& triangles = mesh->getTriangles();
+            size_t numVertices = mesh->getNumVertices();
+            double kernelLength = m_kernelLength->get() * m_tracer->getMeanEdgeLength();
+            double stepSize = m_stepSize->get() * m_tracer->getMeanEdgeLength();
+            uint32_t minHits = static_cast< uint32_t >( std::max( 1, m_minHits->get() ) );
+
+            // Edge crossings count as steps too. Allow twice the steps needed for the length.
+            size_t maxSteps = 2 * static_cast< size_t >( std::ceil( g_streamlineReuse * m_kernelLength->get() / m_stepSize->get() ) );
+
+            // One triangle per vertex to start streamlines in.
+            auto noVertexTriangle = std::numeric_limits< size_t >::max();
+            std::vector< size_t > vertexTriangles( numVertices, noVertexTriangle );
+            for( size_t triangle = 0; triangle < triangles.size(); ++triangle )
+            {
+                for( int k = 0; k < 3; ++k )
+                {
+                    vertexTriangles[ triangles[ triangle ][ k ] ] = triangle;
+                }
+            }
+
+            auto noiseBytes = di::core::NoiseTextureCache::generate( numVertices, g_noiseSeed );
+            std::vector< double > noise( noiseBytes.begin(), noiseBytes.end() );
+
+            // Tiles only write to their own vertices and are processed sequentially, so the result does not depend on the number of threads.
+            LogD << "Convolving " << numVertices << " vertices." << LogEnd;
+            std::vector< double > sums( numVertices, 0.0 );
+            std::vector< uint32_t > hits( numVertices, 0 );
+            size_t numTiles = ( numVertices + g_tileSize - 1 ) / g_tileSize;
+            di::core::parallelFor( numTiles,
+                [ & ]( size_t beginTile, size_t endTile )
+                {
+                    std::vector< di::core::MeshStreamlineTracer::Point > points;
+                    std::vector< double > arcLength;
+                    std::vector< double > values;
+                    std::vector< double > convolved;
+                    for( size_t tile = beginTile; tile < endTile; ++tile )
+                    {
+                        size_t begin = tile * g_tileSize;
+                        size_t end = std::min( begin + g_tileSize, numVertices );
+                        for( size_t vertex = begin; vertex < end; ++vertex )
+                        {
+                            if( ( hits[ vertex ] >= minHits ) || ( vertexTriangles[ vertex ] == noVertexTriangle ) )
+                            {
+                                continue;
+                            }
+
+                            di::core::MeshStreamlineTracer::Point seed;
+                            seed.m_triangle = vertexTriangles[ vertex ];
+                            const auto& seedTri = triangles[ seed.m_triangle ];
+                            seed.m_barycentric = glm::dvec3( seedTri.x == static_cast< int >( vertex ),
+                                                             seedTri.y == static_cast< int >( vertex ),
+                                                             seedTri.z == static_cast< int >( vertex ) );
+
+                            points.clear();
+                            bool truncatedBackward = m_tracer->trace( *vectors, seed, stepSize, maxSteps, true, points );
+                            std::reverse( points.begin(), points.end() );
+                            size_t seedIndex = points.size();
+                            points.push_back( seed );
+                            bool truncatedForward = m_tracer->trace( *vectors, seed, stepSize, maxSteps, false, points );
+
+                            // Sample the noise along the line and convolve.
+                            arcLength.resize( points.size() );
+                            values.resize( points.size() );
+                            auto previous = m_tracer->getPosition( points[ 0 ] );
+                            double length = 0.0;
+                            for( size_t i = 0; i < points.size(); ++i )
+                            {
+                                const auto& tri = triangles[ points[ i ].m_triangle ];
+                                auto position = m_tracer->getPosition( points[ i ] );
+                                length += glm::distance( previous, position );
+                                previous = position;
+                                arcLength[ i ] = length;
+                                values[ i ] = glm::dot( points[ i ].m_barycentric, glm::dvec3( noise[ tri.x ], noise[ tri.y ], noise[ tri.z ] ) );
+                            }
+                            convolveLine( arcLength, values, kernelLength, convolved );
+
+                            // Hand the results to the vertices of this tile close to the line. Skip samples whose kernel was cut off by the
+                            // step limit, besides the seed.
+                            for( size_t i = 0; i < points.size(); ++i )
+                            {
+                                bool cutOff = ( truncatedBackward && ( arcLength[ i ] < kernelLength ) ) ||
+                                              ( truncatedForward && ( arcLength.back() - arcLength[ i ] < kernelLength ) );
+                                if( cutOff && ( i != seedIndex ) )
+                                {
+                                    continue;
+                                }
+
+                                const auto& b = points[ i ].m_barycentric;
+                                int closest = ( b.x >= b.y ) ? ( ( b.x >= b.z ) ? 0 : 2 ) : ( ( b.y >= b.z ) ? 1 : 2 );
+                                size_t closestVertex = static_cast< size_t >( triangles[ points[ i ].m_triangle ][ closest ] );
+                                if( ( b[ closest ] >= g_vertexProximity ) && ( closestVertex >= begin ) && ( closestVertex < end ) )
+                                {
+                                    sums[ closestVertex ] += convolved[ i ];
+                                    ++hits[ closestVertex ];
+                                }
+                            }
+                        }
+                    }
+                },
+                1
+            );
+
+            // Stretch the contrast. Convolution reduces the variance of the noise a lot.
+            std::vector< double > intensities( numVertices );
+            double mean = 0.0;
+            for( size_t vertex = 0; vertex < numVertices; ++vertex )
+            {
+                intensities[ vertex ] = ( hits[ vertex ] > 0 ) ? sums[ vertex ] / hits[ vertex ] : noise[ vertex ];
+                mean += intensities[ vertex ];
+            }
+            mean /= std::max( numVertices, size_t( 1 ) );
+
+            double variance = 0.0;
+            for( auto intensity : intensities )
+            {
+                variance += ( intensity - mean ) * ( intensity - mean );
+            }
+            double deviation = std::sqrt( variance / std::max( numVertices, size_t( 1 ) ) );
+            double scale = ( deviation > 0.0 ) ? 0.5 / ( g_contrastDeviations * deviation ) : 0.0;
+
+            auto colors = std::make_shared< RGBAArray >( numVertices );
+            for( size_t vertex = 0; vertex < numVertices; ++vertex )
+            {
+                auto intensity = static_cast< float >( glm::clamp( 0.5 + ( intensities[ vertex ] - mean ) * scale, 0.0, 1.0 ) );
+                ( *colors )[ vertex ] = glm::vec4( intensity, intensity, intensity, 1.0f );
+            }
+
+            m_licOutput->setData( std::make_shared< di::core::TriangleDataSet >( "LIC", mesh, colors ) );
+        }
+    }
+}
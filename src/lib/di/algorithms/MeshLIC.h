@@ -0,0 +1,99 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MESHLIC_H
+#define DI_MESHLIC_H
+
+#include <di/core/Algorithm.h>
+#include <di/core/ParameterTypes.h>
+#include <di/core/data/DataSetTypes.h>
+#include <di/core/data/MeshStreamlineTracer.h>
+#include <di/core/data/TriangleDataSet.h>
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * Line integral convolution on the vertices of a triangle mesh, computed on the CPU. Unlike \ref SurfaceLIC, the result does not depend
+         * on the view or the resolution and needs no OpenGL context. Per-vertex white noise is convolved along streamlines of the vector
+         * field. Like fast-LIC, each streamline is traced well beyond the kernel and the convolution is updated incrementally along it, so
+         * one streamline provides the result for all vertices it passes. The vertices are split into fixed tiles that are processed in
+         * parallel, which keeps the result independent of the number of threads. The output can be rendered with \ref RenderTriangles.
+         */
+        class MeshLIC: public di::core::Algorithm
+        {
+        public:
+            /**
+             * Constructor. Initialize all inputs, outputs and parameters.
+             */
+            MeshLIC();
+
+            /**
+             * Destructor. Clean up if needed.
+             */
+            virtual ~MeshLIC();
+
+            /**
+             * Compute the LIC intensities of the input field.
+             */
+            virtual void process();
+
+        protected:
+        private:
+            /**
+             * The vector field to convolve along.
+             */
+            SPtr< di::core::Connector< di::core::TriangleVectorField > > m_vectorInput;
+
+            /**
+             * The mesh with the LIC intensity as color.
+             */
+            SPtr< di::core::Connector< di::core::TriangleDataSet > > m_licOutput;
+
+            /**
+             * Half length of the convolution kernel relative to the mean edge length.
+             */
+            core::ParamDouble m_kernelLength;
+
+            /**
+             * Step size relative to the mean edge length.
+             */
+            core::ParamDouble m_stepSize;
+
+            /**
+             * Minimum number of samples per vertex before it is skipped as seed.
+             */
+            core::ParamInt m_minHits;
+
+            /**
+             * The tracer. Kept as long as the mesh does not change.
+             */
+            SPtr< di::core::MeshStreamlineTracer > m_tracer = nullptr;
+        };
+    }
+}
+
+#endif  // DI_MESHLIC_H
+
@@ -0,0 +1,377 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/core/data/Lines.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/MathTypes.h>
+
+#include "RegionBoundaries.h"
+
+#include <di/core/Logger.h>
+#define LogTag "algorithms/RegionBoundaries"
+
+/**
+ * Number of triangles handled by one task. The tiles are fixed, so the result does not depend on the number of threads.
+ */
+static const size_t g_tileSize = 4096;
+
+/**
+ * Marks keys of boundary vertices in the center of a triangle. The other keys are edges, made of two vertex indices of up to 31 bits each.
+ */
+static const uint64_t g_triangleKeyFlag = static_cast< uint64_t >( 1 ) << 63;
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * A boundary segment inside a triangle. The ends are identified by keys, so the segments of neighbouring triangles connect exactly.
+         */
+        struct BoundarySegment
+        {
+            /**
+             * Key of the first end.
+             */
+            uint64_t m_start = 0;
+
+            /**
+             * Key of the second end.
+             */
+            uint64_t m_end = 0;
+        };
+
+        /**
+         * Get the key of the boundary vertex on an edge.
+         *
+         * \param vertex1 the first vertex of the edge
+         * \param vertex2 the second vertex of the edge
+         *
+         * \return the key. The same for both directions of the edge.
+         */
+        static uint64_t getEdgeKey( int vertex1, int vertex2 )
+        {
+            return ( static_cast< uint64_t >( std::min( vertex1, vertex2 ) ) << 32 ) | static_cast< uint64_t >( std::max( vertex1, vertex2 ) );
+        }
+
+        /**
+         * Get the position of the boundary vertex with the given key.
+         *
+         * \param key the key
+         * \param mesh the mesh
+         *
+         * \return the edge midpoint or triangle center
+         */
+        static glm::vec3 getKeyPosition( uint64_t key, const di::core::TriangleMesh& mesh )
+        {
+            const auto& vertices = mesh.getVertices();
+            if( key & g_triangleKeyFlag )
+            {
+                const auto& triangle = mesh.getTriangles()[ key & ~g_triangleKeyFlag ];
+                return ( vertices[ triangle.x ] + vertices[ triangle.y ] + vertices[ triangle.z ] ) / 3.0f;
+            }
+            return 0.5f * ( vertices[ key >> 32 ] + vertices[ key & 0xFFFFFFFF ] );
+        }
+
+        RegionBoundaries::RegionBoundaries():
+            Algorithm( "Region Boundaries",
+                       "Extract the boundaries between labeled regions as lines and the adjacency of the regions." )
+        {
+            // 1: the outputs
+            m_boundariesOutput = addOutput< di::core::LineDataSet >(
+                    "Boundaries",
+                    "The region boundaries as polylines on the surface."
+            );
+
+            m_adjacencyOutput = addOutput< RegionAdjacencyDataSet >(
+                    "Region Adjacency",
+                    "The neighbours of each region and the lengths of their shared boundaries."
+            );
+
+            // 2: the inputs
+            m_meshInput = addInput< di::core::TriangleDataSet >(
+                    "Triangle Mesh",
+                    "The triangle mesh."
+            );
+
+            m_labelInput = addInput< di::io::RegionLabelReader::DataSetType >(
+                    "Labels",
+                    "Labels to assign a region to each mesh vertex."
+            );
+
+            m_lineColor = addParameter< di::Color >(
+                    "Line Color",
+                    "The color of the boundary lines.",
+                    di::Color( 0.0, 0.0, 0.0, 1.0 )
+            );
+        }
+
+        RegionBoundaries::~RegionBoundaries()
+        {
+            // nothing to clean up so far
+        }
+
+        void RegionBoundaries::process()
+        {
+            auto meshDataSet = m_meshInput->getData();
+            auto labelDataSet = m_labelInput->getData();
+            if( !meshDataSet || !labelDataSet )
+            {
+                return;
+            }
+
+            auto mesh = meshDataSet->getGrid();
+            auto labels = labelDataSet->getAttributes< 0 >();
+            if( labels->size() != mesh->getNumVertices() )
+            {
+                LogE << "Number of labels needs to match the number of vertices in the triangle mesh." << LogEnd;
+                return;
+            }
+
+            const auto& vertices = mesh->getVertices();
+            const auto& triangles = mesh->getTriangles();
+
+            // Regions are numbered by ascending label.
+            std::vector< double > regionLabels( labels->begin(), labels->end() );
+            std::sort( regionLabels.begin(), regionLabels.end() );
+            regionLabels.erase( std::unique( regionLabels.begin(), regionLabels.end() ), regionLabels.end() );
+
+            std::vector< uint32_t > regions( vertices.size() );
+            di::core::parallelFor( vertices.size(),
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t vertexID = begin; vertexID < end; ++vertexID )
+                    {
+                        regions[ vertexID ] = static_cast< uint32_t >(
+                            std::lower_bound( regionLabels.begin(), regionLabels.end(), ( *labels )[ vertexID ] ) - regionLabels.begin() );
+                    }
+                }
+            );
+
+            // One pass over the triangles collects the segments and the boundary lengths between each pair of regions.
+            size_t numTiles = ( triangles.size() + g_tileSize - 1 ) / g_tileSize;
+            std::vector< std::vector< BoundarySegment > > tileSegments( numTiles );
+            std::vector< std::map< std::pair< uint32_t, uint32_t >, double > > tileLengths( numTiles );
+            di::core::parallelFor( numTiles,
+                [ & ]( size_t beginTile, size_t endTile )
+                {
+                    for( size_t tile = beginTile; tile < endTile; ++tile )
+                    {
+                        auto& segments = tileSegments[ tile ];
+                        auto& lengths = tileLengths[ tile ];
+                        auto addSegment = [ & ]( uint64_t start, uint64_t end, uint32_t region1, uint32_t region2 )
+                        {
+                            BoundarySegment segment;
+                            segment.m_start = start;
+                            segment.m_end = end;
+                            segments.push_back( segment );
+                            lengths[ std::make_pair( std::min( region1, region2 ), std::max( region1, region2 ) ) ] +=
+                                glm::distance( getKeyPosition( start, *mesh ), getKeyPosition( end, *mesh ) );
+                        };
+
+                        size_t end = std::min( ( tile + 1 ) * g_tileSize, triangles.size() );
+                        for( size_t triangleID = tile * g_tileSize; triangleID < end; ++triangleID )
+                        {
+                            const auto& triangle = triangles[ triangleID ];
+                            auto region = glm::uvec3( regions[ triangle.x ], regions[ triangle.y ], regions[ triangle.z ] );
+                            if( ( region.x == region.y ) && ( region.y == region.z ) )
+                            {
+                                continue;
+                            }
+
+                            if( ( region.x != region.y ) && ( region.y != region.z ) && ( region.x != region.z ) )
+                            {
+                                // Three regions meet in the center.
+                                for( int i = 0; i < 3; ++i )
+                                {
+                                    int j = ( i + 1 ) % 3;
+                                    addSegment( getEdgeKey( triangle[ i ], triangle[ j ] ), g_triangleKeyFlag | triangleID,
+                                                region[ i ], region[ j ] );
+                                }
+                            }
+                            else
+                            {
+                                // The vertex with the other label is cut off.
+                                int k = ( region.y == region.z ) ? 0 : ( ( region.x == region.z ) ? 1 : 2 );
+                                int i = ( k + 1 ) % 3;
+                                int j = ( k + 2 ) % 3;
+                                addSegment( getEdgeKey( triangle[ k ], triangle[ i ] ), getEdgeKey( triangle[ k ], triangle[ j ] ),
+                                            region[ k ], region[ i ] );
+                            }
+                        }
+                    }
+                },
+                1
+            );
+
+            // Number the boundary vertices.
+            std::vector< BoundarySegment > segments;
+            std::vector< di::core::RegionAdjacency::Edge > edges;
+            for( size_t tile = 0; tile < numTiles; ++tile )
+            {
+                segments.insert( segments.end(), tileSegments[ tile ].begin(), tileSegments[ tile ].end() );
+                for( const auto& length : tileLengths[ tile ] )
+                {
+                    edges.push_back( std::make_tuple( length.first.first, length.first.second, length.second ) );
+                }
+            }
+            tileSegments.clear();
+
+            std::vector< uint64_t > keys;
+            keys.reserve( 2 * segments.size() );
+            for( const auto& segment : segments )
+            {
+                keys.push_back( segment.m_start );
+                keys.push_back( segment.m_end );
+            }
+            std::sort( keys.begin(), keys.end() );
+            keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+
+            IndexVec2Array segmentVertices( segments.size() );
+            di::core::parallelFor( segments.size(),
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t segmentID = begin; segmentID < end; ++segmentID )
+                    {
+                        segmentVertices[ segmentID ] = glm::ivec2(
+                            std::lower_bound( keys.begin(), keys.end(), segments[ segmentID ].m_start ) - keys.begin(),
+                            std::lower_bound( keys.begin(), keys.end(), segments[ segmentID ].m_end ) - keys.begin() );
+                    }
+                }
+            );
+
+            // The segments of each boundary vertex.
+            std::vector< size_t > offsets( keys.size() + 1, 0 );
+            for( const auto& segment : segmentVertices )
+            {
+                ++offsets[ segment.x + 1 ];
+                ++offsets[ segment.y + 1 ];
+            }
+            for( size_t key = 0; key < keys.size(); ++key )
+            {
+                offsets[ key + 1 ] += offsets[ key ];
+            }
+            std::vector< size_t > incident( offsets.back() );
+            std::vector< size_t > next( offsets.begin(), offsets.end() - 1 );
+            for( size_t segmentID = 0; segmentID < segmentVertices.size(); ++segmentID )
+            {
+                incident[ next[ segmentVertices[ segmentID ].x ]++ ] = segmentID;
+                incident[ next[ segmentVertices[ segmentID ].y ]++ ] = segmentID;
+            }
+
+            // Chain the segments to polylines. Open polylines start at vertices not shared by exactly two segments. The rest are loops.
+            auto color = m_lineColor->get();
+            Vec3Array lineVertices;
+            IndexVec2Array lineIndices;
+            auto colors = std::make_shared< RGBAArray >();
+            std::vector< int > vertexIndices( keys.size(), -1 );
+            std::vector< char > used( segments.size(), 0 );
+            size_t numPolylines = 0;
+
+            auto getVertexIndex = [ & ]( size_t key )
+            {
+                if( vertexIndices[ key ] < 0 )
+                {
+                    vertexIndices[ key ] = static_cast< int >( lineVertices.size() );
+                    lineVertices.push_back( getKeyPosition( keys[ key ], *mesh ) );
+                    colors->push_back( color );
+                }
+                return vertexIndices[ key ];
+            };
+
+            auto walk = [ & ]( size_t key, size_t segmentID )
+            {
+                ++numPolylines;
+                while( !used[ segmentID ] )
+                {
+                    used[ segmentID ] = 1;
+                    const auto& segment = segmentVertices[ segmentID ];
+                    size_t other = ( static_cast< size_t >( segment.x ) == key ) ? segment.y : segment.x;
+                    lineIndices.push_back( glm::ivec2( getVertexIndex( key ), getVertexIndex( other ) ) );
+
+                    key = other;
+                    if( offsets[ key + 1 ] - offsets[ key ] != 2 )
+                    {
+                        break;
+                    }
+                    segmentID = ( incident[ offsets[ key ] ] == segmentID ) ? incident[ offsets[ key ] + 1 ] : incident[ offsets[ key ] ];
+                }
+            };
+
+            for( size_t key = 0; key < keys.size(); ++key )
+            {
+                if( offsets[ key + 1 ] - offsets[ key ] == 2 )
+                {
+                    continue;
+                }
+                for( size_t i = offsets[ key ]; i < offsets[ key + 1 ]; ++i )
+                {
+                    if( !used[ incident[ i ] ] )
+                    {
+                        walk( key, incident[ i ] );
+                    }
+                }
+            }
+            for( size_t segmentID = 0; segmentID < segments.size(); ++segmentID )
+            {
+                if( !used[ segmentID ] )
+                {
+                    walk( segmentVertices[ segmentID ].x, segmentID );
+                }
+            }
+
+            // The center of each region.
+            Vec3Array centers( regionLabels.size(), glm::vec3( 0.0f ) );
+            std::vector< size_t > counts( regionLabels.size(), 0 );
+            for( size_t vertexID = 0; vertexID < vertices.size(); ++vertexID )
+            {
+                centers[ regions[ vertexID ] ] += vertices[ vertexID ];
+                ++counts[ regions[ vertexID ] ];
+            }
+            for( size_t region = 0; region < centers.size(); ++region )
+            {
+                centers[ region ] /= static_cast< float >( std::max( counts[ region ], static_cast< size_t >( 1 ) ) );
+            }
+
+            auto adjacency = std::make_shared< di::core::RegionAdjacency >( regionLabels, std::move( edges ) );
+            LogD << "Extracted " << numPolylines << " boundary lines with " << lineIndices.size() << " segments between "
+                 << adjacency->getNumRegions() << " regions with " << adjacency->getNumEdges() << " neighbourhoods." << LogEnd;
+
+            auto lines = std::make_shared< di::core::Lines >();
+            lines->setVertices( std::move( lineVertices ) );
+            lines->setLines( std::move( lineIndices ) );
+            m_boundariesOutput->setData( std::make_shared< di::core::LineDataSet >( "Region Boundaries", lines, colors ) );
+
+            auto points = std::make_shared< di::core::Points >();
+            points->setVertices( std::move( centers ) );
+            m_adjacencyOutput->setData( std::make_shared< RegionAdjacencyDataSet >( "Region Adjacency", points, adjacency ) );
+        }
+    }
+}
@@ -0,0 +1,102 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_REGIONBOUNDARIES_H
+#define DI_REGIONBOUNDARIES_H
+
+#include <di/core/Algorithm.h>
+#include <di/core/ParameterTypes.h>
+#include <di/core/data/DataSetTypes.h>
+#include <di/core/data/LineDataSet.h>
+#include <di/core/data/Points.h>
+#include <di/core/data/RegionAdjacency.h>
+#include <di/io/RegionLabelReader.h>
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * Extract the boundaries between labeled regions of a triangle mesh as connected polylines, and the region adjacency graph. The labels
+         * are given per vertex, so the boundaries cross the mesh edges between differently labeled vertices. Triangles with two labels get a
+         * segment between the midpoints of the two crossed edges, triangles with three labels get three segments meeting in the center. The
+         * segments are chained to polylines, which end at junctions of three regions and at the mesh border.
+         *
+         * The segments and the shared boundary lengths of the regions are collected in a single parallel pass over the triangles.
+         */
+        class RegionBoundaries: public di::core::Algorithm
+        {
+        public:
+            /**
+             * The region adjacency graph. The points are the centers of the regions, in the same order as the regions of the graph.
+             */
+            typedef di::core::DataSet< core::Points, core::RegionAdjacency > RegionAdjacencyDataSet;
+
+            /**
+             * Constructor. Initialize all inputs, outputs and parameters.
+             */
+            RegionBoundaries();
+
+            /**
+             * Destructor. Clean up if needed.
+             */
+            virtual ~RegionBoundaries();
+
+            /**
+             * Extract the boundaries and the adjacency of the labeled regions.
+             */
+            virtual void process();
+
+        protected:
+        private:
+            /**
+             * The triangle mesh.
+             */
+            SPtr< di::core::Connector< di::core::TriangleDataSet > > m_meshInput;
+
+            /**
+             * The per-vertex labels.
+             */
+            SPtr< di::core::Connector< di::io::RegionLabelReader::DataSetType > > m_labelInput;
+
+            /**
+             * The boundary lines.
+             */
+            SPtr< di::core::Connector< di::core::LineDataSet > > m_boundariesOutput;
+
+            /**
+             * The region adjacency graph.
+             */
+            SPtr< di::core::Connector< RegionAdjacencyDataSet > > m_adjacencyOutput;
+
+            /**
+             * Line color.
+             */
+            core::ParamColor m_lineColor;
+        };
+    }
+}
+
+#endif  // DI_REGIONBOUNDARIES_H
+
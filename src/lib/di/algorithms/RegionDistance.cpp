@@ -0,0 +1,143 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <vector>
+
+#include <di/core/data/GeodesicDistance.h>
+#include <di/core/data/TriangleMesh.h>
+
+#include "RegionDistance.h"
+
+#include <di/core/Logger.h>
+#define LogTag "algorithms/RegionDistance"
+
+namespace di
+{
+    namespace algorithms
+    {
+        RegionDistance::RegionDistance():
+            Algorithm( "Region Distance",
+                       "Compute the geodesic distance of each vertex to the region borders or to a region." )
+        {
+            // 1: the output
+            m_distanceOutput = addOutput< di::core::TriangleScalarField >(
+                    "Distance",
+                    "The geodesic distance of each vertex."
+            );
+
+            // 2: the inputs
+            m_meshInput = addInput< di::core::TriangleDataSet >(
+                    "Triangle Mesh",
+                    "The triangle mesh."
+            );
+
+            m_labelInput = addInput< di::io::RegionLabelReader::DataSetType >(
+                    "Labels",
+                    "Labels to assign a region to each mesh vertex."
+            );
+
+            m_sourceLabel = addParameter< int >(
+                    "Source Label",
+                    "The label of the region to measure the distance to. Use -1 to measure the distance to the closest region border.",
+                    -1
+            );
+        }
+
+        RegionDistance::~RegionDistance()
+        {
+            // nothing to clean up so far
+        }
+
+        void RegionDistance::process()
+        {
+            auto meshDataSet = m_meshInput->getData();
+            auto labelDataSet = m_labelInput->getData();
+            if( !meshDataSet || !labelDataSet )
+            {
+                return;
+            }
+
+            auto mesh = meshDataSet->getGrid();
+            auto labels = labelDataSet->getAttributes< 0 >();
+            if( labels->size() != mesh->getNumVertices() )
+            {
+                LogE << "Number of labels needs to match the number of vertices in the triangle mesh." << LogEnd;
+                return;
+            }
+
+            // Sources are the vertices of the chosen region or the vertices at edges between differently labeled vertices.
+            std::vector< char > isSource( mesh->getNumVertices(), 0 );
+            if( m_sourceLabel->get() < 0 )
+            {
+                for( const auto& triangle : mesh->getTriangles() )
+                {
+                    for( int i = 0; i < 3; ++i )
+                    {
+                        int j = ( i + 1 ) % 3;
+                        if( ( *labels )[ triangle[ i ] ] != ( *labels )[ triangle[ j ] ] )
+                        {
+                            isSource[ triangle[ i ] ] = 1;
+                            isSource[ triangle[ j ] ] = 1;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                auto label = static_cast< double >( m_sourceLabel->get() );
+                for( size_t vertexID = 0; vertexID < labels->size(); ++vertexID )
+                {
+                    isSource[ vertexID ] = ( ( *labels )[ vertexID ] == label );
+                }
+            }
+
+            std::vector< size_t > sources;
+            for( size_t vertexID = 0; vertexID < isSource.size(); ++vertexID )
+            {
+                if( isSource[ vertexID ] )
+                {
+                    sources.push_back( vertexID );
+                }
+            }
+            if( sources.empty() )
+            {
+                LogE << "No source vertices found. Check the source label." << LogEnd;
+                return;
+            }
+
+            // The operators only depend on the mesh. The dataset keeps them for the next run.
+            auto geodesics = meshDataSet->getDerivedData< di::core::GeodesicDistance >(
+                [ & ]()
+                {
+                    LogD << "Factorizing the geodesic distance operators of " << mesh->getNumVertices() << " vertices." << LogEnd;
+                    return std::make_shared< di::core::GeodesicDistance >( mesh );
+                }
+            );
+
+            auto distances = std::make_shared< std::vector< double > >( geodesics->compute( sources ) );
+            LogD << "Computed the distance to " << sources.size() << " source vertices." << LogEnd;
+            m_distanceOutput->setData( std::make_shared< di::core::TriangleScalarField >( "Region Distance", mesh, distances ) );
+        }
+    }
+}
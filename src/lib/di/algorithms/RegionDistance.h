@@ -0,0 +1,85 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_REGIONDISTANCE_H
+#define DI_REGIONDISTANCE_H
+
+#include <di/core/Algorithm.h>
+#include <di/core/ParameterTypes.h>
+#include <di/core/data/DataSetTypes.h>
+#include <di/io/RegionLabelReader.h>
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * Compute the geodesic distance of each vertex to the region borders or to a given region, using \ref di::core::GeodesicDistance.
+         * The factorized operators are cached on the mesh dataset, so changing the source region only costs a few triangular solves.
+         */
+        class RegionDistance: public di::core::Algorithm
+        {
+        public:
+            /**
+             * Constructor. Initialize all inputs, outputs and parameters.
+             */
+            RegionDistance();
+
+            /**
+             * Destructor. Clean up if needed.
+             */
+            virtual ~RegionDistance();
+
+            /**
+             * Compute the distances.
+             */
+            virtual void process();
+
+        protected:
+        private:
+            /**
+             * The triangle mesh.
+             */
+            SPtr< di::core::Connector< di::core::TriangleDataSet > > m_meshInput;
+
+            /**
+             * The per-vertex labels.
+             */
+            SPtr< di::core::Connector< di::io::RegionLabelReader::DataSetType > > m_labelInput;
+
+            /**
+             * The distance of each vertex.
+             */
+            SPtr< di::core::Connector< di::core::TriangleScalarField > > m_distanceOutput;
+
+            /**
+             * The label of the region to measure the distance to. Negative for the region borders.
+             */
+            core::ParamInt m_sourceLabel;
+        };
+    }
+}
+
+#endif  // DI_REGIONDISTANCE_H
+
@@ -22,22 +22,43 @@
 //
 //---------------------------------------------------------------------------------------
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <random>
 
 #include <di/core/data/TriangleDataSet.h>
 #include <di/core/data/Points.h>
+#include <di/core/data/PoissonDiskSamples.h>
+#include <di/core/data/PrincipalCurvatures.h>
 #include <di/core/Filesystem.h>
 
 #include <di/gfx/GL.h>
 #include <di/gfx/GLError.h>
+#include <di/gfx/GPUTimer.h>
+#include <di/gfx/NoiseTextureCache.h>
+#include <di/gfx/RenderTargetPool.h>
 
 #include "RenderIllustrativeLines.h"
 
 #include <di/core/Logger.h>
 #define LogTag "algorithms/RenderIllustrativeLines"
 
+/**
+ * Radius of the coarsest level of arrow seeds on the surface, relative to the diagonal of the mesh bounding box.
+ */
+static const double g_arrowSeedRadius = 1.0 / 8.0;
+
+/**
+ * Number of levels of arrow seeds on the surface. Each level doubles the number of arrows.
+ */
+static const size_t g_arrowSeedLevels = 11;
+
+/**
+ * Poisson disk samples with radius r are about as dense as a regular grid with spacing r / 0.73.
+ */
+static const double g_arrowSeedGridRatio = 0.73;
+
 namespace di
 {
     namespace algorithms
@@ -128,19 +149,27 @@ namespace di
 
             m_jitterArrows = addParameter< bool >(
                     "Arrows: Jitter",
-                    "Activate to move the center of each arrow around on a random basis. This can help to avoid grid-like arrows artifacts.",
+                    "Activate to move the center of each arrow around on a random basis. This can help to avoid grid-like arrows artifacts. "
+                    "Only used if the arrows are not fixed on the surface.",
                     false
             );
 
+            m_surfaceArrows = addParameter< bool >(
+                    "Arrows: Fixed on Surface",
+                    "Activate to place the arrows on the surface instead of the screen. They stay in place when the camera moves. The amount "
+                    "is approximated by choosing from several densities.",
+                    true
+            );
+
             m_curvatureArrows = addParameter< bool >(
                     "Arrows: Curved",
-                    "Activate to have the arrows follow the surface curvature.",
+                    "Activate to bend the arrows along the curvature of the surface in arrow direction.",
                     false
             );
 
             m_curvatureArrowsSampleDensity = addParameter< int >(
                     "Arrows: Curvature Sampling",
-                    "Change to increase or decrease the amount of samples on the surface. More means less performance but improved visuals.",
+                    "The number of segments of curved arrows. More means less performance but smoother arrows on strongly curved surfaces.",
                     16
             );
 
@@ -225,9 +254,38 @@ namespace di
             m_visTriangleVectorData = vectors;
             m_visTriangleLabelData = labels;
 
-            // Convert labels to ints
-            m_visTriangleLabelDataUInt32 = std::make_shared< std::vector< uint32_t > >( m_visTriangleLabelData->getAttributes()->begin(),
-                                                                                        m_visTriangleLabelData->getAttributes()->end() );
+            // Build the coarse meshes for interaction in the background.
+            m_meshLOD.setMesh( data->getGrid(),
+                [ this ]()
+                {
+                    renderRequest();
+                }
+            );
+
+            // Convert labels to ints. The dataset caches the converted labels, so this only converts once per label dataset.
+            m_visTriangleLabelDataUInt32 = labels ? labels->getAttributesAs< uint32_t >() : nullptr;
+
+            // Arrow seeds on the surface. The dataset keeps them, so they are only computed once per mesh.
+            auto mesh = data->getGrid();
+            m_visArrowSeeds = data->getDerivedData< di::core::PoissonDiskSamples >(
+                [ & ]()
+                {
+                    auto diagonal = glm::length( mesh->getBoundingBox().getSize() );
+                    return std::make_shared< di::core::PoissonDiskSamples >( *mesh, g_arrowSeedRadius * diagonal, g_arrowSeedLevels );
+                }
+            );
+
+            // The curvature tensors replace walking the surface in screen space for curved arrows. Also computed once per mesh.
+            m_visCurvatures = nullptr;
+            if( mesh->getNumNormals() == mesh->getNumVertices() )
+            {
+                m_visCurvatures = data->getDerivedData< di::core::PrincipalCurvatures >(
+                    [ & ]()
+                    {
+                        return std::make_shared< di::core::PrincipalCurvatures >( *mesh );
+                    }
+                );
+            }
 
             // Update normalization length:
             if( vectors )
@@ -260,6 +318,34 @@ namespace di
             }
         }
 
+        size_t RenderIllustrativeLines::selectArrowSeeds( const core::View& view, float& tolerance ) const
+        {
+            tolerance = 0.0f;
+            if( m_numArrows->get() <= 0 )
+            {
+                return 0;
+            }
+
+            // Size of a world unit in pixels. The projection is orthographic and the view matrix scales uniformly.
+            const auto& camera = view.getCamera();
+            auto viewScale = glm::length( glm::vec3( camera.getViewMatrix()[ 0 ] ) );
+            auto pixelsPerUnit = viewScale * camera.getProjectionMatrix()[ 0 ][ 0 ] * 0.5 * view.getViewportSize().x;
+
+            // Use the finest level that is not denser than the requested amount of arrows per image side.
+            auto imageSize = view.getImageSize();
+            double spacing = std::min( imageSize.x, imageSize.y ) / static_cast< double >( m_numArrows->get() );
+            size_t level = 0;
+            while( ( level + 1 < m_visArrowSeeds->getNumLevels() ) &&
+                   ( m_visArrowSeeds->getRadius( level + 1 ) * pixelsPerUnit >= g_arrowSeedGridRatio * spacing ) )
+            {
+                ++level;
+            }
+
+            // Seeds further away from the visible surface than the radius are hidden.
+            tolerance = static_cast< float >( m_visArrowSeeds->getRadius( level ) * viewScale );
+            return m_visArrowSeeds->getNumSamples( level );
+        }
+
         void RenderIllustrativeLines::prepare()
         {
             LogD << "Vis Prepare" << LogEnd;
@@ -283,6 +369,11 @@ namespace di
                                                               core::readTextFile( localShaderPath + "Shading.glsl" ) )
                         }
             ) );
+            // Define the out vars to bind to the attachments
+            m_transformShaderProgram->bindFragDataLocation( 0, "fragColor" );
+            m_transformShaderProgram->bindFragDataLocation( 1, "fragVec" );
+            m_transformShaderProgram->bindFragDataLocation( 2, "fragNormal" );
+            m_transformShaderProgram->bindFragDataLocation( 3, "fragPos" );
             m_transformShaderProgram->realize();
 
             auto arrowVertex = std::make_shared< core::Shader >( core::Shader::ShaderType::Vertex,
@@ -304,6 +395,7 @@ namespace di
                             std::make_shared< core::Shader >( core::Shader::ShaderType::Fragment,
                                                               core::readTextFile( localShaderPath + "Shading.glsl" ) )                        }
             ) );
+            m_arrowShaderProgram->bindFragDataLocation( 0, "fragColor" );
             m_arrowShaderProgram->realize();
 
             auto composeVertex = std::make_shared< core::Shader >( core::Shader::ShaderType::Vertex,
@@ -324,6 +416,8 @@ namespace di
                                                               core::readTextFile( localShaderPath + "LineAO.glsl" ) )
                         }
             ) );
+            m_composeShaderProgram->bindFragDataLocation( 0, "fragColor" );
+            m_composeShaderProgram->bindFragDataLocation( 1, "fragAO" );
             m_composeShaderProgram->realize();
 
             auto finalVertex = std::make_shared< core::Shader >( core::Shader::ShaderType::Vertex,
@@ -356,8 +450,13 @@ namespace di
                 return;
             }
 
+            // Borrow the render targets for this frame.
+            m_fboResolution = di::core::Texture::powerOfTwoResolution( view.getViewportSize() );
+            acquireRenderTargets();
+
             ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 1 - Draw Color and Noise on geometry to textures:
+            di::core::GPUTimer passTimer( "Illustrative Lines: Transform" );
 
             // Bind it to be able to modify and configure:
             glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboTransform );
@@ -389,51 +488,73 @@ namespace di
 
             glBindVertexArray( m_VAO );
 
-            // We need random numbers for the arrows
-
-            auto widthOfArrowArea = 1.0f / static_cast< float >( m_numArrows->get() );
+            size_t numArrowSeeds = 0;
+            float arrowSeedTolerance = 0.0f;
+            if( m_surfaceArrows->get() && m_visArrowSeeds )
+            {
+                // The seeds only change with the mesh.
+                if( m_uploadedArrowSeeds != m_visArrowSeeds )
+                {
+                    m_pointBuffer->bind();
+                    m_pointBuffer->data( m_visArrowSeeds->getPositions() );
+                    logGLError();
+                    m_uploadedArrowSeeds = m_visArrowSeeds;
+                    m_points = nullptr;
+                }
+                numArrowSeeds = selectArrowSeeds( view, arrowSeedTolerance );
+            }
+            else
+            {
+                // We need random numbers for the arrows
 
-            std::default_random_engine generator;
-            std::uniform_real_distribution< float > distribution( -1.0f * widthOfArrowArea, 1.0f * widthOfArrowArea  );
-            auto dice = std::bind( distribution, generator );
+                auto widthOfArrowArea = 1.0f / static_cast< float >( m_numArrows->get() );
 
-            // Need to update points?
-            unsigned int desiredArrows = m_numArrows->get() * m_numArrows->get();
-            if( !m_points || ( desiredArrows != m_points->getNumVertices() ) )
-            {
-                // create regular grid of points
-                m_points = std::make_shared< di::core::Points >();
+                std::default_random_engine generator;
+                std::uniform_real_distribution< float > distribution( -1.0f * widthOfArrowArea, 1.0f * widthOfArrowArea  );
+                auto dice = std::bind( distribution, generator );
 
-                const size_t xSize = m_numArrows->get();
-                const size_t ySize = m_numArrows->get();
-                for( size_t y = 0; y <= ySize; ++y )
+                // Need to update points?
+                unsigned int desiredArrows = ( m_numArrows->get() + 1 ) * ( m_numArrows->get() + 1 );
+                if( !m_points || ( desiredArrows != m_points->getNumVertices() ) )
                 {
-                    for( size_t x = 0; x <= xSize; ++x )
+                    // create regular grid of points
+                    m_points = std::make_shared< di::core::Points >();
+
+                    const size_t xSize = m_numArrows->get();
+                    const size_t ySize = m_numArrows->get();
+                    for( size_t y = 0; y <= ySize; ++y )
                     {
-                        auto jitterX = 0.0f;
-                        auto jitterY = 0.0f;
-                        if( m_jitterArrows->get() )
+                        for( size_t x = 0; x <= xSize; ++x )
                         {
-                            jitterX = 0.25f * dice();
-                            jitterY = 0.25f * dice();
+                            auto jitterX = 0.0f;
+                            auto jitterY = 0.0f;
+                            if( m_jitterArrows->get() )
+                            {
+                                jitterX = 0.25f * dice();
+                                jitterY = 0.25f * dice();
+                            }
+
+                            m_points->addVertex( jitterX + static_cast< float >( x ) / static_cast< float >( xSize ),
+                                                 jitterY + static_cast< float >( y ) / static_cast< float >( ySize ),
+                                                 0.0
+                                               );
                         }
-
-                        m_points->addVertex( jitterX + static_cast< float >( x ) / static_cast< float >( xSize ),
-                                             jitterY + static_cast< float >( y ) / static_cast< float >( ySize ),
-                                             0.0
-                                           );
                     }
+                    m_pointBuffer->bind();
+                    m_pointBuffer->data( m_points->getVertices() );
+                    logGLError();
+                    m_uploadedArrowSeeds = nullptr;
                 }
-                m_vertexBuffer->bind();
-                m_vertexBuffer->data( m_points->getVertices() );
-                logGLError();
+                numArrowSeeds = m_points->getNumVertices();
             }
 
-            glDrawElements( GL_TRIANGLES, m_visTriangleData->getGrid()->getTriangles().size() * 3, GL_UNSIGNED_INT, NULL );
+            auto numTriangles = m_meshLOD.bind( view, m_indexBuffer, m_visTriangleData->getGrid()->getNumTriangles() );
+            glDrawElements( GL_TRIANGLES, numTriangles * 3, GL_UNSIGNED_INT, NULL );
             logGLError();
 
             ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 2 - Draw Arrows:
+            passTimer.next( "Illustrative Lines: Arrows" );
 
             // Bind it to be able to modify and configure:
             glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboArrow );
@@ -442,6 +563,7 @@ namespace di
             m_arrowShaderProgram->setDefine( "d_curvatureEnable", m_curvatureArrows->get() );
             m_arrowShaderProgram->setDefine( "d_curvatureNumSegments", m_curvatureArrowsSampleDensity->get() );
             m_arrowShaderProgram->setDefine( "d_curvatureNumVerts", 2 * m_curvatureArrowsSampleDensity->get() );
+            m_arrowShaderProgram->setDefine( "d_surfaceSeeds", m_surfaceArrows->get() && m_visArrowSeeds );
 
             m_arrowShaderProgram->bind();
             m_arrowShaderProgram->setUniform( "u_ProjectionMatrix", view.getCamera().getProjectionMatrix() );
@@ -449,6 +571,21 @@ namespace di
             // m_arrowShaderProgram->setUniform( "u_viewportSize", view.getViewportSize() );
             m_arrowShaderProgram->setUniform( "u_viewportScale", ( view.getViewportSize() - glm::vec2( 1.0 ) ) / glm::vec2( m_fboResolution.x,
                                                                                                                             m_fboResolution.y ) );
+            // The arrow grid covers the whole image. If we only render a tile of it, only the seeds inside the tile are used. Seeds on the
+            // surface are projected to the viewport directly.
+            auto seedViewportSize = view.getViewportSize() - glm::vec2( 1.0 );
+            if( m_surfaceArrows->get() && m_visArrowSeeds )
+            {
+                m_arrowShaderProgram->setUniform( "u_seedScale", glm::vec2( 1.0 ) );
+                m_arrowShaderProgram->setUniform( "u_seedOffset", glm::vec2( 0.0 ) );
+                m_arrowShaderProgram->setUniform( "u_seedTolerance", arrowSeedTolerance );
+                m_arrowShaderProgram->setUniform( "u_ViewMatrix", view.getCamera().getViewMatrix() );
+            }
+            else
+            {
+                m_arrowShaderProgram->setUniform( "u_seedScale", ( view.getImageSize() - glm::vec2( 1.0 ) ) / seedViewportSize );
+                m_arrowShaderProgram->setUniform( "u_seedOffset", -view.getImageOffset() / seedViewportSize );
+            }
             m_arrowShaderProgram->setUniform( "u_width", m_widthArrows->get() );
             m_arrowShaderProgram->setUniform( "u_widthTails", m_widthArrowTails->get() );
             m_arrowShaderProgram->setUniform( "u_height", m_lengthArrows->get() );
@@ -487,25 +624,37 @@ namespace di
             glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
             glBindVertexArray( m_pointVAO );
-            glDrawArrays( GL_POINTS, 0, m_points->getVertices().size() );
+            glDrawArrays( GL_POINTS, 0, numArrowSeeds );
             logGLError();
 
             ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 3 - Merge everything and output to the normal framebuffer:
             // Set the view to be the target.
+            passTimer.next( "Illustrative Lines: Compose" );
 
             // Bind it to be able to modify and configure:
             glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboCompose );
             logGLError();
 
-            // draw a big quad and compose
+            // draw a big quad and compose. The define selects a program variant, so set the samplers each frame.
+            m_composeShaderProgram->setDefine( "d_samples", view.isHQMode() ? 64 : 16 );
             m_composeShaderProgram->bind();
+            m_composeShaderProgram->setUniform( "u_meshColorSampler",  0 );
+            m_composeShaderProgram->setUniform( "u_arrowColorSampler", 1 );
+            m_composeShaderProgram->setUniform( "u_meshDepthSampler",  2 );
+            m_composeShaderProgram->setUniform( "u_arrowDepthSampler", 3 );
+            m_composeShaderProgram->setUniform( "u_meshNormalSampler",  4 );
+            m_composeShaderProgram->setUniform( "u_noiseSampler",  5 );
             // m_composeShaderProgram->setUniform( "u_ProjectionMatrix", view.getCamera().getProjectionMatrix() );
             m_composeShaderProgram->setUniform( "u_ViewMatrix",       view.getCamera().getViewMatrix() );
             // m_composeShaderProgram->setUniform( "u_viewportSize", view.getViewportSize() );
             m_composeShaderProgram->setUniform( "u_viewportScale", view.getViewportSize() / glm::vec2( m_fboResolution.x, m_fboResolution.y ) );
             m_composeShaderProgram->setUniform( "u_bbSize", getBoundingBox().getSize() );
             m_composeShaderProgram->setUniform( "u_enableSSAO", m_enableSSAO->get() );
+            m_composeShaderProgram->setUniform( "u_imageOffset", view.getImageOffset() );
+            // The AO radius is relative to the framebuffer size. Keep it relative to the framebuffer of the whole image.
+            auto imageResolution = di::core::Texture::powerOfTwoResolution( view.getImageSize() );
+            m_composeShaderProgram->setUniform( "u_imageFramebufferSize", glm::vec2( imageResolution ) );
 
             // Textures
             glActiveTexture( GL_TEXTURE0 );
@@ -544,6 +693,7 @@ namespace di
 
             ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 4 -
+            passTimer.next( "Illustrative Lines: Final" );
 
             view.bind();
             glEnable( GL_BLEND );
@@ -573,23 +723,13 @@ namespace di
             glBindVertexArray( m_screenQuadVAO );
             glDrawArrays( GL_TRIANGLES, 0, 6 ); // 3 indices starting at 0 -> 1 triangle
             logGLError();
+            passTimer.stop();
+
+            releaseRenderTargets();
         }
 
-        void RenderIllustrativeLines::update( const core::View& view, bool reload )
+        void RenderIllustrativeLines::update( const core::View& /* view */, bool reload )
         {
-            // Force update if resolution mismatch
-            auto resolution = di::core::Texture::powerOfTwoResolution( view.getViewportSize() );
-            if( m_fboResolution != resolution )
-            {
-                LogD << "Framebuffer resolution not optimal:" <<
-                        " View: " <<  view.getViewportSize().x << "x" <<  view.getViewportSize().y <<
-                        ", Current FBO: " << m_fboResolution.x << "x" << m_fboResolution.y <<
-                        ", New FBO: " << resolution.x << "x" << resolution.y << LogEnd;
-
-                reload = true;
-                m_fboResolution = resolution;
-            }
-
             if( !m_visTriangleData || !m_visTriangleVectorData || !m_visTriangleLabelData )
             {
                 return;
@@ -602,27 +742,116 @@ namespace di
             LogD << "Vis Update" << LogEnd;
             resetRenderingRequest();
 
-            prepare();
+            // Only rebuild what actually changed. Each domain implies all the ones depending on it. The render targets are not handled here,
+            // they are borrowed from the pool each frame.
+            // NOTE: prepare() alone creates the programs but not the resources of updatePrograms. The screen quad is created there only.
+            bool programs = reload || !m_transformShaderProgram || !m_screenQuadVAO;
+            bool geometry = programs || ( m_uploadedMesh != m_visTriangleData->getGrid() );
+            bool attributes = geometry || ( m_uploadedColors != m_visTriangleData->getAttributes() ) ||
+                                          ( m_uploadedVectors != m_visTriangleVectorData->getAttributes() ) ||
+                                          ( m_uploadedLabels != m_visTriangleLabelDataUInt32 );
 
-            // house-keeping
-            if( m_fboTransform )
+            if( programs )
             {
-                glDeleteFramebuffers( 1, &m_fboTransform );
+                updatePrograms();
             }
-            if( m_fboArrow )
+            if( geometry )
             {
-                glDeleteFramebuffers( 1, &m_fboArrow );
+                updateGeometry();
             }
-            if( m_fboCompose )
+            if( attributes )
             {
-                glDeleteFramebuffers( 1, &m_fboCompose );
+                updateAttributes();
             }
+            m_meshLOD.update( m_visTriangleData->getGrid() );
+        }
 
+        void RenderIllustrativeLines::updatePrograms()
+        {
+            prepare();
+
+            m_finalShaderProgram->bind();
+            m_finalShaderProgram->setUniform( "u_colorSampler",  0 );
+            m_finalShaderProgram->setUniform( "u_depthSampler", 1 );
+            m_finalShaderProgram->setUniform( "u_aoSampler",  2 );
+            logGLError();
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Create Vertex Array Object VAO and the corresponding Vertex Buffer Objects VBO for the arrow points
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+            LogD << "Updating Point VAO" << LogEnd;
+
+            m_arrowShaderProgram->bind();
+            logGLError();
+
+            // get the location of attribute "position" in program
+            GLint vertexPointLoc = m_arrowShaderProgram->getAttribLocation( "position" );
+            logGLError();
+
+            // Create the VAO and its buffer once.
+            if( !m_pointVAO )
+            {
+                glGenVertexArrays( 1, &m_pointVAO );
+                m_pointBuffer = std::make_shared< core::Buffer >();
+            }
+            glBindVertexArray( m_pointVAO );
+            logGLError();
+
+            // Set the location mapping of the shader using the VAO
+            m_pointBuffer->realize();
+            m_pointBuffer->bind();
+
+            // NOTE: filled during rendering
+
+            glEnableVertexAttribArray( vertexPointLoc );
+            glVertexAttribPointer( vertexPointLoc, 3, GL_FLOAT, 0, 0, 0 );
+            logGLError();
+
+            // We need noise. Use a fixed seed to get reproducible images.
+            m_whiteNoiseTex = core::NoiseTextureCache::getInstance().get( glm::ivec3( 128, 128, 1 ), 3 );
+
+            //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Create an VAO containing the full-screen quad
+            if( !m_screenQuadVAO )
+            {
+                LogD << "Creating flat VAO" << LogEnd;
+
+                // Create the full-screen quad.
+                float points[] = {
+                 -1.0f,  1.0f,  0.0f,
+                  1.0f,  1.0f,  0.0f,
+                  1.0f, -1.0f,  0.0f,
+
+                  1.0f, -1.0f,  0.0f,
+                 -1.0f, -1.0f,  0.0f,
+                 -1.0f,  1.0f,  0.0f
+                };
+
+                // Create Vertex Array Object
+                glGenVertexArrays( 1, &m_screenQuadVAO );
+                glBindVertexArray( m_screenQuadVAO );
+                logGLError();
+
+                m_screenQuadVertexBuffer = std::make_shared< core::Buffer >();
+                m_screenQuadVertexBuffer->realize();
+                m_screenQuadVertexBuffer->bind();
+                m_screenQuadVertexBuffer->data( 9 * 2 * sizeof( float ), points );
+                logGLError();
+
+                glEnableVertexAttribArray( 0 );
+                glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 0, nullptr );
+                logGLError();
+            }
+        }
+
+        void RenderIllustrativeLines::updateGeometry()
+        {
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Create Vertex Array Object VAO and the corresponding Vertex Buffer Objects VBO for the mesh itself
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-            LogD << "Creating Mesh VAO" << LogEnd;
+            LogD << "Updating Mesh VAO" << LogEnd;
 
             m_transformShaderProgram->bind();
             logGLError();
@@ -633,27 +862,33 @@ namespace di
             GLint normalLoc = m_transformShaderProgram->getAttribLocation( "normal" );
             GLint vectorsLoc = m_transformShaderProgram->getAttribLocation( "vectors" );
             GLint labelsLoc = m_transformShaderProgram->getAttribLocation( "label" );
+            GLint curvaturesLoc = m_transformShaderProgram->getAttribLocation( "curvatures" );
+            GLint curvatureDirectionLoc = m_transformShaderProgram->getAttribLocation( "curvatureDirection" );
 
             logGLError();
 
-            // Create the VAO
-            glGenVertexArrays( 1, &m_VAO );
+            // Create the VAO and buffers once. They are re-used for all later updates.
+            if( !m_VAO )
+            {
+                glGenVertexArrays( 1, &m_VAO );
+                m_vertexBuffer = std::make_shared< core::Buffer >();
+                m_normalBuffer = std::make_shared< core::Buffer >();
+                m_colorBuffer = std::make_shared< core::Buffer >();
+                m_vectorsBuffer = std::make_shared< core::Buffer >();
+                m_labelsBuffer = std::make_shared< core::Buffer >();
+                m_curvaturesBuffer = std::make_shared< core::Buffer >();
+                m_curvatureDirectionsBuffer = std::make_shared< core::Buffer >();
+                m_indexBuffer = std::make_shared< core::Buffer >( core::Buffer::BufferType::ElementArray );
+            }
             glBindVertexArray( m_VAO );
             logGLError();
 
-            // Create some buffers
-            m_vertexBuffer = std::make_shared< core::Buffer >();
-            m_normalBuffer = std::make_shared< core::Buffer >();
-            m_colorBuffer = std::make_shared< core::Buffer >();
-            m_vectorsBuffer = std::make_shared< core::Buffer >();
-            m_labelsBuffer = std::make_shared< core::Buffer >();
-            m_indexBuffer = std::make_shared< core::Buffer >( core::Buffer::BufferType::ElementArray );
-            logGLError();
+            auto mesh = m_visTriangleData->getGrid();
 
             // Set the data using the triangle mesh. Also set the location mapping of the shader using the VAO
             m_vertexBuffer->realize();
             m_vertexBuffer->bind();
-            m_vertexBuffer->data( m_visTriangleData->getGrid()->getVertices() );
+            m_vertexBuffer->data( mesh->getVertices() );
             logGLError();
 
             glEnableVertexAttribArray( vertexLoc );
@@ -662,126 +897,109 @@ namespace di
 
             m_colorBuffer->realize();
             m_colorBuffer->bind();
-            m_colorBuffer->data( m_visTriangleData->getAttributes() );
             glEnableVertexAttribArray( colorLoc );
             glVertexAttribPointer( colorLoc, 4, GL_FLOAT, 0, 0, 0 );
             logGLError();
 
             m_normalBuffer->realize();
             m_normalBuffer->bind();
-            m_normalBuffer->data( m_visTriangleData->getGrid()->getNormals() );
+            m_normalBuffer->data( mesh->getNormals() );
             glEnableVertexAttribArray( normalLoc );
             glVertexAttribPointer( normalLoc, 3, GL_FLOAT, 0, 0, 0 );
             logGLError();
 
             m_vectorsBuffer->realize();
             m_vectorsBuffer->bind();
-            m_vectorsBuffer->data( m_visTriangleVectorData->getAttributes() );
             glEnableVertexAttribArray( vectorsLoc );
             glVertexAttribPointer( vectorsLoc, 3, GL_FLOAT, 0, 0, 0 );
             logGLError();
 
             m_labelsBuffer->realize();
             m_labelsBuffer->bind();
-            m_labelsBuffer->data( *m_visTriangleLabelDataUInt32 );
             glEnableVertexAttribArray( labelsLoc );
             glVertexAttribIPointer( labelsLoc, 1, GL_UNSIGNED_INT, 0, 0 );
             logGLError();
 
-            m_indexBuffer->realize();
-            m_indexBuffer->bind();
-            m_indexBuffer->data( m_visTriangleData->getGrid()->getTriangles() );
+            // Without curvatures, the arrows stay straight.
+            m_curvaturesBuffer->realize();
+            m_curvaturesBuffer->bind();
+            m_curvaturesBuffer->data( m_visCurvatures ? m_visCurvatures->getCurvatures() : Vec2Array( mesh->getNumVertices() ) );
+            glEnableVertexAttribArray( curvaturesLoc );
+            glVertexAttribPointer( curvaturesLoc, 2, GL_FLOAT, 0, 0, 0 );
             logGLError();
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Create Vertex Array Object VAO and the corresponding Vertex Buffer Objects VBO for the mesh itself
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-            LogD << "Creating Point VAO" << LogEnd;
-
-            m_arrowShaderProgram->bind();
+            m_curvatureDirectionsBuffer->realize();
+            m_curvatureDirectionsBuffer->bind();
+            m_curvatureDirectionsBuffer->data( m_visCurvatures ? m_visCurvatures->getMaxDirections() : Vec3Array( mesh->getNumVertices() ) );
+            glEnableVertexAttribArray( curvatureDirectionLoc );
+            glVertexAttribPointer( curvatureDirectionLoc, 3, GL_FLOAT, 0, 0, 0 );
             logGLError();
 
-            // get the location of attribute "position" in program
-            GLint vertexPointLoc = m_arrowShaderProgram->getAttribLocation( "position" );
+            m_indexBuffer->realize();
+            m_indexBuffer->bind();
+            m_indexBuffer->data( mesh->getTriangles() );
             logGLError();
 
-            // Create the VAO
-            glGenVertexArrays( 1, &m_pointVAO );
-            glBindVertexArray( m_pointVAO );
-            logGLError();
+            m_uploadedMesh = mesh;
+        }
 
-            // Create some buffers
-            m_vertexBuffer = std::make_shared< core::Buffer >();
-            logGLError();
+        void RenderIllustrativeLines::updateAttributes()
+        {
+            LogD << "Updating Mesh Attributes" << LogEnd;
 
-            // Set the data using the triangle mesh. Also set the location mapping of the shader using the VAO
-            m_vertexBuffer->realize();
-            m_vertexBuffer->bind();
+            auto colors = m_visTriangleData->getAttributes();
+            auto vectors = m_visTriangleVectorData->getAttributes();
+            auto labels = m_visTriangleLabelDataUInt32;
 
-            // NOTE: filled during rendering
+            // The VAO references the buffers. Only their contents change.
+            if( m_uploadedColors != colors )
+            {
+                m_colorBuffer->bind();
+                m_colorBuffer->data( colors );
+                logGLError();
+                m_uploadedColors = colors;
+            }
 
-            glEnableVertexAttribArray( vertexLoc );
-            glVertexAttribPointer( vertexPointLoc, 3, GL_FLOAT, 0, 0, 0 );
-            logGLError();
+            if( m_uploadedVectors != vectors )
+            {
+                m_vectorsBuffer->bind();
+                m_vectorsBuffer->data( vectors );
+                logGLError();
+                m_uploadedVectors = vectors;
+            }
 
+            if( labels && ( m_uploadedLabels != labels ) )
+            {
+                m_labelsBuffer->bind();
+                m_labelsBuffer->data( labels );
+                logGLError();
+                m_uploadedLabels = labels;
+            }
+        }
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Create a Framebuffer Object (FBO) and setup LIC pipeline
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        void RenderIllustrativeLines::acquireRenderTargets()
+        {
+            auto& pool = core::RenderTargetPool::getInstance();
+
+            if( !m_fboTransform )
+            {
+                glGenFramebuffers( 1, &m_fboTransform );
+                glGenFramebuffers( 1, &m_fboArrow );
+                glGenFramebuffers( 1, &m_fboCompose );
+                logGLError();
+            }
 
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 1: Render and transform to image space
-            LogD << "Creating Transform Pass FBO" << LogEnd;
-
-            m_transformShaderProgram->bind();
-
-            // The framebuffer
-            glGenFramebuffers( 1, & m_fboTransform );
-
-            // Bind it to be able to modify and configure:
-            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboTransform );
-            logGLError();
-
-            // We need two target texture: color and noise
-            m_step1ColorTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1ColorTex->realize();
-            m_step1ColorTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            // TODO(sebastian): fixed size textures are a problem ...
-            m_step1ColorTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
-            logGLError();
-
-            m_step1VecTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1VecTex->realize();
-            m_step1VecTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            m_step1VecTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA16F, GL_RGBA, GL_FLOAT );
-            logGLError();
-
-            m_step1NormalTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1NormalTex->realize();
-            m_step1NormalTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            m_step1NormalTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA16F, GL_RGBA, GL_FLOAT );
-            logGLError();
-
-            m_step1PosTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1PosTex->realize();
-            m_step1PosTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            m_step1PosTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA16F, GL_RGBA, GL_FLOAT );
-            logGLError();
-
-            m_step1DepthTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1DepthTex->realize();
-            m_step1DepthTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
+            m_step1ColorTex = pool.acquire( m_fboResolution, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
+            m_step1VecTex = pool.acquire( m_fboResolution, GL_RGBA16F, GL_RGBA, GL_FLOAT );
+            m_step1NormalTex = pool.acquire( m_fboResolution, GL_RGBA16F, GL_RGBA, GL_FLOAT );
+            m_step1PosTex = pool.acquire( m_fboResolution, GL_RGBA16F, GL_RGBA, GL_FLOAT );
+            m_step1DepthTex = pool.acquire( m_fboResolution, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT );
             m_step1DepthTex->setTextureFilter( core::Texture::TextureFilter::LinearMipmapLinear, core::Texture::TextureFilter::Linear );
-            m_step1DepthTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT );
             logGLError();
 
-            // Bind textures to FBO
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboTransform );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_step1ColorTex->getObjectID() , 0 );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, m_step1VecTex->getObjectID() , 0 );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, m_step1NormalTex->getObjectID() , 0 );
@@ -789,201 +1007,60 @@ namespace di
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,  m_step1DepthTex->getObjectID() , 0 );
             logGLError();
 
-            // Define the out vars to bind to the attachments
-            glBindFragDataLocation( m_transformShaderProgram->getObjectID(), 0, "fragColor" );
-            logGLError();
-            glBindFragDataLocation( m_transformShaderProgram->getObjectID(), 1, "fragVec" );
-            logGLError();
-            glBindFragDataLocation( m_transformShaderProgram->getObjectID(), 2, "fragNormal" );
-            logGLError();
-            glBindFragDataLocation( m_transformShaderProgram->getObjectID(), 3, "fragPos" );
-            logGLError();
-
-            // Final Check
             if( glCheckFramebufferStatus( GL_DRAW_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
             {
                 LogE << "glCheckFramebufferStatus failed for Step 1." << LogEnd;
             }
 
-
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Step 2: Render and transform to image space
-            LogD << "Creating Arrow Pass FBO" << LogEnd;
-
-            m_arrowShaderProgram->bind();
-
-            // The framebuffer
-            glGenFramebuffers( 1, &m_fboArrow );
-
-            // Bind it to be able to modify and configure:
-            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboArrow );
-            logGLError();
-
-            // We need two target texture: color and noise
-            m_step2ColorTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step2ColorTex->realize();
-            m_step2ColorTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            // TODO(sebastian): fixed size textures are a problem ...
-            m_step2ColorTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
-            logGLError();
-
-            m_step2DepthTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step2DepthTex->realize();
-            m_step2DepthTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
+            // Step 2: Arrows
+            m_step2ColorTex = pool.acquire( m_fboResolution, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
+            m_step2DepthTex = pool.acquire( m_fboResolution, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT );
             m_step2DepthTex->setTextureFilter( core::Texture::TextureFilter::LinearMipmapLinear, core::Texture::TextureFilter::Linear );
-            m_step2DepthTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT );
             logGLError();
 
-            // Bind textures to FBO
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboArrow );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_step2ColorTex->getObjectID() , 0 );
-            logGLError();
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,  m_step2DepthTex->getObjectID() , 0 );
             logGLError();
 
-            // Define the out vars to bind to the attachments
-            glBindFragDataLocation( m_arrowShaderProgram->getObjectID(), 0, "fragColor" );
-            logGLError();
-
-            // Check for validity
             if( glCheckFramebufferStatus( GL_DRAW_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
             {
                 LogE << "glCheckFramebufferStatus failed for Step 2." << LogEnd;
             }
 
-            // We need 3D noise.
-            m_whiteNoiseTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_whiteNoiseTex->realize();
-            m_whiteNoiseTex->bind();
-            logGLError();
-
-            const size_t noiseWidth = 128;
-
-            // create some noise
-            std::srand( time( 0 ) );
-            std::vector< unsigned char > randData;
-            randData.reserve( noiseWidth * noiseWidth * 3 );
-            for( size_t i = 0; i < noiseWidth * noiseWidth * 3; ++i )
-            {
-                unsigned char r = static_cast< unsigned char >( std::rand() % 255 );  // NOLINT - no we want std::rand instead of rand_r
-                randData.push_back( r );
-            }
-
-            // Commit data
-            m_whiteNoiseTex->data( randData.data(), noiseWidth, noiseWidth, 1, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE );
-
-            //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Step 3 - Compose
-            LogD << "Creating flat VAO" << LogEnd;
-
-            // Create the full-screen quad.
-            float points[] = {
-             -1.0f,  1.0f,  0.0f,
-              1.0f,  1.0f,  0.0f,
-              1.0f, -1.0f,  0.0f,
-
-              1.0f, -1.0f,  0.0f,
-             -1.0f, -1.0f,  0.0f,
-             -1.0f,  1.0f,  0.0f
-            };
-
-            // Create Vertex Array Object
-            glGenVertexArrays( 1, &m_screenQuadVAO );
-            glBindVertexArray( m_screenQuadVAO );
-            logGLError();
-
-            m_screenQuadVertexBuffer = std::make_shared< core::Buffer >();
-            m_screenQuadVertexBuffer->realize();
-            m_screenQuadVertexBuffer->bind();
-            m_screenQuadVertexBuffer->data( 9 * 2 * sizeof( float ), points );
-            logGLError();
-
-            glEnableVertexAttribArray( 0 );
-            glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 0, nullptr );
-            logGLError();
-
-            // Do not forget to make the textures available to the final step
-            if( view.isHQMode() )
-            {
-                m_composeShaderProgram->setDefine( "d_samples", 64 );
-            }
-            else
-            {
-                m_composeShaderProgram->setDefine( "d_samples", 16 );
-            }
-            m_composeShaderProgram->bind();
-            m_composeShaderProgram->setUniform( "u_meshColorSampler",  0 );
-            m_composeShaderProgram->setUniform( "u_arrowColorSampler", 1 );
-            m_composeShaderProgram->setUniform( "u_meshDepthSampler",  2 );
-            m_composeShaderProgram->setUniform( "u_arrowDepthSampler", 3 );
-            m_composeShaderProgram->setUniform( "u_meshNormalSampler",  4 );
-            m_composeShaderProgram->setUniform( "u_noiseSampler",  5 );
-            logGLError();
-
-            LogD << "Creating Compose Pass FBO" << LogEnd;
-
-            // The framebuffer
-            glGenFramebuffers( 1, &m_fboCompose );
-
-            // Bind it to be able to modify and configure:
-            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboCompose );
-            logGLError();
-
-            // We need two target texture: color and noise
-            m_step3ColorTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step3ColorTex->realize();
-            m_step3ColorTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            // TODO(sebastian): fixed size textures are a problem ...
-            m_step3ColorTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
-            logGLError();
-
-            // We need two target texture: color and noise
-            m_step3AOTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step3AOTex->realize();
-            m_step3AOTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            // TODO(sebastian): fixed size textures are a problem ...
-            m_step3AOTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
-            logGLError();
-
-            m_step3DepthTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step3DepthTex->realize();
-            m_step3DepthTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Step 3: Compose
+            m_step3ColorTex = pool.acquire( m_fboResolution, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
+            m_step3AOTex = pool.acquire( m_fboResolution, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
+            m_step3DepthTex = pool.acquire( m_fboResolution, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT );
             m_step3DepthTex->setTextureFilter( core::Texture::TextureFilter::LinearMipmapLinear, core::Texture::TextureFilter::Linear );
-            m_step3DepthTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT );
             logGLError();
 
-            // Bind textures to FBO
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboCompose );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_step3ColorTex->getObjectID() , 0 );
-            logGLError();
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, m_step3AOTex->getObjectID() , 0 );
-            logGLError();
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,  m_step3DepthTex->getObjectID() , 0 );
             logGLError();
 
-            // Define the out vars to bind to the attachments
-            glBindFragDataLocation( m_composeShaderProgram->getObjectID(), 0, "fragColor" );
-            glBindFragDataLocation( m_composeShaderProgram->getObjectID(), 1, "fragAO" );
-            logGLError();
-
-            // Check for validity
             if( glCheckFramebufferStatus( GL_DRAW_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
             {
                 LogE << "glCheckFramebufferStatus failed for Step 3." << LogEnd;
             }
+        }
 
-            //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Step 4 - Compose
-
-            m_finalShaderProgram->bind();
-            m_finalShaderProgram->setUniform( "u_colorSampler",  0 );
-            m_finalShaderProgram->setUniform( "u_depthSampler", 1 );
-            m_finalShaderProgram->setUniform( "u_aoSampler",  2 );
-            logGLError();
+        void RenderIllustrativeLines::releaseRenderTargets()
+        {
+            m_step1ColorTex = nullptr;
+            m_step1VecTex = nullptr;
+            m_step1NormalTex = nullptr;
+            m_step1PosTex = nullptr;
+            m_step1DepthTex = nullptr;
+            m_step2ColorTex = nullptr;
+            m_step2DepthTex = nullptr;
+            m_step3ColorTex = nullptr;
+            m_step3AOTex = nullptr;
+            m_step3DepthTex = nullptr;
         }
     }
 }
-
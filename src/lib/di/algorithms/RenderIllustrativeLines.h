@@ -25,7 +25,10 @@
 #ifndef DI_RENDERILLUSTRATIVELINES_H
 #define DI_RENDERILLUSTRATIVELINES_H
 
+#include <vector>
+
 #include <di/gfx/GL.h>
+#include <di/gfx/MeshLOD.h>
 
 #include <di/core/Algorithm.h>
 #include <di/core/ParameterTypes.h>
@@ -39,8 +42,11 @@ namespace di
     namespace core
     {
         class TriangleDataSet;
+        class TriangleMesh;
         class View;
         class Points;
+        class PoissonDiskSamples;
+        class PrincipalCurvatures;
     }
 
     namespace algorithms
@@ -128,6 +134,43 @@ namespace di
              */
             virtual void onParameterChange( SPtr< core::ParameterBase > parameter ) override;
 
+            /**
+             * Create the programs and all resources that do not depend on the data or the framebuffer size.
+             */
+            void updatePrograms();
+
+            /**
+             * Upload the mesh itself and set up the VAO. Requires the programs.
+             */
+            void updateGeometry();
+
+            /**
+             * Upload the per-vertex colors, vectors and labels. Requires the geometry.
+             */
+            void updateAttributes();
+
+            /**
+             * Borrow the render targets for the current resolution from the pool and attach them to the framebuffers. Creates the framebuffers
+             * if needed.
+             */
+            void acquireRenderTargets();
+
+            /**
+             * Return the render targets to the pool.
+             */
+            void releaseRenderTargets();
+
+            /**
+             * Select the level of the surface arrow seeds matching the requested amount of arrows at the current zoom.
+             *
+             * \param view the view to render to
+             * \param tolerance returns the maximum distance between a seed and the visible surface, in view space. Seeds further away are
+             * hidden.
+             *
+             * \return the number of seeds to draw.
+             */
+            size_t selectArrowSeeds( const core::View& view, float& tolerance ) const;
+
         private:
             /**
              * To mask all other labels
@@ -199,6 +242,11 @@ namespace di
              */
             core::ParamBool m_curvatureArrows;
 
+            /**
+             * Place the arrows on the surface instead of the screen.
+             */
+            core::ParamBool m_surfaceArrows;
+
             /**
              * Follow curvature on surface
              */
@@ -246,15 +294,30 @@ namespace di
             ConstSPtr< di::io::RegionLabelReader::DataSetType > m_visTriangleLabelData = nullptr;
 
             /**
-             * Label list as unsigned int 32. Needed for the label buffer.
+             * Label list as unsigned int 32. Needed for the label buffer. Owned by the label dataset's conversion cache.
              */
-            SPtr< std::vector< uint32_t > > m_visTriangleLabelDataUInt32 = nullptr;
+            ConstSPtr< std::vector< uint32_t > > m_visTriangleLabelDataUInt32 = nullptr;
 
             /**
              * The array storing the arrow points
              */
             SPtr< di::core::Points > m_points = nullptr;
 
+            /**
+             * The arrow seeds on the surface. Owned by the triangle dataset.
+             */
+            ConstSPtr< di::core::PoissonDiskSamples > m_visArrowSeeds = nullptr;
+
+            /**
+             * The arrow seeds currently uploaded to the GPU.
+             */
+            ConstSPtr< di::core::PoissonDiskSamples > m_uploadedArrowSeeds = nullptr;
+
+            /**
+             * The curvature of the mesh, used to bend the arrows. Owned by the triangle dataset.
+             */
+            ConstSPtr< di::core::PrincipalCurvatures > m_visCurvatures = nullptr;
+
             /**
              * The Vertex Attribute Array Object (VAO) used for the data.
              */
@@ -295,6 +358,11 @@ namespace di
              */
             SPtr< di::core::Buffer > m_vertexBuffer = nullptr;
 
+            /**
+             * Arrow point data.
+             */
+            SPtr< di::core::Buffer > m_pointBuffer = nullptr;
+
             /**
              * Color data.
              */
@@ -315,11 +383,26 @@ namespace di
              */
             SPtr< di::core::Buffer > m_normalBuffer = nullptr;
 
+            /**
+             * Principal curvatures.
+             */
+            SPtr< di::core::Buffer > m_curvaturesBuffer = nullptr;
+
+            /**
+             * Directions of maximum curvature.
+             */
+            SPtr< di::core::Buffer > m_curvatureDirectionsBuffer = nullptr;
+
             /**
              * Index array.
              */
             SPtr< di::core::Buffer > m_indexBuffer = nullptr;
 
+            /**
+             * Coarse versions of the mesh. Rendered while the view is interacting.
+             */
+            di::core::MeshLOD m_meshLOD;
+
             /**
              * Fullscreen quad used for texture processing
              */
@@ -396,9 +479,29 @@ namespace di
             SPtr< di::core::Texture > m_step3DepthTex = nullptr;
 
             /**
-             * Current FBO resolution.
+             * Current FBO resolution. Updated each frame.
              */
             glm::ivec2 m_fboResolution = glm::ivec2( 2048, 2048 );
+
+            /**
+             * The mesh currently uploaded to the GPU. Used to detect whether the geometry needs an update.
+             */
+            ConstSPtr< di::core::TriangleMesh > m_uploadedMesh = nullptr;
+
+            /**
+             * The colors currently uploaded to the GPU.
+             */
+            ConstSPtr< void > m_uploadedColors = nullptr;
+
+            /**
+             * The vectors currently uploaded to the GPU.
+             */
+            ConstSPtr< void > m_uploadedVectors = nullptr;
+
+            /**
+             * The labels currently uploaded to the GPU.
+             */
+            ConstSPtr< std::vector< uint32_t > > m_uploadedLabels = nullptr;
         };
     }
 }
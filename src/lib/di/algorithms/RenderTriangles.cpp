@@ -68,6 +68,14 @@ namespace di
             bool changeVis = ( m_visTriangleData != data );
             m_visTriangleData = data;
 
+            // Build the coarse meshes for interaction in the background.
+            m_meshLOD.setMesh( data ? data->getGrid() : nullptr,
+                [ this ]()
+                {
+                    renderRequest();
+                }
+            );
+
             // As the rendering system does not render permanently, inform about the update.
             if( changeVis )
             {
@@ -135,7 +143,8 @@ namespace di
             glEnable( GL_BLEND );
 
             glBindVertexArray( m_VAO );
-            glDrawElements( GL_TRIANGLES, m_visTriangleData->getGrid()->getTriangles().size() * 3, GL_UNSIGNED_INT, NULL );
+            auto numTriangles = m_meshLOD.bind( view, m_indexBuffer, m_visTriangleData->getGrid()->getNumTriangles() );
+            glDrawElements( GL_TRIANGLES, numTriangles * 3, GL_UNSIGNED_INT, NULL );
             logGLError();
         }
 
@@ -212,6 +221,8 @@ namespace di
             m_indexBuffer->bind();
             m_indexBuffer->data( m_visTriangleData->getGrid()->getTriangles() );
             logGLError();
+
+            m_meshLOD.update( m_visTriangleData->getGrid() );
         }
     }
 }
@@ -26,6 +26,7 @@
 #define DI_RENDERTRIANGLES_H
 
 #include <di/gfx/GL.h>
+#include <di/gfx/MeshLOD.h>
 
 #include <di/core/Algorithm.h>
 #include <di/core/Visualization.h>
@@ -155,6 +156,11 @@ namespace di
              * Index array.
              */
             SPtr< di::core::Buffer > m_indexBuffer = nullptr;
+
+            /**
+             * Coarse versions of the mesh. Rendered while the view is interacting.
+             */
+            di::core::MeshLOD m_meshLOD;
         };
     }
 }
@@ -30,6 +30,9 @@
 
 #include <di/gfx/GL.h>
 #include <di/gfx/GLError.h>
+#include <di/gfx/GPUTimer.h>
+#include <di/gfx/NoiseTextureCache.h>
+#include <di/gfx/RenderTargetPool.h>
 
 #include "SurfaceLIC.h"
 
@@ -58,6 +61,13 @@ namespace di
                     "Directions",
                     "Directional information on the triangle mesh"
             );
+
+            m_noiseSeed = addParameter< int >(
+                    "Noise Seed",
+                    "The seed of the noise pattern. Equal seeds give equal images.",
+                    0
+            );
+            m_noiseSeed->setRangeHint( 0, 1000 );
         }
 
         SurfaceLIC::~SurfaceLIC()
@@ -65,6 +75,12 @@ namespace di
             // nothing to clean up so far
         }
 
+        void SurfaceLIC::onParameterChange( SPtr< core::ParameterBase > /* parameter */ )
+        {
+            // The only parameter is the noise seed. It does not need a complete update.
+            renderRequest();
+        }
+
         void SurfaceLIC::process()
         {
             // Get input data
@@ -92,6 +108,14 @@ namespace di
             m_visTriangleData = data;
             m_visTriangleVectorData = vectors;
 
+            // Build the coarse meshes for interaction in the background.
+            m_meshLOD.setMesh( data ? data->getGrid() : nullptr,
+                [ this ]()
+                {
+                    renderRequest();
+                }
+            );
+
             // As the rendering system does not render permanently, inform about the update.
             if( changeVis )
             {
@@ -137,6 +161,10 @@ namespace di
                                                               core::readTextFile( localShaderPath + "Shading.glsl" ) )
                         }
             ) );
+            // Define the out vars to bind to the attachments
+            m_shaderProgram->bindFragDataLocation( 0, "fragColor" );
+            m_shaderProgram->bindFragDataLocation( 1, "fragVec" );
+            m_shaderProgram->bindFragDataLocation( 2, "fragNoise" );
             m_shaderProgram->realize();
 
             vertexShader = std::make_shared< core::Shader >( core::Shader::ShaderType::Vertex,
@@ -151,6 +179,7 @@ namespace di
                             fragmentShader
                         }
             ) );
+            m_edgeProgram->bindFragDataLocation( 0, "fragEdge" );
             m_edgeProgram->realize();
 
             vertexShader = std::make_shared< core::Shader >( core::Shader::ShaderType::Vertex,
@@ -165,6 +194,7 @@ namespace di
                             fragmentShader
                         }
             ) );
+            m_advectProgram->bindFragDataLocation( 0, "fragAdvect" );
             m_advectProgram->realize();
 
             vertexShader = std::make_shared< core::Shader >( core::Shader::ShaderType::Vertex,
@@ -195,6 +225,10 @@ namespace di
             }
             // LogD << "Vis Render" << LogEnd;
 
+            // Borrow the render targets for this frame.
+            m_fboResolution = di::core::Texture::powerOfTwoResolution( view.getViewportSize() );
+            acquireRenderTargets();
+
             m_shaderProgram->bind();
             m_shaderProgram->setUniform( "u_ProjectionMatrix", view.getCamera().getProjectionMatrix() );
             m_shaderProgram->setUniform( "u_ViewMatrix",       view.getCamera().getViewMatrix() );
@@ -208,6 +242,7 @@ namespace di
 
             ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 1 - Draw Color and Noise on geometry to textures:
+            di::core::GPUTimer passTimer( "LIC: Transform" );
 
             // Bind it to be able to modify and configure:
             glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboTransform );
@@ -223,11 +258,13 @@ namespace di
             glClearColor( 1.0f, 0.0f, 0.0f, .0f );
 
             glBindVertexArray( m_VAO );
-            glDrawElements( GL_TRIANGLES, m_visTriangleData->getGrid()->getTriangles().size() * 3, GL_UNSIGNED_INT, NULL );
+            auto numTriangles = m_meshLOD.bind( view, m_indexBuffer, m_visTriangleData->getGrid()->getNumTriangles() );
+            glDrawElements( GL_TRIANGLES, numTriangles * 3, GL_UNSIGNED_INT, NULL );
             logGLError();
 
             ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 2 - Edge detection on depth buffer
+            passTimer.next( "LIC: Edge" );
 
             // Bind it to be able to modify and configure:
             glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboEdge );
@@ -252,6 +289,7 @@ namespace di
 
             ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 3 - Advect along the vec field
+            passTimer.next( "LIC: Advect" );
 
             // Bind it to be able to modify and configure:
             glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboAdvect );
@@ -281,6 +319,7 @@ namespace di
 
             ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Final Step - Merge everything and output to the normal framebuffer:
+            passTimer.next( "LIC: Compose" );
 
             // Set the view to be the target.
             view.bind();
@@ -307,24 +346,14 @@ namespace di
             glBindVertexArray( m_screenQuadVAO );
             glDrawArrays( GL_TRIANGLES, 0, 6 ); // 3 indices starting at 0 -> 1 triangle
             logGLError();
+            passTimer.stop();
+
+            releaseRenderTargets();
         }
 
-        void SurfaceLIC::update( const core::View& view, bool reload )
+        void SurfaceLIC::update( const core::View& /* view */, bool reload )
         {
-            // Force update if resolution mismatch
-            auto resolution = di::core::Texture::powerOfTwoResolution( view.getViewportSize() );
-            if( m_fboResolution != resolution )
-            {
-                LogD << "Framebuffer resolution not optimal:" <<
-                        " View: " <<  view.getViewportSize().x << "x" <<  view.getViewportSize().y <<
-                        ", Current FBO: " << m_fboResolution.x << "x" << m_fboResolution.y <<
-                        ", New FBO: " << resolution.x << "x" << resolution.y << LogEnd;
-
-                reload = true;
-                m_fboResolution = resolution;
-            }
-
-            if( !m_visTriangleData )
+            if( !m_visTriangleData || !m_visTriangleVectorData )
             {
                 return;
             }
@@ -336,26 +365,97 @@ namespace di
             LogD << "Vis Update" << LogEnd;
             resetRenderingRequest();
 
-            prepare();
+            // Only rebuild what actually changed. Each domain implies all the ones depending on it. The render targets are not handled here,
+            // they are borrowed from the pool each frame.
+            // NOTE: prepare() alone creates the programs but not the resources of updatePrograms. The screen quad is created there only.
+            bool programs = reload || !m_shaderProgram || !m_screenQuadVAO;
+            bool geometry = programs || ( m_uploadedMesh != m_visTriangleData->getGrid() );
+            bool attributes = geometry || ( m_uploadedColors != m_visTriangleData->getAttributes() ) ||
+                                          ( m_uploadedVectors != m_visTriangleVectorData->getAttributes() );
 
-            // house-keeping
-            if( m_fboEdge )
+            if( programs )
             {
-                glDeleteFramebuffers( 1, &m_fboEdge );
+                updatePrograms();
             }
-            if( m_fboAdvect )
+            if( geometry )
             {
-                glDeleteFramebuffers( 1, &m_fboAdvect );
+                updateGeometry();
             }
-            if( m_fboTransform )
+            if( attributes )
             {
-                glDeleteFramebuffers( 1, &m_fboTransform );
+                updateAttributes();
             }
+            m_meshLOD.update( m_visTriangleData->getGrid() );
+
+            // We need 3D noise. Equal seeds share the same texture.
+            m_whiteNoiseTex = core::NoiseTextureCache::getInstance().get( glm::ivec3( 128, 128, 128 ), 1, m_noiseSeed->get() );
+        }
 
+        void SurfaceLIC::updatePrograms()
+        {
+            prepare();
+
+            // Samplers
+            m_shaderProgram->bind();
+            m_shaderProgram->setUniform( "u_noiseSampler", 0 );
+
+            m_edgeProgram->bind();
+            m_edgeProgram->setUniform( "u_depthSampler", 0 );
+
+            m_advectProgram->bind();
+            m_advectProgram->setUniform( "u_depthSampler", 0 );
+            m_advectProgram->setUniform( "u_noiseSampler", 1 );
+            m_advectProgram->setUniform( "u_vecSampler",   2 );
+            m_advectProgram->setUniform( "u_edgeSampler",   3 );
+
+            m_composeProgram->bind();
+            m_composeProgram->setUniform( "u_colorSampler", 0 );
+            m_composeProgram->setUniform( "u_vecSampler", 1 );
+            m_composeProgram->setUniform( "u_depthSampler", 2 );
+            m_composeProgram->setUniform( "u_edgeSampler", 3 );
+            m_composeProgram->setUniform( "u_noiseSampler", 4 );
+            m_composeProgram->setUniform( "u_advectSampler", 5 );
+
+            //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Create an VAO containing the full-screen quad
+            if( !m_screenQuadVAO )
+            {
+                LogD << "Creating flat VAO" << LogEnd;
+
+                // Create the full-screen quad.
+                float points[] = {
+                 -1.0f,  1.0f,  0.0f,
+                  1.0f,  1.0f,  0.0f,
+                  1.0f, -1.0f,  0.0f,
+
+                  1.0f, -1.0f,  0.0f,
+                 -1.0f, -1.0f,  0.0f,
+                 -1.0f,  1.0f,  0.0f
+                };
+
+                // Create Vertex Array Object
+                glGenVertexArrays( 1, &m_screenQuadVAO );
+                glBindVertexArray( m_screenQuadVAO );
+                logGLError();
+
+                m_screenQuadVertexBuffer = std::make_shared< core::Buffer >();
+                m_screenQuadVertexBuffer->realize();
+                m_screenQuadVertexBuffer->bind();
+                m_screenQuadVertexBuffer->data( 9 * 2 * sizeof( float ), points );
+                logGLError();
+
+                glEnableVertexAttribArray( 0 );
+                glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 0, nullptr );
+                logGLError();
+            }
+        }
+
+        void SurfaceLIC::updateGeometry()
+        {
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Create Vertex Array Object VAO and the corresponding Vertex Buffer Objects VBO for the mesh itself
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            LogD << "Creating Mesh VAO" << LogEnd;
+            LogD << "Updating Mesh VAO" << LogEnd;
 
             m_shaderProgram->bind();
             logGLError();
@@ -367,23 +467,25 @@ namespace di
             GLint vectorsLoc = m_shaderProgram->getAttribLocation( "vectors" );
             logGLError();
 
-            // Create the VAO
-            glGenVertexArrays( 1, &m_VAO );
+            // Create the VAO and buffers once. They are re-used for all later updates.
+            if( !m_VAO )
+            {
+                glGenVertexArrays( 1, &m_VAO );
+                m_vertexBuffer = std::make_shared< core::Buffer >();
+                m_normalBuffer = std::make_shared< core::Buffer >();
+                m_colorBuffer = std::make_shared< core::Buffer >();
+                m_vectorsBuffer = std::make_shared< core::Buffer >();
+                m_indexBuffer = std::make_shared< core::Buffer >( core::Buffer::BufferType::ElementArray );
+            }
             glBindVertexArray( m_VAO );
             logGLError();
 
-            // Create some buffers
-            m_vertexBuffer = std::make_shared< core::Buffer >();
-            m_normalBuffer = std::make_shared< core::Buffer >();
-            m_colorBuffer = std::make_shared< core::Buffer >();
-            m_vectorsBuffer = std::make_shared< core::Buffer >();
-            m_indexBuffer = std::make_shared< core::Buffer >( core::Buffer::BufferType::ElementArray );
-            logGLError();
+            auto mesh = m_visTriangleData->getGrid();
 
             // Set the data using the triangle mesh. Also set the location mapping of the shader using the VAO
             m_vertexBuffer->realize();
             m_vertexBuffer->bind();
-            m_vertexBuffer->data( m_visTriangleData->getGrid()->getVertices() );
+            m_vertexBuffer->data( mesh->getVertices() );
             logGLError();
 
             glEnableVertexAttribArray( vertexLoc );
@@ -392,124 +494,90 @@ namespace di
 
             m_colorBuffer->realize();
             m_colorBuffer->bind();
-            m_colorBuffer->data( m_visTriangleData->getAttributes() );
             glEnableVertexAttribArray( colorLoc );
             glVertexAttribPointer( colorLoc, 4, GL_FLOAT, 0, 0, 0 );
             logGLError();
 
             m_normalBuffer->realize();
             m_normalBuffer->bind();
-            m_normalBuffer->data( m_visTriangleData->getGrid()->getNormals() );
+            m_normalBuffer->data( mesh->getNormals() );
             glEnableVertexAttribArray( normalLoc );
             glVertexAttribPointer( normalLoc, 3, GL_FLOAT, 0, 0, 0 );
             logGLError();
 
             m_vectorsBuffer->realize();
             m_vectorsBuffer->bind();
-            m_vectorsBuffer->data( m_visTriangleVectorData->getAttributes() );
             glEnableVertexAttribArray( vectorsLoc );
             glVertexAttribPointer( vectorsLoc, 3, GL_FLOAT, 0, 0, 0 );
             logGLError();
 
             m_indexBuffer->realize();
             m_indexBuffer->bind();
-            m_indexBuffer->data( m_visTriangleData->getGrid()->getTriangles() );
+            m_indexBuffer->data( mesh->getTriangles() );
             logGLError();
 
             // for texture coordinates, we use the [0,1]-scaled vertex coordinates -> we need the BB to scale.
-            core::BoundingBox bb = m_visTriangleData->getGrid()->getBoundingBox();
+            core::BoundingBox bb = mesh->getBoundingBox();
             m_shaderProgram->setUniform( "u_meshBBMin", bb.getMin() );
             m_shaderProgram->setUniform( "u_meshBBMax", bb.getMax() );
             logGLError();
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Texture input data
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            m_uploadedMesh = mesh;
+        }
 
-            // We need 3D noise.
-            m_whiteNoiseTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex3D );
-            m_whiteNoiseTex->realize();
-            //glActiveTexture( GL_TEXTURE0 );
-            m_whiteNoiseTex->bind();
-            logGLError();
+        void SurfaceLIC::updateAttributes()
+        {
+            LogD << "Updating Mesh Attributes" << LogEnd;
 
-            const size_t noiseWidth = 128;
+            auto colors = m_visTriangleData->getAttributes();
+            auto vectors = m_visTriangleVectorData->getAttributes();
 
-            // create some noise
-            std::srand( time( 0 ) );
-            std::vector< unsigned char > randData;
-            randData.reserve( noiseWidth * noiseWidth * noiseWidth );
-            for( size_t i = 0; i < noiseWidth * noiseWidth * noiseWidth; ++i )
+            // The VAO references the buffers. Only their contents change.
+            if( m_uploadedColors != colors )
             {
-                unsigned char r = static_cast< unsigned char >( std::rand() % 255 );  // NOLINT - no we want std::rand instead of rand_r
-                randData.push_back( r );
+                m_colorBuffer->bind();
+                m_colorBuffer->data( colors );
+                logGLError();
+                m_uploadedColors = colors;
             }
 
-            // Commit data
-            m_whiteNoiseTex->data( randData.data(), noiseWidth, noiseWidth, noiseWidth, GL_R8, GL_RED, GL_UNSIGNED_BYTE );
+            if( m_uploadedVectors != vectors )
+            {
+                m_vectorsBuffer->bind();
+                m_vectorsBuffer->data( vectors );
+                logGLError();
+                m_uploadedVectors = vectors;
+            }
+        }
 
-            // Bind to the shader
-            m_shaderProgram->setUniform( "u_noiseSampler", 0 );
+        void SurfaceLIC::acquireRenderTargets()
+        {
+            auto& pool = core::RenderTargetPool::getInstance();
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Create a Framebuffer Object (FBO) and setup LIC pipeline
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            if( !m_fboTransform )
+            {
+                glGenFramebuffers( 1, &m_fboTransform );
+                glGenFramebuffers( 1, &m_fboEdge );
+                glGenFramebuffers( 1, &m_fboAdvect );
+                logGLError();
+            }
 
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 1: Render and transform to image space
-            LogD << "Creating Transform Pass FBO" << LogEnd;
-
-            // The framebuffer
-            glGenFramebuffers( 1, & m_fboTransform );
-
-            // Bind it to be able to modify and configure:
-            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboTransform );
-            logGLError();
-
-            // We need two target texture: color and noise
-            m_step1ColorTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1ColorTex->realize();
-            m_step1ColorTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            // TODO(sebastian): fixed size textures are a problem ...
-            m_step1ColorTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
-            logGLError();
-
-            m_step1VecTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1VecTex->realize();
-            m_step1VecTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            m_step1VecTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGBA16F, GL_RGBA, GL_FLOAT );
-            logGLError();
-
-            m_step1NoiseTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1NoiseTex->realize();
-            m_step1NoiseTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            m_step1NoiseTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_R8, GL_RED, GL_UNSIGNED_BYTE );
-            logGLError();
-
-            m_step1DepthTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step1DepthTex->realize();
-            m_step1DepthTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            m_step1DepthTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT );
+            m_step1ColorTex = pool.acquire( m_fboResolution, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
+            m_step1VecTex = pool.acquire( m_fboResolution, GL_RGBA16F, GL_RGBA, GL_FLOAT );
+            m_step1NoiseTex = pool.acquire( m_fboResolution, GL_R8, GL_RED, GL_UNSIGNED_BYTE );
+            m_step1DepthTex = pool.acquire( m_fboResolution, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT );
             m_step1DepthTex->setTextureFilter( core::Texture::TextureFilter::LinearMipmapLinear, core::Texture::TextureFilter::Linear );
             logGLError();
 
-            // Bind textures to FBO
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboTransform );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_step1ColorTex->getObjectID() , 0 );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, m_step1VecTex->getObjectID() , 0 );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, m_step1NoiseTex->getObjectID() , 0 );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_step1DepthTex->getObjectID() , 0 );
             logGLError();
 
-            // Define the out vars to bind to the attachments
-            glBindFragDataLocation( m_shaderProgram->getObjectID(), 0, "fragColor" );
-            glBindFragDataLocation( m_shaderProgram->getObjectID(), 1, "fragVec" );
-            glBindFragDataLocation( m_shaderProgram->getObjectID(), 2, "fragNoise" );
-            logGLError();
-
             if( glCheckFramebufferStatus( GL_DRAW_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
             {
                 LogE << "glCheckFramebufferStatus failed for Step 1." << LogEnd;
@@ -517,129 +585,41 @@ namespace di
 
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 2: Edges in depth buffer
-            LogD << "Creating Edge Pass FBO" << LogEnd;
-
-            // The framebuffer
-            glGenFramebuffers( 1, & m_fboEdge );
-
-            // Bind it to be able to modify and configure:
-            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboEdge );
-            logGLError();
-
-            // We need two target texture: color and noise
-            m_step2EdgeTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step2EdgeTex->realize();
-            m_step2EdgeTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            // TODO(sebastian): fixed size textures are a problem ...
-            m_step2EdgeTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE );
+            m_step2EdgeTex = pool.acquire( m_fboResolution, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE );
             m_step2EdgeTex->setTextureFilter( core::Texture::TextureFilter::LinearMipmapLinear, core::Texture::TextureFilter::Linear );
             logGLError();
 
-            // Bind textures to FBO
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboEdge );
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_step2EdgeTex->getObjectID() , 0 );
             logGLError();
 
-            // Define the out vars to bind to the attachments
-            glBindFragDataLocation( m_edgeProgram->getObjectID(), 0, "fragEdge" );
-            logGLError();
-
-            // Samplers
-            m_edgeProgram->bind();
-            m_edgeProgram->setUniform( "u_depthSampler", 0 );
-
             if( glCheckFramebufferStatus( GL_DRAW_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
             {
                 LogE << "glCheckFramebufferStatus failed for Step 2." << LogEnd;
             }
 
-
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Step 3: Advect
-            LogD << "Creating Advect Pass FBO" << LogEnd;
+            m_step3AdvectTex = pool.acquire( m_fboResolution, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE );
 
-            // The framebuffer
-            glGenFramebuffers( 1, & m_fboAdvect );
-
-            // Bind it to be able to modify and configure:
             glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_fboAdvect );
-            logGLError();
-
-            // We need two target texture: color and noise
-            m_step3AdvectTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-            m_step3AdvectTex->realize();
-            m_step3AdvectTex->bind();
-            // NOTE: to use an FBO, the texture needs to be initalized empty.
-            // TODO(sebastian): fixed size textures are a problem ...
-            m_step3AdvectTex->data( nullptr, m_fboResolution.x, m_fboResolution.y, 1, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE );
-            logGLError();
-
-            // Bind textures to FBO
             glFramebufferTexture( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_step3AdvectTex->getObjectID() , 0 );
             logGLError();
 
-            // Define the out vars to bind to the attachments
-            glBindFragDataLocation( m_advectProgram->getObjectID(), 0, "fragAdvect" );
-            logGLError();
-
-            // Samplers
-            m_advectProgram->bind();
-            m_advectProgram->setUniform( "u_depthSampler", 0 );
-            m_advectProgram->setUniform( "u_noiseSampler", 1 );
-            m_advectProgram->setUniform( "u_vecSampler",   2 );
-            m_advectProgram->setUniform( "u_edgeSampler",   3 );
-
             if( glCheckFramebufferStatus( GL_DRAW_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
             {
                 LogE << "glCheckFramebufferStatus failed for Step 3." << LogEnd;
             }
+        }
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Step 4: Compose
-            LogD << "Creating Compose Pass FBO" << LogEnd;
-
-            // Unbind other FBO
-            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 );
-
-            // Bind the result textures to the next step
-            m_composeProgram->bind();
-            m_composeProgram->setUniform( "u_colorSampler", 0 );
-            m_composeProgram->setUniform( "u_vecSampler", 1 );
-            m_composeProgram->setUniform( "u_depthSampler", 2 );
-            m_composeProgram->setUniform( "u_edgeSampler", 3 );
-            m_composeProgram->setUniform( "u_noiseSampler", 4 );
-            m_composeProgram->setUniform( "u_advectSampler", 5 );
-
-            //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Create an VAO containing the full-screen quad
-            LogD << "Creating flat VAO" << LogEnd;
-
-            // Create the full-screen quad.
-            float points[] = {
-             -1.0f,  1.0f,  0.0f,
-              1.0f,  1.0f,  0.0f,
-              1.0f, -1.0f,  0.0f,
-
-              1.0f, -1.0f,  0.0f,
-             -1.0f, -1.0f,  0.0f,
-             -1.0f,  1.0f,  0.0f
-            };
-
-            // Create Vertex Array Object
-            glGenVertexArrays( 1, &m_screenQuadVAO );
-            glBindVertexArray( m_screenQuadVAO );
-            logGLError();
-
-            m_screenQuadVertexBuffer = std::make_shared< core::Buffer >();
-            m_screenQuadVertexBuffer->realize();
-            m_screenQuadVertexBuffer->bind();
-            m_screenQuadVertexBuffer->data( 9 * 2 * sizeof( float ), points );
-            logGLError();
-
-            glEnableVertexAttribArray( 0 );
-            glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 0, nullptr );
-            logGLError();
+        void SurfaceLIC::releaseRenderTargets()
+        {
+            m_step1ColorTex = nullptr;
+            m_step1VecTex = nullptr;
+            m_step1NoiseTex = nullptr;
+            m_step1DepthTex = nullptr;
+            m_step2EdgeTex = nullptr;
+            m_step3AdvectTex = nullptr;
         }
     }
 }
-
@@ -26,8 +26,10 @@
 #define DI_SURFACELIC_H
 
 #include <di/gfx/GL.h>
+#include <di/gfx/MeshLOD.h>
 
 #include <di/core/Algorithm.h>
+#include <di/core/ParameterTypes.h>
 #include <di/core/Visualization.h>
 #include <di/core/data/DataSetTypes.h>
 
@@ -36,6 +38,7 @@ namespace di
     namespace core
     {
         class TriangleDataSet;
+        class TriangleMesh;
         class View;
     }
 
@@ -116,7 +119,46 @@ namespace di
             virtual core::BoundingBox getBoundingBox() const;
 
         protected:
+            /**
+             * Get notified about changes in a parameter. By default, this method calls \ref requestUpdate, if you override this method, it is your
+             * task to decide whether to update the whole algorithm or not.
+             *
+             * \param parameter the parameter that notified this
+             */
+            virtual void onParameterChange( SPtr< core::ParameterBase > parameter ) override;
+
+            /**
+             * Create the programs and all resources that do not depend on the data or the framebuffer size.
+             */
+            void updatePrograms();
+
+            /**
+             * Upload the mesh itself and set up the VAO. Requires the programs.
+             */
+            void updateGeometry();
+
+            /**
+             * Upload the per-vertex colors and vectors. Requires the geometry.
+             */
+            void updateAttributes();
+
+            /**
+             * Borrow the render targets for the current resolution from the pool and attach them to the framebuffers. Creates the framebuffers
+             * if needed.
+             */
+            void acquireRenderTargets();
+
+            /**
+             * Return the render targets to the pool.
+             */
+            void releaseRenderTargets();
+
         private:
+            /**
+             * Seed of the noise pattern.
+             */
+            core::ParamInt m_noiseSeed;
+
             /**
              * The triangle mesh input to use.
              */
@@ -178,7 +220,12 @@ namespace di
             SPtr< di::core::Buffer > m_indexBuffer = nullptr;
 
             /**
-             * The white noise needed for LIC.
+             * Coarse versions of the mesh. Rendered while the view is interacting.
+             */
+            di::core::MeshLOD m_meshLOD;
+
+            /**
+             * The white noise needed for LIC. Owned by the noise texture cache.
              */
             SPtr< di::core::Texture > m_whiteNoiseTex = nullptr;
 
@@ -248,9 +295,24 @@ namespace di
             SPtr< di::core::Program > m_composeProgram = nullptr;
 
             /**
-             * Current FBO resolution.
+             * Current FBO resolution. Updated each frame.
              */
             glm::ivec2 m_fboResolution = glm::ivec2( 2048, 2048 );
+
+            /**
+             * The mesh currently uploaded to the GPU. Used to detect whether the geometry needs an update.
+             */
+            ConstSPtr< di::core::TriangleMesh > m_uploadedMesh = nullptr;
+
+            /**
+             * The colors currently uploaded to the GPU.
+             */
+            ConstSPtr< void > m_uploadedColors = nullptr;
+
+            /**
+             * The vectors currently uploaded to the GPU.
+             */
+            ConstSPtr< void > m_uploadedVectors = nullptr;
         };
     }
 }
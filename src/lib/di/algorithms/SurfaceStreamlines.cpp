@@ -0,0 +1,223 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/core/data/Lines.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/MathTypes.h>
+
+#include "SurfaceStreamlines.h"
+
+#include <di/core/Logger.h>
+#define LogTag "algorithms/SurfaceStreamlines"
+
+/**
+ * Seed of the random number generator. Fixed to get the same lines each time.
+ */
+static const unsigned int g_randomSeed = 42;
+
+/**
+ * The color at the upstream end of a line is the line color mixed with white by this amount. This shows the direction of the flow.
+ */
+static const float g_upstreamFade = 0.75f;
+
+namespace di
+{
+    namespace algorithms
+    {
+        SurfaceStreamlines::SurfaceStreamlines():
+            Algorithm( "Surface Streamlines",
+                       "Trace streamlines of a vector field along a triangle mesh." )
+        {
+            // 1: the output
+            m_linesOutput = addOutput< di::core::LineDataSet >(
+                    "Streamlines",
+                    "The traced streamlines."
+            );
+
+            // 2: the input
+            m_vectorInput = addInput< di::core::TriangleVectorField >(
+                    "Directions",
+                    "The per-vertex vectors to trace."
+            );
+
+            m_numSeeds = addParameter< int >(
+                    "Number of Seeds",
+                    "The number of streamlines to trace. The seeds are distributed randomly over the surface.",
+                    2000
+            );
+            m_numSeeds->setRangeHint( 0, 20000 );
+
+            m_stepSize = addParameter< double >(
+                    "Step Size",
+                    "The integration step size, relative to the mean edge length of the mesh.",
+                    0.5
+            );
+            m_stepSize->setRangeHint( 0.05, 2.0 );
+
+            m_maxSteps = addParameter< int >(
+                    "Maximum Steps",
+                    "The maximum number of integration steps in each direction from the seed.",
+                    500
+            );
+            m_maxSteps->setRangeHint( 1, 5000 );
+
+            m_lineColor = addParameter< di::Color >(
+                    "Line Color",
+                    "The color of the lines. Lines fade to white in upstream direction.",
+                    di::Color( 0.0, 0.0, 0.0, 1.0 )
+            );
+        }
+
+        SurfaceStreamlines::~SurfaceStreamlines()
+        {
+            // nothing to clean up so far
+        }
+
+        void SurfaceStreamlines::process()
+        {
+            auto vectorDataSet = m_vectorInput->getData();
+            if( !vectorDataSet )
+            {
+                return;
+            }
+
+            auto mesh = vectorDataSet->getGrid();
+            auto vectors = vectorDataSet->getAttributes< 0 >();
+            if( vectors->size() != mesh->getNumVertices() )
+            {
+                LogE << "Number of vectors needs to match the number of vertices in the triangle mesh." << LogEnd;
+                return;
+            }
+
+            if( !m_tracer || ( m_tracer->getMesh() != mesh ) )
+            {
+                m_tracer = std::make_shared< di::core::MeshStreamlineTracer >( mesh );
+            }
+
+            const auto& vertices = mesh->getVertices();
+            const auto& triangles = mesh->getTriangles();
+            size_t numSeeds = triangles.empty() ? 0 : static_cast< size_t >( std::max( 0, m_numSeeds->get() ) );
+            size_t maxSteps = static_cast< size_t >( std::max( 1, m_maxSteps->get() ) );
+            double stepSize = m_stepSize->get() * m_tracer->getMeanEdgeLength();
+
+            // Distribute the seeds uniformly over the surface area.
+            std::vector< double > cumulativeArea( triangles.size() );
+            double area = 0.0;
+            for( size_t triangle = 0; triangle < triangles.size(); ++triangle )
+            {
+                const auto& tri = triangles[ triangle ];
+                area += 0.5 * glm::length( glm::cross( glm::dvec3( vertices[ tri.y ] ) - glm::dvec3( vertices[ tri.x ] ),
+                                                       glm::dvec3( vertices[ tri.z ] ) - glm::dvec3( vertices[ tri.x ] ) ) );
+                cumulativeArea[ triangle ] = area;
+            }
+
+            std::mt19937 generator( g_randomSeed );
+            std::uniform_real_distribution< double > uniform( 0.0, 1.0 );
+            std::vector< di::core::MeshStreamlineTracer::Point > seeds( numSeeds );
+            for( auto& seed : seeds )
+            {
+                auto pick = std::upper_bound( cumulativeArea.begin(), cumulativeArea.end(), uniform( generator ) * area );
+                seed.m_triangle = std::min( static_cast< size_t >( pick - cumulativeArea.begin() ), triangles.size() - 1 );
+
+                double s = std::sqrt( uniform( generator ) );
+                double t = uniform( generator );
+                seed.m_barycentric = glm::dvec3( 1.0 - s, s * ( 1.0 - t ), s * t );
+            }
+
+            // Trace. Each seed writes its own line, so the result does not depend on the number of threads.
+            LogD << "Tracing " << numSeeds << " streamlines." << LogEnd;
+            std::vector< std::vector< glm::vec3 > > streamlines( numSeeds );
+            di::core::parallelFor( numSeeds,
+                [ & ]( size_t begin, size_t end )
+                {
+                    std::vector< di::core::MeshStreamlineTracer::Point > points;
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        points.clear();
+                        m_tracer->trace( *vectors, seeds[ i ], stepSize, maxSteps, true, points );
+                        std::reverse( points.begin(), points.end() );
+                        points.push_back( seeds[ i ] );
+                        m_tracer->trace( *vectors, seeds[ i ], stepSize, maxSteps, false, points );
+
+                        auto& line = streamlines[ i ];
+                        line.reserve( points.size() );
+                        for( const auto& point : points )
+                        {
+                            line.push_back( m_tracer->getPosition( point ) );
+                        }
+                    }
+                },
+                16
+            );
+
+            // Merge.
+            size_t numVertices = 0;
+            for( const auto& line : streamlines )
+            {
+                numVertices += ( line.size() > 1 ) ? line.size() : 0;
+            }
+
+            auto color = m_lineColor->get();
+            Vec3Array lineVertices;
+            IndexVec2Array lineIndices;
+            auto colors = std::make_shared< RGBAArray >();
+            lineVertices.reserve( numVertices );
+            lineIndices.reserve( numVertices );
+            colors->reserve( numVertices );
+            for( const auto& line : streamlines )
+            {
+                if( line.size() < 2 )
+                {
+                    continue;
+                }
+
+                for( size_t i = 0; i < line.size(); ++i )
+                {
+                    if( i > 0 )
+                    {
+                        lineIndices.push_back( glm::ivec2( lineVertices.size() - 1, lineVertices.size() ) );
+                    }
+                    lineVertices.push_back( line[ i ] );
+
+                    float fade = g_upstreamFade * ( 1.0f - static_cast< float >( i ) / static_cast< float >( line.size() - 1 ) );
+                    colors->push_back( glm::vec4( glm::mix( glm::vec3( color ), glm::vec3( 1.0f ), fade ), color.a ) );
+                }
+            }
+
+            LogD << "Traced " << lineIndices.size() << " segments with " << lineVertices.size() << " vertices." << LogEnd;
+
+            auto lines = std::make_shared< di::core::Lines >();
+            lines->setVertices( std::move( lineVertices ) );
+            lines->setLines( std::move( lineIndices ) );
+            m_linesOutput->setData( std::make_shared< di::core::LineDataSet >( "Streamlines", lines, colors ) );
+        }
+    }
+}
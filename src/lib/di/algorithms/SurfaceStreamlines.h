@@ -0,0 +1,103 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_SURFACESTREAMLINES_H
+#define DI_SURFACESTREAMLINES_H
+
+#include <vector>
+
+#include <di/core/Algorithm.h>
+#include <di/core/ParameterTypes.h>
+#include <di/core/data/DataSetTypes.h>
+#include <di/core/data/LineDataSet.h>
+#include <di/core/data/MeshStreamlineTracer.h>
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * Trace streamlines of a per-vertex vector field over a triangle mesh using \ref di::core::MeshStreamlineTracer. Seeds are distributed
+         * randomly, weighted by triangle area, and traced in parallel. The result is a line dataset that can be rendered by \ref RenderLines.
+         */
+        class SurfaceStreamlines: public di::core::Algorithm
+        {
+        public:
+            /**
+             * Constructor. Initialize all inputs, outputs and parameters.
+             */
+            SurfaceStreamlines();
+
+            /**
+             * Destructor. Clean up if needed.
+             */
+            virtual ~SurfaceStreamlines();
+
+            /**
+             * Trace the streamlines of the input field.
+             */
+            virtual void process();
+
+        protected:
+        private:
+            /**
+             * The vector field to trace.
+             */
+            SPtr< di::core::Connector< di::core::TriangleVectorField > > m_vectorInput;
+
+            /**
+             * The resulting lines.
+             */
+            SPtr< di::core::Connector< di::core::LineDataSet > > m_linesOutput;
+
+            /**
+             * Number of seed points.
+             */
+            core::ParamInt m_numSeeds;
+
+            /**
+             * Step size relative to the mean edge length.
+             */
+            core::ParamDouble m_stepSize;
+
+            /**
+             * Maximum number of steps per direction.
+             */
+            core::ParamInt m_maxSteps;
+
+            /**
+             * Line color.
+             */
+            core::ParamColor m_lineColor;
+
+            /**
+             * The tracer. Kept as long as the mesh does not change.
+             */
+            SPtr< di::core::MeshStreamlineTracer > m_tracer = nullptr;
+        };
+    }
+}
+
+#endif  // DI_SURFACESTREAMLINES_H
+
@@ -68,6 +68,17 @@ float getZoom( vec2 where );
 float getInfluence( vec2 where );
 vec3 getNoiseAsVector( vec2 where );
 
+/**
+ * Position of the viewport in the whole image. Non-zero if the viewport is a tile of a larger image.
+ */
+uniform vec2 u_imageOffset = vec2( 0.0 );
+
+/**
+ * Size of the framebuffer used if the whole image was rendered at once. The radius is relative to the framebuffer size. Using this instead of
+ * the actual size keeps the hemisphere identical for each tile. Zero to use the actual framebuffer.
+ */
+uniform vec2 u_imageFramebufferSize = vec2( 0.0 );
+
 #ifndef d_samples
     #define d_samples 16
 #endif
@@ -83,8 +94,14 @@ float getLineAO( vec2 where, vec2 px2tx, LineAOParameter params )
     // Fall-off for SSAO per occluder. This should be zero (or nearly zero) since it defines what is counted as before, or behind.
     float falloff = 0.001;
 
-    // grab a random normal for reflecting the sample rays later on
-    vec3 randNormal = normalize( getNoiseAsVector( where * 10.0 ) );
+    // grab a random normal for reflecting the sample rays later on. If rendering a tile, use the position in the framebuffer of the whole
+    // image. Each tile then continues the pattern of its neighbours. Without tiling, this is the same as using where.
+    vec2 noisePos = where;
+    if( u_imageFramebufferSize.x > 0.0 )
+    {
+        noisePos = ( where / px2tx + u_imageOffset ) / u_imageFramebufferSize;
+    }
+    vec3 randNormal = normalize( getNoiseAsVector( noisePos * 10.0 ) );
 
     // grab the current pixel's normal and depth
     vec3 currentPixelSample = getNormal( where, 0 ).xyz;
@@ -98,7 +115,14 @@ float getLineAO( vec2 where, vec2 px2tx, LineAOParameter params )
 
     // the radius of the sphere is, in screen-space, half a pixel. So the hemisphere covers nearly one pixel. Scaling by depth somehow makes it
     // more invariant for zooming
-    float radius = ( getZoom( where ) * max( px2tx.x, px2tx.y ) * params.lineaoRadiusSS );// / ( 1.0 - currentPixelDepth );
+    vec2 imagePx2tx = px2tx;
+    vec2 imageToFramebuffer = vec2( 1.0 );
+    if( u_imageFramebufferSize.x > 0.0 )
+    {
+        imagePx2tx = vec2( 1.0 ) / u_imageFramebufferSize;
+        imageToFramebuffer = u_imageFramebufferSize * px2tx;
+    }
+    float radius = ( getZoom( where ) * max( imagePx2tx.x, imagePx2tx.y ) * params.lineaoRadiusSS );// / ( 1.0 - currentPixelDepth );
 
     // some temporaries needed inside the loop
     vec3 ray;                     // the current ray inside the sphere
@@ -145,6 +169,7 @@ float getLineAO( vec2 where, vec2 px2tx, LineAOParameter params )
             vec3 hemisphereVector = reflect( randSphereNormal, randNormal );
             ray = radiusScaler * radius * hemisphereVector;
             ray = sign( dot( ray, normal ) ) * ray;
+            ray.xy *= imageToFramebuffer;
 
             // get the point in texture space on the hemisphere
             hemispherePoint = ray + ep;
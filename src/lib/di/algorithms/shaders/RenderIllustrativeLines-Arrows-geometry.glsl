@@ -37,6 +37,19 @@ uniform mat4 u_ProjectionMatrix;
 uniform mat4 u_ViewMatrix;
 uniform vec2 u_viewportScale = vec2( 1.0 );
 
+// Maps the arrow seeds, defined in normalized coordinates of the whole image, to the viewport. Needed if the viewport is only a tile of the
+// image.
+uniform vec2 u_seedScale = vec2( 1.0 );
+uniform vec2 u_seedOffset = vec2( 0.0 );
+
+#ifdef d_surfaceSeeds
+// Seeds on the surface, in view space
+in vec4 v_seedPosView[];
+
+// Maximum distance between a seed and the visible surface
+uniform float u_seedTolerance = 0.0;
+#endif
+
 uniform float u_width = 1.5;
 uniform float u_height = 5.0;
 uniform float u_dist = 2.0;
@@ -65,7 +78,7 @@ PointInfo getPointInfo( vec2 where )
     PointInfo result;
 
     // IMPORTANT: works only with GL_NEAREST filtering
-    vec2 texCoord = u_viewportScale * where;
+    vec2 texCoord = u_viewportScale * ( u_seedScale * where + u_seedOffset );
 
     result.pointColor  = texture( u_colorSampler, texCoord.xy );
     result.pointPos    = texture( u_posSampler, texCoord.xy );
@@ -75,10 +88,42 @@ PointInfo getPointInfo( vec2 where )
     return result;
 }
 
+/**
+ * Check whether the given seed lies inside the viewport. Seeds outside belong to other tiles.
+ */
+bool isInViewport( vec2 where )
+{
+    vec2 p = u_seedScale * where + u_seedOffset;
+    return all( greaterThanEqual( p, vec2( 0.0 ) ) ) && all( lessThanEqual( p, vec2( 1.0 ) ) );
+}
+
+/**
+ * Check whether the seed is visible. Seeds on the surface might be hidden by other parts of the surface or be on the back side.
+ */
+bool isSeedVisible( PointInfo pinfo )
+{
+#ifdef d_surfaceSeeds
+    // Background has w = 0
+    return ( pinfo.pointPos.w > 0.0 ) && ( distance( pinfo.pointPos.xyz, v_seedPosView[0].xyz ) <= u_seedTolerance );
+#else
+    return true;
+#endif
+}
+
 #ifdef d_curvatureEnable
 
 void main()
 {
+    if( !isInViewport( gl_in[0].gl_Position.xy ) )
+    {
+        return;
+    }
+    PointInfo pinfo = getPointInfo( gl_in[0].gl_Position.xy );
+    if( !isSeedVisible( pinfo ) )
+    {
+        return;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////
     // Given:
 
@@ -86,40 +131,49 @@ void main()
     float height = u_height;
     float dist = u_dist;
 
-    // Initial position
-    vec2 pos = gl_in[0].gl_Position.xy;
+    // NOTE: magic number: it represents the scaling between texture space and actual transformed world space the arrows reside in ....
+    float scale = 0.005;
+    float lscale = scale * 2.0 * height;
+    float wscale = scale * width;
 
-    // Iterate and add segments
-    for( int segment = 0; segment < d_curvatureNumSegments; ++segment )
+    vec3 normal = normalize( pinfo.pointNormal.xyz );
+    if( length( pinfo.pointVec.xyz ) < 0.00001 )
     {
-        PointInfo pinfo = getPointInfo( pos );
-
-        // Parameterize along the surface
-        float longitudinalParam = float( segment ) / float( d_curvatureNumSegments - 1.0 );
-
-        // float scale = clamp( 0.005 * pinfo.pointVec.w, 0.0001, 0.005 );
+        return;
+    }
 
-        // NOTE: magic number: it represents the scaling between texture space and actual transformed world space the arrows reside in ....
-        float scale = 0.005;
-        float lscale = scale * 2.0 * height / float( d_curvatureNumSegments );
-        float wscale = scale * width;
+    vec3 tangent = pinfo.pointVec.xyz - dot( pinfo.pointVec.xyz, normal ) * normal;
+    if( length( tangent ) < 0.00001 )
+    {
+        return;
+    }
+    tangent = normalize( tangent );
+    vec3 binormal = normalize( cross( tangent, normal ) );
 
-        vec3 p = pinfo.pointPos.xyz;
-        v_color = pinfo.pointColor;
-        v_normal = normalize( pinfo.pointNormal.xyz );
+    // The arrow is an arc in the plane of tangent and normal, bent by the curvature of the surface along the arrow. Limit the bend to a
+    // quarter circle, so arrows at creases do not curl up.
+    float curvature = pinfo.pointNormal.w;
+    float maxCurvature = 0.5 * 3.14159265 / lscale;
+    curvature = clamp( curvature, -maxCurvature, maxCurvature );
 
-        vec3 tangent = normalize( pinfo.pointVec.xyz );
-        vec3 binormal =  normalize( cross( tangent, v_normal ) );
+    vec3 p = pinfo.pointPos.xyz + scale * normal * dist;
+    v_color = pinfo.pointColor;
 
-        if( length( pinfo.pointVec.xyz ) < 0.00001 )
-        {
-            break;
-        }
+    for( int segment = 0; segment < d_curvatureNumSegments; ++segment )
+    {
+        // Parameterize along the arc
+        float longitudinalParam = float( segment ) / float( d_curvatureNumSegments - 1.0 );
+        float arcLength = longitudinalParam * lscale;
+        float angle = curvature * arcLength;
 
-        p += scale * v_normal * dist;
+        // Convex surfaces bend away from the normal. Use the series for nearly flat arcs.
+        float along = ( abs( angle ) > 0.001 ) ? sin( angle ) / curvature : arcLength;
+        float across = ( abs( angle ) > 0.001 ) ? ( 1.0 - cos( angle ) ) / curvature : 0.5 * angle * arcLength;
+        vec3 center = p + tangent * along - normal * across;
+        v_normal = normal * cos( angle ) + tangent * sin( angle );
 
-        vec3 lv1 = p - ( binormal * wscale );
-        vec3 lv2 = p + ( binormal * wscale );
+        vec3 lv1 = center - ( binormal * wscale );
+        vec3 lv2 = center + ( binormal * wscale );
 
         // v1
         gl_Position = u_ProjectionMatrix * vec4( lv1, 1.0 );
@@ -130,14 +184,6 @@ void main()
         gl_Position = u_ProjectionMatrix * vec4( lv2, 1.0 );
         v_surfaceUV = vec2(  1.0, 2.0 * longitudinalParam - 1.0 );
         EmitVertex();
-
-        // Follow the tangential direction
-        pos += tangent.xy * lscale;
-
-        if( length( tangent.xy ) < 0.001 )
-        {
-            break;
-        }
     }
 
     EndPrimitive();
@@ -147,7 +193,15 @@ void main()
 
 void main()
 {
+    if( !isInViewport( gl_in[0].gl_Position.xy ) )
+    {
+        return;
+    }
     PointInfo pinfo = getPointInfo( gl_in[0].gl_Position.xy );
+    if( !isSeedVisible( pinfo ) )
+    {
+        return;
+    }
 
     /////////////////////////////////////////////////////////////////////////////////////
     // Given:
@@ -27,9 +27,30 @@
 // Attribute data
 in vec3 position;
 
+#ifdef d_surfaceSeeds
+
+// Uniforms
+uniform mat4 u_ProjectionMatrix;
+uniform mat4 u_ViewMatrix;
+
+// The seed in view space
+out vec4 v_seedPosView;
+
+void main()
+{
+    // Seeds on the surface are projected to normalized viewport coordinates, like the screen space seeds.
+    v_seedPosView = u_ViewMatrix * vec4( position, 1.0 );
+    vec4 pos = u_ProjectionMatrix * v_seedPosView;
+    gl_Position = vec4( 0.5 * pos.xy / pos.w + vec2( 0.5 ), 0.0, 1.0 );
+}
+
+#else
+
 void main()
 {
     // trivial pass-through
     gl_Position = vec4( position, 1.0 );
 }
 
+#endif
+
@@ -36,6 +36,7 @@ in vec3 v_normal;
 in vec4 v_posView;
 in vec3 v_vector;
 in float v_vectorLength;
+in float v_curvature;
 
 uniform mat4 u_ViewMatrix;
 uniform float u_specularity = 0.25;
@@ -44,7 +45,7 @@ uniform bool u_emphasizeSingularPointsEnable = false;
 
 out vec4 fragColor;
 out vec4 fragVec;
-out vec4 fragNormal;
+out vec4 fragNormal; // w: curvature along the vector
 out vec4 fragPos;
 
 // NOTE the following is LIB code. Load Shading.glsl on host side
@@ -75,7 +76,7 @@ void main()
     fragColor = vec4( desaturate( light * v_color.xyz, 1.0 - v_emphasizeScale ), 1.0 );
     fragVec = vec4( v_vector.xyz, v_vectorLength );
     fragPos = v_posView;
-    fragNormal = vec4( normalize( v_normal ), 1.0 );
+    fragNormal = vec4( normalize( v_normal ), v_curvature );
 
     if( ( normalizedVectorLength < 0.40 ) && ( u_emphasizeSingularPointsEnable ) )
     {
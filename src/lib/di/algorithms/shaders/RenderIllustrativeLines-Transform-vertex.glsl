@@ -32,6 +32,8 @@ in vec4 color;
 in vec3 normal;
 in vec3 vectors;
 in uint label;
+in vec2 curvatures;
+in vec3 curvatureDirection;
 
 // Uniforms
 uniform mat4 u_ProjectionMatrix;
@@ -45,6 +47,7 @@ out vec3 v_normal;
 out vec4 v_posView;
 out vec3 v_vector;
 out float v_vectorLength;
+out float v_curvature;
 
 #ifdef d_enableInterpolation
     out vec4 v_color;
@@ -83,11 +86,19 @@ void main()
     v_normal = ( u_ViewMatrix * vec4( normal, 0.0 ) ).xyz;
     v_posView = u_ViewMatrix * vec4( position, 1.0 );
 
-    // Maybe switch normal. Point towards viewer
+    // Curvature of the surface along the vector. The principal directions span the tangent plane. Scale to view space units.
+    float c = dot( vectors, curvatureDirection );
+    float s = dot( vectors, cross( normal, curvatureDirection ) );
+    float tangentLength = c * c + s * s;
+    v_curvature = ( tangentLength > 0.0 ) ? ( curvatures.x * c * c + curvatures.y * s * s ) / tangentLength : 0.0;
+    v_curvature /= length( u_ViewMatrix[0].xyz );
+
+    // Maybe switch normal. Point towards viewer. The curvature is relative to the normal.
     vec3 toViewer = vec3( 0.0, 0.0, 1.0 );
     if( dot( toViewer, v_normal ) < 0.0 )
     {
         v_normal *= -1.0;
+        v_curvature *= -1.0;
     }
 
     vec4 pos = u_ProjectionMatrix * v_posView;
@@ -0,0 +1,64 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <string>
+
+#include "WriteImage.h"
+
+namespace di
+{
+    namespace commands
+    {
+        WriteImage::WriteImage( ConstSPtr< core::RGBA8Image > image, const std::string& filename, SPtr< di::core::CommandObserver > observer ):
+            Command( observer ),
+            m_image( image ),
+            m_filename( filename )
+        {
+        }
+
+        WriteImage::~WriteImage()
+        {
+        }
+
+        std::string WriteImage::getName() const
+        {
+            return "Write Image";
+        }
+
+        std::string WriteImage::getDescription() const
+        {
+            return "Compress an image and write it to disk.";
+        }
+
+        std::string WriteImage::getFilename() const
+        {
+            return m_filename;
+        }
+
+        ConstSPtr< core::RGBA8Image > WriteImage::getImage() const
+        {
+            return m_image;
+        }
+    }
+}
@@ -0,0 +1,105 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_WRITEIMAGE_H
+#define DI_WRITEIMAGE_H
+
+#include <string>
+
+#include <di/core/CommandObserver.h>
+#include <di/core/Command.h>
+#include <di/gfx/PixelData.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace commands
+    {
+        /**
+         * Implements a command to write an image to disk.
+         */
+        class WriteImage: public di::core::Command
+        {
+        public:
+            /**
+             * Create a command to write the given image.
+             *
+             * \param image the image to write. Must not be modified afterwards.
+             * \param filename the file to write
+             * \param observer an object that gets notified upon changes in this command's state.
+             */
+            WriteImage( ConstSPtr< core::RGBA8Image > image, const std::string& filename, SPtr< di::core::CommandObserver > observer = nullptr );
+
+            /**
+             * Clean up.
+             */
+            virtual ~WriteImage();
+
+            /**
+             * Get the human-readable title of this command. This should be something like "Adding Algorithm".
+             *
+             * \return the title
+             */
+            virtual std::string getName() const;
+
+            /**
+             * Get the human-readable description of this command. This is a more detailed description of what is going on, like "Adding a algorithm
+             * to the network without connecting them".
+             *
+             * \return the description
+             */
+            virtual std::string getDescription() const;
+
+            /**
+             * Get the filename specified.
+             *
+             * \return the filename
+             */
+            std::string getFilename() const;
+
+            /**
+             * Get the image to write.
+             *
+             * \return the image
+             */
+            ConstSPtr< core::RGBA8Image > getImage() const;
+
+        protected:
+        private:
+            /**
+             * The image.
+             */
+            ConstSPtr< core::RGBA8Image > m_image = nullptr;
+
+            /**
+             * The file to write.
+             */
+            std::string m_filename;
+        };
+    }
+}
+
+#endif  // DI_WRITEIMAGE_H
+
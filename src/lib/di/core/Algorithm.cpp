@@ -27,6 +27,7 @@
 
 #include <di/core/ObserverCallback.h>
 #include <di/core/ObserverParameter.h>
+#include <di/core/State.h>
 
 #include "Algorithm.h"
 
@@ -81,6 +82,11 @@ namespace di
             m_outputs.insert( output );
         }
 
+        ThreadPool& Algorithm::getThreadPool() const
+        {
+            return ThreadPool::getInstance();
+        }
+
         const std::string& Algorithm::getName() const
         {
             return m_name;
@@ -194,6 +200,16 @@ namespace di
             }
         }
 
+        State Algorithm::getResultState() const
+        {
+            return State();
+        }
+
+        void Algorithm::setResultState( const State& /* state */ )
+        {
+            // Not supported by default.
+        }
+
         std::ostream& operator<<( std::ostream& os, const Algorithm& obj )
         {
             os << obj.getInstanceInfo();
@@ -35,6 +35,7 @@
 #include <di/core/Parameter.h>
 #include <di/core/Observable.h>
 #include <di/core/ConnectorTransferable.h>
+#include <di/core/ThreadPool.h>
 
 #include <di/Types.h>
 
@@ -42,6 +43,8 @@ namespace di
 {
     namespace core
     {
+        class State;
+
         /**
          * Interface to define the basic operations of all algorithms.
          */
@@ -124,6 +127,22 @@ namespace di
              */
             virtual void setActive( bool active = true );
 
+            /**
+             * Get the results of the last run as state. Use this to embed pre-computed results into project files, allowing to skip
+             * re-computation when the project is loaded again. Algorithms not supporting this return an empty state (the default).
+             *
+             * \return the state describing the results.
+             */
+            virtual State getResultState() const;
+
+            /**
+             * Restore results previously provided by \ref getResultState. The algorithm is responsible for checking whether the results still
+             * match its inputs when it runs the next time. By default, this does nothing.
+             *
+             * \param state the result state
+             */
+            virtual void setResultState( const State& state );
+
             /**
              * Check if the given connector is a valid input of this algorithm.
              *
@@ -393,6 +412,15 @@ namespace di
              * \param parameter the parameter that notified this
              */
             virtual void onParameterChange( SPtr< ParameterBase > parameter );
+
+            /**
+             * The pool to use for parallel work in \ref process. It is shared by all algorithms, which run in parallel themselves. Use
+             * it via \ref parallelFor, \ref parallelReduce or \ref TaskGroup instead of creating threads. This avoids oversubscribing
+             * the machine.
+             *
+             * \return the shared pool
+             */
+            ThreadPool& getThreadPool() const;
         private:
             /**
              * Algorithm inputs. Fill during construction.
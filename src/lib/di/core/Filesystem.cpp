@@ -27,6 +27,16 @@
 #include <fstream>
 #include <streambuf>
 #include <stdexcept>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdio>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#endif
 
 #include "Filesystem.h"
 
@@ -63,6 +73,79 @@ namespace di
             return str;
         }
 
+        bool getFileStatus( const std::string& filename, uint64_t& size, int64_t& modificationTime )
+        {
+            struct stat info;
+            if( stat( filename.c_str(), &info ) != 0 )
+            {
+                return false;
+            }
+
+            size = static_cast< uint64_t >( info.st_size );
+#ifdef __APPLE__
+            modificationTime = static_cast< int64_t >( info.st_mtimespec.tv_sec ) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+            modificationTime = static_cast< int64_t >( info.st_mtim.tv_sec ) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+            return true;
+        }
+
+        bool makeDirectory( const std::string& path )
+        {
+            // Create each path element.
+            for( size_t separator = path.find( '/', 1 ); ; separator = path.find( '/', separator + 1 ) )
+            {
+                std::string current = path.substr( 0, separator );
+                if( !current.empty() && ( mkdir( current.c_str(), 0755 ) != 0 ) && ( errno != EEXIST ) )
+                {
+                    return false;
+                }
+
+                if( separator == std::string::npos )
+                {
+                    break;
+                }
+            }
+
+            struct stat info;
+            return ( stat( path.c_str(), &info ) == 0 ) && S_ISDIR( info.st_mode );
+        }
+
+        bool replaceFile( const std::string& source, const std::string& target )
+        {
+#ifdef _WIN32
+            return MoveFileExA( source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+#else
+            return std::rename( source.c_str(), target.c_str() ) == 0;
+#endif
+        }
+
+        std::string getCachePath()
+        {
+            std::string base;
+            const char* xdgCache = std::getenv( "XDG_CACHE_HOME" );
+            const char* home = std::getenv( "HOME" );
+            if( xdgCache && *xdgCache )
+            {
+                base = xdgCache;
+            }
+            else if( home && *home )
+            {
+                base = std::string( home ) + "/.cache";
+            }
+            else
+            {
+                return "";
+            }
+
+            std::string path = base + "/" + ResourceName + "/";
+            if( !makeDirectory( path ) )
+            {
+                return "";
+            }
+            return path;
+        }
+
         static std::string g_runtimePath = "";
 
         std::string getRuntimePath()
@@ -25,6 +25,7 @@
 #ifndef DI_FILESYSTEM_H
 #define DI_FILESYSTEM_H
 
+#include <cstdint>
 #include <string>
 
 // This file implements some utils we all love from boost::filesystem
@@ -53,6 +54,43 @@ namespace di
          */
         std::string readTextFile( const std::string& filename );
 
+        /**
+         * Query size and modification time of a file.
+         *
+         * \param filename the file
+         * \param size the size in bytes
+         * \param modificationTime the modification time in nanoseconds since epoch
+         *
+         * \return true if the file exists and could be queried.
+         */
+        bool getFileStatus( const std::string& filename, uint64_t& size, int64_t& modificationTime );
+
+        /**
+         * Create the given directory, including all missing parent directories.
+         *
+         * \param path the directory
+         *
+         * \return true if the directory exists after the call.
+         */
+        bool makeDirectory( const std::string& path );
+
+        /**
+         * Move a file to the given name. An existing file of that name is replaced, on Windows too, where std::rename refuses this.
+         *
+         * \param source the file to move
+         * \param target the new name
+         *
+         * \return true on success.
+         */
+        bool replaceFile( const std::string& source, const std::string& target );
+
+        /**
+         * The per-user cache directory of the program. Follows the XDG specification. The directory is created if needed.
+         *
+         * \return the path, guaranteed to end with a directory separator. Empty if no cache directory is available.
+         */
+        std::string getCachePath();
+
         /**
          * The runtime path of the program. Guaranteed to end with a directory separator.
          *
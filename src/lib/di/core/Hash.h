@@ -0,0 +1,83 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_HASH_H
+#define DI_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * The initial value for \ref hashBytes.
+         */
+        const uint64_t HashSeed = 14695981039346656037ull;
+
+        /**
+         * Calculate a 64 bit FNV-1a hash of the given memory. This is not a cryptographic hash. Use it to fingerprint data, for example to
+         * check whether cached results still match their input. Hashes can be chained by passing a previous hash as seed.
+         *
+         * \param data the memory to hash
+         * \param size the number of bytes
+         * \param seed the initial hash value. Use the result of a previous call to combine hashes.
+         *
+         * \return the hash
+         */
+        inline uint64_t hashBytes( const void* data, size_t size, uint64_t seed = HashSeed )
+        {
+            const unsigned char* bytes = static_cast< const unsigned char* >( data );
+            uint64_t hash = seed;
+            for( size_t i = 0; i < size; ++i )
+            {
+                hash ^= bytes[ i ];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        /**
+         * Hash the contents of a vector. The size is part of the hash.
+         *
+         * \tparam ValueType the element type. Needs to be trivially copyable and free of padding.
+         * \param values the values
+         * \param seed the initial hash value. Use the result of a previous call to combine hashes.
+         *
+         * \return the hash
+         */
+        template< typename ValueType >
+        uint64_t hashArray( const std::vector< ValueType >& values, uint64_t seed = HashSeed )
+        {
+            uint64_t size = values.size();
+            seed = hashBytes( &size, sizeof( size ), seed );
+            return hashBytes( values.data(), values.size() * sizeof( ValueType ), seed );
+        }
+    }
+}
+
+#endif  // DI_HASH_H
+
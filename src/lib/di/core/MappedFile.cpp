@@ -0,0 +1,129 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <fstream>
+#include <string>
+#include <stdexcept>
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+    #define DI_MAPPEDFILE_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+namespace di
+{
+    namespace core
+    {
+        MappedFile::MappedFile( const std::string& filename ):
+            m_filename( filename )
+        {
+#ifdef DI_MAPPEDFILE_MMAP
+            int fd = open( filename.c_str(), O_RDONLY );
+            if( fd < 0 )
+            {
+                throw std::invalid_argument( "File \"" + filename + "\" could not be opened for reading." );
+            }
+
+            struct stat info;
+            if( fstat( fd, &info ) != 0 )
+            {
+                close( fd );
+                throw std::invalid_argument( "File \"" + filename + "\" could not be queried." );
+            }
+
+            m_size = static_cast< size_t >( info.st_size );
+
+            // NOTE: mapping zero bytes is not allowed. Empty files simply have no data.
+            if( m_size > 0 )
+            {
+                void* mapped = mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+                if( mapped == MAP_FAILED )
+                {
+                    close( fd );
+                    throw std::invalid_argument( "File \"" + filename + "\" could not be mapped into memory." );
+                }
+                m_data = static_cast< const char* >( mapped );
+
+                // We read the file front to back. Let the OS know.
+                madvise( mapped, m_size, MADV_SEQUENTIAL );
+            }
+
+            // The mapping stays valid after closing the descriptor.
+            close( fd );
+#else
+            std::ifstream file( filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+            if( !file.good() )
+            {
+                throw std::invalid_argument( "File \"" + filename + "\" could not be opened for reading." );
+            }
+
+            m_buffer.resize( static_cast< size_t >( file.tellg() ) );
+            file.seekg( 0, std::ios::beg );
+            if( !file.read( m_buffer.data(), static_cast< std::streamsize >( m_buffer.size() ) ) )
+            {
+                throw std::invalid_argument( "File \"" + filename + "\" could not be read." );
+            }
+
+            m_size = m_buffer.size();
+            m_data = m_buffer.empty() ? nullptr : m_buffer.data();
+#endif
+        }
+
+        MappedFile::~MappedFile()
+        {
+#ifdef DI_MAPPEDFILE_MMAP
+            if( m_data )
+            {
+                munmap( const_cast< char* >( m_data ), m_size );
+            }
+#endif
+        }
+
+        const char* MappedFile::begin() const
+        {
+            return m_data;
+        }
+
+        const char* MappedFile::end() const
+        {
+            return m_data + m_size;
+        }
+
+        size_t MappedFile::size() const
+        {
+            return m_size;
+        }
+
+        const std::string& MappedFile::getFilename() const
+        {
+            return m_filename;
+        }
+    }
+}
+
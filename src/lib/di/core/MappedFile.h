@@ -0,0 +1,122 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MAPPEDFILE_H
+#define DI_MAPPEDFILE_H
+
+#include <string>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A read-only, memory-mapped file. This allows readers to parse large files without copying the whole file into a string first. The
+         * mapping is released on destruction. On platforms without mmap, the file is read into memory instead.
+         */
+        class MappedFile
+        {
+        public:
+            /**
+             * Map the given file into memory.
+             *
+             * \param filename the file to map
+             *
+             * \throw std::invalid_argument if the file could not be opened or mapped.
+             */
+            explicit MappedFile( const std::string& filename );
+
+            /**
+             * Destructor. Unmaps the file.
+             */
+            virtual ~MappedFile();
+
+            /**
+             * Mapped files cannot be copied.
+             */
+            MappedFile( const MappedFile& ) = delete;
+
+            /**
+             * Mapped files cannot be copied.
+             *
+             * \return this
+             */
+            MappedFile& operator=( const MappedFile& ) = delete;
+
+            /**
+             * Get the first byte of the file.
+             *
+             * \return pointer to the first byte. Might be nullptr for empty files.
+             */
+            const char* begin() const;
+
+            /**
+             * Get the byte behind the last byte of the file.
+             *
+             * \return end pointer.
+             */
+            const char* end() const;
+
+            /**
+             * The size of the file in bytes.
+             *
+             * \return the size
+             */
+            size_t size() const;
+
+            /**
+             * The name of the mapped file.
+             *
+             * \return the filename
+             */
+            const std::string& getFilename() const;
+
+        protected:
+        private:
+            /**
+             * The filename.
+             */
+            std::string m_filename = "";
+
+            /**
+             * The mapped memory. Points into \ref m_buffer if the file was read instead.
+             */
+            const char* m_data = nullptr;
+
+            /**
+             * The file contents, if the platform does not support mapping.
+             */
+            std::vector< char > m_buffer;
+
+            /**
+             * Size of the mapped memory.
+             */
+            size_t m_size = 0;
+        };
+    }
+}
+
+#endif  // DI_MAPPEDFILE_H
+
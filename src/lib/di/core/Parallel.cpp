@@ -0,0 +1,114 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include <di/core/TaskGroup.h>
+#include <di/core/ThreadPool.h>
+
+#include "Parallel.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Number of chunks per thread in \ref parallelFor. Threads finishing early take the remaining chunks, which balances uneven work.
+         */
+        static const size_t g_chunksPerThread = 8;
+
+        unsigned getNumThreads( unsigned threads )
+        {
+            if( threads == 0 )
+            {
+                threads = ThreadPool::getInstance().getNumWorkers();
+            }
+            return std::max( 1u, threads );
+        }
+
+        void parallelFor( size_t size, const std::function< void( size_t, size_t ) >& function, size_t minChunkSize, unsigned threads )
+        {
+            if( size == 0 )
+            {
+                return;
+            }
+
+            size_t numThreads = getNumThreads( threads );
+            size_t maxChunks = std::max( size_t( 1 ), size / std::max( size_t( 1 ), minChunkSize ) );
+            size_t numChunks = std::min( numThreads * g_chunksPerThread, maxChunks );
+            size_t numTasks = std::min( numThreads, numChunks );
+            if( numTasks == 1 )
+            {
+                function( 0, size );
+                return;
+            }
+
+            // Each task takes the next chunk until none is left. This limits the parallelism to numTasks and still balances the load.
+            std::atomic< size_t > nextChunk( 0 );
+            auto processChunks = [ & ]()
+            {
+                for( size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++ )
+                {
+                    function( chunk * size / numChunks, ( chunk + 1 ) * size / numChunks );
+                }
+            };
+
+            // One task runs here. Keep its exception until the others are done, as they reference this frame.
+            TaskGroup group;
+            for( size_t task = 1; task < numTasks; ++task )
+            {
+                group.run( processChunks );
+            }
+
+            std::exception_ptr error = nullptr;
+            try
+            {
+                processChunks();
+            }
+            catch( ... )
+            {
+                error = std::current_exception();
+            }
+
+            try
+            {
+                group.wait();
+            }
+            catch( ... )
+            {
+                if( !error )
+                {
+                    error = std::current_exception();
+                }
+            }
+
+            if( error )
+            {
+                std::rethrow_exception( error );
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_PARALLEL_H
+#define DI_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Get the number of threads to use for data parallel work.
+         *
+         * \param threads the requested number. 0 to use the number of workers of the shared \ref ThreadPool.
+         *
+         * \return the number of threads. At least 1.
+         */
+        unsigned getNumThreads( unsigned threads = 0 );
+
+        /**
+         * Split the range [0, size) into contiguous chunks and process them in parallel on the shared \ref ThreadPool. There are several
+         * chunks per thread, so threads that finish early take over the remaining chunks of uneven work. The calling thread processes
+         * chunks too. Returns when all chunks are done. If a chunk throws, the first exception is re-thrown after all chunks finished. Can
+         * be nested.
+         *
+         * Functions doing data parallel work pass their threads argument on to here, so it means the same everywhere: the maximum number of
+         * chunks processed at the same time, where 0 uses all workers. Their results do not depend on it.
+         *
+         * \param size the size of the range
+         * \param function called for each chunk with the begin and end of the chunk. Chunks are not processed in order.
+         * \param minChunkSize ranges smaller than this are not split. Avoids scheduling overhead for little work.
+         * \param threads the maximum number of chunks processed in parallel. 0 to use all workers of the pool.
+         */
+        void parallelFor( size_t size, const std::function< void( size_t, size_t ) >& function, size_t minChunkSize = 4096,
+                          unsigned threads = 0 );
+
+        /**
+         * Reduce the range [0, size) in parallel. The range is split into chunks of fixed size, independent of the number of threads. Each
+         * chunk is mapped to a value and the values are combined from left to right. So the result is the same for any number of threads,
+         * even if combine is not associative, like a sum of floating point values.
+         *
+         * \tparam T the type of the result
+         * \tparam MapT the type of the map function
+         * \tparam CombineT the type of the combine function
+         * \param size the size of the range
+         * \param identity the result for an empty range. Combined with the first chunk.
+         * \param map called for each chunk with the begin and end of the chunk. Returns the value of the chunk.
+         * \param combine called with two values, returns the combined value.
+         * \param chunkSize the size of the chunks
+         * \param threads the thread limit, see \ref parallelFor.
+         *
+         * \return the combined value
+         */
+        template< typename T, typename MapT, typename CombineT >
+        T parallelReduce( size_t size, const T& identity, const MapT& map, const CombineT& combine, size_t chunkSize = 4096,
+                          unsigned threads = 0 )
+        {
+            chunkSize = std::max( size_t( 1 ), chunkSize );
+            size_t numChunks = ( size + chunkSize - 1 ) / chunkSize;
+            std::vector< T > values( numChunks, identity );
+            parallelFor( numChunks,
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t chunk = begin; chunk < end; ++chunk )
+                    {
+                        values[ chunk ] = map( chunk * chunkSize, std::min( size, ( chunk + 1 ) * chunkSize ) );
+                    }
+                }, 1, threads
+            );
+
+            T result = identity;
+            for( const auto& value : values )
+            {
+                result = combine( result, value );
+            }
+            return result;
+        }
+    }
+}
+
+#endif  // DI_PARALLEL_H
+
@@ -31,6 +31,7 @@
 
 #include <di/core/ParameterBase.h>
 #include <di/core/Conversion.h>
+#include <di/core/State.h>
 
 #include <di/core/Logger.h>
 #define LogTag "core/Parameter"
@@ -170,6 +171,21 @@ namespace di
              */
             virtual void fromString( const std::string& source ) override;
 
+            /**
+             * Store the value in the given state, using the name of this parameter. The value keeps its type if the state supports it.
+             *
+             * \param state the state to store the value in
+             */
+            virtual void toState( State& state ) const override;
+
+            /**
+             * Set the value stored in the given state under the name of this parameter. Nothing happens if there is none. Might throw
+             * conversion exceptions.
+             *
+             * \param state the state to read the value from
+             */
+            virtual void fromState( const State& state ) override;
+
         protected:
         private:
             /**
@@ -318,6 +334,21 @@ namespace di
             fromParameterString( source, v );
             set( v );
         }
+
+        template< typename ValueType >
+        void Parameter< ValueType >::toState( State& state ) const
+        {
+            state.set( getName(), m_value );
+        }
+
+        template< typename ValueType >
+        void Parameter< ValueType >::fromState( const State& state )
+        {
+            if( state.isSet( getName() ) )
+            {
+                set( state.getValue< ValueType >( getName(), m_value ) );
+            }
+        }
     }
 }
 
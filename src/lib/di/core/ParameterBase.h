@@ -35,6 +35,7 @@ namespace di
     namespace core
     {
         class Observer;
+        class State;
 
         /**
          * Implements a class to handle parameters conveniently. Created by algorithms, these instances can be shared among UI and others. Changing
@@ -95,6 +96,21 @@ namespace di
              */
             virtual void fromString( const std::string& source ) = 0;
 
+            /**
+             * Store the value in the given state, using the name of this parameter. The value keeps its type if the state supports it.
+             *
+             * \param state the state to store the value in
+             */
+            virtual void toState( State& state ) const = 0;
+
+            /**
+             * Set the value stored in the given state under the name of this parameter. Nothing happens if there is none. Might throw
+             * conversion exceptions.
+             *
+             * \param state the state to read the value from
+             */
+            virtual void fromState( const State& state ) = 0;
+
         protected:
         private:
             /**
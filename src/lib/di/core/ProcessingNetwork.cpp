@@ -27,6 +27,7 @@
 #include <string>
 
 #include <di/core/Reader.h>
+#include <di/core/TaskGroup.h>
 #include <di/core/ObserverCallback.h>
 
 #include <di/commands/ReadFile.h>
@@ -127,7 +128,14 @@ namespace di
                 // Iterate parameters and store
                 for( auto param : algo->getParameters() )
                 {
-                    algoState.set( param->getName(), *param );
+                    param->toState( algoState );
+                }
+
+                // Pre-computed results, if the algorithm supports this.
+                auto resultState = algo->getResultState();
+                if( !resultState.empty() )
+                {
+                    algoState.set( "results", resultState );
                 }
 
                 // Store the algorithm state
@@ -170,7 +178,13 @@ namespace di
                     // Iterate parameters and restore
                     for( auto param : algo->getParameters() )
                     {
-                        param->fromString( algoState.getValue( param->getName(), param->toString() ) );
+                        param->fromState( algoState );
+                    }
+
+                    // Restore pre-computed results. The algorithm decides whether they match its inputs.
+                    if( algoState.isState( "results" ) )
+                    {
+                        algo->setResultState( algoState.getState( "results" ) );
                     }
                 }
             }
@@ -631,8 +645,9 @@ namespace di
             std::map< SPtr< Algorithm >, bool > dataPropagated;
             for( auto layer : executionLayers )
             {
-                // NOTE: as all algorithms in one layer are not dependent on each other, it is possible to use std::async and similar facilities here
-                // to parallelize execution. Not yet done.
+                // All algorithms in one layer are independent of each other. Run them in parallel. Decide and log here, as dataPropagated
+                // is not thread-safe.
+                TaskGroup runs;
                 for( auto algo : layer.first )
                 {
                     if( algo->isActive() && ( algo->isUpdateRequested() || dataPropagated[ algo ] ) )
@@ -641,7 +656,12 @@ namespace di
                              << " - " << *algo << " { Dirty: " << algo->isUpdateRequested() << ", Active: " << algo->isActive()
                              << ", Data: " << dataPropagated[ algo ] << " }"
                              << LogEnd;
-                        algo->run();
+                        runs.run(
+                            [ algo ]()
+                            {
+                                algo->run();
+                            }
+                        );
                     }
                     else
                     {
@@ -651,6 +671,8 @@ namespace di
                              << LogEnd;
                     }
                 }
+                // NOTE: the first exception is re-thrown and handled in CommandQueue, after all algorithms of the layer finished.
+                runs.wait();
 
                 for( auto con : layer.second )
                 {
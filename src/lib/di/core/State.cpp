@@ -22,13 +22,20 @@
 //
 //---------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ios>
 #include <map>
 #include <string>
 #include <sstream>
-#include <fstream>
-#include <regex>
+#include <vector>
+
+#include <unistd.h>
 
 #include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
 #include <di/core/StringUtils.h>
 
 #include "State.h"
@@ -37,25 +44,434 @@ namespace di
 {
     namespace core
     {
-        void State::set( const std::string& name, const State& state )
+        /**
+         * Signature of binary state files.
+         */
+        static const char g_binaryStateSignature[ 8 ] = { 'D', 'I', 'S', 'T', 'A', 'T', 'E', '\0' };
+
+        /**
+         * Version of the binary state format. Version 1 only knew string values, which are still read.
+         */
+        static const uint32_t g_binaryStateVersion = 2;
+
+        /**
+         * Alignment of blobs inside binary state files.
+         */
+        static const size_t g_binaryStateAlignment = 16;
+
+        /**
+         * Append a value to a byte buffer.
+         *
+         * \tparam ValueType the type of the value. Needs to be trivially copyable.
+         * \param buffer the buffer
+         * \param value the value
+         */
+        template< typename ValueType >
+        static void appendBinary( std::vector< uint8_t >& buffer, const ValueType& value )
+        {
+            const uint8_t* bytes = reinterpret_cast< const uint8_t* >( &value );
+            buffer.insert( buffer.end(), bytes, bytes + sizeof( ValueType ) );
+        }
+
+        /**
+         * Read a value from a mapped file and advance the position.
+         *
+         * \tparam ValueType the type of the value. Needs to be trivially copyable.
+         * \param pos the position. Advanced by the size of the value.
+         * \param end end of the mapped memory
+         *
+         * \throw std::ios_base::failure if the file is too short.
+         *
+         * \return the value
+         */
+        template< typename ValueType >
+        static ValueType readBinary( const char*& pos, const char* end )
+        {
+            if( static_cast< size_t >( end - pos ) < sizeof( ValueType ) )
+            {
+                throw std::ios_base::failure( "Unexpected end of binary state file." );
+            }
+
+            ValueType value;
+            std::memcpy( &value, pos, sizeof( ValueType ) );
+            pos += sizeof( ValueType );
+            return value;
+        }
+
+        /**
+         * Read a length-prefixed string from a mapped file and advance the position.
+         *
+         * \param pos the position. Advanced by the size of the string.
+         * \param end end of the mapped memory
+         *
+         * \throw std::ios_base::failure if the file is too short.
+         *
+         * \return the string
+         */
+        static std::string readBinaryString( const char*& pos, const char* end )
+        {
+            auto length = readBinary< uint32_t >( pos, end );
+            if( static_cast< size_t >( end - pos ) < length )
+            {
+                throw std::ios_base::failure( "Unexpected end of binary state file." );
+            }
+
+            std::string result( pos, length );
+            pos += length;
+            return result;
+        }
+
+        /**
+         * Get the interned key with the given ID.
+         *
+         * \param keys the interned keys
+         * \param id the ID
+         *
+         * \throw std::ios_base::failure if the ID is invalid.
+         *
+         * \return the key
+         */
+        static const std::string& getInternedKey( const std::vector< std::string >& keys, uint32_t id )
+        {
+            if( id >= keys.size() )
+            {
+                throw std::ios_base::failure( "Invalid key in binary state file." );
+            }
+            return keys[ id ];
+        }
+
+        /**
+         * Create a vector value from some floats.
+         *
+         * \param values the floats
+         * \param count the number of floats
+         *
+         * \return the value
+         */
+        static State::Value toVectorValue( const float* values, size_t count )
+        {
+            State::Value result;
+            result.m_type = State::Value::Type::Vector;
+            result.m_vector.assign( values, values + count );
+            return result;
+        }
+
+        /**
+         * Copy the numbers of a vector value to some floats.
+         *
+         * \param value the value
+         * \param values the target floats
+         * \param count the number of floats
+         *
+         * \return false if the value is not a vector of the given size.
+         */
+        static bool fromVectorValue( const State::Value& value, float* values, size_t count )
+        {
+            if( ( value.m_type != State::Value::Type::Vector ) || ( value.m_vector.size() != count ) )
+            {
+                return false;
+            }
+
+            for( size_t i = 0; i < count; ++i )
+            {
+                values[ i ] = static_cast< float >( value.m_vector[ i ] );
+            }
+            return true;
+        }
+
+        std::string State::Value::toString() const
+        {
+            switch( m_type )
+            {
+                case Type::Int:
+                    return di::core::toString( m_int );
+                case Type::UInt:
+                    return di::core::toString( m_uint );
+                case Type::Double:
+                    return di::core::toString( m_double );
+                case Type::Bool:
+                    return di::core::toString( m_int != 0 );
+                case Type::Vector:
+                {
+                    std::stringstream ss;
+                    for( size_t i = 0; i < m_vector.size(); ++i )
+                    {
+                        ss << ( i ? "," : "" ) << di::core::toString( m_vector[ i ] );
+                    }
+                    return ss.str();
+                }
+                default:
+                    return m_string;
+            }
+        }
+
+        State::Value State::toValue( const std::string& value )
+        {
+            Value result;
+            result.m_string = value;
+            return result;
+        }
+
+        State::Value State::toValue( const glm::vec2& value )
+        {
+            return toVectorValue( &value[ 0 ], 2 );
+        }
+
+        State::Value State::toValue( const glm::vec3& value )
+        {
+            return toVectorValue( &value[ 0 ], 3 );
+        }
+
+        State::Value State::toValue( const glm::vec4& value )
+        {
+            return toVectorValue( &value[ 0 ], 4 );
+        }
+
+        State::Value State::toValue( const glm::mat2& value )
+        {
+            return toVectorValue( &value[ 0 ][ 0 ], 4 );
+        }
+
+        State::Value State::toValue( const glm::mat3& value )
+        {
+            return toVectorValue( &value[ 0 ][ 0 ], 9 );
+        }
+
+        State::Value State::toValue( const glm::mat4& value )
+        {
+            return toVectorValue( &value[ 0 ][ 0 ], 16 );
+        }
+
+        void State::fromValue( const Value& value, std::string& result )
+        {
+            result = value.toString();
+        }
+
+        void State::fromValue( const Value& value, glm::vec2& result )
+        {
+            if( !fromVectorValue( value, &result[ 0 ], 2 ) )
+            {
+                result = di::core::fromString< glm::vec2 >( value.toString() );
+            }
+        }
+
+        void State::fromValue( const Value& value, glm::vec3& result )
+        {
+            if( !fromVectorValue( value, &result[ 0 ], 3 ) )
+            {
+                result = di::core::fromString< glm::vec3 >( value.toString() );
+            }
+        }
+
+        void State::fromValue( const Value& value, glm::vec4& result )
+        {
+            if( !fromVectorValue( value, &result[ 0 ], 4 ) )
+            {
+                result = di::core::fromString< glm::vec4 >( value.toString() );
+            }
+        }
+
+        void State::fromValue( const Value& value, glm::mat2& result )
+        {
+            if( !fromVectorValue( value, &result[ 0 ][ 0 ], 4 ) )
+            {
+                result = di::core::fromString< glm::mat2 >( value.toString() );
+            }
+        }
+
+        void State::fromValue( const Value& value, glm::mat3& result )
+        {
+            if( !fromVectorValue( value, &result[ 0 ][ 0 ], 9 ) )
+            {
+                result = di::core::fromString< glm::mat3 >( value.toString() );
+            }
+        }
+
+        void State::fromValue( const Value& value, glm::mat4& result )
+        {
+            if( !fromVectorValue( value, &result[ 0 ][ 0 ], 16 ) )
+            {
+                result = di::core::fromString< glm::mat4 >( value.toString() );
+            }
+        }
+
+        /**
+         * Append a typed value to a byte buffer.
+         *
+         * \param buffer the buffer
+         * \param value the value
+         */
+        static void appendBinaryValue( std::vector< uint8_t >& buffer, const State::Value& value )
+        {
+            appendBinary( buffer, static_cast< uint8_t >( value.m_type ) );
+            switch( value.m_type )
+            {
+                case State::Value::Type::Int:
+                    appendBinary( buffer, value.m_int );
+                    break;
+                case State::Value::Type::UInt:
+                    appendBinary( buffer, value.m_uint );
+                    break;
+                case State::Value::Type::Double:
+                    appendBinary( buffer, value.m_double );
+                    break;
+                case State::Value::Type::Bool:
+                    appendBinary( buffer, static_cast< uint8_t >( value.m_int != 0 ) );
+                    break;
+                case State::Value::Type::Vector:
+                    appendBinary( buffer, static_cast< uint32_t >( value.m_vector.size() ) );
+                    for( auto number : value.m_vector )
+                    {
+                        appendBinary( buffer, number );
+                    }
+                    break;
+                default:
+                    appendBinary( buffer, static_cast< uint32_t >( value.m_string.size() ) );
+                    buffer.insert( buffer.end(), value.m_string.begin(), value.m_string.end() );
+                    break;
+            }
+        }
+
+        /**
+         * Read a typed value from a mapped file and advance the position.
+         *
+         * \param pos the position. Advanced by the size of the value.
+         * \param end end of the mapped memory
+         *
+         * \throw std::ios_base::failure if the file is too short or the type is unknown.
+         *
+         * \return the value
+         */
+        static State::Value readBinaryValue( const char*& pos, const char* end )
+        {
+            State::Value value;
+            value.m_type = static_cast< State::Value::Type >( readBinary< uint8_t >( pos, end ) );
+            switch( value.m_type )
+            {
+                case State::Value::Type::String:
+                    value.m_string = readBinaryString( pos, end );
+                    break;
+                case State::Value::Type::Int:
+                    value.m_int = readBinary< int64_t >( pos, end );
+                    break;
+                case State::Value::Type::UInt:
+                    value.m_uint = readBinary< uint64_t >( pos, end );
+                    break;
+                case State::Value::Type::Double:
+                    value.m_double = readBinary< double >( pos, end );
+                    break;
+                case State::Value::Type::Bool:
+                    value.m_int = readBinary< uint8_t >( pos, end ) ? 1 : 0;
+                    break;
+                case State::Value::Type::Vector:
+                {
+                    auto count = readBinary< uint32_t >( pos, end );
+                    if( static_cast< size_t >( end - pos ) / sizeof( double ) < count )
+                    {
+                        throw std::ios_base::failure( "Unexpected end of binary state file." );
+                    }
+                    value.m_vector.resize( count );
+                    if( count )
+                    {
+                        std::memcpy( value.m_vector.data(), pos, count * sizeof( double ) );
+                    }
+                    pos += count * sizeof( double );
+                    break;
+                }
+                default:
+                    throw std::ios_base::failure( "Unknown value type in binary state file." );
+            }
+            return value;
+        }
+
+        void State::checkName( const std::string& name, const std::string& what )
         {
             if( name.empty() )
             {
-                throw std::runtime_error( "Cannot set state without name." );
+                throw std::runtime_error( "Cannot " + what + " without name." );
             }
 
             // is a path?
-            if( core::split( name, '/' ).size() != 1 )
+            if( name.find( '/' ) != std::string::npos )
             {
-                throw std::runtime_error( "Cannot set state with the name being a path." );
+                throw std::runtime_error( "Cannot " + what + " with the name being a path." );
             }
+        }
 
+        void State::set( const std::string& name, const State& state )
+        {
+            checkName( name, "set state" );
             m_keyStateStore[ name ] = state;
         }
 
-        const std::map< std::string, std::string >& State::get() const
+        void State::setBlob( const std::string& name, ConstSPtr< Blob > blob )
+        {
+            checkName( name, "set blob" );
+
+            BlobEntry entry;
+            entry.m_data = blob;
+            entry.m_size = blob ? blob->size() : 0;
+            m_keyBlobStore[ name ] = entry;
+        }
+
+        bool State::isBlob( const std::string& name ) const
         {
-            return m_keyValueStore;
+            return ( m_keyBlobStore.count( name ) != 0 );
+        }
+
+        size_t State::countBlobs() const
+        {
+            return m_keyBlobStore.size();
+        }
+
+        const uint8_t* State::getBlobData( const std::string& name, size_t& size ) const
+        {
+            checkName( name, "get blob" );
+
+            auto entry = m_keyBlobStore.find( name );
+            if( entry == m_keyBlobStore.end() )
+            {
+                size = 0;
+                return nullptr;
+            }
+
+            size = entry->second.m_size;
+            if( entry->second.m_data )
+            {
+                return entry->second.m_data->data();
+            }
+            if( entry->second.m_file )
+            {
+                return reinterpret_cast< const uint8_t* >( entry->second.m_file->begin() + entry->second.m_offset );
+            }
+            return nullptr;
+        }
+
+        ConstSPtr< State::Blob > State::getBlob( const std::string& name ) const
+        {
+            auto entry = m_keyBlobStore.find( name );
+            if( ( entry != m_keyBlobStore.end() ) && entry->second.m_data )
+            {
+                return entry->second.m_data;
+            }
+
+            size_t size = 0;
+            const uint8_t* data = getBlobData( name, size );
+            if( !data )
+            {
+                return nullptr;
+            }
+            return std::make_shared< Blob >( data, data + size );
+        }
+
+        std::map< std::string, std::string > State::get() const
+        {
+            std::map< std::string, std::string > result;
+            for( const auto& kv : m_keyValueStore )
+            {
+                result.insert( result.end(), std::make_pair( kv.first, kv.second.toString() ) );
+            }
+            return result;
         }
 
         bool State::isSet( const std::string& name ) const
@@ -73,9 +489,9 @@ namespace di
             return ( size() == 0 );
         }
 
-        bool State::size() const
+        size_t State::size() const
         {
-            return m_keyStateStore.size() + m_keyValueStore.size();
+            return m_keyStateStore.size() + m_keyValueStore.size() + m_keyBlobStore.size();
         }
 
         size_t State::countStates() const
@@ -88,22 +504,14 @@ namespace di
             return m_keyValueStore.size();
         }
 
-        const std::string& State::getValue( const std::string& name, const std::string& def ) const
+        std::string State::getValue( const std::string& name, const std::string& def ) const
         {
-            if( name.empty() )
-            {
-                throw std::runtime_error( "Cannot get value without name." );
-            }
-
-            // is a path?
-            if( core::split( name, '/' ).size() != 1 )
-            {
-                throw std::runtime_error( "Cannot get value with the name being a path." );
-            }
+            checkName( name, "get value" );
 
-            if( m_keyValueStore.count( name ) )
+            auto value = m_keyValueStore.find( name );
+            if( value != m_keyValueStore.end() )
             {
-                return m_keyValueStore.at( name );
+                return value->second.toString();
             }
             else
             {
@@ -113,16 +521,7 @@ namespace di
 
         State State::getState( const std::string& name ) const
         {
-            if( name.empty() )
-            {
-                throw std::runtime_error( "Cannot get value without name." );
-            }
-
-            // is a path?
-            if( core::split( name, '/' ).size() != 1 )
-            {
-                throw std::runtime_error( "Cannot get value with the name being a path." );
-            }
+            checkName( name, "get state" );
 
             if( m_keyStateStore.count( name ) == 0 )
             {
@@ -169,6 +568,11 @@ namespace di
 
         State State::fromFile( const std::string& filename )
         {
+            if( isBinaryFile( filename ) )
+            {
+                return fromBinaryFile( filename );
+            }
+
             LogD << "Loading state file \"" << filename << "\"." << LogEnd;
             auto file = core::readTextFile( filename );
 
@@ -176,25 +580,239 @@ namespace di
 
             // each line
             auto items = core::split( file );
-            for( auto line : items )
+            for( const auto& line : items )
             {
-                if( line.empty() )
+                // Our format is "path/to/key=value". Keys do not contain '=', values might.
+                size_t separator = line.find( '=' );
+                if( line.empty() || ( separator == std::string::npos ) )
                 {
                     continue;
                 }
 
-                // Ok. Split into parts:
-                std::regex rgx( "(.*)=(.*)$");
-                std::smatch match;
+                s.set( line.substr( 0, separator ), line.substr( separator + 1 ) );
+            }
+
+            return s;
+        }
 
-                // Matches our format?
-                if( std::regex_search( line, match, rgx ) )
+        void State::internKeys( std::map< std::string, uint32_t >& keys ) const
+        {
+            for( const auto& kv : m_keyValueStore )
+            {
+                keys.insert( std::make_pair( kv.first, static_cast< uint32_t >( keys.size() ) ) );
+            }
+            for( const auto& kb : m_keyBlobStore )
+            {
+                keys.insert( std::make_pair( kb.first, static_cast< uint32_t >( keys.size() ) ) );
+            }
+            for( const auto& ks : m_keyStateStore )
+            {
+                keys.insert( std::make_pair( ks.first, static_cast< uint32_t >( keys.size() ) ) );
+                ks.second.internKeys( keys );
+            }
+        }
+
+        void State::writeBinaryTree( const std::map< std::string, uint32_t >& keys, std::vector< uint8_t >& tree,
+                                     std::vector< const BlobEntry* >& blobs, uint64_t& blobOffset ) const
+        {
+            appendBinary( tree, static_cast< uint32_t >( m_keyValueStore.size() ) );
+            for( const auto& kv : m_keyValueStore )
+            {
+                appendBinary( tree, keys.at( kv.first ) );
+                appendBinaryValue( tree, kv.second );
+            }
+
+            appendBinary( tree, static_cast< uint32_t >( m_keyBlobStore.size() ) );
+            for( const auto& kb : m_keyBlobStore )
+            {
+                appendBinary( tree, keys.at( kb.first ) );
+                appendBinary( tree, blobOffset );
+                appendBinary( tree, static_cast< uint64_t >( kb.second.m_size ) );
+
+                blobs.push_back( &kb.second );
+                blobOffset += ( kb.second.m_size + g_binaryStateAlignment - 1 ) / g_binaryStateAlignment * g_binaryStateAlignment;
+            }
+
+            appendBinary( tree, static_cast< uint32_t >( m_keyStateStore.size() ) );
+            for( const auto& ks : m_keyStateStore )
+            {
+                appendBinary( tree, keys.at( ks.first ) );
+                ks.second.writeBinaryTree( keys, tree, blobs, blobOffset );
+            }
+        }
+
+        void State::toBinaryFile( const std::string& filename ) const
+        {
+            // Intern all keys. The map assigns the IDs in order of appearance.
+            std::map< std::string, uint32_t > keys;
+            internKeys( keys );
+            std::vector< const std::string* > keyTable( keys.size() );
+            for( const auto& key : keys )
+            {
+                keyTable[ key.second ] = &key.first;
+            }
+
+            // Build the header, key table and tree in memory. Blobs are written directly afterwards.
+            std::vector< uint8_t > buffer( sizeof( g_binaryStateSignature ) );
+            std::memcpy( buffer.data(), g_binaryStateSignature, sizeof( g_binaryStateSignature ) );
+            appendBinary( buffer, g_binaryStateVersion );
+            // Offset of the blob section. Known after writing the tree.
+            size_t blobSectionField = buffer.size();
+            appendBinary( buffer, static_cast< uint64_t >( 0 ) );
+            appendBinary( buffer, static_cast< uint32_t >( keyTable.size() ) );
+            for( auto key : keyTable )
+            {
+                appendBinary( buffer, static_cast< uint32_t >( key->size() ) );
+                buffer.insert( buffer.end(), key->begin(), key->end() );
+            }
+
+            std::vector< const BlobEntry* > blobs;
+            uint64_t blobOffset = 0;
+            writeBinaryTree( keys, buffer, blobs, blobOffset );
+
+            // The blob section starts aligned.
+            buffer.resize( ( buffer.size() + g_binaryStateAlignment - 1 ) / g_binaryStateAlignment * g_binaryStateAlignment, 0 );
+            uint64_t blobSection = buffer.size();
+            std::memcpy( buffer.data() + blobSectionField, &blobSection, sizeof( blobSection ) );
+
+            // Write to a temporary file first and move it in place afterwards. Lazy blobs might still be read from the file to replace.
+            std::string tempFilename = filename + ".tmp" + std::to_string( getpid() );
+            std::ofstream fs( tempFilename, std::ios::binary | std::ios::trunc );
+            if( !fs.good() )
+            {
+                throw std::ios_base::failure( "File \"" + filename + "\" could not be opened for writing." );
+            }
+            fs.write( reinterpret_cast< const char* >( buffer.data() ), buffer.size() );
+
+            // Write blobs. Use the same path as the readers to get the data. Lazy blobs are copied directly from their file.
+            const char padding[ g_binaryStateAlignment ] = { 0 };
+            for( auto blob : blobs )
+            {
+                const char* data = nullptr;
+                if( blob->m_data )
+                {
+                    data = reinterpret_cast< const char* >( blob->m_data->data() );
+                }
+                else if( blob->m_file )
+                {
+                    data = blob->m_file->begin() + blob->m_offset;
+                }
+
+                if( data )
+                {
+                    fs.write( data, blob->m_size );
+                }
+                fs.write( padding, ( g_binaryStateAlignment - blob->m_size % g_binaryStateAlignment ) % g_binaryStateAlignment );
+            }
+
+            if( !fs.good() )
+            {
+                fs.close();
+                std::remove( tempFilename.c_str() );
+                throw std::ios_base::failure( "Failed to write file \"" + filename + "\"." );
+            }
+            fs.close();
+
+            if( !replaceFile( tempFilename, filename ) )
+            {
+                std::remove( tempFilename.c_str() );
+                throw std::ios_base::failure( "Failed to move the written file to \"" + filename + "\"." );
+            }
+        }
+
+        void State::readBinaryTree( const std::vector< std::string >& keys, ConstSPtr< MappedFile > file, size_t blobSection,
+                                    State& state, const char*& pos, size_t depth )
+        {
+            if( depth > 256 )
+            {
+                throw std::ios_base::failure( "Binary state file nested too deeply." );
+            }
+
+            const char* end = file->end();
+
+            auto numValues = readBinary< uint32_t >( pos, end );
+            for( uint32_t i = 0; i < numValues; ++i )
+            {
+                const auto& key = getInternedKey( keys, readBinary< uint32_t >( pos, end ) );
+                state.m_keyValueStore[ key ] = readBinaryValue( pos, end );
+            }
+
+            // Blobs are not read here. Keep a reference into the mapped file.
+            auto numBlobs = readBinary< uint32_t >( pos, end );
+            for( uint32_t i = 0; i < numBlobs; ++i )
+            {
+                const auto& key = getInternedKey( keys, readBinary< uint32_t >( pos, end ) );
+
+                BlobEntry entry;
+                entry.m_file = file;
+                entry.m_offset = blobSection + readBinary< uint64_t >( pos, end );
+                entry.m_size = readBinary< uint64_t >( pos, end );
+                if( ( entry.m_offset > file->size() ) || ( entry.m_size > file->size() - entry.m_offset ) )
                 {
-                    s.set( match[ 1 ], match[ 2 ] );
+                    throw std::ios_base::failure( "Invalid blob in binary state file." );
                 }
+                state.m_keyBlobStore[ key ] = entry;
+            }
+
+            auto numStates = readBinary< uint32_t >( pos, end );
+            for( uint32_t i = 0; i < numStates; ++i )
+            {
+                const auto& key = getInternedKey( keys, readBinary< uint32_t >( pos, end ) );
+                readBinaryTree( keys, file, blobSection, state.m_keyStateStore[ key ], pos, depth + 1 );
             }
+        }
+
+        State State::fromBinaryFile( const std::string& filename )
+        {
+            LogD << "Loading binary state file \"" << filename << "\"." << LogEnd;
+
+            auto file = std::make_shared< MappedFile >( filename );
+            const char* pos = file->begin();
+            const char* end = file->end();
 
+            if( ( file->size() < sizeof( g_binaryStateSignature ) ) ||
+                !std::equal( g_binaryStateSignature, g_binaryStateSignature + sizeof( g_binaryStateSignature ), pos ) )
+            {
+                throw std::ios_base::failure( "File \"" + filename + "\" is not a binary state file." );
+            }
+            pos += sizeof( g_binaryStateSignature );
+
+            auto version = readBinary< uint32_t >( pos, end );
+            if( ( version == 0 ) || ( version > g_binaryStateVersion ) )
+            {
+                throw std::ios_base::failure( "File \"" + filename + "\" uses unsupported binary state version " + std::to_string( version ) +
+                                              "." );
+            }
+
+            auto blobSection = readBinary< uint64_t >( pos, end );
+
+            // Each key takes at least its length field. Check this before reserving by an unchecked count.
+            auto numKeys = readBinary< uint32_t >( pos, end );
+            if( static_cast< size_t >( end - pos ) / sizeof( uint32_t ) < numKeys )
+            {
+                throw std::ios_base::failure( "Unexpected end of binary state file." );
+            }
+            std::vector< std::string > keys;
+            keys.reserve( numKeys );
+            for( uint32_t i = 0; i < numKeys; ++i )
+            {
+                keys.push_back( readBinaryString( pos, end ) );
+            }
+
+            State s;
+            readBinaryTree( keys, file, blobSection, s, pos, 0 );
             return s;
         }
+
+        bool State::isBinaryFile( const std::string& filename )
+        {
+            std::ifstream fs( filename, std::ios::binary );
+            char signature[ sizeof( g_binaryStateSignature ) ];
+            if( !fs.read( signature, sizeof( signature ) ) )
+            {
+                return false;
+            }
+            return std::equal( signature, signature + sizeof( signature ), g_binaryStateSignature );
+        }
     }
 }
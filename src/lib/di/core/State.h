@@ -25,15 +25,20 @@
 #ifndef DI_STATE_H
 #define DI_STATE_H
 
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 #include <di/core/StringUtils.h>
 #include <di/core/Conversion.h>
 
 #include <di/GfxTypes.h>
+#include <di/Types.h>
 
 #include <di/core/Logger.h>
 #define LogTag "core/State"
@@ -42,12 +47,78 @@ namespace di
 {
     namespace core
     {
+        class MappedFile;
+
         /**
-         * Class represents a key-value pair collection that represents a state.
+         * Class represents a key-value pair collection that represents a state. Besides values and nested states, binary blobs can be stored.
+         * This is useful to embed pre-computed data into project files. Blobs are only written to binary state files (see \ref toBinaryFile).
          */
         class State
         {
         public:
+            /**
+             * The type used for binary blobs.
+             */
+            typedef std::vector< uint8_t > Blob;
+
+            /**
+             * A value. Numbers, booleans and arrays of numbers keep their type, so binary state files store them without converting to
+             * strings. All other types are stored as strings.
+             */
+            class Value
+            {
+            public:
+                /**
+                 * The kind of value. The numbers are used as type tags in binary state files. Do not change them.
+                 */
+                enum class Type: uint8_t
+                {
+                    String = 0,
+                    Int = 1,
+                    UInt = 2,
+                    Double = 3,
+                    Bool = 4,
+                    Vector = 5
+                };
+
+                /**
+                 * The kind of value.
+                 */
+                Type m_type = Type::String;
+
+                /**
+                 * The value if Type::String.
+                 */
+                std::string m_string = "";
+
+                /**
+                 * The value if Type::Int or Type::Bool.
+                 */
+                int64_t m_int = 0;
+
+                /**
+                 * The value if Type::UInt.
+                 */
+                uint64_t m_uint = 0;
+
+                /**
+                 * The value if Type::Double.
+                 */
+                double m_double = 0.0;
+
+                /**
+                 * The values if Type::Vector. Vectors, matrices and lists of numbers.
+                 */
+                std::vector< double > m_vector;
+
+                /**
+                 * Convert to string. This is the representation used in text state files.
+                 *
+                 * \return the string
+                 */
+                std::string toString() const;
+            };
+
             /**
              * Construct and empty state.
              */
@@ -79,16 +150,16 @@ namespace di
             /**
              * Check if empty.
              *
-             * \return true if no state or value is assigned.
+             * \return true if no state, value or blob is assigned.
              */
             bool empty() const;
 
             /**
-             * Sum of all states and values.
+             * Sum of all states, values and blobs.
              *
              * \return the number of assigned names.
              */
-            bool size() const;
+            size_t size() const;
 
             /**
              * The number of states assigned.
@@ -107,7 +178,8 @@ namespace di
             /**
              * Set the value of the specified key
              *
-             * \tparam ValueType the type of the value. Needs to provide << operator
+             * \tparam ValueType the type of the value. Numbers, booleans, glm vectors and matrices and lists of numbers keep their type.
+             * Others need to provide the << operator.
              * \param name name. Can be a nested name in a path.
              * \param value the value
              *
@@ -121,29 +193,28 @@ namespace di
                     throw std::runtime_error( "Cannot set value without name." );
                 }
 
-                // is a path?
-                auto names = core::split( name, '/' );
-
-                // Is a key?
-                if( names.size() == 1 )
+                // Is a key? Avoid splitting the name. This is called very often.
+                size_t separator = name.find( '/' );
+                if( separator == std::string::npos )
                 {
-                    // LogD << "Set Value: " << names[ 0 ] << LogEnd;
-                    m_keyValueStore[ name ] = di::core::toString( value );
+                    // LogD << "Set Value: " << name << LogEnd;
+                    m_keyValueStore[ name ] = toValue( value );
+                    return;
                 }
-                else
+
+                // No it is part of a path. Create as many sub-states as needed. Iterate each path element, excluding the last one (the key
+                // itself)
+                State* current = this;
+                size_t start = 0;
+                while( separator != std::string::npos )
                 {
-                    // No it is part of a path. Create as many sub-states as needed
-                    State* current = this;
-                    // Iterate each path element, excluding the last one (the key itself)
-                    for( size_t i = 0; i < names.size() - 1; ++i )
-                    {
-                        // LogD << "Create State: " << names[ i ] << "-" << current->m_keyStateStore.count( names[ i ] ) << LogEnd;
-                        current = &current->m_keyStateStore[ names[ i ] ];
-                    }
-
-                    // The last path element is the key. Set:
-                    current->set( names[ names.size() - 1 ], value );
+                    current = &current->m_keyStateStore[ name.substr( start, separator - start ) ];
+                    start = separator + 1;
+                    separator = name.find( '/', start );
                 }
+
+                // The last path element is the key. Set:
+                current->m_keyValueStore[ name.substr( start ) ] = toValue( value );
             }
 
             /**
@@ -157,11 +228,98 @@ namespace di
             void set( const std::string& name, const State& state );
 
             /**
-             * Get all key/value pairs.
+             * Add a binary blob. Blobs are not copied. Keep in mind that blobs are only stored by \ref toBinaryFile.
+             *
+             * \param name the name. Paths NOT allowed.
+             * \param blob the data
+             *
+             * \throw std::runtime_error if the name is invalid somehow (empty, is path).
+             */
+            void setBlob( const std::string& name, ConstSPtr< Blob > blob );
+
+            /**
+             * Add the contents of an array as binary blob. The values are copied byte-wise.
+             *
+             * \tparam ValueType the element type. Needs to be trivially copyable.
+             * \param name the name. Paths NOT allowed.
+             * \param values the values to store
+             *
+             * \throw std::runtime_error if the name is invalid somehow (empty, is path).
+             */
+            template< typename ValueType >
+            void setBlob( const std::string& name, const std::vector< ValueType >& values )
+            {
+                auto blob = std::make_shared< Blob >( values.size() * sizeof( ValueType ) );
+                if( !values.empty() )
+                {
+                    std::memcpy( blob->data(), values.data(), blob->size() );
+                }
+                setBlob( name, blob );
+            }
+
+            /**
+             * Check if the given name has a blob assigned.
+             *
+             * \param name the name. No path allowed.
+             *
+             * \return true if there is a blob.
+             */
+            bool isBlob( const std::string& name ) const;
+
+            /**
+             * The number of blobs.
+             *
+             * \return the number of blobs.
+             */
+            size_t countBlobs() const;
+
+            /**
+             * Get the blob with the given name. Blobs of states loaded from binary files are read lazily. Each call creates a new copy of
+             * those. Prefer the typed variant to avoid an additional copy.
+             *
+             * \param name the name. Path is not allowed.
+             *
+             * \throw std::runtime_error if the name is invalid somehow (empty, is path).
+             *
+             * \return the blob or nullptr if there is none.
+             */
+            ConstSPtr< Blob > getBlob( const std::string& name ) const;
+
+            /**
+             * Get the blob with the given name as typed array. The data is copied directly from its source to the array.
+             *
+             * \tparam ValueType the element type. Needs to be trivially copyable.
+             * \param name the name. Path is not allowed.
+             * \param values the target array. Resized accordingly.
+             *
+             * \throw std::runtime_error if the name is invalid somehow (empty, is path).
+             *
+             * \return true if the blob exists and its size matches the type.
+             */
+            template< typename ValueType >
+            bool getBlob( const std::string& name, std::vector< ValueType >& values ) const
+            {
+                size_t size = 0;
+                const uint8_t* data = getBlobData( name, size );
+                if( !data || ( size % sizeof( ValueType ) != 0 ) )
+                {
+                    return false;
+                }
+
+                values.resize( size / sizeof( ValueType ) );
+                if( size )
+                {
+                    std::memcpy( static_cast< void* >( values.data() ), data, size );
+                }
+                return true;
+            }
+
+            /**
+             * Get all key/value pairs. Values are converted to strings.
              *
              * \return the key-value-pairs
              */
-            const std::map< std::string, std::string >& get() const;
+            std::map< std::string, std::string > get() const;
 
             /**
              * Get the value at a given name as string. Returns the specified default if no value was set.
@@ -173,7 +331,7 @@ namespace di
              *
              * \return the value as string
              */
-            const std::string& getValue( const std::string& name, const std::string& def ) const;
+            std::string getValue( const std::string& name, const std::string& def ) const;
 
             /**
              * Get the value at a given name as string. Returns the specified default if no value was set.
@@ -181,22 +339,29 @@ namespace di
              * \param name the name. Path is not allowed.
              * \param def the default to return in case of errors
              *
-             * \tparam ValueType the desired type of the result. Provide some conversion for your type is available in di/core/Conversion.h
+             * \tparam ValueType the desired type of the result. Typed values are converted directly. Values stored as string need a
+             * conversion in di/core/Conversion.h.
              *
              * \throw std::runtime_error if the name is invalid somehow (empty, is path).
+             * \throw std::invalid_argument if a list of numbers is requested as single number.
              *
              * \return the value or the specified default
              */
             template< typename ValueType >
             ValueType getValue( const std::string& name, const ValueType& def ) const
             {
-                auto result = getValue( name, "" );
-                if( result.empty() )
+                checkName( name, "get value" );
+
+                auto value = m_keyValueStore.find( name );
+                if( ( value == m_keyValueStore.end() ) ||
+                    ( ( value->second.m_type == Value::Type::String ) && value->second.m_string.empty() ) )
                 {
                     return def;
                 }
 
-                return di::core::fromString< ValueType >( result );
+                ValueType result = def;
+                fromValue( value->second, result );
+                return result;
             }
 
             /**
@@ -242,17 +407,354 @@ namespace di
              */
             static State fromFile( const std::string& filename );
 
+            /**
+             * Save to a binary file. Keys are interned, so each distinct name is stored only once. Values are stored with a type tag and
+             * their native binary representation, strings length-prefixed. Blobs are stored as aligned raw data behind the state tree. Byte
+             * order is that of the host.
+             *
+             * \param filename the filename
+             *
+             * \throw std::ios_base::failure if the file could not be written.
+             */
+            void toBinaryFile( const std::string& filename ) const;
+
+            /**
+             * Load state from a binary file written by \ref toBinaryFile. The file is mapped into memory. Blobs are not read until requested.
+             *
+             * \param filename the file to load
+             *
+             * \throw std::invalid_argument if the file could not be opened.
+             * \throw std::ios_base::failure if the file is not a valid binary state file.
+             *
+             * \return the state
+             */
+            static State fromBinaryFile( const std::string& filename );
+
+            /**
+             * Check whether the given file is a binary state file.
+             *
+             * \param filename the file to check
+             *
+             * \return true if the file starts with the binary state signature.
+             */
+            static bool isBinaryFile( const std::string& filename );
+
         protected:
         private:
             /**
-             * Store each name and value as string in here.
+             * A blob. Either in memory or a reference into a mapped binary state file.
+             */
+            class BlobEntry
+            {
+            public:
+                /**
+                 * The data if in memory.
+                 */
+                ConstSPtr< Blob > m_data = nullptr;
+
+                /**
+                 * The file containing the data if not in memory.
+                 */
+                ConstSPtr< MappedFile > m_file = nullptr;
+
+                /**
+                 * Offset of the data inside the file.
+                 */
+                size_t m_offset = 0;
+
+                /**
+                 * Size of the data in bytes.
+                 */
+                size_t m_size = 0;
+            };
+
+            /**
+             * Get the raw memory of a blob.
+             *
+             * \param name the name. Path is not allowed.
+             * \param size the size of the blob in bytes
+             *
+             * \throw std::runtime_error if the name is invalid somehow (empty, is path).
+             *
+             * \return the memory or nullptr if there is no such blob.
+             */
+            const uint8_t* getBlobData( const std::string& name, size_t& size ) const;
+
+            /**
+             * Collect all names in this state and its nested states.
+             *
+             * \param keys the target. Maps each name to its index.
+             */
+            void internKeys( std::map< std::string, uint32_t >& keys ) const;
+
+            /**
+             * Serialize the state tree.
+             *
+             * \param keys the interned names
+             * \param tree the target buffer for the tree
+             * \param blobs the list of blobs in the order they are referenced in the tree
+             * \param blobOffset the offset of the next blob relative to the blob section. Incremented for each blob.
+             */
+            void writeBinaryTree( const std::map< std::string, uint32_t >& keys, std::vector< uint8_t >& tree,
+                                  std::vector< const BlobEntry* >& blobs, uint64_t& blobOffset ) const;
+
+            /**
+             * Read a state tree from a binary state file.
+             *
+             * \param keys the interned keys
+             * \param file the mapped file
+             * \param blobSection the offset of the blob section in the file
+             * \param state the state to fill
+             * \param pos the position. Advanced.
+             * \param depth the nesting depth. Used to detect broken files.
+             *
+             * \throw std::ios_base::failure if the file is invalid
              */
-            std::map< std::string, std::string > m_keyValueStore;
+            static void readBinaryTree( const std::vector< std::string >& keys, ConstSPtr< MappedFile > file, size_t blobSection,
+                                        State& state, const char*& pos, size_t depth );
+
+            /**
+             * Check whether a name is valid for direct access (not empty, not a path)
+             *
+             * \param name the name to check
+             * \param what what is accessed. Used for the error message.
+             *
+             * \throw std::runtime_error if the name is invalid somehow (empty, is path).
+             */
+            static void checkName( const std::string& name, const std::string& what );
+
+            /**
+             * Create a value of the matching type.
+             *
+             * \tparam ValueType the type of the value
+             * \param value the value
+             *
+             * \return the value
+             */
+            template< typename ValueType >
+            static Value toValue( const ValueType& value )
+            {
+                return toValue( value, std::is_arithmetic< ValueType >() );
+            }
+
+            /**
+             * \copydoc toValue
+             *
+             * \note numbers and booleans
+             */
+            template< typename ValueType >
+            static Value toValue( const ValueType& value, std::true_type )
+            {
+                Value result;
+                if( std::is_same< ValueType, bool >::value )
+                {
+                    result.m_type = Value::Type::Bool;
+                    result.m_int = value ? 1 : 0;
+                }
+                else if( std::is_floating_point< ValueType >::value )
+                {
+                    result.m_type = Value::Type::Double;
+                    result.m_double = static_cast< double >( value );
+                }
+                else if( std::is_unsigned< ValueType >::value )
+                {
+                    result.m_type = Value::Type::UInt;
+                    result.m_uint = static_cast< uint64_t >( value );
+                }
+                else
+                {
+                    result.m_type = Value::Type::Int;
+                    result.m_int = static_cast< int64_t >( value );
+                }
+                return result;
+            }
+
+            /**
+             * \copydoc toValue
+             *
+             * \note everything else is stored as string
+             */
+            template< typename ValueType >
+            static Value toValue( const ValueType& value, std::false_type )
+            {
+                return toValue( di::core::toString( value ) );
+            }
+
+            /**
+             * \copydoc toValue
+             *
+             * \note lists of numbers
+             */
+            template< typename ValueType >
+            static Value toValue( const std::vector< ValueType >& values )
+            {
+                static_assert( std::is_arithmetic< ValueType >::value, "Only lists of numbers are supported." );
+
+                Value result;
+                result.m_type = Value::Type::Vector;
+                result.m_vector.assign( values.begin(), values.end() );
+                return result;
+            }
+
+            /**
+             * \copydoc toValue
+             */
+            static Value toValue( const std::string& value );
+
+            /**
+             * \copydoc toValue
+             */
+            static Value toValue( const glm::vec2& value );
+
+            /**
+             * \copydoc toValue
+             */
+            static Value toValue( const glm::vec3& value );
+
+            /**
+             * \copydoc toValue
+             */
+            static Value toValue( const glm::vec4& value );
+
+            /**
+             * \copydoc toValue
+             */
+            static Value toValue( const glm::mat2& value );
+
+            /**
+             * \copydoc toValue
+             */
+            static Value toValue( const glm::mat3& value );
+
+            /**
+             * \copydoc toValue
+             */
+            static Value toValue( const glm::mat4& value );
+
+            /**
+             * Convert a value to the given type. Values stored as string are parsed using di/core/Conversion.h.
+             *
+             * \tparam ValueType the target type
+             * \param value the value
+             * \param result the target
+             *
+             * \throw std::invalid_argument if the value cannot be converted.
+             */
+            template< typename ValueType >
+            static void fromValue( const Value& value, ValueType& result )
+            {
+                fromValue( value, result, std::is_arithmetic< ValueType >() );
+            }
+
+            /**
+             * \copydoc fromValue
+             *
+             * \note numbers and booleans
+             */
+            template< typename ValueType >
+            static void fromValue( const Value& value, ValueType& result, std::true_type )
+            {
+                switch( value.m_type )
+                {
+                    case Value::Type::Int:
+                    case Value::Type::Bool:
+                        result = static_cast< ValueType >( value.m_int );
+                        break;
+                    case Value::Type::UInt:
+                        result = static_cast< ValueType >( value.m_uint );
+                        break;
+                    case Value::Type::Double:
+                        result = static_cast< ValueType >( value.m_double );
+                        break;
+                    case Value::Type::String:
+                        result = di::core::fromString< ValueType >( value.m_string );
+                        break;
+                    default:
+                        throw std::invalid_argument( "Cannot convert a list of numbers to a single number." );
+                }
+            }
+
+            /**
+             * \copydoc fromValue
+             *
+             * \note everything else is parsed from its string representation
+             */
+            template< typename ValueType >
+            static void fromValue( const Value& value, ValueType& result, std::false_type )
+            {
+                result = di::core::fromString< ValueType >( value.toString() );
+            }
+
+            /**
+             * \copydoc fromValue
+             *
+             * \note lists of numbers
+             */
+            template< typename ValueType >
+            static void fromValue( const Value& value, std::vector< ValueType >& result )
+            {
+                if( value.m_type != Value::Type::Vector )
+                {
+                    result = di::core::fromStringAsVector< ValueType >( value.toString() );
+                    return;
+                }
+
+                result.resize( value.m_vector.size() );
+                for( size_t i = 0; i < value.m_vector.size(); ++i )
+                {
+                    result[ i ] = static_cast< ValueType >( value.m_vector[ i ] );
+                }
+            }
+
+            /**
+             * \copydoc fromValue
+             */
+            static void fromValue( const Value& value, std::string& result );
+
+            /**
+             * \copydoc fromValue
+             */
+            static void fromValue( const Value& value, glm::vec2& result );
+
+            /**
+             * \copydoc fromValue
+             */
+            static void fromValue( const Value& value, glm::vec3& result );
+
+            /**
+             * \copydoc fromValue
+             */
+            static void fromValue( const Value& value, glm::vec4& result );
+
+            /**
+             * \copydoc fromValue
+             */
+            static void fromValue( const Value& value, glm::mat2& result );
+
+            /**
+             * \copydoc fromValue
+             */
+            static void fromValue( const Value& value, glm::mat3& result );
+
+            /**
+             * \copydoc fromValue
+             */
+            static void fromValue( const Value& value, glm::mat4& result );
+
+            /**
+             * Store each name and value in here.
+             */
+            std::map< std::string, Value > m_keyValueStore;
 
             /**
              * Handle states separately.
              */
             std::map< std::string, State > m_keyStateStore;
+
+            /**
+             * Binary blobs.
+             */
+            std::map< std::string, BlobEntry > m_keyBlobStore;
         };
 
         /**
@@ -0,0 +1,224 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "TaskGroup.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * The tasks of a group that did not start yet.
+         */
+        struct TaskGroupQueue
+        {
+            /**
+             * The tasks. Taken from the front.
+             */
+            std::deque< ThreadPool::Task > m_tasks;
+
+            /**
+             * Protects \ref m_tasks.
+             */
+            std::mutex m_mutex;
+        };
+
+        /**
+         * Take the oldest task from the queue.
+         *
+         * \param queue the queue
+         * \param task the task, if there was one
+         *
+         * \return true if a task was taken.
+         */
+        static bool popTask( TaskGroupQueue& queue, ThreadPool::Task& task )
+        {
+            std::lock_guard< std::mutex > lock( queue.m_mutex );
+            if( queue.m_tasks.empty() )
+            {
+                return false;
+            }
+            task = std::move( queue.m_tasks.front() );
+            queue.m_tasks.pop_front();
+            return true;
+        }
+
+        TaskGroup::TaskGroup( ThreadPool& pool ):
+            m_pool( pool ),
+            m_queue( std::make_shared< TaskGroupQueue >() )
+        {
+        }
+
+        TaskGroup::~TaskGroup()
+        {
+            m_pool.waitUntil(
+                [ this ]()
+                {
+                    return isDone();
+                },
+                [ this ]()
+                {
+                    return runQueuedTask();
+                }
+            );
+        }
+
+        void TaskGroup::run( ThreadPool::Task task )
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                ++m_numPending;
+            }
+            submit( std::move( task ) );
+        }
+
+        void TaskGroup::then( ThreadPool::Task continuation )
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                if( m_numPending > 0 )
+                {
+                    m_continuations.push_back( std::move( continuation ) );
+                    return;
+                }
+                ++m_numPending;
+            }
+            submit( std::move( continuation ) );
+        }
+
+        void TaskGroup::wait()
+        {
+            m_pool.waitUntil(
+                [ this ]()
+                {
+                    return isDone();
+                },
+                [ this ]()
+                {
+                    return runQueuedTask();
+                }
+            );
+
+            std::exception_ptr error = nullptr;
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                std::swap( error, m_error );
+            }
+            if( error )
+            {
+                std::rethrow_exception( error );
+            }
+        }
+
+        bool TaskGroup::isDone() const
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            return m_numPending == 0;
+        }
+
+        void TaskGroup::execute( const ThreadPool::Task& task )
+        {
+            std::exception_ptr error = nullptr;
+            try
+            {
+                task();
+            }
+            catch( ... )
+            {
+                error = std::current_exception();
+            }
+
+            // The group might be destroyed as soon as the count drops to zero. Do not touch it afterwards.
+            auto& pool = m_pool;
+            std::vector< ThreadPool::Task > continuations;
+            bool done = false;
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                if( error && !m_error )
+                {
+                    m_error = error;
+                }
+
+                if( m_numPending == 1 )
+                {
+                    // Hand over the count to the continuations, so the group does not look finished in between.
+                    std::swap( continuations, m_continuations );
+                    m_numPending = continuations.size();
+                }
+                else
+                {
+                    --m_numPending;
+                }
+                done = ( m_numPending == 0 );
+            }
+
+            for( auto& continuation : continuations )
+            {
+                submit( std::move( continuation ) );
+            }
+            if( done )
+            {
+                pool.notifyWaiting();
+            }
+        }
+
+        bool TaskGroup::runQueuedTask()
+        {
+            ThreadPool::Task task;
+            if( !popTask( *m_queue, task ) )
+            {
+                return false;
+            }
+            execute( task );
+            return true;
+        }
+
+        void TaskGroup::submit( ThreadPool::Task task )
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_queue->m_mutex );
+                m_queue->m_tasks.push_back( std::move( task ) );
+            }
+
+            // The pool task takes one task of the group. It finds none if the waiting thread was faster. The group might be gone then, so
+            // only touch it if there was a task, which keeps the group alive.
+            auto queue = m_queue;
+            m_pool.submit(
+                [ this, queue ]()
+                {
+                    ThreadPool::Task task;
+                    if( popTask( *queue, task ) )
+                    {
+                        execute( task );
+                    }
+                }
+            );
+        }
+    }
+}
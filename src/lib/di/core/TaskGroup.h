@@ -0,0 +1,158 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_TASKGROUP_H
+#define DI_TASKGROUP_H
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <di/core/ThreadPool.h>
+
+namespace di
+{
+    namespace core
+    {
+        struct TaskGroupQueue;
+
+        /**
+         * A set of tasks executed by a \ref ThreadPool, which can be waited for as a whole. Continuations registered with \ref then run
+         * after all tasks added before them finished. So dependent steps can be queued without blocking a thread. The first exception
+         * thrown by any task or continuation is re-thrown by \ref wait. While waiting, threads outside the pool only execute tasks of this
+         * group.
+         *
+         * \code
+         * TaskGroup group;
+         * group.run( loadA );
+         * group.run( loadB );
+         * group.then( merge ); // after loadA and loadB
+         * group.wait();        // after merge
+         * \endcode
+         */
+        class TaskGroup
+        {
+        public:
+            /**
+             * Create an empty group.
+             *
+             * \param pool the pool to execute the tasks. Needs to outlive the group.
+             */
+            explicit TaskGroup( ThreadPool& pool = ThreadPool::getInstance() );
+
+            /**
+             * Destructor. Waits for all tasks. Exceptions are dropped here, so call \ref wait to get them.
+             */
+            virtual ~TaskGroup();
+
+            /**
+             * Add a task. It is executed as soon as a thread is free.
+             *
+             * \param task the task
+             */
+            void run( ThreadPool::Task task );
+
+            /**
+             * Add a continuation. It runs when all tasks and continuations of this group that are not yet finished are done. If there are
+             * none, it runs right away, like \ref run. Continuations added while others are waiting run together with them. Continuations
+             * can add further tasks and continuations to the group.
+             *
+             * \param continuation the continuation
+             */
+            void then( ThreadPool::Task continuation );
+
+            /**
+             * Wait until all tasks and continuations are finished. The calling thread helps executing tasks meanwhile.
+             *
+             * \throw the first exception thrown by a task or continuation since the last wait. The group can be used further.
+             */
+            void wait();
+
+            /**
+             * Check whether all tasks and continuations are finished.
+             *
+             * \return true if nothing is pending.
+             */
+            bool isDone() const;
+
+        protected:
+        private:
+            /**
+             * Execute a task of this group and mark it as finished. Starts the continuations if it was the last one.
+             *
+             * \param task the task
+             */
+            void execute( const ThreadPool::Task& task );
+
+            /**
+             * Submit a task of this group to the pool. It needs to be counted in \ref m_numPending already.
+             *
+             * \param task the task
+             */
+            void submit( ThreadPool::Task task );
+
+            /**
+             * Execute one task of this group that did not start yet, if there is one.
+             *
+             * \return true if a task was executed.
+             */
+            bool runQueuedTask();
+
+            /**
+             * The pool executing the tasks.
+             */
+            ThreadPool& m_pool;
+
+            /**
+             * Protects the members below.
+             */
+            mutable std::mutex m_mutex;
+
+            /**
+             * The number of tasks and continuations submitted and not yet finished.
+             */
+            size_t m_numPending = 0;
+
+            /**
+             * Continuations waiting for \ref m_numPending to drop to zero.
+             */
+            std::vector< ThreadPool::Task > m_continuations;
+
+            /**
+             * The first exception thrown since the last \ref wait.
+             */
+            std::exception_ptr m_error = nullptr;
+
+            /**
+             * The tasks submitted but not yet started. Whoever takes them first executes them, a pool worker or the thread waiting for the
+             * group. Shared with the tasks queued in the pool, which can outlive the group.
+             */
+            std::shared_ptr< TaskGroupQueue > m_queue;
+        };
+    }
+}
+
+#endif  // DI_TASKGROUP_H
+
@@ -0,0 +1,361 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <thread>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ThreadPool.h"
+
+#include "Logger.h"
+#define LogTag "core/ThreadPool"
+
+/**
+ * Protects the configuration of the shared instance.
+ */
+static std::mutex g_configurationMutex;
+
+/**
+ * The number of workers of the shared instance.
+ */
+static unsigned g_configuredWorkers = 0;
+
+/**
+ * Pin the workers of the shared instance.
+ */
+static bool g_configuredPinning = false;
+
+/**
+ * True as soon as the shared instance exists. It cannot be configured anymore then.
+ */
+static bool g_instanceCreated = false;
+
+/**
+ * The pool the calling thread is a worker of. nullptr for other threads.
+ */
+static thread_local di::core::ThreadPool* g_currentPool = nullptr;
+
+/**
+ * The index of the calling thread in \ref g_currentPool.
+ */
+static thread_local size_t g_currentWorker = 0;
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A worker thread and its task queue.
+         */
+        struct ThreadPoolWorker
+        {
+            /**
+             * The tasks submitted by this worker. It takes them from the back, thieves from the front.
+             */
+            std::deque< ThreadPool::Task > m_tasks;
+
+            /**
+             * Protects \ref m_tasks.
+             */
+            std::mutex m_tasksMutex;
+
+            /**
+             * The thread.
+             */
+            std::thread m_thread;
+        };
+
+        /**
+         * Create the shared instance with the current configuration.
+         *
+         * \return the pool
+         */
+        static ThreadPool* createInstance()
+        {
+            std::lock_guard< std::mutex > lock( g_configurationMutex );
+            g_instanceCreated = true;
+            return new ThreadPool( g_configuredWorkers, g_configuredPinning );
+        }
+
+        bool ThreadPool::configure( unsigned numWorkers, bool pinWorkers )
+        {
+            std::lock_guard< std::mutex > lock( g_configurationMutex );
+            if( g_instanceCreated )
+            {
+                return false;
+            }
+            g_configuredWorkers = numWorkers;
+            g_configuredPinning = pinWorkers;
+            return true;
+        }
+
+        ThreadPool& ThreadPool::getInstance()
+        {
+            static std::unique_ptr< ThreadPool > pool( createInstance() );
+            return *pool;
+        }
+
+        ThreadPool::ThreadPool( unsigned numWorkers, bool pinWorkers ):
+            m_numPending( 0 )
+        {
+            unsigned numCPUs = std::max( 1u, std::thread::hardware_concurrency() );
+            if( numWorkers == 0 )
+            {
+                numWorkers = numCPUs;
+            }
+
+            for( unsigned index = 0; index < numWorkers; ++index )
+            {
+                m_workers.emplace_back( new ThreadPoolWorker );
+            }
+
+            // Start after all queues exist. The workers steal from each other right away.
+            for( unsigned index = 0; index < numWorkers; ++index )
+            {
+                auto& thread = m_workers[ index ]->m_thread;
+                thread = std::thread( &ThreadPool::work, this, index );
+#ifdef __linux__
+                if( pinWorkers )
+                {
+                    cpu_set_t cpus;
+                    CPU_ZERO( &cpus );
+                    CPU_SET( index % numCPUs, &cpus );
+                    if( pthread_setaffinity_np( thread.native_handle(), sizeof( cpu_set_t ), &cpus ) != 0 )
+                    {
+                        LogW << "Could not pin worker " << index << " to CPU " << index % numCPUs << "." << LogEnd;
+                    }
+                }
+#else
+                if( pinWorkers && ( index == 0 ) )
+                {
+                    LogW << "Pinning workers is not supported on this platform." << LogEnd;
+                }
+#endif
+            }
+
+            LogD << "Started " << numWorkers << " workers." << LogEnd;
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_sleepMutex );
+                m_stop = true;
+            }
+            m_wakeUp.notify_all();
+
+            for( auto& worker : m_workers )
+            {
+                worker->m_thread.join();
+            }
+        }
+
+        unsigned ThreadPool::getNumWorkers() const
+        {
+            return static_cast< unsigned >( m_workers.size() );
+        }
+
+        void ThreadPool::submit( Task task )
+        {
+            // Count before the task can be taken. Otherwise, the count could drop below zero. Count under the lock. Otherwise, a thread
+            // could check the count and go to sleep right before the notification.
+            {
+                std::lock_guard< std::mutex > lock( m_sleepMutex );
+                ++m_numPending;
+            }
+
+            if( g_currentPool == this )
+            {
+                auto& worker = *m_workers[ g_currentWorker ];
+                std::lock_guard< std::mutex > lock( worker.m_tasksMutex );
+                worker.m_tasks.push_back( std::move( task ) );
+            }
+            else
+            {
+                std::lock_guard< std::mutex > lock( m_injectedTasksMutex );
+                m_injectedTasks.push_back( std::move( task ) );
+            }
+            m_wakeUp.notify_one();
+        }
+
+        bool ThreadPool::runPendingTask()
+        {
+            Task task;
+            if( !popTask( task ) )
+            {
+                return false;
+            }
+            execute( task );
+            return true;
+        }
+
+        void ThreadPool::waitUntil( const std::function< bool() >& done, const std::function< bool() >& runOwnTask )
+        {
+            // Threads outside the pool only help with their own tasks. Any other task, like a whole algorithm run, could block them for
+            // long.
+            bool isWorker = ( g_currentPool == this );
+            Task task;
+            while( !done() )
+            {
+                if( runOwnTask && runOwnTask() )
+                {
+                    continue;
+                }
+
+                if( isWorker && popTask( task ) )
+                {
+                    execute( task );
+                    task = nullptr;
+                    continue;
+                }
+
+                std::unique_lock< std::mutex > lock( m_sleepMutex );
+                if( isWorker )
+                {
+                    m_wakeUp.wait( lock,
+                        [ & ]()
+                        {
+                            return done() || ( m_numPending > 0 );
+                        }
+                    );
+                }
+                else
+                {
+                    m_waiterWakeUp.wait( lock, done );
+                }
+            }
+
+            // The notification that woke this thread might have been meant for a new task. Pass it on.
+            if( isWorker && ( m_numPending > 0 ) )
+            {
+                m_wakeUp.notify_one();
+            }
+        }
+
+        void ThreadPool::notifyWaiting()
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_sleepMutex );
+            }
+            m_wakeUp.notify_all();
+            m_waiterWakeUp.notify_all();
+        }
+
+        void ThreadPool::work( size_t index )
+        {
+            g_currentPool = this;
+            g_currentWorker = index;
+
+            Task task;
+            while( true )
+            {
+                if( popTask( task ) )
+                {
+                    execute( task );
+                    task = nullptr;
+                    continue;
+                }
+
+                std::unique_lock< std::mutex > lock( m_sleepMutex );
+                m_wakeUp.wait( lock,
+                    [ & ]()
+                    {
+                        return m_stop || ( m_numPending > 0 );
+                    }
+                );
+                if( m_stop && ( m_numPending == 0 ) )
+                {
+                    return;
+                }
+            }
+        }
+
+        bool ThreadPool::popTask( Task& task )
+        {
+            bool isWorker = ( g_currentPool == this );
+            if( isWorker )
+            {
+                auto& worker = *m_workers[ g_currentWorker ];
+                std::lock_guard< std::mutex > lock( worker.m_tasksMutex );
+                if( !worker.m_tasks.empty() )
+                {
+                    task = std::move( worker.m_tasks.back() );
+                    worker.m_tasks.pop_back();
+                    --m_numPending;
+                    return true;
+                }
+            }
+
+            {
+                std::lock_guard< std::mutex > lock( m_injectedTasksMutex );
+                if( !m_injectedTasks.empty() )
+                {
+                    task = std::move( m_injectedTasks.front() );
+                    m_injectedTasks.pop_front();
+                    --m_numPending;
+                    return true;
+                }
+            }
+
+            // Steal the oldest task of another worker. Those are usually the largest.
+            size_t first = isWorker ? g_currentWorker + 1 : 0;
+            for( size_t i = 0; i < m_workers.size(); ++i )
+            {
+                auto& victim = *m_workers[ ( first + i ) % m_workers.size() ];
+                std::lock_guard< std::mutex > lock( victim.m_tasksMutex );
+                if( !victim.m_tasks.empty() )
+                {
+                    task = std::move( victim.m_tasks.front() );
+                    victim.m_tasks.pop_front();
+                    --m_numPending;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void ThreadPool::execute( const Task& task )
+        {
+            try
+            {
+                task();
+            }
+            catch( const std::exception& e )
+            {
+                LogE << "Uncaught exception in task: " << e.what() << LogEnd;
+            }
+            catch( ... )
+            {
+                LogE << "Uncaught exception in task." << LogEnd;
+            }
+        }
+    }
+}
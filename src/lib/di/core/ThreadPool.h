@@ -0,0 +1,197 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_THREADPOOL_H
+#define DI_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        struct ThreadPoolWorker;
+
+        /**
+         * A pool of worker threads executing tasks. Each worker has its own queue. Tasks submitted by a worker go to its own queue and are
+         * taken from there in LIFO order, which keeps nested work local. Idle workers steal the oldest tasks of the others. Tasks
+         * submitted from outside the pool are queued separately and taken by any worker.
+         *
+         * Workers waiting for tasks via \ref waitUntil execute pending tasks meanwhile. So nested parallelism cannot deadlock and does not
+         * need more threads than the workers. Other threads waiting, like the GL thread, only help with their own tasks. They never pick up
+         * unrelated work, which could take arbitrarily long. Use the shared instance, \ref getInstance, to avoid oversubscribing the machine. See
+         * \ref TaskGroup and \ref parallelFor for the usual ways to use the pool.
+         */
+        class ThreadPool
+        {
+        public:
+            /**
+             * A task.
+             */
+            typedef std::function< void() > Task;
+
+            /**
+             * Configure the shared instance. Only possible before it is used the first time.
+             *
+             * \param numWorkers the number of worker threads. 0 to use the number of hardware threads.
+             * \param pinWorkers if true, each worker is bound to one CPU. Only supported on Linux.
+             *
+             * \return false if the shared instance already exists. The configuration is ignored then.
+             */
+            static bool configure( unsigned numWorkers, bool pinWorkers = false );
+
+            /**
+             * The shared instance. Created on first use.
+             *
+             * \return the pool
+             */
+            static ThreadPool& getInstance();
+
+            /**
+             * Create a pool and start the workers.
+             *
+             * \param numWorkers the number of worker threads. 0 to use the number of hardware threads.
+             * \param pinWorkers if true, each worker is bound to one CPU. Only supported on Linux.
+             */
+            explicit ThreadPool( unsigned numWorkers = 0, bool pinWorkers = false );
+
+            /**
+             * Destructor. Executes all pending tasks and stops the workers.
+             */
+            virtual ~ThreadPool();
+
+            /**
+             * The number of worker threads.
+             *
+             * \return the number of workers. At least 1.
+             */
+            unsigned getNumWorkers() const;
+
+            /**
+             * Queue a task. Exceptions escaping the task are logged and dropped. Use \ref TaskGroup to get them.
+             *
+             * \param task the task
+             */
+            void submit( Task task );
+
+            /**
+             * Execute one pending task in the calling thread, if there is one.
+             *
+             * \return true if a task was executed.
+             */
+            bool runPendingTask();
+
+            /**
+             * Execute pending tasks until the given condition holds. Blocks while there is nothing to do. Whoever makes the condition true
+             * needs to call \ref notifyWaiting afterwards. Only workers of this pool execute any pending task. Other threads only execute
+             * tasks provided by runOwnTask.
+             *
+             * \param done the condition. Needs to be thread-safe.
+             * \param runOwnTask executes one of the tasks the caller waits for, if there is one left. Returns false if there was none. Can be
+             * nullptr.
+             */
+            void waitUntil( const std::function< bool() >& done, const std::function< bool() >& runOwnTask = nullptr );
+
+            /**
+             * Wake all threads in \ref waitUntil to check their condition.
+             */
+            void notifyWaiting();
+
+        protected:
+        private:
+            /**
+             * The loop of a worker thread.
+             *
+             * \param index the index of the worker
+             */
+            void work( size_t index );
+
+            /**
+             * Take a pending task. Prefers the queue of the calling worker, then tasks submitted from outside, then steals.
+             *
+             * \param task the task, if found
+             *
+             * \return true if a task was found.
+             */
+            bool popTask( Task& task );
+
+            /**
+             * Execute a task and catch its exceptions.
+             *
+             * \param task the task
+             */
+            void execute( const Task& task );
+
+            /**
+             * The workers.
+             */
+            std::vector< std::unique_ptr< ThreadPoolWorker > > m_workers;
+
+            /**
+             * Tasks submitted from outside the pool.
+             */
+            std::deque< Task > m_injectedTasks;
+
+            /**
+             * Protects \ref m_injectedTasks.
+             */
+            std::mutex m_injectedTasksMutex;
+
+            /**
+             * The number of queued tasks in all queues.
+             */
+            std::atomic< size_t > m_numPending;
+
+            /**
+             * Idle and waiting threads sleep on \ref m_wakeUp with this mutex.
+             */
+            std::mutex m_sleepMutex;
+
+            /**
+             * Signaled on new tasks, on \ref notifyWaiting and on shutdown.
+             */
+            std::condition_variable m_wakeUp;
+
+            /**
+             * Threads outside the pool, waiting in \ref waitUntil, sleep on this. Signaled on \ref notifyWaiting only. New tasks do not
+             * concern them, and a notification for a new task must not get lost on them.
+             */
+            std::condition_variable m_waiterWakeUp;
+
+            /**
+             * Set on destruction. Guarded by \ref m_sleepMutex.
+             */
+            bool m_stop = false;
+        };
+    }
+}
+
+#endif  // DI_THREADPOOL_H
+
@@ -22,12 +22,41 @@
 //
 //---------------------------------------------------------------------------------------
 
+#include <di/core/Observable.h>
+#include <di/core/Observer.h>
+
 #include "Visualization.h"
 
 namespace di
 {
     namespace core
     {
+        /**
+         * Distributes the render requests of all visualizations.
+         */
+        class RenderRequestNotifier: public Observable
+        {
+        public:
+            /**
+             * Get the notifier instance.
+             *
+             * \return the instance
+             */
+            static RenderRequestNotifier& getInstance()
+            {
+                static RenderRequestNotifier notifier;
+                return notifier;
+            }
+
+            /**
+             * Notify all observers.
+             */
+            void notify() override
+            {
+                Observable::notify();
+            }
+        };
+
         Visualization::Visualization()
         {
             // nothing to do
@@ -47,16 +76,25 @@ namespace di
 
         void Visualization::renderRequest()
         {
-            // This is a temporary solution. This will be replaced with a push-based approach soon.
             m_renderingRequested.store( true );
+            RenderRequestNotifier::getInstance().notify();
         }
 
         void Visualization::resetRenderingRequest()
         {
-            // This is a temporary solution. This will be replaced with a push-based approach soon.
             m_renderingRequested.store( false );
         }
 
+        void Visualization::observeRenderRequests( SPtr< Observer > observer )
+        {
+            RenderRequestNotifier::getInstance().observe( observer );
+        }
+
+        void Visualization::removeRenderRequestObserver( SPtr< Observer > observer )
+        {
+            RenderRequestNotifier::getInstance().removeObserver( observer );
+        }
+
         bool Visualization::isRenderingRequested() const
         {
             return m_renderingRequested.load();
@@ -69,7 +107,10 @@ namespace di
 
         void Visualization::setRenderingActive( bool active )
         {
-            m_renderingActive.store( active );
+            if( m_renderingActive.exchange( active ) != active )
+            {
+                RenderRequestNotifier::getInstance().notify();
+            }
         }
     }
 }
@@ -36,6 +36,7 @@ namespace di
     namespace core
     {
         class View;
+        class Observer;
 
         /**
          * Interface to define the basic operations of all visualizations. If your algorithm wants to output graphics, derive from this class and
@@ -92,10 +93,28 @@ namespace di
 
             /**
              * Request an update of the rendering. Since the rendering system is not permanently updating/rendering, this is needed to force a
-             * wake-up.
+             * wake-up. All render request observers get notified.
+             *
+             * \note can be called from any thread.
              */
             virtual void renderRequest();
 
+            /**
+             * Get notified whenever a visualization requests rendering or gets (de-)activated. Views use this to redraw on demand only.
+             *
+             * \note the observer is called in the thread that issued the request.
+             *
+             * \param observer the observer
+             */
+            static void observeRenderRequests( SPtr< Observer > observer );
+
+            /**
+             * Stop notifying the given observer.
+             *
+             * \param observer the observer to remove
+             */
+            static void removeRenderRequestObserver( SPtr< Observer > observer );
+
             /**
              * Is an update()/render() cycle requested?
              *
@@ -111,7 +130,8 @@ namespace di
             bool isRenderingActive() const;
 
             /**
-             * Change rendering state of this visualization. If set to true, the visualization is active and gets drawn.
+             * Change rendering state of this visualization. If set to true, the visualization is active and gets drawn. Notifies the render
+             * request observers on change.
              *
              * \param active draw this visualization.
              */
@@ -0,0 +1,220 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_ARRAYVIEW_H
+#define DI_ARRAYVIEW_H
+
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A typed, non-owning view onto a contiguous array of elements. Use this to hand out (parts of) attribute arrays without copying them.
+         * The view does not keep the data alive. Ensure that the owner (usually a ConstSPtr to the attribute array) outlives the view.
+         *
+         * \tparam ValueT the element type. Use a const type for read-only views.
+         */
+        template< typename ValueT >
+        class ArrayView
+        {
+        public:
+            /**
+             * The type of each element.
+             */
+            typedef ValueT value_type;
+
+            /**
+             * Iterator type. As the data is contiguous, this is a plain pointer.
+             */
+            typedef ValueT* iterator;
+
+            /**
+             * Const iterator type.
+             */
+            typedef const ValueT* const_iterator;
+
+            /**
+             * Create an empty view.
+             */
+            ArrayView() = default;
+
+            /**
+             * Create a view on the given memory.
+             *
+             * \param data pointer to the first element
+             * \param size number of elements
+             */
+            ArrayView( ValueT* data, size_t size ):
+                m_data( data ),
+                m_size( size )
+            {
+            }
+
+            /**
+             * Create a view on the whole vector. The vector must not be resized during the lifetime of the view.
+             *
+             * \param vector the vector to view
+             */
+            ArrayView( std::vector< typename std::remove_const< ValueT >::type >& vector ): // NOLINT - implicit conversion is intended
+                m_data( vector.data() ),
+                m_size( vector.size() )
+            {
+            }
+
+            /**
+             * Create a read-only view on the whole vector. Only available for views of const elements.
+             *
+             * \tparam VectorValueT the element type of the vector.
+             * \param vector the vector to view
+             */
+            template< typename VectorValueT,
+                      typename = typename std::enable_if< std::is_const< ValueT >::value &&
+                                                          std::is_same< const VectorValueT, ValueT >::value >::type >
+            ArrayView( const std::vector< VectorValueT >& vector ): // NOLINT - implicit conversion is intended
+                m_data( vector.data() ),
+                m_size( vector.size() )
+            {
+            }
+
+            /**
+             * Get the pointer to the first element.
+             *
+             * \return the data pointer. Might be nullptr for empty views.
+             */
+            ValueT* data() const
+            {
+                return m_data;
+            }
+
+            /**
+             * The number of elements in this view.
+             *
+             * \return the size
+             */
+            size_t size() const
+            {
+                return m_size;
+            }
+
+            /**
+             * Check for emptiness.
+             *
+             * \return true if there are no elements in the view.
+             */
+            bool empty() const
+            {
+                return ( m_size == 0 );
+            }
+
+            /**
+             * Iterator to the first element.
+             *
+             * \return the iterator
+             */
+            iterator begin() const
+            {
+                return m_data;
+            }
+
+            /**
+             * Iterator behind the last element.
+             *
+             * \return the iterator
+             */
+            iterator end() const
+            {
+                return m_data + m_size;
+            }
+
+            /**
+             * Access an element without range check.
+             *
+             * \param index the element index
+             *
+             * \return the element
+             */
+            ValueT& operator[]( size_t index ) const
+            {
+                return m_data[ index ];
+            }
+
+            /**
+             * Access an element with range check.
+             *
+             * \param index the element index
+             * \throw std::out_of_range if the index is invalid.
+             *
+             * \return the element
+             */
+            ValueT& at( size_t index ) const
+            {
+                if( index >= m_size )
+                {
+                    throw std::out_of_range( "Index " + std::to_string( index ) + " is out of range of view with size " +
+                                             std::to_string( m_size ) + "." );
+                }
+                return m_data[ index ];
+            }
+
+            /**
+             * Create a sub-view of this view. The new view references the same memory.
+             *
+             * \param offset the first element of the new view
+             * \param count the number of elements in the new view
+             * \throw std::out_of_range if the range is not completely inside this view.
+             *
+             * \return the sub-view
+             */
+            ArrayView slice( size_t offset, size_t count ) const
+            {
+                if( ( offset > m_size ) || ( count > m_size - offset ) )
+                {
+                    throw std::out_of_range( "Slice [" + std::to_string( offset ) + ", " + std::to_string( offset + count ) +
+                                             ") is out of range of view with size " + std::to_string( m_size ) + "." );
+                }
+                return ArrayView( m_data + offset, count );
+            }
+
+        protected:
+        private:
+            /**
+             * The first element.
+             */
+            ValueT* m_data = nullptr;
+
+            /**
+             * Number of elements.
+             */
+            size_t m_size = 0;
+        };
+    }
+}
+
+#endif  // DI_ARRAYVIEW_H
+
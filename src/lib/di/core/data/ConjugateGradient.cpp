@@ -0,0 +1,170 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <di/core/data/SparseMatrix.h>
+#include <di/core/Parallel.h>
+
+#include "ConjugateGradient.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Number of vector elements summed up by one chunk in \ref dot. Fixed to get the same result for any number of threads.
+         */
+        static const size_t g_dotBlockSize = 4096;
+
+        /**
+         * Calculate the dot product of two vectors of equal size in parallel.
+         *
+         * \param a first vector
+         * \param b second vector
+         * \param threads the thread limit, see \ref parallelFor.
+         *
+         * \return the dot product
+         */
+        static double dot( const std::vector< double >& a, const std::vector< double >& b, unsigned threads )
+        {
+            return parallelReduce( a.size(), 0.0,
+                [ & ]( size_t begin, size_t end )
+                {
+                    double sum = 0.0;
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        sum += a[ i ] * b[ i ];
+                    }
+                    return sum;
+                },
+                std::plus< double >(), g_dotBlockSize, threads
+            );
+        }
+
+        ConjugateGradientResult solveConjugateGradient( const SparseMatrix& matrix, const std::vector< double >& rhs,
+                                                        std::vector< double >& solution, double tolerance,
+                                                        size_t maxIterations, unsigned threads )
+        {
+            size_t size = matrix.getNumRows();
+            if( ( matrix.getNumColumns() != size ) || ( rhs.size() != size ) )
+            {
+                throw std::invalid_argument( "Conjugate gradient needs a square matrix matching the right hand side." );
+            }
+            if( solution.size() != size )
+            {
+                solution.assign( size, 0.0 );
+            }
+
+            ConjugateGradientResult result;
+            double rhsNorm = std::sqrt( dot( rhs, rhs, threads ) );
+            if( rhsNorm == 0.0 )
+            {
+                // The only solution in the range of the matrix.
+                solution.assign( size, 0.0 );
+                result.m_converged = true;
+                return result;
+            }
+
+            // Jacobi preconditioner. Empty rows keep their value.
+            auto inverseDiagonal = matrix.getDiagonal();
+            for( auto& value : inverseDiagonal )
+            {
+                value = ( value != 0.0 ) ? 1.0 / value : 1.0;
+            }
+
+            // r = b - A x, z = M^-1 r, p = z
+            std::vector< double > residual;
+            matrix.multiply( solution, residual, threads );
+            std::vector< double > preconditioned( size );
+            std::vector< double > direction( size );
+            parallelFor( size,
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        residual[ i ] = rhs[ i ] - residual[ i ];
+                        preconditioned[ i ] = inverseDiagonal[ i ] * residual[ i ];
+                        direction[ i ] = preconditioned[ i ];
+                    }
+                },
+                4096, threads
+            );
+
+            double residualDotPreconditioned = dot( residual, preconditioned, threads );
+            result.m_relativeResidual = std::sqrt( dot( residual, residual, threads ) ) / rhsNorm;
+            result.m_converged = result.m_relativeResidual <= tolerance;
+
+            std::vector< double > matrixTimesDirection;
+            while( !result.m_converged && ( result.m_iterations < maxIterations ) )
+            {
+                matrix.multiply( direction, matrixTimesDirection, threads );
+                double curvature = dot( direction, matrixTimesDirection, threads );
+                if( curvature <= 0.0 )
+                {
+                    // Only happens in the null space of a semi-definite matrix. Nothing more to gain there.
+                    break;
+                }
+                double alpha = residualDotPreconditioned / curvature;
+
+                parallelFor( size,
+                    [ & ]( size_t begin, size_t end )
+                    {
+                        for( size_t i = begin; i < end; ++i )
+                        {
+                            solution[ i ] += alpha * direction[ i ];
+                            residual[ i ] -= alpha * matrixTimesDirection[ i ];
+                            preconditioned[ i ] = inverseDiagonal[ i ] * residual[ i ];
+                        }
+                    },
+                    4096, threads
+                );
+                ++result.m_iterations;
+
+                result.m_relativeResidual = std::sqrt( dot( residual, residual, threads ) ) / rhsNorm;
+                result.m_converged = result.m_relativeResidual <= tolerance;
+
+                double nextResidualDotPreconditioned = dot( residual, preconditioned, threads );
+                double beta = nextResidualDotPreconditioned / residualDotPreconditioned;
+                residualDotPreconditioned = nextResidualDotPreconditioned;
+
+                parallelFor( size,
+                    [ & ]( size_t begin, size_t end )
+                    {
+                        for( size_t i = begin; i < end; ++i )
+                        {
+                            direction[ i ] = preconditioned[ i ] + beta * direction[ i ];
+                        }
+                    },
+                    4096, threads
+                );
+            }
+
+            return result;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_CONJUGATEGRADIENT_H
+#define DI_CONJUGATEGRADIENT_H
+
+#include <cstddef>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        class SparseMatrix;
+
+        /**
+         * Outcome of \ref solveConjugateGradient.
+         */
+        struct ConjugateGradientResult
+        {
+            /**
+             * The number of iterations done.
+             */
+            size_t m_iterations = 0;
+
+            /**
+             * The final residual norm relative to the norm of the right hand side.
+             */
+            double m_relativeResidual = 0.0;
+
+            /**
+             * True if the tolerance was reached.
+             */
+            bool m_converged = false;
+        };
+
+        /**
+         * Solve matrix * solution = rhs using the conjugate gradient method with a Jacobi (diagonal) preconditioner. The matrix needs to be
+         * symmetric and positive semi-definite. For semi-definite matrices, the right hand side needs to be in the range of the matrix. The
+         * matrix-vector products and vector operations run in parallel.
+         *
+         * \throw std::invalid_argument if the sizes do not match.
+         *
+         * \param matrix the square matrix
+         * \param rhs the right hand side
+         * \param solution the initial guess. Contains the solution afterwards. Resized and set to 0 if the size does not match.
+         * \param tolerance stop if the residual norm drops below tolerance times the norm of the right hand side.
+         * \param maxIterations stop after this many iterations.
+         * \param threads the thread limit, see \ref parallelFor.
+         *
+         * \return the number of iterations and the reached residual.
+         */
+        ConjugateGradientResult solveConjugateGradient( const SparseMatrix& matrix, const std::vector< double >& rhs,
+                                                        std::vector< double >& solution, double tolerance = 1e-6,
+                                                        size_t maxIterations = 1000, unsigned threads = 0 );
+    }
+}
+
+#endif  // DI_CONJUGATEGRADIENT_H
+
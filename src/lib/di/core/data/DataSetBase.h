@@ -25,7 +25,14 @@
 #ifndef DI_DATASETBASE_H
 #define DI_DATASETBASE_H
 
+#include <functional>
+#include <map>
+#include <mutex>
 #include <string>
+#include <typeindex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <di/core/ConnectorTransferable.h>
 
@@ -59,12 +66,127 @@ namespace di
              * \return the dataset name
              */
             const std::string& getName() const;
+
+            /**
+             * Get data derived from this dataset, like acceleration structures or sample points. It is created on first request and kept with
+             * this dataset. As datasets are immutable, it never needs to be updated. The creation runs without holding the lock, so other
+             * requests are not blocked by it. If two threads create it at the same time, the first result is kept and returned to both.
+             *
+             * \tparam DerivedT the type of the derived data. Identifies the cache entry.
+             * \param create creates the derived data
+             *
+             * \return the derived data. Shared between all callers.
+             */
+            template< typename DerivedT >
+            ConstSPtr< DerivedT > getDerivedData( const std::function< ConstSPtr< DerivedT >() >& create ) const
+            {
+                auto key = std::type_index( typeid( DerivedT ) );
+                {
+                    std::lock_guard< std::mutex > lock( m_conversionCacheMutex );
+                    auto cached = m_derivedDataCache.find( key );
+                    if( cached != m_derivedDataCache.end() )
+                    {
+                        return std::static_pointer_cast< const DerivedT >( cached->second );
+                    }
+                }
+
+                auto created = create();
+
+                std::lock_guard< std::mutex > lock( m_conversionCacheMutex );
+                auto inserted = m_derivedDataCache.insert( std::make_pair( key, ConstSPtr< void >( created ) ) );
+                return std::static_pointer_cast< const DerivedT >( inserted.first->second );
+            }
+
         protected:
+            /**
+             * Get the given attribute array converted to another element type. The conversion is done lazily on first request and cached in
+             * this dataset. As datasets are immutable, the cache never needs to be invalidated. If the source already is a vector of the target
+             * type, the source is returned directly without any copy.
+             *
+             * \tparam TargetT the element type to convert to
+             * \tparam SourceT the attribute array type. Needs to be a container providing begin() and end().
+             * \param index the index of the attribute. Used to distinguish cache entries of different attributes.
+             * \param source the attribute array to convert
+             *
+             * \return the converted array. Shared between all callers.
+             */
+            template< typename TargetT, typename SourceT >
+            ConstSPtr< std::vector< TargetT > > getConvertedAttributes( size_t index, ConstSPtr< SourceT > source ) const
+            {
+                return convertAttributes< TargetT >( index, source, std::is_same< SourceT, std::vector< TargetT > >() );
+            }
+
         private:
+            /**
+             * Conversion to the same type. Returns the source.
+             *
+             * \tparam TargetT the element type to convert to
+             * \tparam SourceT the attribute array type.
+             * \param source the attribute array
+             *
+             * \return the source
+             */
+            template< typename TargetT, typename SourceT >
+            ConstSPtr< std::vector< TargetT > > convertAttributes( size_t /* index */, ConstSPtr< SourceT > source, std::true_type ) const
+            {
+                return source;
+            }
+
+            /**
+             * Conversion to a different type. Uses the conversion cache.
+             *
+             * \tparam TargetT the element type to convert to
+             * \tparam SourceT the attribute array type.
+             * \param index the index of the attribute.
+             * \param source the attribute array
+             *
+             * \return the converted array
+             */
+            template< typename TargetT, typename SourceT >
+            ConstSPtr< std::vector< TargetT > > convertAttributes( size_t index, ConstSPtr< SourceT > source, std::false_type ) const
+            {
+                if( !source )
+                {
+                    return nullptr;
+                }
+
+                std::lock_guard< std::mutex > lock( m_conversionCacheMutex );
+                auto key = std::make_pair( index, std::type_index( typeid( TargetT ) ) );
+                auto cached = m_conversionCache.find( key );
+                if( cached != m_conversionCache.end() )
+                {
+                    return std::static_pointer_cast< const std::vector< TargetT > >( cached->second );
+                }
+
+                auto converted = std::make_shared< std::vector< TargetT > >();
+                converted->reserve( source->size() );
+                for( const auto& value : *source )
+                {
+                    converted->push_back( static_cast< TargetT >( value ) );
+                }
+                m_conversionCache[ key ] = converted;
+                return converted;
+            }
+
             /**
              * The name
              */
             std::string m_name = "";
+
+            /**
+             * Protects the conversion cache and the derived data.
+             */
+            mutable std::mutex m_conversionCacheMutex;
+
+            /**
+             * Converted attribute arrays. Key is the attribute index and the target element type.
+             */
+            mutable std::map< std::pair< size_t, std::type_index >, ConstSPtr< void > > m_conversionCache;
+
+            /**
+             * Derived data. Key is the type of the data.
+             */
+            mutable std::map< std::type_index, ConstSPtr< void > > m_derivedDataCache;
         };
     }
 }
@@ -28,6 +28,7 @@
 #include <string>
 #include <tuple>
 
+#include <di/core/data/ArrayView.h>
 #include <di/core/data/DataSetBase.h>
 
 #include <di/Types.h>
@@ -75,6 +76,33 @@ namespace di
                 return std::get< Index >( m_attributes );
             }
 
+            /**
+             * Get a read-only, non-owning view on the attribute array. No data is copied. The view is only valid as long as this dataset (or
+             * any other owner of the attribute array) lives.
+             *
+             * \tparam Index the attribute index if any.
+             * \return the view
+             */
+            template< int Index = 0 >
+            ArrayView< const typename std::tuple_element< Index, std::tuple< AttributeT... > >::type::value_type > getAttributeView() const
+            {
+                return *std::get< Index >( m_attributes );
+            }
+
+            /**
+             * Get the attributes converted to another element type. The conversion happens on first request and is cached in the dataset.
+             * Subsequent calls return the same array. If the attribute already uses the target type, no copy is made at all.
+             *
+             * \tparam TargetT the target element type
+             * \tparam Index the attribute index if any.
+             * \return the converted attributes
+             */
+            template< typename TargetT, int Index = 0 >
+            ConstSPtr< std::vector< TargetT > > getAttributesAs() const
+            {
+                return this->template getConvertedAttributes< TargetT >( Index, std::get< Index >( m_attributes ) );
+            }
+
         protected:
         private:
             /**
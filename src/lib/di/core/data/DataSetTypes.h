@@ -61,6 +61,11 @@ namespace di
          * A vector field given on a triangle mesh
          */
         typedef di::core::DataSet< TriangleMesh, di::Vec3Array > TriangleVectorField;
+
+        /**
+         * A scalar field given on a triangle mesh
+         */
+        typedef di::core::DataSet< TriangleMesh, std::vector< double > > TriangleScalarField;
     }
 }
 
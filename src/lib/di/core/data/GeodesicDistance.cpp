@@ -0,0 +1,263 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/core/data/MeshLaplacian.h>
+#include <di/core/data/SparseMatrix.h>
+#include <di/core/data/TriangleMesh.h>
+
+#include "GeodesicDistance.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * The Laplacian of the Poisson step is shifted by this times M / t to make it definite. Small enough to not change the distances.
+         */
+        static const double g_poissonShift = 1e-8;
+
+        /**
+         * Build scale * laplacian + massScale * M, where M is the diagonal mass matrix. Rows of unreferenced vertices get a 1 on the
+         * diagonal, which keeps the matrix definite without coupling them to anything.
+         *
+         * \param laplacian the Laplacian
+         * \param scale the factor for the Laplacian
+         * \param mass the diagonal of the mass matrix
+         * \param massScale the factor for the mass matrix
+         *
+         * \return the matrix
+         */
+        static SparseMatrix combine( const SparseMatrix& laplacian, double scale, const std::vector< double >& mass, double massScale )
+        {
+            const auto& offsets = laplacian.getRowOffsets();
+            const auto& columns = laplacian.getColumns();
+            const auto& values = laplacian.getValues();
+
+            std::vector< SparseMatrix::Entry > entries;
+            entries.reserve( laplacian.getNumNonZeros() + mass.size() );
+            for( size_t row = 0; row < laplacian.getNumRows(); ++row )
+            {
+                for( size_t entry = offsets[ row ]; entry < offsets[ row + 1 ]; ++entry )
+                {
+                    entries.push_back( SparseMatrix::Entry( row, columns[ entry ], scale * values[ entry ] ) );
+                }
+                bool unreferenced = ( offsets[ row ] == offsets[ row + 1 ] ) && !( mass[ row ] > 0.0 );
+                entries.push_back( SparseMatrix::Entry( row, row, unreferenced ? 1.0 : massScale * mass[ row ] ) );
+            }
+            return SparseMatrix( laplacian.getNumRows(), laplacian.getNumColumns(), entries );
+        }
+
+        /**
+         * Find the representative of a set in a union-find structure. Shortens the path on the way.
+         *
+         * \param sets the parent of each element
+         * \param element the element
+         *
+         * \return the representative
+         */
+        static size_t findSet( std::vector< size_t >& sets, size_t element )
+        {
+            while( sets[ element ] != element )
+            {
+                sets[ element ] = sets[ sets[ element ] ];
+                element = sets[ element ];
+            }
+            return element;
+        }
+
+        GeodesicDistance::GeodesicDistance( ConstSPtr< TriangleMesh > mesh ):
+            m_mesh( mesh )
+        {
+            const auto& vertices = mesh->getVertices();
+            const auto& triangles = mesh->getTriangles();
+
+            // Per-triangle operators and the lumped mass of each vertex.
+            std::vector< double > mass( vertices.size(), 0.0 );
+            double edgeLengths = 0.0;
+            m_hatGradients.assign( 3 * triangles.size(), glm::dvec3( 0.0 ) );
+            m_cotangents.assign( triangles.size(), glm::dvec3( 0.0 ) );
+            m_components.resize( vertices.size() );
+            std::iota( m_components.begin(), m_components.end(), 0 );
+            for( size_t triangleID = 0; triangleID < triangles.size(); ++triangleID )
+            {
+                const auto& tri = triangles[ triangleID ];
+                glm::dvec3 corners[ 3 ];
+                for( int i = 0; i < 3; ++i )
+                {
+                    corners[ i ] = glm::dvec3( vertices[ tri[ i ] ] );
+                }
+
+                // Twice the area.
+                auto normal = glm::cross( corners[ 1 ] - corners[ 0 ], corners[ 2 ] - corners[ 0 ] );
+                double area2 = glm::length( normal );
+                for( int i = 0; i < 3; ++i )
+                {
+                    int j = ( i + 1 ) % 3;
+                    int k = ( i + 2 ) % 3;
+                    auto opposite = corners[ k ] - corners[ j ];
+                    edgeLengths += glm::length( opposite );
+                    mass[ tri[ i ] ] += area2 / 6.0;
+                    if( area2 > 0.0 )
+                    {
+                        m_hatGradients[ 3 * triangleID + i ] = glm::cross( normal, opposite ) / ( area2 * area2 );
+                        auto u = corners[ j ] - corners[ i ];
+                        auto v = corners[ k ] - corners[ i ];
+                        m_cotangents[ triangleID ][ i ] = glm::dot( u, v ) / glm::length( glm::cross( u, v ) );
+                    }
+                }
+
+                auto first = findSet( m_components, tri.x );
+                m_components[ findSet( m_components, tri.y ) ] = first;
+                m_components[ findSet( m_components, tri.z ) ] = first;
+            }
+            for( size_t vertexID = 0; vertexID < vertices.size(); ++vertexID )
+            {
+                m_components[ vertexID ] = findSet( m_components, vertexID );
+            }
+
+            // The time step is the squared mean edge length, as recommended by Crane et al.
+            double meanEdgeLength = triangles.empty() ? 1.0 : edgeLengths / static_cast< double >( 3 * triangles.size() );
+            double time = std::max( meanEdgeLength * meanEdgeLength, std::numeric_limits< double >::min() );
+
+            // The divergence uses the plain cotangents. The Laplacian needs to use the same, or distances get distorted at obtuse triangles.
+            auto laplacian = calculateLaplacian( *mesh, LaplacianWeights::CotangentUnclamped );
+            m_heatSolver = std::make_shared< SparseCholesky >( combine( laplacian, time, mass, 1.0 ) );
+            m_poissonSolver = std::make_shared< SparseCholesky >( combine( laplacian, 1.0, mass, g_poissonShift / time ) );
+        }
+
+        GeodesicDistance::~GeodesicDistance()
+        {
+            // nothing to do
+        }
+
+        ConstSPtr< TriangleMesh > GeodesicDistance::getMesh() const
+        {
+            return m_mesh;
+        }
+
+        std::vector< double > GeodesicDistance::compute( const std::vector< size_t >& sources ) const
+        {
+            const auto& vertices = m_mesh->getVertices();
+            const auto& triangles = m_mesh->getTriangles();
+
+            std::vector< double > distances( vertices.size(), std::numeric_limits< double >::infinity() );
+            if( sources.empty() )
+            {
+                return distances;
+            }
+
+            // 1: diffuse heat from the sources.
+            std::vector< double > delta( vertices.size(), 0.0 );
+            for( auto source : sources )
+            {
+                if( source >= vertices.size() )
+                {
+                    throw std::out_of_range( "The geodesic distance source is not a vertex of the mesh." );
+                }
+                delta[ source ] = 1.0;
+            }
+            std::vector< double > heat;
+            m_heatSolver->solve( delta, heat );
+
+            // 2: the integrated divergence of the normalized gradient field, which points away from the sources.
+            std::vector< double > divergence( vertices.size(), 0.0 );
+            for( size_t triangleID = 0; triangleID < triangles.size(); ++triangleID )
+            {
+                const auto& tri = triangles[ triangleID ];
+                glm::dvec3 gradient( 0.0 );
+                for( int i = 0; i < 3; ++i )
+                {
+                    gradient += heat[ tri[ i ] ] * m_hatGradients[ 3 * triangleID + i ];
+                }
+                double length = glm::length( gradient );
+                if( !( length > 0.0 ) )
+                {
+                    continue;
+                }
+                auto direction = -gradient / length;
+
+                const auto& cotangents = m_cotangents[ triangleID ];
+                for( int i = 0; i < 3; ++i )
+                {
+                    int j = ( i + 1 ) % 3;
+                    int k = ( i + 2 ) % 3;
+                    auto corner = glm::dvec3( vertices[ tri[ i ] ] );
+                    auto toJ = glm::dvec3( vertices[ tri[ j ] ] ) - corner;
+                    auto toK = glm::dvec3( vertices[ tri[ k ] ] ) - corner;
+                    divergence[ tri[ i ] ] += 0.5 * ( cotangents[ k ] * glm::dot( toJ, direction ) +
+                                                      cotangents[ j ] * glm::dot( toK, direction ) );
+                }
+            }
+
+            // 3: the distance whose gradient fits best. The Laplacian of this module is positive, hence the negation.
+            for( auto& value : divergence )
+            {
+                value = -value;
+            }
+            std::vector< double > potential;
+            m_poissonSolver->solve( divergence, potential );
+
+            // The potential is only defined up to a constant. The sources are at distance 0.
+            double offset = 0.0;
+            std::vector< char > reached( vertices.size(), 0 );
+            for( auto source : sources )
+            {
+                offset += potential[ source ];
+                reached[ m_components[ source ] ] = 1;
+            }
+            offset /= static_cast< double >( sources.size() );
+
+            for( size_t vertexID = 0; vertexID < vertices.size(); ++vertexID )
+            {
+                if( reached[ m_components[ vertexID ] ] )
+                {
+                    distances[ vertexID ] = std::max( 0.0, potential[ vertexID ] - offset );
+                }
+            }
+            return distances;
+        }
+
+        std::vector< std::vector< double > > GeodesicDistance::computeEach( const std::vector< size_t >& sources, unsigned threads ) const
+        {
+            std::vector< std::vector< double > > distances( sources.size() );
+            parallelFor( sources.size(),
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        distances[ i ] = compute( std::vector< size_t >( 1, sources[ i ] ) );
+                    }
+                }, 1, threads
+            );
+            return distances;
+        }
+    }
+}
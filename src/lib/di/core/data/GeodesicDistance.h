@@ -0,0 +1,133 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_GEODESICDISTANCE_H
+#define DI_GEODESICDISTANCE_H
+
+#include <vector>
+
+#include <di/core/data/SparseCholesky.h>
+#include <di/MathTypes.h>
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleMesh;
+
+        /**
+         * Geodesic distances on a triangle mesh using the heat method (Crane et al., "Geodesics in Heat", 2013). Heat diffuses from the
+         * sources for a short time, the normalized negative heat gradient points away from the sources, and a Poisson equation recovers the
+         * distance whose gradient matches it best.
+         *
+         * Both linear systems only depend on the mesh. They are factorized once on construction, so each query costs two pairs of
+         * triangular solves and some per-triangle work. Queries are const and can run in parallel. Keep the instance as long as the mesh
+         * does not change, for example with \ref DataSetBase::getDerivedData.
+         */
+        class GeodesicDistance
+        {
+        public:
+            /**
+             * Build and factorize the operators of the mesh.
+             *
+             * \throw std::runtime_error if a factorization fails. This only happens for degenerate meshes.
+             *
+             * \param mesh the mesh
+             */
+            explicit GeodesicDistance( ConstSPtr< TriangleMesh > mesh );
+
+            /**
+             * Destructor.
+             */
+            virtual ~GeodesicDistance();
+
+            /**
+             * The mesh.
+             *
+             * \return the mesh
+             */
+            ConstSPtr< TriangleMesh > getMesh() const;
+
+            /**
+             * Compute the distance of each vertex to the closest of the given source vertices. Vertices not connected to any source get an
+             * infinite distance.
+             *
+             * \throw std::out_of_range if a source is not a vertex of the mesh.
+             *
+             * \param sources the source vertices
+             *
+             * \return the distance of each vertex
+             */
+            std::vector< double > compute( const std::vector< size_t >& sources ) const;
+
+            /**
+             * Compute the distance field of each source separately. The sources are processed in parallel.
+             *
+             * \throw std::out_of_range if a source is not a vertex of the mesh.
+             *
+             * \param sources the source vertices
+             * \param threads the thread limit, see \ref parallelFor.
+             *
+             * \return the distance of each vertex, for each source
+             */
+            std::vector< std::vector< double > > computeEach( const std::vector< size_t >& sources, unsigned threads = 0 ) const;
+
+        protected:
+        private:
+            /**
+             * The mesh.
+             */
+            ConstSPtr< TriangleMesh > m_mesh = nullptr;
+
+            /**
+             * Factorization of M + t L, with the lumped mass matrix M, the cotangent Laplacian L and the time step t.
+             */
+            SPtr< SparseCholesky > m_heatSolver = nullptr;
+
+            /**
+             * Factorization of L, slightly shifted to make it definite.
+             */
+            SPtr< SparseCholesky > m_poissonSolver = nullptr;
+
+            /**
+             * The gradient of the hat function of each corner of each triangle. Three per triangle.
+             */
+            std::vector< glm::dvec3 > m_hatGradients;
+
+            /**
+             * The cotangent of the angle at each corner of each triangle.
+             */
+            std::vector< glm::dvec3 > m_cotangents;
+
+            /**
+             * The connected component of each vertex.
+             */
+            std::vector< size_t > m_components;
+        };
+    }
+}
+
+#endif  // DI_GEODESICDISTANCE_H
+
@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <map>
+#include <utility>
 
 #include "Lines.h"
 
@@ -45,13 +46,11 @@ namespace di
         {
             if( ifUnique )
             {
-                for( size_t vIdx = 0; vIdx < m_vertices.size(); ++vIdx )
+                size_t vIdx = 0;
+                m_vertexHash.update( m_vertices );
+                if( m_vertexHash.find( m_vertices, vertex, vIdx ) )
                 {
-                    auto dist = glm::distance( vertex, m_vertices[ vIdx ] );
-                    if( dist < 0.001 )
-                    {
-                        return vIdx;
-                    }
+                    return vIdx;
                 }
             }
 
@@ -135,11 +134,45 @@ namespace di
         void Lines::setVertices( const Vec3Array& vertices )
         {
             m_vertices = vertices;
+            m_vertexHash.clear();
+        }
+
+        void Lines::setVertices( Vec3Array&& vertices )
+        {
+            m_vertices = std::move( vertices );
+            m_vertexHash.clear();
+        }
+
+        std::vector< size_t > Lines::weldVertices( float tolerance, unsigned threads )
+        {
+            Vec3Array welded;
+            auto mapping = VertexHash::weld( m_vertices, welded, tolerance, threads );
+
+            // Lines shorter than the tolerance collapse to a point. Drop them.
+            IndexVec2Array lines;
+            lines.reserve( m_lines.size() );
+            for( const auto& line : m_lines )
+            {
+                glm::ivec2 weldedLine( mapping[ line.x ], mapping[ line.y ] );
+                if( weldedLine.x != weldedLine.y )
+                {
+                    lines.push_back( weldedLine );
+                }
+            }
+            m_lines = std::move( lines );
+
+            setVertices( std::move( welded ) );
+            return mapping;
         }
 
         void Lines::setLines( const IndexVec2Array& lines )
         {
             m_lines = lines;
         }
+
+        void Lines::setLines( IndexVec2Array&& lines )
+        {
+            m_lines = std::move( lines );
+        }
     }
 }
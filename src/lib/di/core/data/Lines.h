@@ -29,6 +29,7 @@
 #include <tuple>
 
 #include <di/core/BoundingBox.h>
+#include <di/core/data/VertexHash.h>
 
 #include <di/MathTypes.h>
 #include <di/GfxTypes.h>
@@ -59,7 +60,8 @@ namespace di
              * Add a vertex to the vertex list.
              *
              * \param vertex the vertex to add.
-             * \param ifUnique add vertex if not yet present. If already present, return its index.
+             * \param ifUnique add vertex if not yet present. If already present, return its index. Vertices closer than 0.001 are the
+             * same. Uses a spatial hash, so this takes constant time in average.
              *
              * \return the index of the vertex.
              */
@@ -111,6 +113,24 @@ namespace di
              */
             void setVertices( const Vec3Array& vertices );
 
+            /**
+             * Set the vertex array by moving it. Avoids copying large arrays. Previously added vertices will be overwritten.
+             *
+             * \param vertices the vertex array. Empty after the call.
+             */
+            void setVertices( Vec3Array&& vertices );
+
+            /**
+             * Merge all vertices closer than the given tolerance, in parallel. See \ref VertexHash::weld. The lines are re-mapped to the kept
+             * vertices. Lines whose two vertices are merged are removed, so line IDs can change.
+             *
+             * \param tolerance vertices closer than this are merged
+             * \param threads the thread limit, see \ref parallelFor.
+             *
+             * \return the new index of each old vertex. Use it to re-map per-vertex attributes.
+             */
+            std::vector< size_t > weldVertices( float tolerance = 0.001f, unsigned threads = 0 );
+
             /**
              * Abbreviation for 2 vertices of a line.
              */
@@ -159,6 +179,13 @@ namespace di
              */
             void setLines( const IndexVec2Array& lines );
 
+            /**
+             * Set the lines index array by moving it. Overwrites previously set lines.
+             *
+             * \param lines the index array. Empty after the call.
+             */
+            void setLines( IndexVec2Array&& lines );
+
             /**
              * The number of lines currently defined.
              *
@@ -203,6 +230,11 @@ namespace di
              * The bounding box.
              */
             BoundingBox m_boundingBox;
+
+            /**
+             * Finds duplicates when adding unique vertices. Only indexes the vertices when needed.
+             */
+            VertexHash m_vertexHash;
         };
     }
 }
@@ -0,0 +1,169 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <di/core/data/TriangleMesh.h>
+#include <di/MathTypes.h>
+
+#include "MeshGradient.h"
+
+namespace di
+{
+    namespace core
+    {
+        MeshGradient::MeshGradient( const TriangleMesh& mesh, unsigned threads )
+        {
+            const auto& vertices = mesh.getVertices();
+            const auto& triangles = mesh.getTriangles();
+            size_t numVertices = mesh.getNumVertices();
+            if( numVertices > std::numeric_limits< uint32_t >::max() )
+            {
+                throw std::invalid_argument( "Mesh has too many vertices for the gradient operator." );
+            }
+
+            // Area weighted vertex normals define the tangent planes. They do not rely on normals being present in the mesh.
+            std::vector< glm::dvec3 > normals( numVertices, glm::dvec3( 0.0 ) );
+
+            // Unique directed edges, sorted by source vertex. This is the CSR structure.
+            std::vector< std::pair< uint32_t, uint32_t > > edges;
+            edges.reserve( triangles.size() * 6 );
+            for( const auto& tri : triangles )
+            {
+                auto normal = glm::cross( glm::dvec3( vertices[ tri.y ] ) - glm::dvec3( vertices[ tri.x ] ),
+                                          glm::dvec3( vertices[ tri.z ] ) - glm::dvec3( vertices[ tri.x ] ) );
+                for( int k = 0; k < 3; ++k )
+                {
+                    uint32_t a = tri[ k ];
+                    uint32_t b = tri[ ( k + 1 ) % 3 ];
+                    normals[ a ] += normal;
+                    edges.push_back( std::make_pair( a, b ) );
+                    edges.push_back( std::make_pair( b, a ) );
+                }
+            }
+            std::sort( edges.begin(), edges.end() );
+            edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+            m_rowOffsets.assign( numVertices + 1, 0 );
+            m_columns.resize( edges.size() );
+            for( size_t i = 0; i < edges.size(); ++i )
+            {
+                ++m_rowOffsets[ edges[ i ].first + 1 ];
+                m_columns[ i ] = edges[ i ].second;
+            }
+            for( size_t vertex = 0; vertex < numVertices; ++vertex )
+            {
+                m_rowOffsets[ vertex + 1 ] += m_rowOffsets[ vertex ];
+            }
+
+            m_coefficientsX.assign( edges.size(), 0.0f );
+            m_coefficientsY.assign( edges.size(), 0.0f );
+            m_coefficientsZ.assign( edges.size(), 0.0f );
+
+            // Per vertex: minimize sum_j w_j ( g . d_j - ( f_j - f_i ) )^2 for g in the tangent plane, with d_j the projected edge and
+            // w_j = 1 / |d_j|^2. The solution is g = sum_j c_j ( f_j - f_i ) with c_j = w_j B M^-1 B^T d_j, where B is the tangent basis and
+            // M = sum_j w_j B^T d_j d_j^T B.
+            parallelFor( numVertices,
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t vertex = begin; vertex < end; ++vertex )
+                    {
+                        auto normalLength = glm::length( normals[ vertex ] );
+                        if( normalLength <= 0.0 )
+                        {
+                            continue;
+                        }
+                        auto normal = normals[ vertex ] / normalLength;
+
+                        // Any orthonormal basis of the tangent plane.
+                        auto helper = ( std::abs( normal.x ) < 0.9 ) ? glm::dvec3( 1.0, 0.0, 0.0 ) : glm::dvec3( 0.0, 1.0, 0.0 );
+                        auto tangent = glm::normalize( glm::cross( normal, helper ) );
+                        auto bitangent = glm::cross( normal, tangent );
+
+                        auto origin = glm::dvec3( vertices[ vertex ] );
+                        double m00 = 0.0;
+                        double m01 = 0.0;
+                        double m11 = 0.0;
+                        for( size_t i = m_rowOffsets[ vertex ]; i < m_rowOffsets[ vertex + 1 ]; ++i )
+                        {
+                            auto d = glm::dvec3( vertices[ m_columns[ i ] ] ) - origin;
+                            double u = glm::dot( d, tangent );
+                            double v = glm::dot( d, bitangent );
+                            double lengthSquared = u * u + v * v;
+                            if( lengthSquared <= 0.0 )
+                            {
+                                continue;
+                            }
+                            double w = 1.0 / lengthSquared;
+                            m00 += w * u * u;
+                            m01 += w * u * v;
+                            m11 += w * v * v;
+                        }
+
+                        // Collinear or too few neighbours: the gradient is not defined.
+                        double determinant = m00 * m11 - m01 * m01;
+                        if( determinant <= 1e-12 * ( m00 + m11 ) * ( m00 + m11 ) )
+                        {
+                            continue;
+                        }
+
+                        double i00 = m11 / determinant;
+                        double i01 = -m01 / determinant;
+                        double i11 = m00 / determinant;
+                        for( size_t i = m_rowOffsets[ vertex ]; i < m_rowOffsets[ vertex + 1 ]; ++i )
+                        {
+                            auto d = glm::dvec3( vertices[ m_columns[ i ] ] ) - origin;
+                            double u = glm::dot( d, tangent );
+                            double v = glm::dot( d, bitangent );
+                            double lengthSquared = u * u + v * v;
+                            if( lengthSquared <= 0.0 )
+                            {
+                                continue;
+                            }
+                            double w = 1.0 / lengthSquared;
+                            auto coefficient = w * ( ( i00 * u + i01 * v ) * tangent + ( i01 * u + i11 * v ) * bitangent );
+                            m_coefficientsX[ i ] = static_cast< float >( coefficient.x );
+                            m_coefficientsY[ i ] = static_cast< float >( coefficient.y );
+                            m_coefficientsZ[ i ] = static_cast< float >( coefficient.z );
+                        }
+                    }
+                },
+                1024, threads
+            );
+        }
+
+        MeshGradient::~MeshGradient()
+        {
+        }
+
+        size_t MeshGradient::getNumVertices() const
+        {
+            return m_rowOffsets.empty() ? 0 : m_rowOffsets.size() - 1;
+        }
+    }
+}
@@ -0,0 +1,151 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MESHGRADIENT_H
+#define DI_MESHGRADIENT_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/GfxTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleMesh;
+
+        /**
+         * Discrete gradient operator of a triangle mesh. For each vertex, the gradient of a scalar field is the least-squares fit of a linear
+         * function in the tangent plane to the differences to the direct neighbours. This only depends on the geometry, so the operator is
+         * built once per mesh. Applying it to a field is a sparse matrix-vector product.
+         *
+         * The operator is stored in CSR layout with one coefficient array per gradient component (structure of arrays). The gradient at vertex
+         * i is sum_j c_ij * ( f_j - f_i ) over all neighbours j.
+         */
+        class MeshGradient
+        {
+        public:
+            /**
+             * Build the operator.
+             *
+             * \throw std::invalid_argument if the mesh has too many vertices.
+             *
+             * \param mesh the mesh
+             * \param threads the thread limit, see \ref parallelFor.
+             */
+            explicit MeshGradient( const TriangleMesh& mesh, unsigned threads = 0 );
+
+            /**
+             * Destructor.
+             */
+            virtual ~MeshGradient();
+
+            /**
+             * The number of vertices of the mesh this operator was built for.
+             *
+             * \return the number of vertices
+             */
+            size_t getNumVertices() const;
+
+            /**
+             * Calculate the gradient of a scalar field defined at the vertices. Vertices with less than two neighbours that are not collinear
+             * get a zero gradient.
+             *
+             * \throw std::invalid_argument if the number of values does not match the number of vertices.
+             *
+             * \tparam ValueType a type convertible to float
+             * \param values one value per vertex
+             * \param gradients the gradients. Resized to the number of vertices.
+             * \param threads the thread limit, see \ref parallelFor.
+             */
+            template< typename ValueType >
+            void apply( const std::vector< ValueType >& values, Vec3Array& gradients, unsigned threads = 0 ) const;
+
+        protected:
+        private:
+            /**
+             * Start of each vertex' neighbours in \ref m_columns and the coefficients.
+             */
+            std::vector< size_t > m_rowOffsets = {};
+
+            /**
+             * The neighbour vertices.
+             */
+            std::vector< uint32_t > m_columns = {};
+
+            /**
+             * x component of the coefficients.
+             */
+            std::vector< float > m_coefficientsX = {};
+
+            /**
+             * y component of the coefficients.
+             */
+            std::vector< float > m_coefficientsY = {};
+
+            /**
+             * z component of the coefficients.
+             */
+            std::vector< float > m_coefficientsZ = {};
+        };
+
+        template< typename ValueType >
+        void MeshGradient::apply( const std::vector< ValueType >& values, Vec3Array& gradients, unsigned threads ) const
+        {
+            if( values.size() != getNumVertices() )
+            {
+                throw std::invalid_argument( "The number of values does not match the number of vertices." );
+            }
+
+            gradients.resize( values.size() );
+            parallelFor( values.size(),
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t vertex = begin; vertex < end; ++vertex )
+                    {
+                        float value = static_cast< float >( values[ vertex ] );
+                        float x = 0.0f;
+                        float y = 0.0f;
+                        float z = 0.0f;
+                        for( size_t i = m_rowOffsets[ vertex ]; i < m_rowOffsets[ vertex + 1 ]; ++i )
+                        {
+                            float difference = static_cast< float >( values[ m_columns[ i ] ] ) - value;
+                            x += m_coefficientsX[ i ] * difference;
+                            y += m_coefficientsY[ i ] * difference;
+                            z += m_coefficientsZ[ i ] * difference;
+                        }
+                        gradients[ vertex ] = glm::vec3( x, y, z );
+                    }
+                },
+                4096, threads
+            );
+        }
+    }
+}
+
+#endif  // DI_MESHGRADIENT_H
+
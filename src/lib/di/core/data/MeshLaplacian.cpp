@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <di/core/data/TriangleMesh.h>
+#include <di/MathTypes.h>
+
+#include "MeshLaplacian.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Smallest cotangent weight. Obtuse triangles cause negative weights, which are clamped to this.
+         */
+        static const double g_minCotangentWeight = 1e-4;
+
+        SparseMatrix calculateLaplacian( const TriangleMesh& mesh, LaplacianWeights weights )
+        {
+            const auto& vertices = mesh.getVertices();
+            const auto& triangles = mesh.getTriangles();
+
+            // Collect the weight of each edge. Interior edges get a contribution of both triangles.
+            std::vector< std::pair< std::pair< size_t, size_t >, double > > edges;
+            edges.reserve( triangles.size() * 3 );
+            for( const auto& tri : triangles )
+            {
+                for( int k = 0; k < 3; ++k )
+                {
+                    size_t a = tri[ ( k + 1 ) % 3 ];
+                    size_t b = tri[ ( k + 2 ) % 3 ];
+                    double weight = 1.0;
+                    if( weights != LaplacianWeights::Uniform )
+                    {
+                        // The angle opposite to edge (a, b) is at vertex k.
+                        auto u = glm::dvec3( vertices[ a ] ) - glm::dvec3( vertices[ tri[ k ] ] );
+                        auto v = glm::dvec3( vertices[ b ] ) - glm::dvec3( vertices[ tri[ k ] ] );
+                        auto sine = glm::length( glm::cross( u, v ) );
+                        weight = ( sine > 0.0 ) ? 0.5 * glm::dot( u, v ) / sine : 0.0;
+                    }
+                    edges.push_back( std::make_pair( std::make_pair( std::min( a, b ), std::max( a, b ) ), weight ) );
+                }
+            }
+
+            std::sort( edges.begin(), edges.end() );
+
+            std::vector< SparseMatrix::Entry > entries;
+            entries.reserve( edges.size() * 2 );
+            for( size_t i = 0; i < edges.size(); )
+            {
+                auto edge = edges[ i ].first;
+                double weight = 0.0;
+                for( ; ( i < edges.size() ) && ( edges[ i ].first == edge ); ++i )
+                {
+                    weight += edges[ i ].second;
+                }
+
+                if( weights == LaplacianWeights::Uniform )
+                {
+                    weight = 1.0;
+                }
+                else if( weights == LaplacianWeights::Cotangent )
+                {
+                    weight = std::max( weight, g_minCotangentWeight );
+                }
+
+                entries.push_back( SparseMatrix::Entry( edge.first, edge.second, -weight ) );
+                entries.push_back( SparseMatrix::Entry( edge.second, edge.first, -weight ) );
+                entries.push_back( SparseMatrix::Entry( edge.first, edge.first, weight ) );
+                entries.push_back( SparseMatrix::Entry( edge.second, edge.second, weight ) );
+            }
+
+            return SparseMatrix( mesh.getNumVertices(), mesh.getNumVertices(), entries );
+        }
+    }
+}
@@ -0,0 +1,65 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MESHLAPLACIAN_H
+#define DI_MESHLAPLACIAN_H
+
+#include <di/core/data/SparseMatrix.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleMesh;
+
+        /**
+         * The edge weights of a mesh Laplacian.
+         */
+        enum class LaplacianWeights
+        {
+            Uniform,            // Each edge has weight 1. Ignores the geometry.
+            Cotangent,          // Half the sum of the cotangents of the angles opposite to the edge. Accounts for irregular triangulations.
+            CotangentUnclamped  // Like Cotangent, but negative weights are kept. The discrete Laplace-Beltrami operator of the mesh.
+        };
+
+        /**
+         * Build the Laplacian L = D - W of a triangle mesh. W contains the edge weights, D is the diagonal matrix of the row sums of W. The
+         * matrix is symmetric and positive semi-definite. Each vertex is a row. Unreferenced vertices have empty rows.
+         *
+         * \note with \ref LaplacianWeights::Cotangent, negative weights, caused by obtuse triangles, are clamped to a small positive value.
+         * This keeps all off-diagonal entries negative and the vertices connected. Use \ref LaplacianWeights::CotangentUnclamped where the
+         * Laplacian needs to match other cotangent based operators, like the divergence on the mesh. The matrix is positive semi-definite in
+         * both cases.
+         *
+         * \param mesh the mesh
+         * \param weights the edge weights to use
+         *
+         * \return the Laplacian
+         */
+        SparseMatrix calculateLaplacian( const TriangleMesh& mesh, LaplacianWeights weights = LaplacianWeights::Cotangent );
+    }
+}
+
+#endif  // DI_MESHLAPLACIAN_H
+
@@ -0,0 +1,715 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include <di/core/data/TriangleMesh.h>
+#include <di/MathTypes.h>
+
+#include "MeshSimplifier.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Weight of the planes perpendicular to boundary edges, relative to the area weighted planes of the triangles. Large values keep the
+         * boundary in place.
+         */
+        static const double g_boundaryWeight = 100.0;
+
+        /**
+         * Collapses that change the orientation of a triangle by more than about 78 degrees are rejected.
+         */
+        static const double g_minNormalAgreement = 0.2;
+
+        /**
+         * Symmetric 4x4 matrix describing the sum of squared distances of a point to a set of planes.
+         */
+        struct Quadric
+        {
+            /**
+             * Upper triangle of the matrix, row by row.
+             */
+            double m_a[ 10 ] = {};
+
+            /**
+             * Add the plane n.x + d = 0.
+             *
+             * \param n the unit normal of the plane
+             * \param d the distance to the origin
+             * \param weight the weight of the plane
+             */
+            void addPlane( const glm::dvec3& n, double d, double weight )
+            {
+                m_a[ 0 ] += weight * n.x * n.x;
+                m_a[ 1 ] += weight * n.x * n.y;
+                m_a[ 2 ] += weight * n.x * n.z;
+                m_a[ 3 ] += weight * n.x * d;
+                m_a[ 4 ] += weight * n.y * n.y;
+                m_a[ 5 ] += weight * n.y * n.z;
+                m_a[ 6 ] += weight * n.y * d;
+                m_a[ 7 ] += weight * n.z * n.z;
+                m_a[ 8 ] += weight * n.z * d;
+                m_a[ 9 ] += weight * d * d;
+            }
+
+            /**
+             * Add another quadric.
+             *
+             * \param other the quadric to add
+             */
+            void add( const Quadric& other )
+            {
+                for( size_t i = 0; i < 10; ++i )
+                {
+                    m_a[ i ] += other.m_a[ i ];
+                }
+            }
+
+            /**
+             * Evaluate the error at the given point.
+             *
+             * \param p the point
+             *
+             * \return the sum of the weighted squared distances to the planes.
+             */
+            double evaluate( const glm::dvec3& p ) const
+            {
+                return m_a[ 0 ] * p.x * p.x + 2.0 * m_a[ 1 ] * p.x * p.y + 2.0 * m_a[ 2 ] * p.x * p.z + 2.0 * m_a[ 3 ] * p.x +
+                       m_a[ 4 ] * p.y * p.y + 2.0 * m_a[ 5 ] * p.y * p.z + 2.0 * m_a[ 6 ] * p.y +
+                       m_a[ 7 ] * p.z * p.z + 2.0 * m_a[ 8 ] * p.z +
+                       m_a[ 9 ];
+            }
+        };
+
+        /**
+         * A candidate edge collapse. Moves the vertex m_from onto m_to.
+         */
+        struct Collapse
+        {
+            /**
+             * Create a candidate.
+             *
+             * \param cost the error introduced by the collapse
+             * \param from the vertex to remove
+             * \param to the vertex to keep
+             * \param fromVersion the current version of from
+             * \param toVersion the current version of to
+             */
+            Collapse( double cost, uint32_t from, uint32_t to, uint32_t fromVersion, uint32_t toVersion ):
+                m_cost( cost ),
+                m_from( from ),
+                m_to( to ),
+                m_fromVersion( fromVersion ),
+                m_toVersion( toVersion )
+            {
+            }
+
+            /**
+             * The error introduced by the collapse.
+             */
+            double m_cost;
+
+            /**
+             * The vertex to remove.
+             */
+            uint32_t m_from;
+
+            /**
+             * The vertex to keep.
+             */
+            uint32_t m_to;
+
+            /**
+             * Version of m_from when the collapse was evaluated.
+             */
+            uint32_t m_fromVersion;
+
+            /**
+             * Version of m_to when the collapse was evaluated.
+             */
+            uint32_t m_toVersion;
+
+            /**
+             * Order by cost. The cheapest collapse has the highest priority.
+             *
+             * \param other the collapse to compare with
+             *
+             * \return true if this collapse is more expensive.
+             */
+            bool operator<( const Collapse& other ) const
+            {
+                return m_cost > other.m_cost;
+            }
+        };
+
+        /**
+         * Greedy edge collapse simplification. Collapses are evaluated lazily: each vertex has a version, which increases whenever its quadric
+         * changes. Queued collapses referring to an old version are skipped.
+         */
+        class QuadricSimplifier
+        {
+        public:
+            /**
+             * Set up the quadrics and the initial collapses.
+             *
+             * \param mesh the mesh to simplify. Needs to outlive the simplifier.
+             * \param cancel stop as soon as possible if this becomes true. Can be nullptr. Needs to outlive the simplifier.
+             */
+            explicit QuadricSimplifier( const TriangleMesh& mesh, const std::atomic< bool >* cancel = nullptr );
+
+            /**
+             * Collapse edges until the number of triangles reaches each of the given targets.
+             *
+             * \param targets the triangle counts to record the mesh at. Descending.
+             *
+             * \return the triangles at each reached target. Incomplete if cancelled.
+             */
+            std::vector< IndexVec3Array > run( const std::vector< size_t >& targets );
+
+            /**
+             * Check whether the simplification was cancelled.
+             *
+             * \return true if cancelled.
+             */
+            bool isCancelled() const;
+
+            /**
+             * Get the remaining triangles.
+             *
+             * \return the triangles
+             */
+            IndexVec3Array getTriangles() const;
+
+            /**
+             * Get the number of remaining triangles.
+             *
+             * \return the number of triangles
+             */
+            size_t getNumTriangles() const;
+
+        private:
+            /**
+             * Get the position of a vertex in double precision.
+             *
+             * \param vertex the vertex
+             *
+             * \return the position
+             */
+            glm::dvec3 getPosition( uint32_t vertex ) const;
+
+            /**
+             * Collect the vertices connected to the given vertex.
+             *
+             * \param vertex the vertex
+             * \param result the sorted vertices. Cleared first.
+             */
+            void getNeighbours( uint32_t vertex, std::vector< uint32_t >& result ) const;
+
+            /**
+             * Evaluate the collapse of the edge in both directions and queue the cheaper one.
+             *
+             * \param a first vertex of the edge
+             * \param b second vertex of the edge
+             */
+            void pushCollapse( uint32_t a, uint32_t b );
+
+            /**
+             * Check whether the collapse keeps the mesh manifold and does not flip triangles.
+             *
+             * \param from the vertex to remove
+             * \param to the vertex to keep
+             *
+             * \return true if the collapse can be done.
+             */
+            bool isCollapseValid( uint32_t from, uint32_t to );
+
+            /**
+             * Collapse the edge and queue the changed edges.
+             *
+             * \param from the vertex to remove
+             * \param to the vertex to keep
+             */
+            void collapse( uint32_t from, uint32_t to );
+
+            /**
+             * The vertices of the original mesh.
+             */
+            const Vec3Array& m_vertices;
+
+            /**
+             * The triangles. Collapses modify them in place.
+             */
+            IndexVec3Array m_triangles = {};
+
+            /**
+             * False for triangles that degenerated during a collapse.
+             */
+            std::vector< char > m_triangleAlive = {};
+
+            /**
+             * The alive triangles using each vertex.
+             */
+            std::vector< std::vector< uint32_t > > m_vertexTriangles = {};
+
+            /**
+             * The quadric of each vertex.
+             */
+            std::vector< Quadric > m_quadrics = {};
+
+            /**
+             * The version of each vertex.
+             */
+            std::vector< uint32_t > m_versions = {};
+
+            /**
+             * True for vertices that were collapsed onto another one.
+             */
+            std::vector< char > m_removed = {};
+
+            /**
+             * The candidate collapses, cheapest first.
+             */
+            std::priority_queue< Collapse > m_queue;
+
+            /**
+             * Number of alive triangles.
+             */
+            size_t m_numTriangles = 0;
+
+            /**
+             * Scratch space for neighbour queries.
+             */
+            std::vector< uint32_t > m_neighboursA = {};
+
+            /**
+             * Scratch space for neighbour queries.
+             */
+            std::vector< uint32_t > m_neighboursB = {};
+
+            /**
+             * The cancellation flag. Can be nullptr.
+             */
+            const std::atomic< bool >* m_cancel = nullptr;
+        };
+
+        QuadricSimplifier::QuadricSimplifier( const TriangleMesh& mesh, const std::atomic< bool >* cancel ):
+            m_vertices( mesh.getVertices() ),
+            m_triangles( mesh.getTriangles() ),
+            m_cancel( cancel )
+        {
+            size_t numVertices = m_vertices.size();
+            if( numVertices > std::numeric_limits< uint32_t >::max() )
+            {
+                throw std::invalid_argument( "Mesh has too many vertices for simplification." );
+            }
+
+            m_triangleAlive.resize( m_triangles.size(), 0 );
+            m_vertexTriangles.resize( numVertices );
+            m_quadrics.resize( numVertices );
+            m_versions.resize( numVertices, 0 );
+            m_removed.resize( numVertices, 0 );
+
+            // Build the inverse index. Invalid and degenerate triangles are dropped right away.
+            for( size_t t = 0; ( t < m_triangles.size() ) && !isCancelled(); ++t )
+            {
+                const auto& tri = m_triangles[ t ];
+                bool valid = ( tri.x >= 0 ) && ( tri.y >= 0 ) && ( tri.z >= 0 ) &&
+                             ( static_cast< size_t >( std::max( tri.x, std::max( tri.y, tri.z ) ) ) < numVertices ) &&
+                             ( tri.x != tri.y ) && ( tri.y != tri.z ) && ( tri.x != tri.z );
+                if( !valid )
+                {
+                    continue;
+                }
+
+                m_triangleAlive[ t ] = 1;
+                ++m_numTriangles;
+                for( int k = 0; k < 3; ++k )
+                {
+                    m_vertexTriangles[ tri[ k ] ].push_back( static_cast< uint32_t >( t ) );
+                }
+            }
+
+            // Each vertex accumulates the area weighted planes of its triangles. Boundary edges add a plane perpendicular to the triangle.
+            for( size_t t = 0; t < m_triangles.size(); ++t )
+            {
+                if( !m_triangleAlive[ t ] )
+                {
+                    continue;
+                }
+                if( isCancelled() )
+                {
+                    return;
+                }
+
+                const auto& tri = m_triangles[ t ];
+                auto n = glm::cross( getPosition( tri.y ) - getPosition( tri.x ), getPosition( tri.z ) - getPosition( tri.x ) );
+                auto length = glm::length( n );
+                if( length <= 0.0 )
+                {
+                    continue;
+                }
+                n /= length;
+
+                Quadric plane;
+                plane.addPlane( n, -glm::dot( n, getPosition( tri.x ) ), 0.5 * length );
+                for( int k = 0; k < 3; ++k )
+                {
+                    m_quadrics[ tri[ k ] ].add( plane );
+                }
+
+                for( int k = 0; k < 3; ++k )
+                {
+                    uint32_t a = tri[ k ];
+                    uint32_t b = tri[ ( k + 1 ) % 3 ];
+                    size_t uses = 0;
+                    for( auto other : m_vertexTriangles[ a ] )
+                    {
+                        const auto& otherTri = m_triangles[ other ];
+                        uses += ( static_cast< uint32_t >( otherTri.x ) == b ) ||
+                                ( static_cast< uint32_t >( otherTri.y ) == b ) ||
+                                ( static_cast< uint32_t >( otherTri.z ) == b );
+                    }
+                    if( uses != 1 )
+                    {
+                        continue;
+                    }
+
+                    auto edge = getPosition( b ) - getPosition( a );
+                    auto edgeNormal = glm::cross( edge, n );
+                    auto edgeNormalLength = glm::length( edgeNormal );
+                    if( edgeNormalLength <= 0.0 )
+                    {
+                        continue;
+                    }
+                    edgeNormal /= edgeNormalLength;
+
+                    Quadric boundary;
+                    boundary.addPlane( edgeNormal, -glm::dot( edgeNormal, getPosition( a ) ), g_boundaryWeight * glm::dot( edge, edge ) );
+                    m_quadrics[ a ].add( boundary );
+                    m_quadrics[ b ].add( boundary );
+                }
+            }
+
+            // Queue each edge once.
+            for( uint32_t v = 0; ( v < numVertices ) && !isCancelled(); ++v )
+            {
+                getNeighbours( v, m_neighboursA );
+                for( auto w : m_neighboursA )
+                {
+                    if( w > v )
+                    {
+                        pushCollapse( v, w );
+                    }
+                }
+            }
+        }
+
+        glm::dvec3 QuadricSimplifier::getPosition( uint32_t vertex ) const
+        {
+            return glm::dvec3( m_vertices[ vertex ] );
+        }
+
+        void QuadricSimplifier::getNeighbours( uint32_t vertex, std::vector< uint32_t >& result ) const
+        {
+            result.clear();
+            for( auto t : m_vertexTriangles[ vertex ] )
+            {
+                const auto& tri = m_triangles[ t ];
+                for( int k = 0; k < 3; ++k )
+                {
+                    if( static_cast< uint32_t >( tri[ k ] ) != vertex )
+                    {
+                        result.push_back( tri[ k ] );
+                    }
+                }
+            }
+            std::sort( result.begin(), result.end() );
+            result.erase( std::unique( result.begin(), result.end() ), result.end() );
+        }
+
+        void QuadricSimplifier::pushCollapse( uint32_t a, uint32_t b )
+        {
+            Quadric q = m_quadrics[ a ];
+            q.add( m_quadrics[ b ] );
+
+            double costAToB = q.evaluate( getPosition( b ) );
+            double costBToA = q.evaluate( getPosition( a ) );
+            if( costAToB <= costBToA )
+            {
+                m_queue.push( Collapse( costAToB, a, b, m_versions[ a ], m_versions[ b ] ) );
+            }
+            else
+            {
+                m_queue.push( Collapse( costBToA, b, a, m_versions[ b ], m_versions[ a ] ) );
+            }
+        }
+
+        bool QuadricSimplifier::isCollapseValid( uint32_t from, uint32_t to )
+        {
+            // Triangles sharing the edge vanish. On a manifold, these are 1 (boundary edge) or 2.
+            size_t sharedTriangles = 0;
+            for( auto t : m_vertexTriangles[ from ] )
+            {
+                const auto& tri = m_triangles[ t ];
+                sharedTriangles += ( static_cast< uint32_t >( tri.x ) == to ) ||
+                                   ( static_cast< uint32_t >( tri.y ) == to ) ||
+                                   ( static_cast< uint32_t >( tri.z ) == to );
+            }
+            if( ( sharedTriangles == 0 ) || ( sharedTriangles > 2 ) )
+            {
+                return false;
+            }
+
+            // Link condition: the vertices connected to both end points need to be exactly the opposite vertices of the shared triangles.
+            // Otherwise, the collapse creates non-manifold edges.
+            getNeighbours( from, m_neighboursA );
+            getNeighbours( to, m_neighboursB );
+            size_t common = 0;
+            auto itA = m_neighboursA.begin();
+            auto itB = m_neighboursB.begin();
+            while( ( itA != m_neighboursA.end() ) && ( itB != m_neighboursB.end() ) )
+            {
+                if( *itA < *itB )
+                {
+                    ++itA;
+                }
+                else if( *itB < *itA )
+                {
+                    ++itB;
+                }
+                else
+                {
+                    ++common;
+                    ++itA;
+                    ++itB;
+                }
+            }
+            if( common != sharedTriangles )
+            {
+                return false;
+            }
+
+            // An interior edge between two boundary vertices would pinch the mesh. On a manifold, a vertex is on the boundary if it has more
+            // neighbours than triangles.
+            bool fromOnBoundary = m_neighboursA.size() > m_vertexTriangles[ from ].size();
+            bool toOnBoundary = m_neighboursB.size() > m_vertexTriangles[ to ].size();
+            if( ( sharedTriangles == 2 ) && fromOnBoundary && toOnBoundary )
+            {
+                return false;
+            }
+
+            // Reject collapses that flip or degenerate the remaining triangles around the removed vertex.
+            auto target = getPosition( to );
+            for( auto t : m_vertexTriangles[ from ] )
+            {
+                const auto& tri = m_triangles[ t ];
+                glm::dvec3 before[ 3 ];
+                glm::dvec3 after[ 3 ];
+                bool shared = false;
+                for( int k = 0; k < 3; ++k )
+                {
+                    uint32_t v = tri[ k ];
+                    shared = shared || ( v == to );
+                    before[ k ] = getPosition( v );
+                    after[ k ] = ( v == from ) ? target : before[ k ];
+                }
+                if( shared )
+                {
+                    continue;
+                }
+
+                auto normalBefore = glm::cross( before[ 1 ] - before[ 0 ], before[ 2 ] - before[ 0 ] );
+                auto normalAfter = glm::cross( after[ 1 ] - after[ 0 ], after[ 2 ] - after[ 0 ] );
+                if( glm::dot( normalBefore, normalAfter ) <=
+                    g_minNormalAgreement * glm::length( normalBefore ) * glm::length( normalAfter ) )
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void QuadricSimplifier::collapse( uint32_t from, uint32_t to )
+        {
+            for( auto t : m_vertexTriangles[ from ] )
+            {
+                auto& tri = m_triangles[ t ];
+                bool shared = ( static_cast< uint32_t >( tri.x ) == to ) ||
+                              ( static_cast< uint32_t >( tri.y ) == to ) ||
+                              ( static_cast< uint32_t >( tri.z ) == to );
+                if( shared )
+                {
+                    // The triangle degenerates. Remove it from its other vertices.
+                    m_triangleAlive[ t ] = 0;
+                    --m_numTriangles;
+                    for( int k = 0; k < 3; ++k )
+                    {
+                        uint32_t v = tri[ k ];
+                        if( v != from )
+                        {
+                            auto& triangles = m_vertexTriangles[ v ];
+                            triangles.erase( std::find( triangles.begin(), triangles.end(), t ) );
+                        }
+                    }
+                }
+                else
+                {
+                    for( int k = 0; k < 3; ++k )
+                    {
+                        if( static_cast< uint32_t >( tri[ k ] ) == from )
+                        {
+                            tri[ k ] = static_cast< int >( to );
+                        }
+                    }
+                    m_vertexTriangles[ to ].push_back( t );
+                }
+            }
+
+            m_vertexTriangles[ from ].clear();
+            m_vertexTriangles[ from ].shrink_to_fit();
+            m_removed[ from ] = 1;
+            m_quadrics[ to ].add( m_quadrics[ from ] );
+            ++m_versions[ to ];
+
+            // All edges at the kept vertex changed their cost.
+            getNeighbours( to, m_neighboursA );
+            for( auto w : m_neighboursA )
+            {
+                pushCollapse( to, w );
+            }
+        }
+
+        bool QuadricSimplifier::isCancelled() const
+        {
+            return m_cancel && m_cancel->load( std::memory_order_relaxed );
+        }
+
+        std::vector< IndexVec3Array > QuadricSimplifier::run( const std::vector< size_t >& targets )
+        {
+            std::vector< IndexVec3Array > levels;
+            size_t nextTarget = 0;
+            while( ( nextTarget < targets.size() ) && !isCancelled() )
+            {
+                if( m_numTriangles <= targets[ nextTarget ] )
+                {
+                    levels.push_back( getTriangles() );
+                    ++nextTarget;
+                    continue;
+                }
+
+                if( m_queue.empty() )
+                {
+                    break;
+                }
+
+                auto candidate = m_queue.top();
+                m_queue.pop();
+
+                bool outdated = m_removed[ candidate.m_from ] || m_removed[ candidate.m_to ] ||
+                                ( m_versions[ candidate.m_from ] != candidate.m_fromVersion ) ||
+                                ( m_versions[ candidate.m_to ] != candidate.m_toVersion );
+                if( outdated || !isCollapseValid( candidate.m_from, candidate.m_to ) )
+                {
+                    continue;
+                }
+
+                collapse( candidate.m_from, candidate.m_to );
+            }
+            return levels;
+        }
+
+        IndexVec3Array QuadricSimplifier::getTriangles() const
+        {
+            IndexVec3Array result;
+            result.reserve( m_numTriangles );
+            for( size_t t = 0; t < m_triangles.size(); ++t )
+            {
+                if( m_triangleAlive[ t ] )
+                {
+                    result.push_back( m_triangles[ t ] );
+                }
+            }
+            return result;
+        }
+
+        size_t QuadricSimplifier::getNumTriangles() const
+        {
+            return m_numTriangles;
+        }
+
+        IndexVec3Array simplifyMesh( const TriangleMesh& mesh, size_t targetTriangles )
+        {
+            QuadricSimplifier simplifier( mesh );
+            simplifier.run( std::vector< size_t >( 1, targetTriangles ) );
+            return simplifier.getTriangles();
+        }
+
+        std::vector< IndexVec3Array > buildLevelsOfDetail( const TriangleMesh& mesh, size_t minTriangles, double reduction,
+                                                           const std::atomic< bool >* cancel )
+        {
+            if( ( reduction <= 0.0 ) || ( reduction >= 1.0 ) )
+            {
+                throw std::invalid_argument( "The reduction between two levels of detail needs to be in (0, 1)." );
+            }
+
+            std::vector< size_t > targets;
+            double target = reduction * static_cast< double >( mesh.getNumTriangles() );
+            while( ( target >= static_cast< double >( minTriangles ) ) && ( target >= 1.0 ) )
+            {
+                targets.push_back( static_cast< size_t >( target ) );
+                target *= reduction;
+            }
+            if( targets.empty() )
+            {
+                return std::vector< IndexVec3Array >();
+            }
+
+            QuadricSimplifier simplifier( mesh, cancel );
+            auto levels = simplifier.run( targets );
+            if( simplifier.isCancelled() )
+            {
+                return std::vector< IndexVec3Array >();
+            }
+
+            // The mesh might not be reducible down to all targets. Keep the coarsest result if it is still worth it.
+            if( levels.size() < targets.size() )
+            {
+                double previous = static_cast< double >( levels.empty() ? mesh.getNumTriangles() : levels.back().size() );
+                if( static_cast< double >( simplifier.getNumTriangles() ) < ( 1.0 - 0.5 * ( 1.0 - reduction ) ) * previous )
+                {
+                    levels.push_back( simplifier.getTriangles() );
+                }
+            }
+            return levels;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MESHSIMPLIFIER_H
+#define DI_MESHSIMPLIFIER_H
+
+#include <atomic>
+#include <vector>
+
+#include <di/GfxTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleMesh;
+
+        /**
+         * Simplify a triangle mesh by quadric error edge collapses (Garland and Heckbert). An edge always collapses onto one of its end points,
+         * no new vertices are created. The resulting triangles therefore index the vertex array of the original mesh, and all per-vertex
+         * attributes (normals, colors, labels, vectors) of the original mesh remain valid for the simplified one. Mesh boundaries are
+         * preserved and collapses that would flip triangles or break the manifold property are skipped.
+         *
+         * \param mesh the mesh to simplify
+         * \param targetTriangles the number of triangles to reduce the mesh to. The result can be larger if no more edge can be collapsed.
+         *
+         * \return the triangles of the simplified mesh.
+         */
+        IndexVec3Array simplifyMesh( const TriangleMesh& mesh, size_t targetTriangles );
+
+        /**
+         * Build a chain of successively coarser versions of the given mesh. This works like \ref simplifyMesh but produces all levels in a
+         * single simplification run. All levels index the vertex array of the original mesh.
+         *
+         * \param mesh the mesh to simplify
+         * \param minTriangles stop if a level has less triangles than this
+         * \param reduction the ratio of triangles between two successive levels. In (0, 1).
+         * \param cancel if set and becoming true, the simplification stops as soon as possible. Can be nullptr.
+         *
+         * \return the levels, finest first. The original mesh is not included. Empty if the mesh is not larger than minTriangles or the
+         * build was cancelled.
+         */
+        std::vector< IndexVec3Array > buildLevelsOfDetail( const TriangleMesh& mesh, size_t minTriangles, double reduction = 0.5,
+                                                           const std::atomic< bool >* cancel = nullptr );
+    }
+}
+
+#endif  // DI_MESHSIMPLIFIER_H
+
@@ -0,0 +1,263 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <di/core/data/TriangleMesh.h>
+
+#include "MeshStreamlineTracer.h"
+
+/**
+ * Tracing stops if the interpolated vector is shorter than this fraction of the mean vector length at the triangle vertices.
+ */
+static const double g_minRelativeSpeed = 1e-3;
+
+/**
+ * Tracing stops if the line leaves a triangle through the edge it just entered after less than this fraction of a step. This happens
+ * where the field converges along an edge.
+ */
+static const double g_minProgress = 1e-3;
+
+namespace di
+{
+    namespace core
+    {
+        MeshStreamlineTracer::MeshStreamlineTracer( ConstSPtr< TriangleMesh > mesh ):
+            m_mesh( mesh )
+        {
+            const auto& vertices = mesh->getVertices();
+            const auto& triangles = mesh->getTriangles();
+
+            // Collect all edges with the triangle and the local index of the opposite vertex. Sorting brings the triangles sharing an edge
+            // together.
+            std::vector< std::pair< std::pair< int, int >, size_t > > edges;
+            edges.reserve( triangles.size() * 3 );
+            double edgeLengthSum = 0.0;
+            for( size_t triangle = 0; triangle < triangles.size(); ++triangle )
+            {
+                const auto& tri = triangles[ triangle ];
+                for( int k = 0; k < 3; ++k )
+                {
+                    int a = tri[ ( k + 1 ) % 3 ];
+                    int b = tri[ ( k + 2 ) % 3 ];
+                    edges.push_back( std::make_pair( std::make_pair( std::min( a, b ), std::max( a, b ) ), triangle * 3 + k ) );
+                    edgeLengthSum += glm::distance( vertices[ a ], vertices[ b ] );
+                }
+            }
+            std::sort( edges.begin(), edges.end() );
+
+            m_adjacency.assign( triangles.size(), glm::ivec3( -1 ) );
+            for( size_t begin = 0; begin < edges.size(); )
+            {
+                size_t end = begin + 1;
+                while( ( end < edges.size() ) && ( edges[ end ].first == edges[ begin ].first ) )
+                {
+                    ++end;
+                }
+
+                // Only manifold edges connect triangles.
+                if( end - begin == 2 )
+                {
+                    auto first = edges[ begin ].second;
+                    auto second = edges[ begin + 1 ].second;
+                    m_adjacency[ first / 3 ][ first % 3 ] = static_cast< int >( second / 3 );
+                    m_adjacency[ second / 3 ][ second % 3 ] = static_cast< int >( first / 3 );
+                }
+                begin = end;
+            }
+
+            m_meanEdgeLength = edges.empty() ? 0.0 : edgeLengthSum / static_cast< double >( edges.size() );
+        }
+
+        MeshStreamlineTracer::~MeshStreamlineTracer()
+        {
+            // nothing to clean up
+        }
+
+        ConstSPtr< TriangleMesh > MeshStreamlineTracer::getMesh() const
+        {
+            return m_mesh;
+        }
+
+        double MeshStreamlineTracer::getMeanEdgeLength() const
+        {
+            return m_meanEdgeLength;
+        }
+
+        glm::vec3 MeshStreamlineTracer::getPosition( const Point& point ) const
+        {
+            const auto& tri = m_mesh->getTriangles()[ point.m_triangle ];
+            const auto& vertices = m_mesh->getVertices();
+            const auto& b = point.m_barycentric;
+            return glm::vec3( b.x * glm::dvec3( vertices[ tri.x ] ) + b.y * glm::dvec3( vertices[ tri.y ] ) + b.z * glm::dvec3( vertices[ tri.z ] ) );
+        }
+
+        bool MeshStreamlineTracer::getVelocity( const Vec3Array& vectors, size_t triangle, const glm::dvec3& barycentric, double direction,
+                                                glm::dvec3& result ) const
+        {
+            const auto& tri = m_mesh->getTriangles()[ triangle ];
+            const auto& vertices = m_mesh->getVertices();
+
+            auto e1 = glm::dvec3( vertices[ tri.y ] ) - glm::dvec3( vertices[ tri.x ] );
+            auto e2 = glm::dvec3( vertices[ tri.z ] ) - glm::dvec3( vertices[ tri.x ] );
+            auto normal = glm::cross( e1, e2 );
+            auto normalLength = glm::length( normal );
+            if( normalLength <= 0.0 )
+            {
+                return false;
+            }
+            normal /= normalLength;
+
+            glm::dvec3 v0( vectors[ tri.x ] );
+            glm::dvec3 v1( vectors[ tri.y ] );
+            glm::dvec3 v2( vectors[ tri.z ] );
+            auto v = barycentric.x * v0 + barycentric.y * v1 + barycentric.z * v2;
+            v -= normal * glm::dot( v, normal );
+
+            auto speed = glm::length( v );
+            auto meanSpeed = ( glm::length( v0 ) + glm::length( v1 ) + glm::length( v2 ) ) / 3.0;
+            if( ( speed <= 0.0 ) || ( speed < g_minRelativeSpeed * meanSpeed ) )
+            {
+                return false;
+            }
+            v *= direction / speed;
+
+            // Solve v = d1 * e1 + d2 * e2 using the Gram matrix of the edges.
+            double g11 = glm::dot( e1, e1 );
+            double g12 = glm::dot( e1, e2 );
+            double g22 = glm::dot( e2, e2 );
+            double det = g11 * g22 - g12 * g12;
+            if( det <= 0.0 )
+            {
+                return false;
+            }
+            double r1 = glm::dot( v, e1 );
+            double r2 = glm::dot( v, e2 );
+            double d1 = ( g22 * r1 - g12 * r2 ) / det;
+            double d2 = ( g11 * r2 - g12 * r1 ) / det;
+            result = glm::dvec3( -d1 - d2, d1, d2 );
+            return true;
+        }
+
+        bool MeshStreamlineTracer::trace( const Vec3Array& vectors, const Point& seed, double stepSize, size_t maxSteps, bool backward,
+                                          std::vector< Point >& points ) const
+        {
+            const auto& triangles = m_mesh->getTriangles();
+            double direction = backward ? -1.0 : 1.0;
+
+            auto current = seed;
+            int entryEdge = -1;
+            for( size_t step = 0; step < maxSteps; ++step )
+            {
+                auto triangle = current.m_triangle;
+                const auto& b = current.m_barycentric;
+
+                // RK4. The field is linear in the barycentric coordinates, so evaluating slightly outside the triangle is fine.
+                glm::dvec3 k1;
+                glm::dvec3 k2;
+                glm::dvec3 k3;
+                glm::dvec3 k4;
+                if( !getVelocity( vectors, triangle, b, direction, k1 ) ||
+                    !getVelocity( vectors, triangle, b + 0.5 * stepSize * k1, direction, k2 ) ||
+                    !getVelocity( vectors, triangle, b + 0.5 * stepSize * k2, direction, k3 ) ||
+                    !getVelocity( vectors, triangle, b + stepSize * k3, direction, k4 ) )
+                {
+                    return false;
+                }
+                auto next = b + ( stepSize / 6.0 ) * ( k1 + 2.0 * k2 + 2.0 * k3 + k4 );
+
+                // Find where the step leaves the triangle first, if at all.
+                double exitFraction = 1.0;
+                int exitVertex = -1;
+                for( int c = 0; c < 3; ++c )
+                {
+                    if( next[ c ] < 0.0 )
+                    {
+                        double fraction = b[ c ] / ( b[ c ] - next[ c ] );
+                        if( fraction < exitFraction )
+                        {
+                            exitFraction = fraction;
+                            exitVertex = c;
+                        }
+                    }
+                }
+
+                if( exitVertex < 0 )
+                {
+                    current.m_barycentric = next;
+                    points.push_back( current );
+                    entryEdge = -1;
+                    continue;
+                }
+
+                // Clip the step at the edge opposite to the exit vertex.
+                auto onEdge = b + exitFraction * ( next - b );
+                onEdge[ exitVertex ] = 0.0;
+                onEdge = glm::max( onEdge, glm::dvec3( 0.0 ) );
+                onEdge /= onEdge.x + onEdge.y + onEdge.z;
+                current.m_barycentric = onEdge;
+                points.push_back( current );
+
+                if( ( exitVertex == entryEdge ) && ( exitFraction < g_minProgress ) )
+                {
+                    return false;
+                }
+
+                auto neighbour = m_adjacency[ triangle ][ exitVertex ];
+                if( neighbour < 0 )
+                {
+                    return false;
+                }
+
+                // Express the edge point in the neighbour's barycentric coordinates. The vertex not on the shared edge gets weight 0.
+                const auto& tri = triangles[ triangle ];
+                const auto& neighbourTri = triangles[ neighbour ];
+                glm::dvec3 neighbourBarycentric( 0.0 );
+                entryEdge = -1;
+                for( int n = 0; n < 3; ++n )
+                {
+                    bool shared = false;
+                    for( int c = 0; c < 3; ++c )
+                    {
+                        if( ( c != exitVertex ) && ( tri[ c ] == neighbourTri[ n ] ) )
+                        {
+                            neighbourBarycentric[ n ] = onEdge[ c ];
+                            shared = true;
+                        }
+                    }
+                    if( !shared )
+                    {
+                        entryEdge = n;
+                    }
+                }
+
+                current.m_triangle = static_cast< size_t >( neighbour );
+                current.m_barycentric = neighbourBarycentric;
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,151 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MESHSTREAMLINETRACER_H
+#define DI_MESHSTREAMLINETRACER_H
+
+#include <vector>
+
+#include <di/GfxTypes.h>
+#include <di/MathTypes.h>
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleMesh;
+
+        /**
+         * Traces streamlines of a per-vertex vector field over a triangle mesh. Each step is a fourth order Runge-Kutta step in barycentric
+         * coordinates of the current triangle. Steps leaving the triangle get clipped at the edge and the line continues in the neighbour
+         * sharing that edge. The triangle adjacency is built once on construction. Tracing is const and can be done from several threads.
+         */
+        class MeshStreamlineTracer
+        {
+        public:
+            /**
+             * Position on the mesh. Barycentric coordinates inside a triangle.
+             */
+            struct Point
+            {
+                /**
+                 * The triangle.
+                 */
+                size_t m_triangle = 0;
+
+                /**
+                 * Barycentric coordinates relative to the vertices of the triangle. Sum up to 1.
+                 */
+                glm::dvec3 m_barycentric = glm::dvec3( 1.0 / 3.0 );
+            };
+
+            /**
+             * Create the tracer and build the triangle adjacency.
+             *
+             * \param mesh the mesh to trace on
+             */
+            explicit MeshStreamlineTracer( ConstSPtr< TriangleMesh > mesh );
+
+            /**
+             * Destructor.
+             */
+            virtual ~MeshStreamlineTracer();
+
+            /**
+             * The mesh.
+             *
+             * \return the mesh
+             */
+            ConstSPtr< TriangleMesh > getMesh() const;
+
+            /**
+             * The mean edge length of the mesh. Useful to derive step sizes.
+             *
+             * \return the mean edge length
+             */
+            double getMeanEdgeLength() const;
+
+            /**
+             * Get the world position of a point.
+             *
+             * \param point the point on the mesh
+             *
+             * \return the position
+             */
+            glm::vec3 getPosition( const Point& point ) const;
+
+            /**
+             * Trace a streamline in one direction. Tracing stops at boundaries, where the field vanishes and where it converges onto an edge.
+             *
+             * \param vectors the per-vertex vectors
+             * \param seed where to start
+             * \param stepSize the length of an integration step in world units
+             * \param maxSteps the maximum number of steps
+             * \param backward if true, trace against the field direction
+             * \param points the points along the line get appended here. This includes the points where the line crosses edges. The seed
+             * itself is not added.
+             *
+             * \return true if tracing stopped because it reached maxSteps.
+             */
+            bool trace( const Vec3Array& vectors, const Point& seed, double stepSize, size_t maxSteps, bool backward,
+                        std::vector< Point >& points ) const;
+
+        protected:
+            /**
+             * Interpolate the field at a point in a triangle and express it as change of the barycentric coordinates. The vector is projected
+             * to the triangle plane and normalized, so the integration advances by arc length.
+             *
+             * \param vectors the per-vertex vectors
+             * \param triangle the triangle
+             * \param barycentric the position in the triangle
+             * \param direction 1 to follow the field, -1 to trace backwards
+             * \param result the change of the barycentric coordinates per unit length
+             *
+             * \return false if the field vanishes or the triangle is degenerate.
+             */
+            bool getVelocity( const Vec3Array& vectors, size_t triangle, const glm::dvec3& barycentric, double direction,
+                              glm::dvec3& result ) const;
+
+        private:
+            /**
+             * The mesh.
+             */
+            ConstSPtr< TriangleMesh > m_mesh = nullptr;
+
+            /**
+             * For each triangle, the neighbour across the edge opposite to each of its vertices. -1 on boundary and non-manifold edges.
+             */
+            IndexVec3Array m_adjacency;
+
+            /**
+             * The mean edge length.
+             */
+            double m_meanEdgeLength = 0.0;
+        };
+    }
+}
+
+#endif  // DI_MESHSTREAMLINETRACER_H
+
@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <map>
+#include <utility>
 
 #include "Points.h"
 
@@ -41,19 +42,29 @@ namespace di
             // nothing to do. Vectors get cleared on destruction.
         }
 
-        size_t Points::addVertex( const glm::vec3& vertex )
+        size_t Points::addVertex( const glm::vec3& vertex, bool ifUnique )
         {
+            if( ifUnique )
+            {
+                size_t vIdx = 0;
+                m_vertexHash.update( m_vertices );
+                if( m_vertexHash.find( m_vertices, vertex, vIdx ) )
+                {
+                    return vIdx;
+                }
+            }
+
             m_boundingBox.include( vertex );
             m_vertices.push_back( vertex );
             return m_vertices.size() - 1;
         }
 
-        size_t Points::addVertex( float x, float y, float z )
+        size_t Points::addVertex( float x, float y, float z, bool ifUnique )
         {
             return addVertex(
                 {
                     x, y, z
-                }
+                }, ifUnique
             );
         }
 
@@ -79,12 +90,29 @@ namespace di
 
         Points::Point& Points::getVertex( size_t pointID )
         {
+            // The vertex might get modified.
+            m_vertexHash.clear();
             return m_vertices[ pointID ];
         }
 
         void Points::setVertices( const Vec3Array& vertices )
         {
             m_vertices = vertices;
+            m_vertexHash.clear();
+        }
+
+        void Points::setVertices( Vec3Array&& vertices )
+        {
+            m_vertices = std::move( vertices );
+            m_vertexHash.clear();
+        }
+
+        std::vector< size_t > Points::weldVertices( float tolerance, unsigned threads )
+        {
+            Vec3Array welded;
+            auto mapping = VertexHash::weld( m_vertices, welded, tolerance, threads );
+            setVertices( std::move( welded ) );
+            return mapping;
         }
     }
 }
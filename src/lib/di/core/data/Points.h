@@ -29,6 +29,7 @@
 #include <tuple>
 
 #include <di/core/BoundingBox.h>
+#include <di/core/data/VertexHash.h>
 
 #include <di/MathTypes.h>
 #include <di/GfxTypes.h>
@@ -59,10 +60,12 @@ namespace di
              * Add a vertex to the vertex list.
              *
              * \param vertex the vertex to add.
+             * \param ifUnique add vertex if not yet present. If already present, return its index. Vertices closer than 0.001 are the
+             * same. Uses a spatial hash, so this takes constant time in average.
              *
              * \return the index of the vertex.
              */
-            size_t addVertex( const glm::vec3& vertex );
+            size_t addVertex( const glm::vec3& vertex, bool ifUnique = false );
 
             /**
              * Add a vertex to the vertex list.
@@ -70,10 +73,11 @@ namespace di
              * \param x x component
              * \param y y component
              * \param z z component
+             * \param ifUnique add vertex if not yet present. If already present, return its index.
              *
              * \return the index of the vertex.
              */
-            size_t addVertex( float x, float y, float z );
+            size_t addVertex( float x, float y, float z, bool ifUnique = false );
 
             /**
              * Get the vertex array.
@@ -89,6 +93,23 @@ namespace di
              */
             void setVertices( const Vec3Array& vertices );
 
+            /**
+             * Set the vertex array by moving it. Avoids copying large arrays. Previously added vertices will be overwritten.
+             *
+             * \param vertices the vertex array. Empty after the call.
+             */
+            void setVertices( Vec3Array&& vertices );
+
+            /**
+             * Merge all vertices closer than the given tolerance, in parallel. See \ref VertexHash::weld. Only the kept vertices remain.
+             *
+             * \param tolerance vertices closer than this are merged
+             * \param threads the thread limit, see \ref parallelFor.
+             *
+             * \return the new index of each old vertex. Use it to re-map per-vertex attributes.
+             */
+            std::vector< size_t > weldVertices( float tolerance = 0.001f, unsigned threads = 0 );
+
             /**
              * Abbreviation for 2 vertices of a point.
              */
@@ -112,6 +133,8 @@ namespace di
              *
              * \param pointID the id of the point to retrieve the vertices for.
              *
+             * \note the index used by \ref addVertex for unique vertices is rebuilt after this call.
+             *
              * \return the vertices
              */
             Point& getVertex( size_t pointID );
@@ -141,6 +164,11 @@ namespace di
              * The bounding box.
              */
             BoundingBox m_boundingBox;
+
+            /**
+             * Finds duplicates when adding unique vertices. Only indexes the vertices when needed.
+             */
+            VertexHash m_vertexHash;
         };
     }
 }
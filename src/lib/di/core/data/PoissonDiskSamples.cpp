@@ -0,0 +1,321 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/MathTypes.h>
+
+#include "PoissonDiskSamples.h"
+
+/**
+ * Number of candidates per squared radius of surface area, at the finest level. More candidates fill the gaps better.
+ */
+static const double g_candidatesPerArea = 4.0;
+
+/**
+ * Upper limit for the number of candidates. Limits memory and time for very fine levels.
+ */
+static const size_t g_maxCandidates = 1 << 22;
+
+/**
+ * Seed of the random number generator. Fixed to get the same samples for the same mesh each time.
+ */
+static const unsigned int g_randomSeed = 42;
+
+/**
+ * Number of bits per coordinate in the hash key of a cell.
+ */
+static const int g_cellKeyBits = 21;
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A cell of the spatial hash used while building one level.
+         */
+        struct PoissonDiskCell
+        {
+            /**
+             * Cell coordinates.
+             */
+            glm::ivec3 m_coordinates = glm::ivec3( 0 );
+
+            /**
+             * Range of the sorted candidates in this cell.
+             */
+            size_t m_candidatesBegin = 0;
+
+            /**
+             * End of the range of the sorted candidates in this cell.
+             */
+            size_t m_candidatesEnd = 0;
+
+            /**
+             * Accepted samples in this cell, including the ones of the coarser levels.
+             */
+            Vec3Array m_samples;
+
+            /**
+             * Number of samples in \ref m_samples that stem from the coarser levels.
+             */
+            size_t m_numOldSamples = 0;
+        };
+
+        /**
+         * Get the hash key of a cell.
+         *
+         * \param coordinates the cell coordinates. Need to be positive.
+         *
+         * \return the key
+         */
+        static uint64_t getCellKey( const glm::ivec3& coordinates )
+        {
+            return static_cast< uint64_t >( coordinates.x ) |
+                   ( static_cast< uint64_t >( coordinates.y ) << g_cellKeyBits ) |
+                   ( static_cast< uint64_t >( coordinates.z ) << ( 2 * g_cellKeyBits ) );
+        }
+
+        PoissonDiskSamples::PoissonDiskSamples( const TriangleMesh& mesh, double coarsestRadius, size_t numLevels, unsigned threads )
+        {
+            if( numLevels == 0 )
+            {
+                throw std::invalid_argument( "At least one level of samples is required." );
+            }
+            if( !( coarsestRadius > 0.0 ) )
+            {
+                throw std::invalid_argument( "The sample radius needs to be positive." );
+            }
+
+            for( size_t level = 0; level < numLevels; ++level )
+            {
+                m_radii.push_back( coarsestRadius * std::pow( 0.5, 0.5 * static_cast< double >( level ) ) );
+            }
+            m_levelSizes.assign( numLevels, 0 );
+
+            const auto& vertices = mesh.getVertices();
+            const auto& triangles = mesh.getTriangles();
+            if( triangles.empty() )
+            {
+                return;
+            }
+
+            std::vector< double > cumulativeArea( triangles.size() );
+            double area = 0.0;
+            for( size_t triangle = 0; triangle < triangles.size(); ++triangle )
+            {
+                const auto& tri = triangles[ triangle ];
+                area += 0.5 * glm::length( glm::cross( glm::dvec3( vertices[ tri.y ] ) - glm::dvec3( vertices[ tri.x ] ),
+                                                       glm::dvec3( vertices[ tri.z ] ) - glm::dvec3( vertices[ tri.x ] ) ) );
+                cumulativeArea[ triangle ] = area;
+            }
+            if( !( area > 0.0 ) )
+            {
+                return;
+            }
+
+            auto getNumCandidates = [ & ]( double radius )
+            {
+                return std::min( g_maxCandidates, static_cast< size_t >( std::ceil( g_candidatesPerArea * area / ( radius * radius ) ) ) );
+            };
+
+            // Uniformly distributed candidates in random order. So each prefix is uniformly distributed too, and the coarser levels just
+            // use less of them.
+            size_t numCandidates = getNumCandidates( m_radii.back() );
+            Vec3Array candidates( numCandidates );
+            std::mt19937 generator( g_randomSeed );
+            std::uniform_real_distribution< double > uniform( 0.0, 1.0 );
+            for( auto& candidate : candidates )
+            {
+                auto pick = std::upper_bound( cumulativeArea.begin(), cumulativeArea.end(), uniform( generator ) * area );
+                const auto& tri = triangles[ std::min( static_cast< size_t >( pick - cumulativeArea.begin() ), triangles.size() - 1 ) ];
+
+                double s = std::sqrt( uniform( generator ) );
+                double t = uniform( generator );
+                candidate = glm::vec3( ( 1.0 - s ) * glm::dvec3( vertices[ tri.x ] ) +
+                                       s * ( 1.0 - t ) * glm::dvec3( vertices[ tri.y ] ) +
+                                       s * t * glm::dvec3( vertices[ tri.z ] ) );
+            }
+
+            // Keep one cell of margin, so the neighbours of all cells have positive coordinates.
+            glm::dvec3 origin( vertices[ 0 ] );
+            for( const auto& vertex : vertices )
+            {
+                origin = glm::min( origin, glm::dvec3( vertex ) );
+            }
+            origin -= glm::dvec3( coarsestRadius );
+
+            for( size_t level = 0; level < numLevels; ++level )
+            {
+                double radius = m_radii[ level ];
+                double radiusSquared = radius * radius;
+                auto getCell = [ & ]( const glm::vec3& position )
+                {
+                    return glm::ivec3( glm::floor( ( glm::dvec3( position ) - origin ) / radius ) );
+                };
+
+                // Sort the candidates of this level into cells.
+                size_t numLevelCandidates = getNumCandidates( radius );
+                std::vector< std::pair< uint64_t, uint32_t > > sorted( numLevelCandidates );
+                for( size_t i = 0; i < numLevelCandidates; ++i )
+                {
+                    sorted[ i ] = std::make_pair( getCellKey( getCell( candidates[ i ] ) ), static_cast< uint32_t >( i ) );
+                }
+                std::sort( sorted.begin(), sorted.end() );
+
+                std::vector< PoissonDiskCell > cells;
+                std::unordered_map< uint64_t, size_t > cellIndices;
+                for( size_t begin = 0; begin < sorted.size(); )
+                {
+                    size_t end = begin + 1;
+                    while( ( end < sorted.size() ) && ( sorted[ end ].first == sorted[ begin ].first ) )
+                    {
+                        ++end;
+                    }
+
+                    PoissonDiskCell cell;
+                    cell.m_coordinates = getCell( candidates[ sorted[ begin ].second ] );
+                    cell.m_candidatesBegin = begin;
+                    cell.m_candidatesEnd = end;
+                    cellIndices[ sorted[ begin ].first ] = cells.size();
+                    cells.push_back( std::move( cell ) );
+                    begin = end;
+                }
+
+                // The samples of the coarser levels stay.
+                for( const auto& position : m_positions )
+                {
+                    auto coordinates = getCell( position );
+                    auto key = getCellKey( coordinates );
+                    auto found = cellIndices.find( key );
+                    if( found == cellIndices.end() )
+                    {
+                        PoissonDiskCell cell;
+                        cell.m_coordinates = coordinates;
+                        found = cellIndices.insert( std::make_pair( key, cells.size() ) ).first;
+                        cells.push_back( std::move( cell ) );
+                    }
+                    cells[ found->second ].m_samples.push_back( position );
+                    ++cells[ found->second ].m_numOldSamples;
+                }
+
+                // Cells of the same phase are at least two cells apart. Their candidates cannot conflict and they only read cells of other
+                // phases.
+                std::vector< std::vector< size_t > > phases( 27 );
+                for( size_t cell = 0; cell < cells.size(); ++cell )
+                {
+                    auto phase = cells[ cell ].m_coordinates % 3;
+                    phases[ phase.x + 3 * phase.y + 9 * phase.z ].push_back( cell );
+                }
+
+                for( const auto& phase : phases )
+                {
+                    parallelFor( phase.size(),
+                        [ & ]( size_t begin, size_t end )
+                        {
+                            for( size_t i = begin; i < end; ++i )
+                            {
+                                auto& cell = cells[ phase[ i ] ];
+                                for( size_t candidate = cell.m_candidatesBegin; candidate < cell.m_candidatesEnd; ++candidate )
+                                {
+                                    const auto& position = candidates[ sorted[ candidate ].second ];
+                                    bool conflict = false;
+                                    for( int dz = -1; ( dz <= 1 ) && !conflict; ++dz )
+                                    {
+                                        for( int dy = -1; ( dy <= 1 ) && !conflict; ++dy )
+                                        {
+                                            for( int dx = -1; ( dx <= 1 ) && !conflict; ++dx )
+                                            {
+                                                auto found = cellIndices.find( getCellKey( cell.m_coordinates + glm::ivec3( dx, dy, dz ) ) );
+                                                if( found == cellIndices.end() )
+                                                {
+                                                    continue;
+                                                }
+                                                for( const auto& sample : cells[ found->second ].m_samples )
+                                                {
+                                                    auto difference = sample - position;
+                                                    if( glm::dot( difference, difference ) < radiusSquared )
+                                                    {
+                                                        conflict = true;
+                                                        break;
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    if( !conflict )
+                                    {
+                                        cell.m_samples.push_back( position );
+                                    }
+                                }
+                            }
+                        },
+                        64, threads
+                    );
+                }
+
+                for( const auto& cell : cells )
+                {
+                    m_positions.insert( m_positions.end(), cell.m_samples.begin() + cell.m_numOldSamples, cell.m_samples.end() );
+                }
+                m_levelSizes[ level ] = m_positions.size();
+            }
+        }
+
+        PoissonDiskSamples::~PoissonDiskSamples()
+        {
+            // nothing to clean up
+        }
+
+        const Vec3Array& PoissonDiskSamples::getPositions() const
+        {
+            return m_positions;
+        }
+
+        size_t PoissonDiskSamples::getNumLevels() const
+        {
+            return m_radii.size();
+        }
+
+        double PoissonDiskSamples::getRadius( size_t level ) const
+        {
+            return m_radii.at( level );
+        }
+
+        size_t PoissonDiskSamples::getNumSamples( size_t level ) const
+        {
+            return m_levelSizes.at( level );
+        }
+    }
+}
@@ -0,0 +1,118 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_POISSONDISKSAMPLES_H
+#define DI_POISSONDISKSAMPLES_H
+
+#include <vector>
+
+#include <di/GfxTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleMesh;
+
+        /**
+         * Blue noise sample points on the surface of a triangle mesh, in several density levels. No two samples of a level are closer than the
+         * radius of the level. The levels are nested: each level contains all samples of the coarser levels, and the samples are sorted by
+         * level. So a level is just a prefix of \ref getPositions. The radius shrinks by sqrt(2) per level, which doubles the density.
+         *
+         * The samples are selected from random candidates on the surface by dart throwing. A spatial hash with cells as large as the radius
+         * finds the close samples. Cells that are at least two cells apart cannot conflict, so the cells are processed in 27 interleaved
+         * phases, each in parallel. The result does not depend on the number of threads.
+         */
+        class PoissonDiskSamples
+        {
+        public:
+            /**
+             * Compute the samples.
+             *
+             * \param mesh the mesh to sample
+             * \param coarsestRadius the radius of level 0
+             * \param numLevels the number of levels. At least 1.
+             * \param threads the thread limit, see \ref parallelFor.
+             */
+            PoissonDiskSamples( const TriangleMesh& mesh, double coarsestRadius, size_t numLevels, unsigned threads = 0 );
+
+            /**
+             * Destructor.
+             */
+            virtual ~PoissonDiskSamples();
+
+            /**
+             * The sample positions of all levels, sorted by level.
+             *
+             * \return the positions
+             */
+            const Vec3Array& getPositions() const;
+
+            /**
+             * The number of levels.
+             *
+             * \return the number of levels
+             */
+            size_t getNumLevels() const;
+
+            /**
+             * The minimal distance of the samples in the given level.
+             *
+             * \param level the level
+             *
+             * \return the radius
+             */
+            double getRadius( size_t level ) const;
+
+            /**
+             * The number of samples in the given level. These are the first samples in \ref getPositions.
+             *
+             * \param level the level
+             *
+             * \return the number of samples
+             */
+            size_t getNumSamples( size_t level ) const;
+
+        protected:
+        private:
+            /**
+             * All samples.
+             */
+            Vec3Array m_positions;
+
+            /**
+             * The radius of each level.
+             */
+            std::vector< double > m_radii;
+
+            /**
+             * The number of samples of each level.
+             */
+            std::vector< size_t > m_levelSizes;
+        };
+    }
+}
+
+#endif  // DI_POISSONDISKSAMPLES_H
+
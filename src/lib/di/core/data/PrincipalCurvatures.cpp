@@ -0,0 +1,372 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/MathTypes.h>
+
+#include "PrincipalCurvatures.h"
+
+/**
+ * Triangles whose least squares system is this close to singular get no curvature. Relative to the cubed squared edge lengths.
+ */
+static const double g_degenerateDeterminant = 1e-12;
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * The second fundamental form fitted to a triangle.
+         */
+        struct PrincipalCurvaturesTriangle
+        {
+            /**
+             * First axis of the frame the tensor is given in.
+             */
+            glm::dvec3 m_u = glm::dvec3( 0.0 );
+
+            /**
+             * Second axis of the frame the tensor is given in.
+             */
+            glm::dvec3 m_v = glm::dvec3( 0.0 );
+
+            /**
+             * The tensor entries uu, uv and vv.
+             */
+            glm::dvec3 m_tensor = glm::dvec3( 0.0 );
+
+            /**
+             * The part of the triangle area associated with each corner.
+             */
+            glm::dvec3 m_cornerAreas = glm::dvec3( 0.0 );
+        };
+
+        /**
+         * Rotate a frame around the axis perpendicular to its normal and a new normal, so that it becomes perpendicular to the new normal.
+         *
+         * \param u first axis of the frame
+         * \param v second axis of the frame
+         * \param normal the new normal
+         * \param rotatedU the rotated first axis
+         * \param rotatedV the rotated second axis
+         */
+        static void rotateFrame( const glm::dvec3& u, const glm::dvec3& v, const glm::dvec3& normal,
+                                 glm::dvec3& rotatedU, glm::dvec3& rotatedV )
+        {
+            rotatedU = u;
+            rotatedV = v;
+
+            auto oldNormal = glm::cross( u, v );
+            auto cosine = glm::dot( oldNormal, normal );
+            if( cosine <= -1.0 + 1e-9 )
+            {
+                rotatedU = -u;
+                rotatedV = -v;
+                return;
+            }
+
+            auto perpendicular = normal - cosine * oldNormal;
+            auto correction = ( oldNormal + normal ) / ( 1.0 + cosine );
+            rotatedU -= correction * glm::dot( rotatedU, perpendicular );
+            rotatedV -= correction * glm::dot( rotatedV, perpendicular );
+        }
+
+        /**
+         * Express a tensor given in one frame in another frame, which might have another normal.
+         *
+         * \param u first axis of the old frame
+         * \param v second axis of the old frame
+         * \param tensor the tensor entries uu, uv and vv in the old frame
+         * \param newU first axis of the new frame
+         * \param newV second axis of the new frame
+         *
+         * \return the tensor entries in the new frame
+         */
+        static glm::dvec3 projectTensor( const glm::dvec3& u, const glm::dvec3& v, const glm::dvec3& tensor,
+                                         const glm::dvec3& newU, const glm::dvec3& newV )
+        {
+            glm::dvec3 rotatedU;
+            glm::dvec3 rotatedV;
+            rotateFrame( newU, newV, glm::cross( u, v ), rotatedU, rotatedV );
+
+            double u1 = glm::dot( rotatedU, u );
+            double v1 = glm::dot( rotatedU, v );
+            double u2 = glm::dot( rotatedV, u );
+            double v2 = glm::dot( rotatedV, v );
+            return glm::dvec3( tensor.x * u1 * u1 + tensor.y * 2.0 * u1 * v1 + tensor.z * v1 * v1,
+                               tensor.x * u1 * u2 + tensor.y * ( u1 * v2 + u2 * v1 ) + tensor.z * v1 * v2,
+                               tensor.x * u2 * u2 + tensor.y * 2.0 * u2 * v2 + tensor.z * v2 * v2 );
+        }
+
+        /**
+         * Split the area of a triangle among its corners by the Voronoi regions of the corners. Obtuse triangles give half of their area to
+         * the obtuse corner instead (Meyer et al., "Discrete Differential-Geometry Operators for Triangulated 2-Manifolds", 2003).
+         *
+         * \param edges the edges opposite to each corner, in counter-clockwise order
+         * \param area the triangle area
+         *
+         * \return the area of each corner
+         */
+        static glm::dvec3 getCornerAreas( const glm::dvec3 edges[ 3 ], double area )
+        {
+            glm::dvec3 lengths;
+            glm::dvec3 weights;
+            for( int i = 0; i < 3; ++i )
+            {
+                lengths[ i ] = glm::dot( edges[ i ], edges[ i ] );
+            }
+            for( int i = 0; i < 3; ++i )
+            {
+                weights[ i ] = lengths[ i ] * ( lengths[ ( i + 1 ) % 3 ] + lengths[ ( i + 2 ) % 3 ] - lengths[ i ] );
+            }
+
+            glm::dvec3 areas;
+            for( int i = 0; i < 3; ++i )
+            {
+                if( weights[ i ] <= 0.0 )
+                {
+                    int j = ( i + 1 ) % 3;
+                    int k = ( i + 2 ) % 3;
+                    areas[ j ] = -0.25 * lengths[ k ] * area / glm::dot( edges[ i ], edges[ k ] );
+                    areas[ k ] = -0.25 * lengths[ j ] * area / glm::dot( edges[ i ], edges[ j ] );
+                    areas[ i ] = area - areas[ j ] - areas[ k ];
+                    return areas;
+                }
+            }
+
+            double scale = 0.5 * area / ( weights.x + weights.y + weights.z );
+            for( int i = 0; i < 3; ++i )
+            {
+                areas[ i ] = scale * ( weights[ ( i + 1 ) % 3 ] + weights[ ( i + 2 ) % 3 ] );
+            }
+            return areas;
+        }
+
+        /**
+         * Find the corner of a triangle at the given vertex.
+         *
+         * \param triangle the triangle. Needs to contain the vertex.
+         * \param vertex the vertex
+         *
+         * \return the corner, 0 to 2
+         */
+        static int getCorner( const glm::ivec3& triangle, size_t vertex )
+        {
+            return ( static_cast< size_t >( triangle.x ) == vertex ) ? 0 : ( ( static_cast< size_t >( triangle.y ) == vertex ) ? 1 : 2 );
+        }
+
+        PrincipalCurvatures::PrincipalCurvatures( const TriangleMesh& mesh, unsigned threads )
+        {
+            const auto& vertices = mesh.getVertices();
+            const auto& normals = mesh.getNormals();
+            const auto& triangles = mesh.getTriangles();
+            if( normals.size() != vertices.size() )
+            {
+                throw std::invalid_argument( "The mesh needs one normal per vertex to compute curvatures." );
+            }
+
+            // Fit the tensor of each triangle to the normal change along its edges.
+            std::vector< PrincipalCurvaturesTriangle > fits( triangles.size() );
+            parallelFor( triangles.size(),
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t triangle = begin; triangle < end; ++triangle )
+                    {
+                        const auto& tri = triangles[ triangle ];
+                        glm::dvec3 positions[ 3 ] = { glm::dvec3( vertices[ tri.x ] ), glm::dvec3( vertices[ tri.y ] ),
+                                                      glm::dvec3( vertices[ tri.z ] ) };
+                        glm::dvec3 edges[ 3 ] = { positions[ 2 ] - positions[ 1 ], positions[ 0 ] - positions[ 2 ],
+                                                  positions[ 1 ] - positions[ 0 ] };
+                        auto normal = glm::cross( edges[ 0 ], edges[ 1 ] );
+                        double area = 0.5 * glm::length( normal );
+                        if( !( area > 0.0 ) )
+                        {
+                            continue;
+                        }
+
+                        auto& fit = fits[ triangle ];
+                        fit.m_u = glm::normalize( edges[ 0 ] );
+                        fit.m_v = glm::normalize( glm::cross( normal, fit.m_u ) );
+
+                        // Least squares: the tensor applied to each edge gives the normal difference along the edge.
+                        glm::dmat3 system( 0.0 );
+                        glm::dvec3 rhs( 0.0 );
+                        for( int j = 0; j < 3; ++j )
+                        {
+                            double u = glm::dot( edges[ j ], fit.m_u );
+                            double v = glm::dot( edges[ j ], fit.m_v );
+                            system[ 0 ][ 0 ] += u * u;
+                            system[ 0 ][ 1 ] += u * v;
+                            system[ 2 ][ 2 ] += v * v;
+
+                            auto normalChange = glm::dvec3( normals[ tri[ ( j + 2 ) % 3 ] ] ) -
+                                                glm::dvec3( normals[ tri[ ( j + 1 ) % 3 ] ] );
+                            double nu = glm::dot( normalChange, fit.m_u );
+                            double nv = glm::dot( normalChange, fit.m_v );
+                            rhs += glm::dvec3( nu * u, nu * v + nv * u, nv * v );
+                        }
+                        system[ 1 ][ 1 ] = system[ 0 ][ 0 ] + system[ 2 ][ 2 ];
+                        system[ 1 ][ 2 ] = system[ 0 ][ 1 ];
+                        system[ 1 ][ 0 ] = system[ 0 ][ 1 ];
+                        system[ 2 ][ 1 ] = system[ 1 ][ 2 ];
+
+                        double scale = system[ 1 ][ 1 ] * system[ 1 ][ 1 ] * system[ 1 ][ 1 ];
+                        if( !( std::abs( glm::determinant( system ) ) > g_degenerateDeterminant * scale ) )
+                        {
+                            continue;
+                        }
+                        fit.m_tensor = glm::inverse( system ) * rhs;
+                        fit.m_cornerAreas = getCornerAreas( edges, area );
+                    }
+                },
+                1024, threads
+            );
+
+            // Average the tensors of the triangles around each vertex in the tangent frame of the vertex and diagonalize. Gathering per
+            // vertex avoids write conflicts between the threads.
+            const auto& inverseIndex = mesh.getInverseIndex();
+            m_curvatures.resize( vertices.size() );
+            m_maxDirections.resize( vertices.size() );
+            m_minDirections.resize( vertices.size() );
+            parallelFor( vertices.size(),
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t vertex = begin; vertex < end; ++vertex )
+                    {
+                        glm::dvec3 normal( normals[ vertex ] );
+                        normal = ( glm::length( normal ) > 0.0 ) ? glm::normalize( normal ) : glm::dvec3( 0.0, 0.0, 1.0 );
+
+                        // Any tangent will do as the first axis. Prefer an edge, to be independent of the orientation of the mesh.
+                        glm::dvec3 u( 1.0, 0.0, 0.0 );
+                        if( !inverseIndex[ vertex ].empty() )
+                        {
+                            const auto& tri = triangles[ inverseIndex[ vertex ].front() ];
+                            auto next = tri[ ( getCorner( tri, vertex ) + 1 ) % 3 ];
+                            u = glm::dvec3( vertices[ next ] ) - glm::dvec3( vertices[ vertex ] );
+                        }
+                        u = glm::cross( u, normal );
+                        if( !( glm::length( u ) > 0.0 ) )
+                        {
+                            u = glm::cross( ( std::abs( normal.x ) < 0.5 ) ? glm::dvec3( 1.0, 0.0, 0.0 ) : glm::dvec3( 0.0, 1.0, 0.0 ),
+                                            normal );
+                        }
+                        u = glm::normalize( u );
+                        auto v = glm::cross( normal, u );
+
+                        glm::dvec3 tensor( 0.0 );
+                        double area = 0.0;
+                        for( auto triangle : inverseIndex[ vertex ] )
+                        {
+                            const auto& fit = fits[ triangle ];
+                            int corner = getCorner( triangles[ triangle ], vertex );
+                            tensor += fit.m_cornerAreas[ corner ] * projectTensor( fit.m_u, fit.m_v, fit.m_tensor, u, v );
+                            area += fit.m_cornerAreas[ corner ];
+                        }
+                        if( area > 0.0 )
+                        {
+                            tensor /= area;
+                        }
+
+                        // Jacobi rotation to diagonalize the symmetric 2x2 tensor.
+                        double c = 1.0;
+                        double s = 0.0;
+                        double t = 0.0;
+                        if( tensor.y != 0.0 )
+                        {
+                            double h = 0.5 * ( tensor.z - tensor.x ) / tensor.y;
+                            t = ( h < 0.0 ) ? 1.0 / ( h - std::sqrt( 1.0 + h * h ) ) : 1.0 / ( h + std::sqrt( 1.0 + h * h ) );
+                            c = 1.0 / std::sqrt( 1.0 + t * t );
+                            s = t * c;
+                        }
+                        double k1 = tensor.x - t * tensor.y;
+                        double k2 = tensor.z + t * tensor.y;
+
+                        glm::dvec3 maxDirection;
+                        if( k1 >= k2 )
+                        {
+                            m_curvatures[ vertex ] = glm::vec2( k1, k2 );
+                            maxDirection = c * u - s * v;
+                        }
+                        else
+                        {
+                            m_curvatures[ vertex ] = glm::vec2( k2, k1 );
+                            maxDirection = s * u + c * v;
+                        }
+                        m_maxDirections[ vertex ] = glm::vec3( maxDirection );
+                        m_minDirections[ vertex ] = glm::vec3( glm::cross( normal, maxDirection ) );
+                    }
+                },
+                1024, threads
+            );
+        }
+
+        PrincipalCurvatures::~PrincipalCurvatures()
+        {
+            // nothing to clean up
+        }
+
+        const Vec2Array& PrincipalCurvatures::getCurvatures() const
+        {
+            return m_curvatures;
+        }
+
+        const Vec3Array& PrincipalCurvatures::getMaxDirections() const
+        {
+            return m_maxDirections;
+        }
+
+        const Vec3Array& PrincipalCurvatures::getMinDirections() const
+        {
+            return m_minDirections;
+        }
+
+        float PrincipalCurvatures::getMeanCurvature( size_t vertex ) const
+        {
+            return 0.5f * ( m_curvatures[ vertex ].x + m_curvatures[ vertex ].y );
+        }
+
+        float PrincipalCurvatures::getGaussianCurvature( size_t vertex ) const
+        {
+            return m_curvatures[ vertex ].x * m_curvatures[ vertex ].y;
+        }
+
+        float PrincipalCurvatures::getNormalCurvature( size_t vertex, const glm::vec3& direction ) const
+        {
+            // The principal directions span the tangent plane. So these are the coordinates of the projected direction.
+            float c = glm::dot( direction, m_maxDirections[ vertex ] );
+            float s = glm::dot( direction, m_minDirections[ vertex ] );
+            float length = c * c + s * s;
+            if( !( length > 0.0f ) )
+            {
+                return 0.0f;
+            }
+            return ( m_curvatures[ vertex ].x * c * c + m_curvatures[ vertex ].y * s * s ) / length;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_PRINCIPALCURVATURES_H
+#define DI_PRINCIPALCURVATURES_H
+
+#include <di/GfxTypes.h>
+#include <di/MathTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleMesh;
+
+        /**
+         * Per-vertex curvature tensors of a triangle mesh, given as principal curvatures and directions. The second fundamental form is
+         * fitted per triangle to the change of the vertex normals along its edges and averaged at the vertices, weighted by the Voronoi
+         * area of each corner (Rusinkiewicz, "Estimating Curvatures and Their Derivatives on Triangle Meshes", 2004).
+         *
+         * Curvatures are positive where the surface bends away from its normal, like on a sphere with outward normals. Triangles and
+         * vertices are processed in parallel. The result does not depend on the number of threads.
+         */
+        class PrincipalCurvatures
+        {
+        public:
+            /**
+             * Compute the curvatures.
+             *
+             * \throw std::invalid_argument if the mesh does not have one normal per vertex.
+             *
+             * \param mesh the mesh. Needs normals.
+             * \param threads the thread limit, see \ref parallelFor.
+             */
+            explicit PrincipalCurvatures( const TriangleMesh& mesh, unsigned threads = 0 );
+
+            /**
+             * Destructor.
+             */
+            virtual ~PrincipalCurvatures();
+
+            /**
+             * The principal curvatures of each vertex. x is the maximum, y the minimum curvature.
+             *
+             * \return the curvatures
+             */
+            const Vec2Array& getCurvatures() const;
+
+            /**
+             * The direction of maximum curvature of each vertex. Unit length and perpendicular to the vertex normal.
+             *
+             * \return the directions
+             */
+            const Vec3Array& getMaxDirections() const;
+
+            /**
+             * The direction of minimum curvature of each vertex. Unit length and perpendicular to the vertex normal and the maximum
+             * direction.
+             *
+             * \return the directions
+             */
+            const Vec3Array& getMinDirections() const;
+
+            /**
+             * The mean curvature of a vertex.
+             *
+             * \param vertex the vertex
+             *
+             * \return the mean of the principal curvatures
+             */
+            float getMeanCurvature( size_t vertex ) const;
+
+            /**
+             * The Gaussian curvature of a vertex.
+             *
+             * \param vertex the vertex
+             *
+             * \return the product of the principal curvatures
+             */
+            float getGaussianCurvature( size_t vertex ) const;
+
+            /**
+             * The curvature of the surface at a vertex along a given direction.
+             *
+             * \param vertex the vertex
+             * \param direction the direction. Does not need to be normalized or tangential. Only its projection to the tangent plane is
+             * used.
+             *
+             * \return the normal curvature. 0 if the direction is parallel to the normal.
+             */
+            float getNormalCurvature( size_t vertex, const glm::vec3& direction ) const;
+
+        protected:
+        private:
+            /**
+             * Maximum and minimum curvature per vertex.
+             */
+            Vec2Array m_curvatures;
+
+            /**
+             * Direction of maximum curvature per vertex.
+             */
+            Vec3Array m_maxDirections;
+
+            /**
+             * Direction of minimum curvature per vertex.
+             */
+            Vec3Array m_minDirections;
+        };
+    }
+}
+
+#endif  // DI_PRINCIPALCURVATURES_H
+
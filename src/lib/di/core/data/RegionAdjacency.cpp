@@ -0,0 +1,152 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "RegionAdjacency.h"
+
+namespace di
+{
+    namespace core
+    {
+        RegionAdjacency::RegionAdjacency( const std::vector< double >& labels, std::vector< Edge > edges ):
+            m_labels( labels ),
+            m_offsets( labels.size() + 1, 0 )
+        {
+            // Use the smaller region first. This way, sorting brings the duplicates together.
+            for( auto& edge : edges )
+            {
+                if( ( std::get< 0 >( edge ) >= labels.size() ) || ( std::get< 1 >( edge ) >= labels.size() ) )
+                {
+                    throw std::out_of_range( "The region adjacency edge references an unknown region." );
+                }
+                if( std::get< 0 >( edge ) > std::get< 1 >( edge ) )
+                {
+                    std::swap( std::get< 0 >( edge ), std::get< 1 >( edge ) );
+                }
+            }
+            std::sort( edges.begin(), edges.end() );
+
+            // Merge duplicates and drop self-loops.
+            std::vector< Edge > merged;
+            for( const auto& edge : edges )
+            {
+                if( std::get< 0 >( edge ) == std::get< 1 >( edge ) )
+                {
+                    continue;
+                }
+                if( !merged.empty() && ( std::get< 0 >( merged.back() ) == std::get< 0 >( edge ) ) &&
+                                       ( std::get< 1 >( merged.back() ) == std::get< 1 >( edge ) ) )
+                {
+                    std::get< 2 >( merged.back() ) += std::get< 2 >( edge );
+                }
+                else
+                {
+                    merged.push_back( edge );
+                }
+            }
+
+            // Count the neighbours of each region and place them.
+            for( const auto& edge : merged )
+            {
+                ++m_offsets[ std::get< 0 >( edge ) + 1 ];
+                ++m_offsets[ std::get< 1 >( edge ) + 1 ];
+            }
+            for( size_t region = 0; region < labels.size(); ++region )
+            {
+                m_offsets[ region + 1 ] += m_offsets[ region ];
+            }
+
+            // First fill in the smaller neighbours of each region, then the larger ones. The edges are sorted, so both come in ascending
+            // order. This keeps each row sorted without any further sorting.
+            std::vector< size_t > next( m_offsets.begin(), m_offsets.end() - 1 );
+            m_neighbours.resize( m_offsets.back() );
+            m_boundaryLengths.resize( m_offsets.back() );
+            for( const auto& edge : merged )
+            {
+                auto first = std::get< 0 >( edge );
+                auto second = std::get< 1 >( edge );
+                m_neighbours[ next[ second ] ] = first;
+                m_boundaryLengths[ next[ second ]++ ] = std::get< 2 >( edge );
+            }
+            for( const auto& edge : merged )
+            {
+                auto first = std::get< 0 >( edge );
+                auto second = std::get< 1 >( edge );
+                m_neighbours[ next[ first ] ] = second;
+                m_boundaryLengths[ next[ first ]++ ] = std::get< 2 >( edge );
+            }
+        }
+
+        RegionAdjacency::~RegionAdjacency()
+        {
+            // nothing to do
+        }
+
+        size_t RegionAdjacency::getNumRegions() const
+        {
+            return m_labels.size();
+        }
+
+        size_t RegionAdjacency::getNumEdges() const
+        {
+            return m_neighbours.size() / 2;
+        }
+
+        const std::vector< double >& RegionAdjacency::getLabels() const
+        {
+            return m_labels;
+        }
+
+        ArrayView< const size_t > RegionAdjacency::getNeighbours( size_t region ) const
+        {
+            return ArrayView< const size_t >( m_neighbours.data() + m_offsets[ region ], m_offsets[ region + 1 ] - m_offsets[ region ] );
+        }
+
+        ArrayView< const double > RegionAdjacency::getBoundaryLengths( size_t region ) const
+        {
+            return ArrayView< const double >( m_boundaryLengths.data() + m_offsets[ region ], m_offsets[ region + 1 ] - m_offsets[ region ] );
+        }
+
+        double RegionAdjacency::getBoundaryLength( size_t region1, size_t region2 ) const
+        {
+            auto begin = m_neighbours.begin() + m_offsets[ region1 ];
+            auto end = m_neighbours.begin() + m_offsets[ region1 + 1 ];
+            auto found = std::lower_bound( begin, end, region2 );
+            if( ( found == end ) || ( *found != region2 ) )
+            {
+                return 0.0;
+            }
+            return m_boundaryLengths[ found - m_neighbours.begin() ];
+        }
+
+        const std::vector< size_t >& RegionAdjacency::getOffsets() const
+        {
+            return m_offsets;
+        }
+    }
+}
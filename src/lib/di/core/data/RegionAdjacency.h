@@ -0,0 +1,149 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_REGIONADJACENCY_H
+#define DI_REGIONADJACENCY_H
+
+#include <tuple>
+#include <vector>
+
+#include <di/core/data/ArrayView.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * The neighbourhood graph of labeled regions on a mesh. Each pair of adjacent regions is connected by an edge weighted by the length of
+         * their shared boundary. The graph is stored in compressed sparse row form: the neighbours of all regions are stored in one array,
+         * sorted by region and neighbour, and an offset array marks where each region starts. The graph is symmetric.
+         */
+        class RegionAdjacency
+        {
+        public:
+            /**
+             * An edge between two regions: the region indices and the boundary length.
+             */
+            typedef std::tuple< size_t, size_t, double > Edge;
+
+            /**
+             * Build the graph.
+             *
+             * \param labels the label of each region. The index in this array is the region index.
+             * \param edges the edges between the regions. Each pair of regions only needs to be listed in one direction. Edges listed
+             * multiple times are merged and their lengths are summed up. Edges of a region to itself are ignored.
+             *
+             * \throw std::out_of_range if an edge references a region that does not exist.
+             */
+            RegionAdjacency( const std::vector< double >& labels, std::vector< Edge > edges );
+
+            /**
+             * Destructor.
+             */
+            virtual ~RegionAdjacency();
+
+            /**
+             * The number of regions.
+             *
+             * \return the number of regions
+             */
+            size_t getNumRegions() const;
+
+            /**
+             * The number of pairs of adjacent regions. Each pair is counted once.
+             *
+             * \return the number of edges
+             */
+            size_t getNumEdges() const;
+
+            /**
+             * The label of each region.
+             *
+             * \return the labels
+             */
+            const std::vector< double >& getLabels() const;
+
+            /**
+             * Get the neighbours of a region, sorted by region index.
+             *
+             * \param region the region
+             *
+             * \return the region indices of the neighbours
+             */
+            ArrayView< const size_t > getNeighbours( size_t region ) const;
+
+            /**
+             * Get the length of the boundary to each neighbour of a region. In the same order as \ref getNeighbours.
+             *
+             * \param region the region
+             *
+             * \return the boundary lengths
+             */
+            ArrayView< const double > getBoundaryLengths( size_t region ) const;
+
+            /**
+             * Get the length of the boundary between two regions.
+             *
+             * \param region1 the first region
+             * \param region2 the second region
+             *
+             * \return the length. 0 if the regions are not adjacent.
+             */
+            double getBoundaryLength( size_t region1, size_t region2 ) const;
+
+            /**
+             * The start of the neighbours of each region in \ref getNeighbours. Contains one more element than there are regions, which
+             * marks the end of the last region.
+             *
+             * \return the offsets
+             */
+            const std::vector< size_t >& getOffsets() const;
+
+        protected:
+        private:
+            /**
+             * The label of each region.
+             */
+            std::vector< double > m_labels;
+
+            /**
+             * The start of the neighbours of each region.
+             */
+            std::vector< size_t > m_offsets;
+
+            /**
+             * The neighbours of all regions.
+             */
+            std::vector< size_t > m_neighbours;
+
+            /**
+             * The boundary lengths to the neighbours of all regions.
+             */
+            std::vector< double > m_boundaryLengths;
+        };
+    }
+}
+
+#endif  // DI_REGIONADJACENCY_H
+
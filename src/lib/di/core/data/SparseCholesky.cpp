@@ -0,0 +1,388 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <di/core/data/SparseMatrix.h>
+
+#include "SparseCholesky.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Parts of the graph with at most this many vertices are not dissected any further.
+         */
+        static const size_t g_minDissectionSize = 64;
+
+        /**
+         * Marks a missing index.
+         */
+        static const size_t g_none = std::numeric_limits< size_t >::max();
+
+        /**
+         * Breadth-first search in the graph of a matrix, limited to the vertices with the given tag.
+         *
+         * \param matrix the matrix. Each off-diagonal entry is an edge.
+         * \param root the start vertex
+         * \param tags the tag of each vertex
+         * \param tag only vertices with this tag are searched
+         * \param stamps marks the visited vertices
+         * \param stamp the mark to use. Vertices already carrying this mark are skipped.
+         * \param levels the distance of each visited vertex to the root
+         * \param visited the visited vertices, in the order of visiting. So the last one is the farthest one.
+         */
+        static void searchBreadthFirst( const SparseMatrix& matrix, size_t root, const std::vector< size_t >& tags, size_t tag,
+                                        std::vector< size_t >& stamps, size_t stamp, std::vector< size_t >& levels,
+                                        std::vector< size_t >& visited )
+        {
+            const auto& offsets = matrix.getRowOffsets();
+            const auto& columns = matrix.getColumns();
+
+            visited.clear();
+            visited.push_back( root );
+            stamps[ root ] = stamp;
+            levels[ root ] = 0;
+            for( size_t i = 0; i < visited.size(); ++i )
+            {
+                auto vertex = visited[ i ];
+                for( size_t entry = offsets[ vertex ]; entry < offsets[ vertex + 1 ]; ++entry )
+                {
+                    auto neighbour = columns[ entry ];
+                    if( ( tags[ neighbour ] == tag ) && ( stamps[ neighbour ] != stamp ) )
+                    {
+                        stamps[ neighbour ] = stamp;
+                        levels[ neighbour ] = levels[ vertex ] + 1;
+                        visited.push_back( neighbour );
+                    }
+                }
+            }
+        }
+
+        /**
+         * Order the rows of a symmetric matrix by nested dissection.
+         *
+         * \param matrix the matrix
+         *
+         * \return the original row of each row in the new order
+         */
+        static std::vector< size_t > orderNestedDissection( const SparseMatrix& matrix )
+        {
+            const auto& offsets = matrix.getRowOffsets();
+            const auto& columns = matrix.getColumns();
+            size_t size = matrix.getNumRows();
+
+            std::vector< size_t > order( size );
+            std::vector< size_t > tags( size, 0 );
+            std::vector< size_t > stamps( size, 0 );
+            std::vector< size_t > levels( size, 0 );
+            std::vector< size_t > visited;
+            size_t nextTag = 1;
+            size_t nextStamp = 1;
+
+            // Each part of the graph owns a range of the new order, starting at the given position.
+            std::vector< std::pair< size_t, std::vector< size_t > > > parts;
+            std::vector< size_t > all( size );
+            std::iota( all.begin(), all.end(), 0 );
+            parts.push_back( std::make_pair( 0, std::move( all ) ) );
+            while( !parts.empty() )
+            {
+                auto begin = parts.back().first;
+                auto vertices = std::move( parts.back().second );
+                parts.pop_back();
+                if( vertices.size() <= g_minDissectionSize )
+                {
+                    std::copy( vertices.begin(), vertices.end(), order.begin() + begin );
+                    continue;
+                }
+
+                size_t tag = nextTag++;
+                for( auto vertex : vertices )
+                {
+                    tags[ vertex ] = tag;
+                }
+
+                // Split disconnected parts into their components first.
+                size_t stamp = nextStamp++;
+                searchBreadthFirst( matrix, vertices.front(), tags, tag, stamps, stamp, levels, visited );
+                if( visited.size() < vertices.size() )
+                {
+                    size_t position = begin;
+                    parts.push_back( std::make_pair( position, visited ) );
+                    position += visited.size();
+                    for( auto vertex : vertices )
+                    {
+                        if( stamps[ vertex ] != stamp )
+                        {
+                            searchBreadthFirst( matrix, vertex, tags, tag, stamps, stamp, levels, visited );
+                            parts.push_back( std::make_pair( position, visited ) );
+                            position += visited.size();
+                        }
+                    }
+                    continue;
+                }
+
+                // The last vertex found is far away from the root. Searching from there gives a long and thin level structure.
+                searchBreadthFirst( matrix, visited.back(), tags, tag, stamps, nextStamp++, levels, visited );
+                size_t numLevels = levels[ visited.back() ] + 1;
+                if( numLevels < 3 )
+                {
+                    std::copy( vertices.begin(), vertices.end(), order.begin() + begin );
+                    continue;
+                }
+
+                // The middle level splits the vertices in halves. Only its vertices touching the next level are needed to separate them.
+                size_t separatorLevel = std::min( std::max( levels[ visited[ visited.size() / 2 ] ], static_cast< size_t >( 1 ) ),
+                                                  numLevels - 2 );
+                std::vector< size_t > first;
+                std::vector< size_t > second;
+                std::vector< size_t > separator;
+                for( auto vertex : visited )
+                {
+                    if( levels[ vertex ] < separatorLevel )
+                    {
+                        first.push_back( vertex );
+                    }
+                    else if( levels[ vertex ] > separatorLevel )
+                    {
+                        second.push_back( vertex );
+                    }
+                    else
+                    {
+                        bool touches = false;
+                        for( size_t entry = offsets[ vertex ]; ( entry < offsets[ vertex + 1 ] ) && !touches; ++entry )
+                        {
+                            touches = ( tags[ columns[ entry ] ] == tag ) && ( levels[ columns[ entry ] ] == separatorLevel + 1 );
+                        }
+                        ( touches ? separator : first ).push_back( vertex );
+                    }
+                }
+
+                // The separator is eliminated last.
+                std::copy( separator.begin(), separator.end(), order.begin() + begin + first.size() + second.size() );
+                parts.push_back( std::make_pair( begin + first.size(), std::move( second ) ) );
+                parts.push_back( std::make_pair( begin, std::move( first ) ) );
+            }
+            return order;
+        }
+
+        SparseCholesky::SparseCholesky( const SparseMatrix& matrix )
+        {
+            if( matrix.getNumRows() != matrix.getNumColumns() )
+            {
+                throw std::invalid_argument( "Only square matrices can be factorized." );
+            }
+
+            size_t size = matrix.getNumRows();
+            m_permutation = orderNestedDissection( matrix );
+            std::vector< size_t > inverse( size );
+            for( size_t row = 0; row < size; ++row )
+            {
+                inverse[ m_permutation[ row ] ] = row;
+            }
+
+            // The lower triangle of the reordered matrix, by rows.
+            const auto& offsets = matrix.getRowOffsets();
+            const auto& columns = matrix.getColumns();
+            const auto& values = matrix.getValues();
+            std::vector< size_t > lowerOffsets( size + 1, 0 );
+            std::vector< std::pair< size_t, double > > lower;
+            lower.reserve( matrix.getNumNonZeros() / 2 + size );
+            for( size_t row = 0; row < size; ++row )
+            {
+                auto original = m_permutation[ row ];
+                for( size_t entry = offsets[ original ]; entry < offsets[ original + 1 ]; ++entry )
+                {
+                    if( inverse[ columns[ entry ] ] <= row )
+                    {
+                        lower.push_back( std::make_pair( inverse[ columns[ entry ] ], values[ entry ] ) );
+                    }
+                }
+                lowerOffsets[ row + 1 ] = lower.size();
+            }
+
+            // The elimination tree. The parent of a column is the first row below the diagonal with a non-zero in L.
+            std::vector< size_t > parent( size, g_none );
+            std::vector< size_t > ancestor( size, g_none );
+            for( size_t row = 0; row < size; ++row )
+            {
+                for( size_t entry = lowerOffsets[ row ]; entry < lowerOffsets[ row + 1 ]; ++entry )
+                {
+                    size_t next = g_none;
+                    for( size_t column = lower[ entry ].first; ( column != g_none ) && ( column < row ); column = next )
+                    {
+                        next = ancestor[ column ];
+                        ancestor[ column ] = row;
+                        if( next == g_none )
+                        {
+                            parent[ column ] = row;
+                        }
+                    }
+                }
+            }
+
+            // The non-zeros of row k of L are the nodes reached walking up the tree from the non-zeros of row k of the matrix. The stack
+            // gets them in topological order, so each column is final before it is used.
+            std::vector< size_t > marks( size, g_none );
+            std::vector< size_t > path( size );
+            std::vector< size_t > stack( size );
+            auto reachRow = [ & ]( size_t row )
+            {
+                size_t top = size;
+                marks[ row ] = row;
+                for( size_t entry = lowerOffsets[ row ]; entry < lowerOffsets[ row + 1 ]; ++entry )
+                {
+                    size_t length = 0;
+                    for( size_t column = lower[ entry ].first; marks[ column ] != row; column = parent[ column ] )
+                    {
+                        path[ length++ ] = column;
+                        marks[ column ] = row;
+                    }
+                    while( length > 0 )
+                    {
+                        stack[ --top ] = path[ --length ];
+                    }
+                }
+                return top;
+            };
+
+            // Count the non-zeros per column.
+            m_columnOffsets.assign( size + 1, 0 );
+            for( size_t row = 0; row < size; ++row )
+            {
+                ++m_columnOffsets[ row + 1 ];
+                for( size_t top = reachRow( row ); top < size; ++top )
+                {
+                    ++m_columnOffsets[ stack[ top ] + 1 ];
+                }
+            }
+            for( size_t column = 0; column < size; ++column )
+            {
+                m_columnOffsets[ column + 1 ] += m_columnOffsets[ column ];
+            }
+            m_rows.resize( m_columnOffsets.back() );
+            m_values.resize( m_columnOffsets.back() );
+
+            // Compute L row by row. Each row needs a sparse triangular solve with the rows above.
+            std::fill( marks.begin(), marks.end(), g_none );
+            std::vector< size_t > next( m_columnOffsets.begin(), m_columnOffsets.end() - 1 );
+            std::vector< double > work( size, 0.0 );
+            for( size_t row = 0; row < size; ++row )
+            {
+                size_t top = reachRow( row );
+                for( size_t entry = lowerOffsets[ row ]; entry < lowerOffsets[ row + 1 ]; ++entry )
+                {
+                    work[ lower[ entry ].first ] += lower[ entry ].second;
+                }
+
+                double diagonal = work[ row ];
+                work[ row ] = 0.0;
+                for( ; top < size; ++top )
+                {
+                    auto column = stack[ top ];
+                    double value = work[ column ] / m_values[ m_columnOffsets[ column ] ];
+                    work[ column ] = 0.0;
+                    for( size_t entry = m_columnOffsets[ column ] + 1; entry < next[ column ]; ++entry )
+                    {
+                        work[ m_rows[ entry ] ] -= m_values[ entry ] * value;
+                    }
+                    diagonal -= value * value;
+                    m_rows[ next[ column ] ] = row;
+                    m_values[ next[ column ]++ ] = value;
+                }
+
+                if( !( diagonal > 0.0 ) )
+                {
+                    throw std::runtime_error( "The matrix is not positive definite." );
+                }
+                m_rows[ next[ row ] ] = row;
+                m_values[ next[ row ]++ ] = std::sqrt( diagonal );
+            }
+        }
+
+        SparseCholesky::~SparseCholesky()
+        {
+            // nothing to do
+        }
+
+        size_t SparseCholesky::getSize() const
+        {
+            return m_permutation.size();
+        }
+
+        size_t SparseCholesky::getNumNonZeros() const
+        {
+            return m_values.size();
+        }
+
+        void SparseCholesky::solve( const std::vector< double >& rhs, std::vector< double >& solution ) const
+        {
+            size_t size = getSize();
+            if( rhs.size() != size )
+            {
+                throw std::invalid_argument( "The right hand side does not match the size of the matrix." );
+            }
+
+            std::vector< double > work( size );
+            for( size_t row = 0; row < size; ++row )
+            {
+                work[ row ] = rhs[ m_permutation[ row ] ];
+            }
+
+            // Solve L y = b.
+            for( size_t column = 0; column < size; ++column )
+            {
+                work[ column ] /= m_values[ m_columnOffsets[ column ] ];
+                for( size_t entry = m_columnOffsets[ column ] + 1; entry < m_columnOffsets[ column + 1 ]; ++entry )
+                {
+                    work[ m_rows[ entry ] ] -= m_values[ entry ] * work[ column ];
+                }
+            }
+
+            // Solve L^T x = y.
+            for( size_t column = size; column > 0; --column )
+            {
+                double value = work[ column - 1 ];
+                for( size_t entry = m_columnOffsets[ column - 1 ] + 1; entry < m_columnOffsets[ column ]; ++entry )
+                {
+                    value -= m_values[ entry ] * work[ m_rows[ entry ] ];
+                }
+                work[ column - 1 ] = value / m_values[ m_columnOffsets[ column - 1 ] ];
+            }
+
+            solution.resize( size );
+            for( size_t row = 0; row < size; ++row )
+            {
+                solution[ m_permutation[ row ] ] = work[ row ];
+            }
+        }
+    }
+}
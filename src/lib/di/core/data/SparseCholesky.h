@@ -0,0 +1,113 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_SPARSECHOLESKY_H
+#define DI_SPARSECHOLESKY_H
+
+#include <cstddef>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        class SparseMatrix;
+
+        /**
+         * Sparse Cholesky factorization P A P^T = L L^T of a symmetric positive definite matrix. Factorize once, then solve for any
+         * number of right hand sides with two triangular solves each. Use this instead of \ref solveConjugateGradient if the same matrix is
+         * solved repeatedly.
+         *
+         * The rows are reordered by nested dissection to limit the fill-in: the graph of the matrix is split recursively by the middle
+         * level of a breadth-first search, and the separators are eliminated last. This works well for the graphs of surface meshes.
+         */
+        class SparseCholesky
+        {
+        public:
+            /**
+             * Factorize the matrix. Only the lower triangle is used.
+             *
+             * \throw std::invalid_argument if the matrix is not square.
+             * \throw std::runtime_error if the matrix is not positive definite.
+             *
+             * \param matrix the symmetric positive definite matrix
+             */
+            explicit SparseCholesky( const SparseMatrix& matrix );
+
+            /**
+             * Destructor.
+             */
+            virtual ~SparseCholesky();
+
+            /**
+             * The number of rows of the factorized matrix.
+             *
+             * \return the size
+             */
+            size_t getSize() const;
+
+            /**
+             * The number of non-zeros of the factor L. Shows the memory use and the cost of \ref solve.
+             *
+             * \return the number of non-zeros
+             */
+            size_t getNumNonZeros() const;
+
+            /**
+             * Solve matrix * solution = rhs. Can be called from several threads at once.
+             *
+             * \throw std::invalid_argument if the size of rhs does not match.
+             *
+             * \param rhs the right hand side
+             * \param solution the solution. Resized if needed.
+             */
+            void solve( const std::vector< double >& rhs, std::vector< double >& solution ) const;
+
+        protected:
+        private:
+            /**
+             * The original row of each row of the reordered matrix.
+             */
+            std::vector< size_t > m_permutation;
+
+            /**
+             * Start of each column of L. The diagonal element is the first one in each column.
+             */
+            std::vector< size_t > m_columnOffsets;
+
+            /**
+             * The row of each non-zero of L.
+             */
+            std::vector< size_t > m_rows;
+
+            /**
+             * The value of each non-zero of L.
+             */
+            std::vector< double > m_values;
+        };
+    }
+}
+
+#endif  // DI_SPARSECHOLESKY_H
+
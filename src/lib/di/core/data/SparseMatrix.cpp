@@ -0,0 +1,192 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <di/core/Parallel.h>
+
+#include "SparseMatrix.h"
+
+namespace di
+{
+    namespace core
+    {
+        SparseMatrix::Entry::Entry( size_t row, size_t column, double value ):
+            m_row( row ),
+            m_column( column ),
+            m_value( value )
+        {
+        }
+
+        SparseMatrix::SparseMatrix()
+        {
+        }
+
+        SparseMatrix::SparseMatrix( size_t rows, size_t columns, const std::vector< Entry >& entries ):
+            m_numRows( rows ),
+            m_numColumns( columns )
+        {
+            // Count the entries per row to bucket them without sorting the whole list.
+            std::vector< size_t > offsets( rows + 1, 0 );
+            for( const auto& entry : entries )
+            {
+                if( ( entry.m_row >= rows ) || ( entry.m_column >= columns ) )
+                {
+                    throw std::out_of_range( "Sparse matrix entry is outside the matrix." );
+                }
+                ++offsets[ entry.m_row + 1 ];
+            }
+            for( size_t row = 0; row < rows; ++row )
+            {
+                offsets[ row + 1 ] += offsets[ row ];
+            }
+
+            std::vector< std::pair< size_t, double > > buckets( entries.size() );
+            auto fill = offsets;
+            for( const auto& entry : entries )
+            {
+                buckets[ fill[ entry.m_row ]++ ] = std::make_pair( entry.m_column, entry.m_value );
+            }
+
+            // Sort each row by column and merge duplicates.
+            m_rowOffsets.assign( rows + 1, 0 );
+            m_columns.reserve( entries.size() );
+            m_values.reserve( entries.size() );
+            for( size_t row = 0; row < rows; ++row )
+            {
+                auto begin = buckets.begin() + offsets[ row ];
+                auto end = buckets.begin() + offsets[ row + 1 ];
+                std::sort( begin, end,
+                    []( const std::pair< size_t, double >& a, const std::pair< size_t, double >& b )
+                    {
+                        return a.first < b.first;
+                    }
+                );
+
+                for( auto it = begin; it != end; ++it )
+                {
+                    if( ( m_columns.size() > m_rowOffsets[ row ] ) && ( m_columns.back() == it->first ) )
+                    {
+                        m_values.back() += it->second;
+                    }
+                    else
+                    {
+                        m_columns.push_back( it->first );
+                        m_values.push_back( it->second );
+                    }
+                }
+                m_rowOffsets[ row + 1 ] = m_columns.size();
+            }
+        }
+
+        SparseMatrix::~SparseMatrix()
+        {
+        }
+
+        size_t SparseMatrix::getNumRows() const
+        {
+            return m_numRows;
+        }
+
+        size_t SparseMatrix::getNumColumns() const
+        {
+            return m_numColumns;
+        }
+
+        size_t SparseMatrix::getNumNonZeros() const
+        {
+            return m_values.size();
+        }
+
+        const std::vector< size_t >& SparseMatrix::getRowOffsets() const
+        {
+            return m_rowOffsets;
+        }
+
+        const std::vector< size_t >& SparseMatrix::getColumns() const
+        {
+            return m_columns;
+        }
+
+        const std::vector< double >& SparseMatrix::getValues() const
+        {
+            return m_values;
+        }
+
+        double SparseMatrix::get( size_t row, size_t column ) const
+        {
+            if( ( row >= m_numRows ) || ( column >= m_numColumns ) )
+            {
+                throw std::out_of_range( "Sparse matrix position is outside the matrix." );
+            }
+
+            auto begin = m_columns.begin() + m_rowOffsets[ row ];
+            auto end = m_columns.begin() + m_rowOffsets[ row + 1 ];
+            auto it = std::lower_bound( begin, end, column );
+            if( ( it == end ) || ( *it != column ) )
+            {
+                return 0.0;
+            }
+            return m_values[ it - m_columns.begin() ];
+        }
+
+        std::vector< double > SparseMatrix::getDiagonal() const
+        {
+            std::vector< double > diagonal( std::min( m_numRows, m_numColumns ), 0.0 );
+            for( size_t row = 0; row < diagonal.size(); ++row )
+            {
+                diagonal[ row ] = get( row, row );
+            }
+            return diagonal;
+        }
+
+        void SparseMatrix::multiply( const std::vector< double >& vector, std::vector< double >& result, unsigned threads ) const
+        {
+            if( vector.size() != m_numColumns )
+            {
+                throw std::invalid_argument( "Vector size does not match the number of matrix columns." );
+            }
+
+            result.resize( m_numRows );
+            parallelFor( m_numRows,
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t row = begin; row < end; ++row )
+                    {
+                        double sum = 0.0;
+                        for( size_t i = m_rowOffsets[ row ]; i < m_rowOffsets[ row + 1 ]; ++i )
+                        {
+                            sum += m_values[ i ] * vector[ m_columns[ i ] ];
+                        }
+                        result[ row ] = sum;
+                    }
+                },
+                4096, threads
+            );
+        }
+    }
+}
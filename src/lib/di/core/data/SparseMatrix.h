@@ -0,0 +1,196 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_SPARSEMATRIX_H
+#define DI_SPARSEMATRIX_H
+
+#include <cstddef>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A sparse matrix in compressed sparse row (CSR) format. The matrix is immutable after construction. Build it from a list of entries.
+         */
+        class SparseMatrix
+        {
+        public:
+            /**
+             * A single entry of the matrix. Used to build the matrix.
+             */
+            struct Entry
+            {
+                /**
+                 * Create an entry.
+                 *
+                 * \param row the row
+                 * \param column the column
+                 * \param value the value
+                 */
+                Entry( size_t row, size_t column, double value );
+
+                /**
+                 * The row.
+                 */
+                size_t m_row;
+
+                /**
+                 * The column.
+                 */
+                size_t m_column;
+
+                /**
+                 * The value.
+                 */
+                double m_value;
+            };
+
+            /**
+             * Create an empty 0x0 matrix.
+             */
+            SparseMatrix();
+
+            /**
+             * Create a matrix from the given entries. Entries at the same position are summed up.
+             *
+             * \throw std::out_of_range if an entry is outside the matrix.
+             *
+             * \param rows the number of rows
+             * \param columns the number of columns
+             * \param entries the non-zero entries in any order.
+             */
+            SparseMatrix( size_t rows, size_t columns, const std::vector< Entry >& entries );
+
+            /**
+             * Destructor.
+             */
+            virtual ~SparseMatrix();
+
+            /**
+             * The number of rows.
+             *
+             * \return the number of rows
+             */
+            size_t getNumRows() const;
+
+            /**
+             * The number of columns.
+             *
+             * \return the number of columns
+             */
+            size_t getNumColumns() const;
+
+            /**
+             * The number of stored entries.
+             *
+             * \return the number of entries.
+             */
+            size_t getNumNonZeros() const;
+
+            /**
+             * The start of each row in \ref getColumns and \ref getValues. Has \ref getNumRows() + 1 elements. The last one is the number of
+             * stored entries.
+             *
+             * \return the row offsets
+             */
+            const std::vector< size_t >& getRowOffsets() const;
+
+            /**
+             * The column of each stored entry. Sorted within each row.
+             *
+             * \return the columns
+             */
+            const std::vector< size_t >& getColumns() const;
+
+            /**
+             * The value of each stored entry.
+             *
+             * \return the values
+             */
+            const std::vector< double >& getValues() const;
+
+            /**
+             * Get the value at the given position.
+             *
+             * \throw std::out_of_range if the position is outside the matrix.
+             *
+             * \param row the row
+             * \param column the column
+             *
+             * \return the value. 0 if not stored.
+             */
+            double get( size_t row, size_t column ) const;
+
+            /**
+             * Get the diagonal.
+             *
+             * \return the diagonal. Has min( rows, columns ) elements.
+             */
+            std::vector< double > getDiagonal() const;
+
+            /**
+             * Calculate result = matrix * vector. The rows are processed in parallel.
+             *
+             * \throw std::invalid_argument if the vector size does not match the number of columns.
+             *
+             * \param vector the vector to multiply
+             * \param result the result. Resized to the number of rows.
+             * \param threads the thread limit, see \ref parallelFor.
+             */
+            void multiply( const std::vector< double >& vector, std::vector< double >& result, unsigned threads = 0 ) const;
+
+        protected:
+        private:
+            /**
+             * Number of rows.
+             */
+            size_t m_numRows = 0;
+
+            /**
+             * Number of columns.
+             */
+            size_t m_numColumns = 0;
+
+            /**
+             * Start of each row.
+             */
+            std::vector< size_t > m_rowOffsets = { 0 };
+
+            /**
+             * Column of each entry.
+             */
+            std::vector< size_t > m_columns = {};
+
+            /**
+             * Value of each entry.
+             */
+            std::vector< double > m_values = {};
+        };
+    }
+}
+
+#endif  // DI_SPARSEMATRIX_H
+
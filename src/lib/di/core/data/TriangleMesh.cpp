@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <vector>
 #include <map>
+#include <utility>
 
 #include "TriangleMesh.h"
 
@@ -42,19 +43,29 @@ namespace di
             // nothing to do. Vectors get cleared on destruction.
         }
 
-        size_t TriangleMesh::addVertex( const glm::vec3& vertex )
+        size_t TriangleMesh::addVertex( const glm::vec3& vertex, bool ifUnique )
         {
+            if( ifUnique )
+            {
+                size_t vIdx = 0;
+                m_vertexHash.update( m_vertices );
+                if( m_vertexHash.find( m_vertices, vertex, vIdx ) )
+                {
+                    return vIdx;
+                }
+            }
+
             m_boundingBox.include( vertex );
             m_vertices.push_back( vertex );
             return m_vertices.size() - 1;
         }
 
-        size_t TriangleMesh::addVertex( float x, float y, float z )
+        size_t TriangleMesh::addVertex( float x, float y, float z, bool ifUnique )
         {
             return addVertex(
                 {
                     x, y, z
-                }
+                }, ifUnique
             );
         }
 
@@ -116,7 +127,7 @@ namespace di
         bool TriangleMesh::sanityCheck() const
         {
             bool enoughTris = ( getNumTriangles() >= 1 );
-            bool enoughNormals = ( getNumNormals() == 0 ) || ( getNumNormals() == getNumTriangles() );  // either a normal for every vertex or none.
+            bool enoughNormals = ( getNumNormals() == 0 ) || ( getNumNormals() == getNumVertices() );  // either a normal for every vertex or none.
             return enoughTris && enoughNormals;
         }
 
@@ -150,9 +161,60 @@ namespace di
             m_triangles = triangles;
         }
 
+        void TriangleMesh::setTriangles( IndexVec3Array&& triangles )
+        {
+            m_triangles = std::move( triangles );
+        }
+
         void TriangleMesh::setVertices( const Vec3Array& vertices )
         {
             m_vertices = vertices;
+            m_vertexHash.clear();
+            updateBoundingBox();
+        }
+
+        void TriangleMesh::setVertices( Vec3Array&& vertices )
+        {
+            m_vertices = std::move( vertices );
+            m_vertexHash.clear();
+            updateBoundingBox();
+        }
+
+        std::vector< size_t > TriangleMesh::weldVertices( float tolerance, unsigned threads )
+        {
+            Vec3Array welded;
+            auto mapping = VertexHash::weld( m_vertices, welded, tolerance, threads );
+
+            // Triangles smaller than the tolerance collapse to a line or point. Drop them.
+            IndexVec3Array triangles;
+            triangles.reserve( m_triangles.size() );
+            for( const auto& triangle : m_triangles )
+            {
+                glm::ivec3 weldedTriangle( mapping[ triangle.x ], mapping[ triangle.y ], mapping[ triangle.z ] );
+                if( ( weldedTriangle.x != weldedTriangle.y ) && ( weldedTriangle.y != weldedTriangle.z ) &&
+                    ( weldedTriangle.x != weldedTriangle.z ) )
+                {
+                    triangles.push_back( weldedTriangle );
+                }
+            }
+            m_triangles = std::move( triangles );
+
+            // Keep the normals of the kept vertices. These are the first ones mapped to each new index.
+            if( m_normals.size() == m_vertices.size() )
+            {
+                NormalArray normals( welded.size() );
+                for( size_t vertexID = m_vertices.size(); vertexID > 0; --vertexID )
+                {
+                    normals[ mapping[ vertexID - 1 ] ] = m_normals[ vertexID - 1 ];
+                }
+                m_normals = std::move( normals );
+            }
+
+            setVertices( std::move( welded ) );
+
+            // Triangles now share vertices they did not share before.
+            calculateInverseIndex();
+            return mapping;
         }
 
         void TriangleMesh::setNormals( const NormalArray& normals )
@@ -160,6 +222,27 @@ namespace di
             m_normals = normals;
         }
 
+        void TriangleMesh::setNormals( NormalArray&& normals )
+        {
+            m_normals = std::move( normals );
+        }
+
+        void TriangleMesh::reserve( size_t numVertices, size_t numTriangles )
+        {
+            m_vertices.reserve( numVertices );
+            m_normals.reserve( numVertices );
+            m_triangles.reserve( numTriangles );
+        }
+
+        void TriangleMesh::updateBoundingBox()
+        {
+            m_boundingBox = BoundingBox();
+            for( const auto& vertex : m_vertices )
+            {
+                m_boundingBox.include( vertex );
+            }
+        }
+
         glm::vec3 TriangleMesh::getNormal( size_t vertexID ) const
         {
             return m_normals[ vertexID ];
@@ -183,6 +266,20 @@ namespace di
             }
         }
 
+        const std::vector< std::vector< size_t > >& TriangleMesh::getInverseIndex() const
+        {
+            if( m_inverseIndex.empty() )
+            {
+                calculateInverseIndex();
+            }
+            return m_inverseIndex;
+        }
+
+        void TriangleMesh::setInverseIndex( std::vector< std::vector< size_t > >&& inverseIndex )
+        {
+            m_inverseIndex = std::move( inverseIndex );
+        }
+
         std::vector< size_t > TriangleMesh::getNeighbours( size_t triID ) const
         {
             if( m_inverseIndex.empty() )
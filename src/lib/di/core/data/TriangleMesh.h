@@ -29,6 +29,7 @@
 #include <tuple>
 
 #include <di/core/BoundingBox.h>
+#include <di/core/data/VertexHash.h>
 
 #include <di/MathTypes.h>
 #include <di/GfxTypes.h>
@@ -60,10 +61,12 @@ namespace di
              * Add a vertex to the vertex list.
              *
              * \param vertex the vertex to add.
+             * \param ifUnique add vertex if not yet present. If already present, return its index. Vertices closer than 0.001 are the
+             * same. Uses a spatial hash, so this takes constant time in average.
              *
              * \return the index of the vertex.
              */
-            size_t addVertex( const glm::vec3& vertex );
+            size_t addVertex( const glm::vec3& vertex, bool ifUnique = false );
 
             /**
              * Add a vertex to the vertex list.
@@ -71,10 +74,11 @@ namespace di
              * \param x x component
              * \param y y component
              * \param z z component
+             * \param ifUnique add vertex if not yet present. If already present, return its index.
              *
              * \return the index of the vertex.
              */
-            size_t addVertex( float x, float y, float z );
+            size_t addVertex( float x, float y, float z, bool ifUnique = false );
 
             /**
              * Add the given normal.
@@ -125,12 +129,32 @@ namespace di
             const Vec3Array& getVertices() const;
 
             /**
-             * Set the vertex array. Previously added vertices will be overwritten.
+             * Set the vertex array. Previously added vertices will be overwritten. The bounding box is updated accordingly.
              *
              * \param vertices the vertex array.
              */
             void setVertices( const Vec3Array& vertices );
 
+            /**
+             * Set the vertex array by moving it into the mesh. Avoids copying large arrays. Previously added vertices will be overwritten. The
+             * bounding box is updated accordingly.
+             *
+             * \param vertices the vertex array. Empty after the call.
+             */
+            void setVertices( Vec3Array&& vertices );
+
+            /**
+             * Merge all vertices closer than the given tolerance, in parallel. See \ref VertexHash::weld. The triangles are re-mapped to the
+             * kept vertices and the normals of the kept vertices remain. Triangles that degenerate, because two of their vertices are merged,
+             * are removed. Triangle IDs can therefore change. The inverse index is re-calculated.
+             *
+             * \param tolerance vertices closer than this are merged
+             * \param threads the thread limit, see \ref parallelFor.
+             *
+             * \return the new index of each old vertex. Use it to re-map per-vertex attributes.
+             */
+            std::vector< size_t > weldVertices( float tolerance = 0.001f, unsigned threads = 0 );
+
             /**
              * Abbreviation for 3 vertices of a triangle.
              */
@@ -211,6 +235,13 @@ namespace di
              */
             void setNormals( const NormalArray& normals );
 
+            /**
+             * Set the given normals by moving them into the mesh. Overwrites previously defined normals.
+             *
+             * \param normals the normals to set. Empty after the call.
+             */
+            void setNormals( NormalArray&& normals );
+
             /**
              * Get the amount of normals for this mesh. A valid mesh will contain either 0 or exactly 1 for each vertex.
              *
@@ -232,6 +263,22 @@ namespace di
              */
             void setTriangles( const IndexVec3Array& triangles );
 
+            /**
+             * Set the triangle index array by moving it into the mesh. Overwrites previously set triangles.
+             *
+             * \param triangles the index array. Empty after the call.
+             */
+            void setTriangles( IndexVec3Array&& triangles );
+
+            /**
+             * Reserve memory for the given amount of vertices and triangles. Use this before adding a known amount of vertices and triangles
+             * using \ref addVertex and \ref addTriangle to avoid re-allocation and the temporary memory overhead that comes with it.
+             *
+             * \param numVertices the number of vertices to expect. Also used for the normals.
+             * \param numTriangles the number of triangles to expect.
+             */
+            void reserve( size_t numVertices, size_t numTriangles );
+
             /**
              * The number of triangles currently defined.
              *
@@ -271,8 +318,28 @@ namespace di
              * Create an inverse index to find triangles associated with a given vertex.
              */
             void calculateInverseIndex() const;
+
+            /**
+             * Get the inverse index, which associates each vertex with the triangles using it. Calculated if not yet done.
+             *
+             * \return the inverse index. One sorted list of triangle IDs per vertex.
+             */
+            const std::vector< std::vector< size_t > >& getInverseIndex() const;
+
+            /**
+             * Set a pre-computed inverse index. Use this to avoid re-calculation, for example when loading cached meshes. The index is not
+             * validated.
+             *
+             * \param inverseIndex the index. One sorted list of triangle IDs per vertex. Empty after the call.
+             */
+            void setInverseIndex( std::vector< std::vector< size_t > >&& inverseIndex );
         protected:
         private:
+            /**
+             * Re-calculate the bounding box from the whole vertex array.
+             */
+            void updateBoundingBox();
+
             /**
              * Vertex array.
              */
@@ -299,6 +366,11 @@ namespace di
              * The bounding box.
              */
             BoundingBox m_boundingBox;
+
+            /**
+             * Finds duplicates when adding unique vertices. Only indexes the vertices when needed.
+             */
+            VertexHash m_vertexHash;
         };
     }
 }
@@ -0,0 +1,173 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/MathTypes.h>
+
+#include "VectorFieldSingularities.h"
+
+/**
+ * Number of triangles handled as one unit of work. Fixed, so the order of the result does not depend on the number of threads.
+ */
+static const size_t g_tileSize = 4096;
+
+/**
+ * Fields whose interpolation in a triangle is this close to singular are skipped. Relative to the squared vector lengths. This happens for
+ * constant and parallel vectors, where the zero is not isolated.
+ */
+static const double g_degenerateDeterminant = 1e-12;
+
+/**
+ * A rotation counts as center if the real part of the eigenvalues is below this fraction of the imaginary part.
+ */
+static const double g_centerTolerance = 0.01;
+
+namespace di
+{
+    namespace core
+    {
+        VectorFieldSingularities::VectorFieldSingularities( const TriangleMesh& mesh, const Vec3Array& vectors, unsigned threads )
+        {
+            const auto& vertices = mesh.getVertices();
+            const auto& triangles = mesh.getTriangles();
+            if( vectors.size() != vertices.size() )
+            {
+                throw std::invalid_argument( "Number of vectors needs to match the number of vertices in the triangle mesh." );
+            }
+
+            size_t numTiles = ( triangles.size() + g_tileSize - 1 ) / g_tileSize;
+            std::vector< std::vector< Singularity > > tiles( numTiles );
+            parallelFor( numTiles,
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t tile = begin; tile < end; ++tile )
+                    {
+                        size_t last = std::min( triangles.size(), ( tile + 1 ) * g_tileSize );
+                        for( size_t triangle = tile * g_tileSize; triangle < last; ++triangle )
+                        {
+                            const auto& tri = triangles[ triangle ];
+                            glm::dvec3 origin( vertices[ tri.x ] );
+                            glm::dvec3 edge1 = glm::dvec3( vertices[ tri.y ] ) - origin;
+                            glm::dvec3 edge2 = glm::dvec3( vertices[ tri.z ] ) - origin;
+                            glm::dvec3 normal = glm::cross( edge1, edge2 );
+                            if( !( glm::length( edge1 ) > 0.0 ) || !( glm::length( normal ) > 0.0 ) )
+                            {
+                                continue;
+                            }
+
+                            // Work in an orthonormal frame of the triangle plane.
+                            glm::dvec3 u = glm::normalize( edge1 );
+                            glm::dvec3 w = glm::cross( glm::normalize( normal ), u );
+                            auto project = [ & ]( const glm::vec3& vector )
+                            {
+                                return glm::dvec2( glm::dot( glm::dvec3( vector ), u ), glm::dot( glm::dvec3( vector ), w ) );
+                            };
+                            glm::dvec2 a0 = project( vectors[ tri.x ] );
+                            glm::dvec2 a1 = project( vectors[ tri.y ] );
+                            glm::dvec2 a2 = project( vectors[ tri.z ] );
+
+                            // Solve a0 + s * ( a1 - a0 ) + t * ( a2 - a0 ) = 0.
+                            glm::dmat2 field( a1 - a0, a2 - a0 );
+                            double determinant = glm::determinant( field );
+                            double scale = std::max( glm::dot( a0, a0 ), std::max( glm::dot( a1, a1 ), glm::dot( a2, a2 ) ) );
+                            if( !( std::abs( determinant ) > g_degenerateDeterminant * scale ) )
+                            {
+                                continue;
+                            }
+
+                            glm::dvec2 st = glm::inverse( field ) * ( -a0 );
+                            if( !( st.x > 0.0 ) || !( st.y > 0.0 ) || !( st.x + st.y < 1.0 ) )
+                            {
+                                continue;
+                            }
+
+                            // The Jacobian with respect to the position in the plane.
+                            glm::dmat2 shape( glm::dvec2( glm::dot( edge1, u ), 0.0 ),
+                                              glm::dvec2( glm::dot( edge2, u ), glm::dot( edge2, w ) ) );
+                            glm::dmat2 jacobian = field * glm::inverse( shape );
+                            double trace = jacobian[ 0 ][ 0 ] + jacobian[ 1 ][ 1 ];
+                            double jacobianDeterminant = glm::determinant( jacobian );
+                            double discriminant = trace * trace - 4.0 * jacobianDeterminant;
+
+                            Singularity singularity;
+                            singularity.m_position = glm::vec3( origin + st.x * edge1 + st.y * edge2 );
+                            singularity.m_triangle = triangle;
+                            if( jacobianDeterminant < 0.0 )
+                            {
+                                singularity.m_type = Type::Saddle;
+                            }
+                            else if( ( discriminant < 0.0 ) && ( std::abs( trace ) <= g_centerTolerance * std::sqrt( -discriminant ) ) )
+                            {
+                                singularity.m_type = Type::Center;
+                            }
+                            else
+                            {
+                                singularity.m_type = ( trace > 0.0 ) ? Type::Source : Type::Sink;
+                            }
+                            tiles[ tile ].push_back( singularity );
+                        }
+                    }
+                },
+                1, threads
+            );
+
+            for( const auto& tile : tiles )
+            {
+                m_singularities.insert( m_singularities.end(), tile.begin(), tile.end() );
+            }
+        }
+
+        VectorFieldSingularities::~VectorFieldSingularities()
+        {
+            // nothing to clean up
+        }
+
+        const std::vector< VectorFieldSingularities::Singularity >& VectorFieldSingularities::getSingularities() const
+        {
+            return m_singularities;
+        }
+
+        size_t VectorFieldSingularities::getNumSingularities( Type type ) const
+        {
+            return std::count_if( m_singularities.begin(), m_singularities.end(),
+                                  [ & ]( const Singularity& singularity )
+                                  {
+                                      return singularity.m_type == type;
+                                  }
+            );
+        }
+
+        int VectorFieldSingularities::getIndexSum() const
+        {
+            auto numSaddles = getNumSingularities( Type::Saddle );
+            return static_cast< int >( m_singularities.size() - numSaddles ) - static_cast< int >( numSaddles );
+        }
+    }
+}
@@ -0,0 +1,135 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_VECTORFIELDSINGULARITIES_H
+#define DI_VECTORFIELDSINGULARITIES_H
+
+#include <vector>
+
+#include <di/GfxTypes.h>
+#include <di/MathTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleMesh;
+
+        /**
+         * Finds the critical points of a per-vertex vector field on a triangle mesh. The field is interpolated linearly in each triangle,
+         * after projecting the vertex vectors into the triangle plane. So each triangle contains at most one zero, which is found by
+         * solving for its barycentric coordinates. The Jacobian of the interpolated field classifies it: a negative determinant is a saddle
+         * (Poincare index -1), otherwise the trace tells sources from sinks (index +1). Rotations without noticeable divergence are
+         * centers.
+         *
+         * Zeros exactly on an edge or a vertex are not reported. They only happen for degenerate input, like vertices with zero vectors.
+         * The triangles are processed in parallel and the result does not depend on the number of threads.
+         */
+        class VectorFieldSingularities
+        {
+        public:
+            /**
+             * The kind of a critical point.
+             */
+            enum class Type
+            {
+                Source, // the field points away in all directions
+                Sink,   // the field points towards it from all directions
+                Saddle, // the field points towards it along one axis and away along the other
+                Center  // the field rotates around it
+            };
+
+            /**
+             * A critical point.
+             */
+            struct Singularity
+            {
+                /**
+                 * The position.
+                 */
+                glm::vec3 m_position = glm::vec3( 0.0f );
+
+                /**
+                 * The triangle containing the point.
+                 */
+                size_t m_triangle = 0;
+
+                /**
+                 * The kind.
+                 */
+                Type m_type = Type::Source;
+            };
+
+            /**
+             * Find the critical points.
+             *
+             * \throw std::invalid_argument if the number of vectors does not match the number of vertices.
+             *
+             * \param mesh the mesh
+             * \param vectors the per-vertex vectors
+             * \param threads the thread limit, see \ref parallelFor.
+             */
+            VectorFieldSingularities( const TriangleMesh& mesh, const Vec3Array& vectors, unsigned threads = 0 );
+
+            /**
+             * Destructor.
+             */
+            virtual ~VectorFieldSingularities();
+
+            /**
+             * All critical points, sorted by triangle.
+             *
+             * \return the critical points
+             */
+            const std::vector< Singularity >& getSingularities() const;
+
+            /**
+             * The number of critical points of the given kind.
+             *
+             * \param type the kind
+             *
+             * \return the number of points
+             */
+            size_t getNumSingularities( Type type ) const;
+
+            /**
+             * The sum of the Poincare indices of all critical points. For a smooth tangential field on a closed mesh, this usually matches
+             * the Euler characteristic of the surface, which makes it a cheap sanity check.
+             *
+             * \return the index sum
+             */
+            int getIndexSum() const;
+
+        protected:
+        private:
+            /**
+             * The critical points.
+             */
+            std::vector< Singularity > m_singularities;
+        };
+    }
+}
+
+#endif  // DI_VECTORFIELDSINGULARITIES_H
+
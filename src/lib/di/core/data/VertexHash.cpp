@@ -0,0 +1,301 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/MathTypes.h>
+
+#include "VertexHash.h"
+
+/**
+ * Number of bits per coordinate in the hash key of a cell. Cells further apart than this wrap around and share keys, which only costs some
+ * distance checks.
+ */
+static const int g_cellKeyBits = 21;
+
+/**
+ * Arrays smaller than this are sorted by a single thread.
+ */
+static const size_t g_minParallelSortSize = 1 << 16;
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A vertex in the sorted cell list of \ref VertexHash::weld: the cell key and the index of the vertex.
+         */
+        typedef std::pair< uint64_t, size_t > CellEntry;
+
+        /**
+         * Get the cell of a vertex.
+         *
+         * \param vertex the vertex
+         * \param tolerance the cell size
+         *
+         * \return the integer cell coordinates
+         */
+        static glm::dvec3 getCell( const glm::vec3& vertex, float tolerance )
+        {
+            return glm::floor( glm::dvec3( vertex ) / static_cast< double >( tolerance ) );
+        }
+
+        /**
+         * Get the hash key of a cell.
+         *
+         * \param cell the integer cell coordinates
+         *
+         * \return the key
+         */
+        static uint64_t getCellKey( const glm::dvec3& cell )
+        {
+            const uint64_t mask = ( static_cast< uint64_t >( 1 ) << g_cellKeyBits ) - 1;
+            return ( static_cast< uint64_t >( static_cast< int64_t >( cell.x ) ) & mask ) |
+                   ( ( static_cast< uint64_t >( static_cast< int64_t >( cell.y ) ) & mask ) << g_cellKeyBits ) |
+                   ( ( static_cast< uint64_t >( static_cast< int64_t >( cell.z ) ) & mask ) << ( 2 * g_cellKeyBits ) );
+        }
+
+        /**
+         * Sort the cell list. Chunks are sorted in parallel and merged pairwise afterwards, also in parallel.
+         *
+         * \param entries the list to sort
+         * \param threads the thread limit, see \ref parallelFor.
+         */
+        static void sortParallel( std::vector< CellEntry >& entries, unsigned threads )
+        {
+            size_t numChunks = getNumThreads( threads );
+            if( ( numChunks == 1 ) || ( entries.size() < g_minParallelSortSize ) )
+            {
+                std::sort( entries.begin(), entries.end() );
+                return;
+            }
+
+            size_t chunkSize = ( entries.size() + numChunks - 1 ) / numChunks;
+            parallelFor( numChunks,
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t chunk = begin; chunk < end; ++chunk )
+                    {
+                        std::sort( entries.begin() + std::min( chunk * chunkSize, entries.size() ),
+                                   entries.begin() + std::min( ( chunk + 1 ) * chunkSize, entries.size() ) );
+                    }
+                }, 1, threads
+            );
+
+            for( size_t width = chunkSize; width < entries.size(); width *= 2 )
+            {
+                size_t numMerges = ( entries.size() + 2 * width - 1 ) / ( 2 * width );
+                parallelFor( numMerges,
+                    [ & ]( size_t begin, size_t end )
+                    {
+                        for( size_t merge = begin; merge < end; ++merge )
+                        {
+                            size_t first = merge * 2 * width;
+                            std::inplace_merge( entries.begin() + first,
+                                                entries.begin() + std::min( first + width, entries.size() ),
+                                                entries.begin() + std::min( first + 2 * width, entries.size() ) );
+                        }
+                    }, 1, threads
+                );
+            }
+        }
+
+        /**
+         * Find the first vertex before the given one which is closer than the tolerance, using the sorted cell list.
+         *
+         * \param vertices the vertices
+         * \param entries the sorted cell list of the vertices
+         * \param vertexID the vertex to search for
+         * \param tolerance the tolerance and cell size
+         * \param kept if not null, only vertices marked here are considered.
+         *
+         * \return the index of the vertex found or vertexID if there is none
+         */
+        static size_t findFirst( const Vec3Array& vertices, const std::vector< CellEntry >& entries, size_t vertexID, float tolerance,
+                                 const std::vector< char >* kept )
+        {
+            const auto& vertex = vertices[ vertexID ];
+            auto cell = getCell( vertex, tolerance );
+            size_t first = vertexID;
+            for( int dz = -1; dz <= 1; ++dz )
+            {
+                for( int dy = -1; dy <= 1; ++dy )
+                {
+                    for( int dx = -1; dx <= 1; ++dx )
+                    {
+                        auto key = getCellKey( cell + glm::dvec3( dx, dy, dz ) );
+                        auto entry = std::lower_bound( entries.begin(), entries.end(), std::make_pair( key, static_cast< size_t >( 0 ) ) );
+
+                        // The entries of a cell are sorted by index. Only the ones before the current best are of interest.
+                        for( ; ( entry != entries.end() ) && ( entry->first == key ) && ( entry->second < first ); ++entry )
+                        {
+                            if( ( !kept || ( *kept )[ entry->second ] ) &&
+                                ( glm::distance( vertex, vertices[ entry->second ] ) < tolerance ) )
+                            {
+                                first = entry->second;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            return first;
+        }
+
+        VertexHash::VertexHash( float tolerance ):
+            m_tolerance( tolerance )
+        {
+            if( !( tolerance > 0.0f ) )
+            {
+                throw std::invalid_argument( "The vertex tolerance needs to be positive." );
+            }
+        }
+
+        VertexHash::~VertexHash()
+        {
+            // nothing to do
+        }
+
+        void VertexHash::update( const Vec3Array& vertices )
+        {
+            for( ; m_numIndexed < vertices.size(); ++m_numIndexed )
+            {
+                auto key = getCellKey( getCell( vertices[ m_numIndexed ], m_tolerance ) );
+                auto inserted = m_cells.insert( std::make_pair( key, m_numIndexed ) );
+                m_previous.push_back( inserted.first->second );
+                inserted.first->second = m_numIndexed;
+            }
+        }
+
+        void VertexHash::clear()
+        {
+            m_numIndexed = 0;
+            m_cells.clear();
+            m_previous.clear();
+        }
+
+        bool VertexHash::find( const Vec3Array& vertices, const glm::vec3& vertex, size_t& index ) const
+        {
+            auto cell = getCell( vertex, m_tolerance );
+            bool found = false;
+            for( int dz = -1; dz <= 1; ++dz )
+            {
+                for( int dy = -1; dy <= 1; ++dy )
+                {
+                    for( int dx = -1; dx <= 1; ++dx )
+                    {
+                        auto head = m_cells.find( getCellKey( cell + glm::dvec3( dx, dy, dz ) ) );
+                        if( head == m_cells.end() )
+                        {
+                            continue;
+                        }
+
+                        // Walk the cell from the most recent to the first vertex. Keep the first close one.
+                        for( size_t current = head->second; ; current = m_previous[ current ] )
+                        {
+                            if( ( !found || ( current < index ) ) && ( glm::distance( vertex, vertices[ current ] ) < m_tolerance ) )
+                            {
+                                found = true;
+                                index = current;
+                            }
+                            if( m_previous[ current ] == current )
+                            {
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            return found;
+        }
+
+        float VertexHash::getTolerance() const
+        {
+            return m_tolerance;
+        }
+
+        std::vector< size_t > VertexHash::weld( const Vec3Array& vertices, Vec3Array& welded, float tolerance, unsigned threads )
+        {
+            if( !( tolerance > 0.0f ) )
+            {
+                throw std::invalid_argument( "The vertex tolerance needs to be positive." );
+            }
+
+            // Sort the vertices into cells. Inside a cell, they stay sorted by index.
+            std::vector< CellEntry > entries( vertices.size() );
+            parallelFor( vertices.size(),
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t vertexID = begin; vertexID < end; ++vertexID )
+                    {
+                        entries[ vertexID ] = std::make_pair( getCellKey( getCell( vertices[ vertexID ], tolerance ) ), vertexID );
+                    }
+                }, 4096, threads
+            );
+            sortParallel( entries, threads );
+
+            // The first close vertex of each vertex. Independent for each vertex.
+            std::vector< size_t > first( vertices.size() );
+            parallelFor( vertices.size(),
+                [ & ]( size_t begin, size_t end )
+                {
+                    for( size_t vertexID = begin; vertexID < end; ++vertexID )
+                    {
+                        first[ vertexID ] = findFirst( vertices, entries, vertexID, tolerance, nullptr );
+                    }
+                }, 1024, threads
+            );
+
+            // A vertex is merged into the first close vertex that is kept. Usually, this is the first close vertex. Only if that one was
+            // merged itself, the kept ones need to be searched.
+            std::vector< size_t > mapping( vertices.size() );
+            std::vector< char > kept( vertices.size(), 0 );
+            welded.clear();
+            for( size_t vertexID = 0; vertexID < vertices.size(); ++vertexID )
+            {
+                auto target = first[ vertexID ];
+                if( ( target != vertexID ) && !kept[ target ] )
+                {
+                    target = findFirst( vertices, entries, vertexID, tolerance, &kept );
+                }
+
+                if( target == vertexID )
+                {
+                    kept[ vertexID ] = 1;
+                    mapping[ vertexID ] = welded.size();
+                    welded.push_back( vertices[ vertexID ] );
+                }
+                else
+                {
+                    mapping[ vertexID ] = mapping[ target ];
+                }
+            }
+            return mapping;
+        }
+    }
+}
@@ -0,0 +1,132 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_VERTEXHASH_H
+#define DI_VERTEXHASH_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <di/GfxTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A uniform grid hash to find vertices closer than a tolerance to a given position. The cells are as large as the tolerance, so a
+         * lookup only needs to check the 27 cells around the position. The hash does not store the vertices. It indexes an external vertex
+         * array, which may only grow between calls to \ref update. This is used to add unique vertices to meshes and line sets in constant
+         * expected time.
+         *
+         * Additionally, \ref weld merges all close vertices of an array at once, in parallel.
+         */
+        class VertexHash
+        {
+        public:
+            /**
+             * Create an empty hash.
+             *
+             * \param tolerance vertices closer than this are considered equal. Needs to be positive.
+             */
+            explicit VertexHash( float tolerance = 0.001f );
+
+            /**
+             * Destructor.
+             */
+            virtual ~VertexHash();
+
+            /**
+             * Add the vertices not yet indexed. These are all vertices behind the ones indexed by previous calls.
+             *
+             * \param vertices the vertex array. Needs to be the same as for previous calls, with vertices appended only.
+             */
+            void update( const Vec3Array& vertices );
+
+            /**
+             * Remove all vertices from the hash. Needed if the indexed vertex array was replaced or modified.
+             */
+            void clear();
+
+            /**
+             * Find the first indexed vertex closer than the tolerance to the given position.
+             *
+             * \param vertices the vertex array used for \ref update.
+             * \param vertex the position to search for
+             * \param index the index of the vertex found
+             *
+             * \return true if a vertex was found
+             */
+            bool find( const Vec3Array& vertices, const glm::vec3& vertex, size_t& index ) const;
+
+            /**
+             * Get the tolerance.
+             *
+             * \return the tolerance
+             */
+            float getTolerance() const;
+
+            /**
+             * Merge all vertices closer than the tolerance. The result is the same as adding the vertices one by one and only keeping those
+             * that are not closer than the tolerance to any kept vertex. The vertices are sorted into cells and searched in parallel; only
+             * vertices whose earliest close vertex was merged itself need a sequential second look.
+             *
+             * \param vertices the vertices to merge
+             * \param welded the kept vertices, in their original order
+             * \param tolerance vertices closer than this are considered equal. Needs to be positive.
+             * \param threads the thread limit, see \ref parallelFor.
+             *
+             * \return the index of the kept vertex in welded for each input vertex.
+             */
+            static std::vector< size_t > weld( const Vec3Array& vertices, Vec3Array& welded, float tolerance = 0.001f,
+                                               unsigned threads = 0 );
+
+        protected:
+        private:
+            /**
+             * Tolerance and cell size.
+             */
+            float m_tolerance = 0.001f;
+
+            /**
+             * Number of vertices in the hash.
+             */
+            size_t m_numIndexed = 0;
+
+            /**
+             * The most recently added vertex of each cell.
+             */
+            std::unordered_map< uint64_t, size_t > m_cells;
+
+            /**
+             * The previously added vertex of the same cell for each vertex. Points to itself for the first vertex of a cell.
+             */
+            std::vector< size_t > m_previous;
+        };
+    }
+}
+
+#endif  // DI_VERTEXHASH_H
+
@@ -19329,6 +19329,8 @@ GLEWAPI GLboolean GLEWAPIENTRY glewContextIsSupported (const GLEWContext *ctx, c
 #else /* GLEW_MX */
 
 GLEWAPI GLenum GLEWAPIENTRY glewInit (void);
+/* DirectionalityIndicator: initialize the GL entry points only. Unlike glewInit, this does not query GLX and works for EGL and OSMesa. */
+GLEWAPI GLenum GLEWAPIENTRY glewContextInit (void);
 GLEWAPI GLboolean GLEWAPIENTRY glewIsSupported (const char *name);
 #define glewIsExtensionSupported(x) glewIsSupported(x)
 
@@ -19338,6 +19340,10 @@ GLEWAPI GLboolean GLEWAPIENTRY glewIsSupported (const char *name);
 #endif /* GLEW_MX */
 
 GLEWAPI GLboolean glewExperimental;
+/* DirectionalityIndicator: override the entry point lookup for contexts not created by GLX. NULL restores the default. Linux only. */
+typedef void (*GLEWfuncptr)(void);
+typedef GLEWfuncptr (*GLEWprocaddressresolver)(const char* name);
+GLEWAPI void GLEWAPIENTRY glewSetProcAddressResolver (GLEWprocaddressresolver resolver);
 GLEWAPI GLboolean GLEWAPIENTRY glewGetExtension (const char *name);
 GLEWAPI const GLubyte * GLEWAPIENTRY glewGetErrorString (GLenum error);
 GLEWAPI const GLubyte * GLEWAPIENTRY glewGetString (GLenum name);
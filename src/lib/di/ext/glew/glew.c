@@ -182,7 +182,13 @@ void* NSGLGetProcAddress (const GLubyte *name)
 #elif defined(__native_client__)
 #  define glewGetProcAddress(name) NULL /* TODO */
 #else /* __linux */
-#  define glewGetProcAddress(name) (*glXGetProcAddressARB)(name)
+/* DirectionalityIndicator: contexts not created by GLX (EGL, OSMesa) need their own entry point lookup. See glewSetProcAddressResolver. */
+static GLEWprocaddressresolver __glewProcAddressResolver = NULL;
+void GLEWAPIENTRY glewSetProcAddressResolver (GLEWprocaddressresolver resolver)
+{
+  __glewProcAddressResolver = resolver;
+}
+#  define glewGetProcAddress(name) (__glewProcAddressResolver ? __glewProcAddressResolver((const char*)name) : (*glXGetProcAddressARB)(name))
 #endif
 
 /*
@@ -10277,9 +10283,7 @@ GLboolean GLEWAPIENTRY glewGetExtension (const char* name)
 
 /* ------------------------------------------------------------------------- */
 
-#ifndef GLEW_MX
-static
-#endif
+/* DirectionalityIndicator: exported in the non-MX case too. See GL/glew.h. */
 GLenum GLEWAPIENTRY glewContextInit (GLEW_CONTEXT_ARG_DEF_LIST)
 {
   const GLubyte* s;
@@ -68,6 +68,7 @@ namespace di
             {
                 glDeleteBuffers( 1, &m_object );
                 m_object = 0;
+                m_size = 0;
             }
         }
 
@@ -79,10 +80,25 @@ namespace di
 
         void Buffer::data( size_t size, const void* ptr )
         {
+            // Same size? Just replace the contents and keep the storage.
+            if( ptr && size && ( size == m_size ) )
+            {
+                glBufferSubData( toGLType( m_bufferType ), 0, size, ptr );
+                logGLError();
+                return;
+            }
+
             // feed the buffer, and let OpenGL know that we don't plan to
-            // change it (STATIC) and that it will be used for drawing (DRAW)
-            glBufferData( toGLType( m_bufferType ), size, ptr, GL_STATIC_DRAW );
+            // change it (STATIC) and that it will be used for drawing (DRAW). Pixel pack buffers are written once by GL and read back (STREAM_READ).
+            GLenum usage = ( m_bufferType == BufferType::PixelPack ) ? GL_STREAM_READ : GL_STATIC_DRAW;
+            glBufferData( toGLType( m_bufferType ), size, ptr, usage );
             logGLError();
+            m_size = size;
+        }
+
+        size_t Buffer::getSize() const
+        {
+            return m_size;
         }
 
         GLenum Buffer::toGLType( const BufferType& type )
@@ -93,6 +109,8 @@ namespace di
                     return GL_ARRAY_BUFFER;
                 case BufferType::ElementArray:
                     return GL_ELEMENT_ARRAY_BUFFER;
+                case BufferType::PixelPack:
+                    return GL_PIXEL_PACK_BUFFER;
                 default:
                     return -1;
             }
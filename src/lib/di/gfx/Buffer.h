@@ -48,8 +48,9 @@ namespace di
              */
             enum class BufferType
             {
-                Array,       // OpenGL: GL_ARRAY_BUFFER
-                ElementArray // OpenGL: GL_ELEMENT_ARRAY_BUFFER
+                Array,        // OpenGL: GL_ARRAY_BUFFER
+                ElementArray, // OpenGL: GL_ELEMENT_ARRAY_BUFFER
+                PixelPack     // OpenGL: GL_PIXEL_PACK_BUFFER. Target of asynchronous pixel read-back.
             };
 
             /**
@@ -121,12 +122,20 @@ namespace di
             }
 
             /**
-             * Commit data to this buffer.
+             * Commit data to this buffer. If the buffer already has storage of the same size, the storage is re-used and only its contents are
+             * replaced. Otherwise, new storage is allocated and the old one is orphaned.
              *
              * \param size the size of the buffer
-             * \param ptr the data pointer.
+             * \param ptr the data pointer. Can be nullptr to only allocate storage.
              */
             virtual void data( size_t size, const void* ptr );
+
+            /**
+             * The size of the storage allocated by the last \ref data call.
+             *
+             * \return the size in bytes
+             */
+            size_t getSize() const;
         protected:
             /**
              * Convert the given internal type to a GL enum.
@@ -142,6 +151,11 @@ namespace di
              * The type of this buffer.
              */
             BufferType m_bufferType;
+
+            /**
+             * The size of the allocated storage in bytes.
+             */
+            size_t m_size = 0;
         };
     }
 }
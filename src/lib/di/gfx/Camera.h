@@ -31,6 +31,8 @@ namespace di
 {
     namespace core
     {
+        class BoundingBox;
+
         /**
          * Class represents the camera of a view. In OpenGL, a camera is nothing more than a matrix. This class provides
          * some functionality to set the matrix. This camera additionally differentiates between view and projection.
@@ -77,6 +79,45 @@ namespace di
              */
             void setProjectionMatrix( const glm::mat4& matrix );
 
+            /**
+             * Build a view matrix that fits the given scene into the unit cube in front of the camera. Use this method only if you want a matrix
+             * that is based on the current scene. If the scene changes, this matrix might not be useful anymore.
+             *
+             * \param sceneBB the bounding box of the scene to view.
+             * \param orientation orientation
+             * \param zoom a zoom factor. Default = 1.0.
+             * \param drag a drag offset. Defaults to glm::vec2( 0.0 ).
+             *
+             * \return the matrix.
+             */
+            static glm::mat4 buildViewMatrix( const BoundingBox& sceneBB, const glm::mat4& orientation, float zoom = 1.0,
+                                              const glm::vec2& drag = glm::vec2( 0.0 ) );
+
+            /**
+             * Build the orthographic projection matrix matching \ref buildViewMatrix.
+             *
+             * \param near the near value
+             * \param far the far value
+             * \param aspect the aspect ratio
+             *
+             * \return the projection matrix.
+             */
+            static glm::mat4 buildProjectionMatrix( float near, float far, float aspect );
+
+            /**
+             * Restrict a projection matrix to a rectangular part of the image. The resulting matrix maps exactly this part to the whole
+             * viewport. Use this to render an image in several tiles. The region may exceed the image.
+             *
+             * \param projection the projection of the whole image
+             * \param imageSize the size of the whole image in pixels
+             * \param tileOrigin the lower-left corner of the part, in pixels
+             * \param tileSize the size of the part in pixels
+             *
+             * \return the projection matrix of the part.
+             */
+            static glm::mat4 buildTileProjectionMatrix( const glm::mat4& projection, const glm::vec2& imageSize, const glm::vec2& tileOrigin,
+                                                        const glm::vec2& tileSize );
+
         protected:
         private:
             /**
@@ -0,0 +1,244 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <di/gfx/GL.h>
+#include <di/gfx/GLError.h>
+
+#include "GPUProfiler.h"
+
+#include <di/core/Logger.h>
+#define LogTag "gfx/GPUProfiler"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Number of frames to wait for the results before dropping a frame.
+         */
+        static const size_t g_gpuProfilerMaxPendingFrames = 4;
+
+        /**
+         * Weight of a new value in the moving average.
+         */
+        static const double g_gpuProfilerAverageWeight = 0.1;
+
+        const size_t GPUProfiler::InvalidTimestamp = static_cast< size_t >( -1 );
+
+        GPUProfiler& GPUProfiler::getInstance()
+        {
+            static GPUProfiler profiler;
+            return profiler;
+        }
+
+        GPUProfiler::~GPUProfiler()
+        {
+            // The queries are freed by clear(). Call it while the context is current.
+        }
+
+        void GPUProfiler::setEnabled( bool enable )
+        {
+            m_enabled = enable;
+        }
+
+        bool GPUProfiler::isEnabled() const
+        {
+            return m_enabled;
+        }
+
+        void GPUProfiler::beginFrame()
+        {
+            m_frameActive = m_enabled;
+        }
+
+        void GPUProfiler::endFrame()
+        {
+            if( m_frameActive && !m_frame.m_queries.empty() )
+            {
+                m_pending.push_back( m_frame );
+            }
+            m_frame = Frame();
+            m_frameActive = false;
+
+            // Collect in order. Later frames cannot be ready before earlier ones.
+            while( !m_pending.empty() && isAvailable( m_pending.front() ) )
+            {
+                collect( m_pending.front() );
+                m_pending.pop_front();
+            }
+
+            // Do not pile up frames if the results take too long.
+            while( m_pending.size() > g_gpuProfilerMaxPendingFrames )
+            {
+                recycle( m_pending.front() );
+                m_pending.pop_front();
+            }
+        }
+
+        void GPUProfiler::flush()
+        {
+            for( auto& frame : m_pending )
+            {
+                collect( frame );
+            }
+            m_pending.clear();
+        }
+
+        size_t GPUProfiler::timestamp()
+        {
+            if( !m_frameActive )
+            {
+                return InvalidTimestamp;
+            }
+
+            GLuint query = 0;
+            if( m_queryPool.empty() )
+            {
+                glGenQueries( 1, &query );
+            }
+            else
+            {
+                query = m_queryPool.back();
+                m_queryPool.pop_back();
+            }
+
+            glQueryCounter( query, GL_TIMESTAMP );
+            m_frame.m_queries.push_back( query );
+            return m_frame.m_queries.size() - 1;
+        }
+
+        void GPUProfiler::record( const std::string& name, size_t begin, size_t end )
+        {
+            if( !m_frameActive || ( begin >= m_frame.m_queries.size() ) || ( end >= m_frame.m_queries.size() ) )
+            {
+                return;
+            }
+
+            Timer timer;
+            timer.m_name = name;
+            timer.m_begin = begin;
+            timer.m_end = end;
+            m_frame.m_timers.push_back( timer );
+        }
+
+        bool GPUProfiler::isAvailable( const Frame& frame ) const
+        {
+            GLint available = 0;
+            glGetQueryObjectiv( frame.m_queries.back(), GL_QUERY_RESULT_AVAILABLE, &available );
+            return available;
+        }
+
+        void GPUProfiler::collect( Frame& frame )
+        {
+            std::vector< GLuint64 > times( frame.m_queries.size(), 0 );
+            for( size_t i = 0; i < frame.m_queries.size(); ++i )
+            {
+                glGetQueryObjectui64v( frame.m_queries[ i ], GL_QUERY_RESULT, &times[ i ] );
+            }
+            recycle( frame );
+
+            // Sum timers of the same name. A pass might be rendered by multiple views or tiles.
+            std::map< std::string, double > frameTimes;
+            for( const auto& timer : frame.m_timers )
+            {
+                frameTimes[ timer.m_name ] += static_cast< double >( times[ timer.m_end ] - times[ timer.m_begin ] ) / 1.0e6;
+            }
+
+            std::lock_guard< std::mutex > lock( m_statisticsMutex );
+            for( const auto& frameTime : frameTimes )
+            {
+                auto& stats = m_statistics[ frameTime.first ];
+                double time = frameTime.second;
+                if( stats.m_count == 0 )
+                {
+                    stats.m_average = time;
+                    stats.m_min = time;
+                    stats.m_max = time;
+                }
+                stats.m_last = time;
+                stats.m_average += g_gpuProfilerAverageWeight * ( time - stats.m_average );
+                stats.m_min = std::min( stats.m_min, time );
+                stats.m_max = std::max( stats.m_max, time );
+                stats.m_count++;
+            }
+        }
+
+        void GPUProfiler::recycle( Frame& frame )
+        {
+            m_queryPool.insert( m_queryPool.end(), frame.m_queries.begin(), frame.m_queries.end() );
+            frame.m_queries.clear();
+        }
+
+        std::map< std::string, GPUTimerStatistics > GPUProfiler::getStatistics() const
+        {
+            std::lock_guard< std::mutex > lock( m_statisticsMutex );
+            return m_statistics;
+        }
+
+        std::string GPUProfiler::getReport() const
+        {
+            std::ostringstream report;
+            report << std::fixed << std::setprecision( 2 );
+            for( const auto& timer : getStatistics() )
+            {
+                if( report.tellp() > 0 )
+                {
+                    report << std::endl;
+                }
+                report << timer.first << ": " << timer.second.m_average << " ms (last " << timer.second.m_last
+                       << ", min " << timer.second.m_min << ", max " << timer.second.m_max << ", " << timer.second.m_count << " frames)";
+            }
+            return report.str();
+        }
+
+        void GPUProfiler::clear()
+        {
+            recycle( m_frame );
+            m_frame = Frame();
+            m_frameActive = false;
+            for( auto& frame : m_pending )
+            {
+                recycle( frame );
+            }
+            m_pending.clear();
+
+            if( !m_queryPool.empty() )
+            {
+                glDeleteQueries( static_cast< GLsizei >( m_queryPool.size() ), m_queryPool.data() );
+                m_queryPool.clear();
+            }
+            logGLError();
+
+            std::lock_guard< std::mutex > lock( m_statisticsMutex );
+            m_statistics.clear();
+        }
+    }
+}
@@ -0,0 +1,270 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_GPUPROFILER_H
+#define DI_GPUPROFILER_H
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <di/gfx/OpenGL.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Timing statistics of a single GPU timer. All times in milliseconds.
+         */
+        struct GPUTimerStatistics
+        {
+            /**
+             * The time of the last frame.
+             */
+            double m_last = 0.0;
+
+            /**
+             * Moving average over the last frames.
+             */
+            double m_average = 0.0;
+
+            /**
+             * Minimum time.
+             */
+            double m_min = 0.0;
+
+            /**
+             * Maximum time.
+             */
+            double m_max = 0.0;
+
+            /**
+             * Number of frames measured.
+             */
+            size_t m_count = 0;
+        };
+
+        /**
+         * Measures the GPU time of render passes using OpenGL timestamp queries. The passes are annotated with \ref GPUTimer. The query results
+         * are fetched some frames later, once they are available, so the profiler never waits for the GPU. Frames whose results are not
+         * available after a few frames are dropped.
+         *
+         * The profiler is disabled by default. If disabled, timers do not issue any queries.
+         *
+         * \note the profiler must only be used in the OpenGL thread. \ref getStatistics and \ref getReport can be called from any thread.
+         */
+        class GPUProfiler
+        {
+        public:
+            /**
+             * Used to denote an invalid timestamp.
+             */
+            static const size_t InvalidTimestamp;
+
+            /**
+             * The profiler used by the application.
+             *
+             * \return the profiler.
+             */
+            static GPUProfiler& getInstance();
+
+            /**
+             * Destructor.
+             */
+            virtual ~GPUProfiler();
+
+            /**
+             * Enable or disable profiling. Takes effect with the next frame.
+             *
+             * \param enable true to enable.
+             */
+            void setEnabled( bool enable = true );
+
+            /**
+             * Check whether profiling is enabled.
+             *
+             * \return true if enabled.
+             */
+            bool isEnabled() const;
+
+            /**
+             * Start a frame. Timers are only recorded between \ref beginFrame and \ref endFrame.
+             */
+            void beginFrame();
+
+            /**
+             * End the frame and collect the results of previous frames that became available in the meantime.
+             */
+            void endFrame();
+
+            /**
+             * Wait for the results of all finished frames. This stalls. Use at the end of batch rendering only.
+             */
+            void flush();
+
+            /**
+             * Issue a timestamp query.
+             *
+             * \return the id of the timestamp in the current frame. \ref InvalidTimestamp if profiling is disabled or there is no frame.
+             */
+            size_t timestamp();
+
+            /**
+             * Record a timer between two timestamps of the current frame. The times of timers with the same name in one frame are summed.
+             *
+             * \param name the name of the timer.
+             * \param begin the start timestamp
+             * \param end the end timestamp
+             */
+            void record( const std::string& name, size_t begin, size_t end );
+
+            /**
+             * Get the statistics of all timers seen so far.
+             *
+             * \return the statistics by timer name.
+             */
+            std::map< std::string, GPUTimerStatistics > getStatistics() const;
+
+            /**
+             * Get the statistics as human-readable text. One line per timer, sorted by name.
+             *
+             * \return the text
+             */
+            std::string getReport() const;
+
+            /**
+             * Reset the statistics and free all queries. Requires the context to be current.
+             */
+            void clear();
+
+        protected:
+            /**
+             * Constructor. Use \ref getInstance.
+             */
+            GPUProfiler() = default;
+
+        private:
+            /**
+             * A timer of a frame.
+             */
+            struct Timer
+            {
+                /**
+                 * The name.
+                 */
+                std::string m_name;
+
+                /**
+                 * Start timestamp.
+                 */
+                size_t m_begin;
+
+                /**
+                 * End timestamp.
+                 */
+                size_t m_end;
+            };
+
+            /**
+             * The queries and timers of a frame.
+             */
+            struct Frame
+            {
+                /**
+                 * The timestamp queries.
+                 */
+                std::vector< GLuint > m_queries;
+
+                /**
+                 * The timers.
+                 */
+                std::vector< Timer > m_timers;
+            };
+
+            /**
+             * Check whether the results of a frame are available.
+             *
+             * \param frame the frame
+             *
+             * \return true if available
+             */
+            bool isAvailable( const Frame& frame ) const;
+
+            /**
+             * Read the results of a frame and update the statistics. Returns the queries to the pool.
+             *
+             * \param frame the frame.
+             */
+            void collect( Frame& frame );
+
+            /**
+             * Return the queries of the frame to the pool.
+             *
+             * \param frame the frame
+             */
+            void recycle( Frame& frame );
+
+            /**
+             * True if enabled.
+             */
+            bool m_enabled = false;
+
+            /**
+             * True between \ref beginFrame and \ref endFrame if enabled.
+             */
+            bool m_frameActive = false;
+
+            /**
+             * The frame currently recorded.
+             */
+            Frame m_frame;
+
+            /**
+             * Frames waiting for their results.
+             */
+            std::deque< Frame > m_pending;
+
+            /**
+             * Unused query objects.
+             */
+            std::vector< GLuint > m_queryPool;
+
+            /**
+             * Protects the statistics.
+             */
+            mutable std::mutex m_statisticsMutex;
+
+            /**
+             * The statistics.
+             */
+            std::map< std::string, GPUTimerStatistics > m_statistics;
+        };
+    }
+}
+
+#endif  // DI_GPUPROFILER_H
+
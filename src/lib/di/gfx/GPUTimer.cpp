@@ -0,0 +1,72 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <string>
+
+#include <di/gfx/GPUProfiler.h>
+
+#include "GPUTimer.h"
+
+namespace di
+{
+    namespace core
+    {
+        GPUTimer::GPUTimer( const std::string& name ):
+            m_name( name ),
+            m_begin( GPUProfiler::getInstance().timestamp() )
+        {
+        }
+
+        GPUTimer::~GPUTimer()
+        {
+            stop();
+        }
+
+        void GPUTimer::next( const std::string& name )
+        {
+            auto& profiler = GPUProfiler::getInstance();
+            size_t end = profiler.timestamp();
+            if( m_running )
+            {
+                profiler.record( m_name, m_begin, end );
+            }
+
+            m_name = name;
+            m_begin = end;
+            m_running = true;
+        }
+
+        void GPUTimer::stop()
+        {
+            if( !m_running )
+            {
+                return;
+            }
+            m_running = false;
+
+            auto& profiler = GPUProfiler::getInstance();
+            profiler.record( m_name, m_begin, profiler.timestamp() );
+        }
+    }
+}
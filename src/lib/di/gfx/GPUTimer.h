@@ -0,0 +1,96 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_GPUTIMER_H
+#define DI_GPUTIMER_H
+
+#include <cstddef>
+#include <string>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Measures the GPU time of the OpenGL commands issued during its lifetime and reports it to the \ref GPUProfiler. Timers can be nested.
+         * Does nothing if the profiler is disabled.
+         *
+         * \code
+         * GPUTimer timer( "My Vis: Pass 1" );
+         * // ... draw pass 1
+         * timer.next( "My Vis: Pass 2" );
+         * // ... draw pass 2
+         * \endcode
+         *
+         * \note the timer must only be used in the OpenGL thread.
+         */
+        class GPUTimer
+        {
+        public:
+            /**
+             * Start the timer.
+             *
+             * \param name the name used in the statistics.
+             */
+            explicit GPUTimer( const std::string& name );
+
+            /**
+             * Destructor. Stops the timer.
+             */
+            virtual ~GPUTimer();
+
+            /**
+             * Stop the timer and start measuring the next pass. This needs only one query for both.
+             *
+             * \param name the name of the next pass.
+             */
+            void next( const std::string& name );
+
+            /**
+             * Stop the timer. Subsequent calls do nothing.
+             */
+            void stop();
+
+        protected:
+        private:
+            /**
+             * The name.
+             */
+            std::string m_name;
+
+            /**
+             * The start timestamp.
+             */
+            size_t m_begin = 0;
+
+            /**
+             * True until stopped.
+             */
+            bool m_running = true;
+        };
+    }
+}
+
+#endif  // DI_GPUTIMER_H
+
@@ -0,0 +1,277 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <stdexcept>
+#include <string>
+
+#include <di/gfx/OpenGL.h>
+
+#ifdef DI_HEADLESS_EGL
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#endif
+
+#ifdef DI_HEADLESS_OSMESA
+    #include <GL/osmesa.h>
+#endif
+
+#include "HeadlessContext.h"
+
+#include <di/core/Logger.h>
+#define LogTag "gfx/HeadlessContext"
+
+namespace di
+{
+    namespace core
+    {
+#ifdef DI_HEADLESS_EGL
+        /**
+         * GLEW looks up entry points using GLX by default. This does not work for EGL contexts.
+         *
+         * \param name the function name
+         *
+         * \return the function or nullptr
+         */
+        static GLEWfuncptr resolveEGL( const char* name )
+        {
+            return reinterpret_cast< GLEWfuncptr >( eglGetProcAddress( name ) );
+        }
+#endif
+
+#ifdef DI_HEADLESS_OSMESA
+        /**
+         * GLEW looks up entry points using GLX by default. This does not work for OSMesa contexts.
+         *
+         * \param name the function name
+         *
+         * \return the function or nullptr
+         */
+        static GLEWfuncptr resolveOSMesa( const char* name )
+        {
+            return reinterpret_cast< GLEWfuncptr >( OSMesaGetProcAddress( name ) );
+        }
+#endif
+
+        HeadlessContext::HeadlessContext()
+        {
+            if( !createEGL() && !createOSMesa() )
+            {
+                throw std::runtime_error( "Cannot create a headless OpenGL 3.3 core context. No usable EGL or OSMesa found." );
+            }
+
+            // The GLX specific parts of glewInit would fail without a X display. Only initialize the GL entry points.
+            glewExperimental = true;
+            GLenum err = glewContextInit();
+            if( GLEW_OK != err )
+            {
+                throw std::runtime_error( "Error during GLEW initialization: " +
+                                          std::string( reinterpret_cast< const char* >( glewGetErrorString( err ) ) ) );
+            }
+
+            // Experimental mode may leave an error behind. Reset.
+            glGetError();
+
+            LogI << "Headless context using " << getBackendName() << "." << LogEnd;
+            LogI << "GL Renderer: " << glGetString( GL_RENDERER ) << LogEnd;
+            LogI << "GL Version: " << glGetString( GL_VERSION ) << LogEnd;
+            LogI << "GLEW Version: " << glewGetString( GLEW_VERSION ) << LogEnd;
+        }
+
+        HeadlessContext::~HeadlessContext()
+        {
+            doneCurrent();
+            glewSetProcAddressResolver( nullptr );
+
+#ifdef DI_HEADLESS_EGL
+            if( m_backend == Backend::EGL )
+            {
+                eglDestroyContext( static_cast< EGLDisplay >( m_display ), static_cast< EGLContext >( m_context ) );
+                eglTerminate( static_cast< EGLDisplay >( m_display ) );
+            }
+#endif
+#ifdef DI_HEADLESS_OSMESA
+            if( m_backend == Backend::OSMesa )
+            {
+                OSMesaDestroyContext( static_cast< OSMesaContext >( m_context ) );
+            }
+#endif
+        }
+
+        bool HeadlessContext::createEGL()
+        {
+#ifdef DI_HEADLESS_EGL
+            m_backend = Backend::EGL;
+
+            // The surfaceless platform needs neither X nor a DRM device and works with llvmpipe. Fall back to the default display if the
+            // implementation does not know it.
+            EGLDisplay display = EGL_NO_DISPLAY;
+            auto getPlatformDisplay = reinterpret_cast< PFNEGLGETPLATFORMDISPLAYEXTPROC >( eglGetProcAddress( "eglGetPlatformDisplayEXT" ) );
+            if( getPlatformDisplay )
+            {
+                display = getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr );
+            }
+            if( display == EGL_NO_DISPLAY )
+            {
+                display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+            }
+
+            EGLint major = 0;
+            EGLint minor = 0;
+            if( ( display == EGL_NO_DISPLAY ) || !eglInitialize( display, &major, &minor ) )
+            {
+                LogW << "EGL: cannot initialize display. Error " << eglGetError() << "." << LogEnd;
+                return false;
+            }
+            LogD << "EGL version " << major << "." << minor << "." << LogEnd;
+
+            if( !eglBindAPI( EGL_OPENGL_API ) )
+            {
+                LogW << "EGL: desktop OpenGL not supported." << LogEnd;
+                eglTerminate( display );
+                return false;
+            }
+
+            // We never create a surface. Any config supporting desktop GL is fine.
+            const EGLint configAttributes[] = {
+                EGL_SURFACE_TYPE, 0,
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_NONE
+            };
+            EGLConfig config = nullptr;
+            EGLint numConfigs = 0;
+            eglChooseConfig( display, configAttributes, &config, 1, &numConfigs );
+
+            const EGLint contextAttributes[] = {
+                EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+                EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+                EGL_NONE
+            };
+            EGLContext context = eglCreateContext( display, ( numConfigs > 0 ) ? config : nullptr, EGL_NO_CONTEXT, contextAttributes );
+            if( context == EGL_NO_CONTEXT )
+            {
+                LogW << "EGL: cannot create an OpenGL 3.3 core context. Error " << eglGetError() << "." << LogEnd;
+                eglTerminate( display );
+                return false;
+            }
+
+            m_display = display;
+            m_context = context;
+            makeCurrent();
+            glewSetProcAddressResolver( &resolveEGL );
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        bool HeadlessContext::createOSMesa()
+        {
+#ifdef DI_HEADLESS_OSMESA
+            m_backend = Backend::OSMesa;
+
+            const int attributes[] = {
+                OSMESA_FORMAT, OSMESA_RGBA,
+                OSMESA_DEPTH_BITS, 24,
+                OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+                OSMESA_CONTEXT_MAJOR_VERSION, 3,
+                OSMESA_CONTEXT_MINOR_VERSION, 3,
+                0
+            };
+            OSMesaContext context = OSMesaCreateContextAttribs( attributes, nullptr );
+            if( !context )
+            {
+                LogW << "OSMesa: cannot create an OpenGL 3.3 core context." << LogEnd;
+                return false;
+            }
+
+            m_context = context;
+            m_osmesaBuffer.resize( 4 );
+            makeCurrent();
+            glewSetProcAddressResolver( &resolveOSMesa );
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void HeadlessContext::makeCurrent()
+        {
+            bool success = false;
+#ifdef DI_HEADLESS_EGL
+            if( m_backend == Backend::EGL )
+            {
+                success = eglMakeCurrent( static_cast< EGLDisplay >( m_display ), EGL_NO_SURFACE, EGL_NO_SURFACE,
+                                          static_cast< EGLContext >( m_context ) );
+            }
+#endif
+#ifdef DI_HEADLESS_OSMESA
+            if( m_backend == Backend::OSMesa )
+            {
+                success = OSMesaMakeCurrent( static_cast< OSMesaContext >( m_context ), m_osmesaBuffer.data(), GL_UNSIGNED_BYTE, 1, 1 );
+            }
+#endif
+            if( !success )
+            {
+                throw std::runtime_error( "Cannot make the headless context current." );
+            }
+        }
+
+        void HeadlessContext::doneCurrent()
+        {
+#ifdef DI_HEADLESS_EGL
+            if( m_backend == Backend::EGL )
+            {
+                eglMakeCurrent( static_cast< EGLDisplay >( m_display ), EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+            }
+#endif
+#ifdef DI_HEADLESS_OSMESA
+            if( m_backend == Backend::OSMesa )
+            {
+                OSMesaMakeCurrent( nullptr, nullptr, 0, 0, 0 );
+            }
+#endif
+        }
+
+        HeadlessContext::Backend HeadlessContext::getBackend() const
+        {
+            return m_backend;
+        }
+
+        std::string HeadlessContext::getBackendName() const
+        {
+            return ( m_backend == Backend::EGL ) ? "EGL (surfaceless)" : "OSMesa";
+        }
+
+        bool HeadlessContext::isAvailable()
+        {
+#if defined( DI_HEADLESS_EGL ) || defined( DI_HEADLESS_OSMESA )
+            return true;
+#else
+            return false;
+#endif
+        }
+    }
+}
+
@@ -0,0 +1,141 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_HEADLESSCONTEXT_H
+#define DI_HEADLESSCONTEXT_H
+
+#include <string>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Provides an OpenGL 3.3 core context without any windowing system. This allows rendering on machines without display server, like
+         * nodes of a CPU cluster using Mesa's llvmpipe. The context has no default framebuffer. Render to an \ref OffscreenView.
+         *
+         * Two backends are supported, depending on what was found during the build: EGL on the surfaceless platform (preferred) and OSMesa
+         * (fallback). The context is made current and GLEW gets initialized during construction.
+         *
+         * \note the context is bound to the thread that created it.
+         */
+        class HeadlessContext
+        {
+        public:
+            /**
+             * The available backends.
+             */
+            enum class Backend
+            {
+                EGL,
+                OSMesa
+            };
+
+            /**
+             * Create the context, make it current and initialize GLEW. Tries all backends compiled in.
+             *
+             * \throw std::runtime_error if no backend could provide an OpenGL 3.3 core context.
+             */
+            HeadlessContext();
+
+            /**
+             * Destroy the context.
+             */
+            virtual ~HeadlessContext();
+
+            /**
+             * Make the context current in the calling thread.
+             *
+             * \throw std::runtime_error if this fails.
+             */
+            void makeCurrent();
+
+            /**
+             * Release the context from the calling thread.
+             */
+            void doneCurrent();
+
+            /**
+             * The backend providing this context.
+             *
+             * \return the backend
+             */
+            Backend getBackend() const;
+
+            /**
+             * The name of the backend. Useful for log output.
+             *
+             * \return the name
+             */
+            std::string getBackendName() const;
+
+            /**
+             * Check whether a headless backend was compiled in at all.
+             *
+             * \return true if there is at least one backend.
+             */
+            static bool isAvailable();
+
+        protected:
+        private:
+            /**
+             * Try creating the context using EGL without any surface.
+             *
+             * \return true on success.
+             */
+            bool createEGL();
+
+            /**
+             * Try creating the context using OSMesa.
+             *
+             * \return true on success.
+             */
+            bool createOSMesa();
+
+            /**
+             * The backend in use.
+             */
+            Backend m_backend = Backend::EGL;
+
+            /**
+             * The EGL display. Unused for OSMesa. Stored as void pointer to keep the platform headers out of here.
+             */
+            void* m_display = nullptr;
+
+            /**
+             * The EGL or OSMesa context.
+             */
+            void* m_context = nullptr;
+
+            /**
+             * OSMesa always needs a color buffer to make a context current. We only render to FBOs, so this is kept tiny.
+             */
+            std::vector< unsigned char > m_osmesaBuffer;
+        };
+    }
+}
+
+#endif  // DI_HEADLESSCONTEXT_H
+
@@ -0,0 +1,209 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+
+#include <di/core/BoundingBox.h>
+#include <di/core/Visualization.h>
+#include <di/gfx/GL.h>
+#include <di/gfx/GPUProfiler.h>
+#include <di/gfx/GPUTimer.h>
+#include <di/gfx/ImageTiler.h>
+#include <di/gfx/NoiseTextureCache.h>
+#include <di/gfx/OffscreenView.h>
+#include <di/gfx/PixelReadback.h>
+#include <di/gfx/RenderTargetPool.h>
+
+#include "HeadlessRenderer.h"
+
+#include <di/core/Logger.h>
+#define LogTag "gfx/HeadlessRenderer"
+
+namespace di
+{
+    namespace core
+    {
+        HeadlessRenderer::HeadlessRenderer( SPtr< ProcessingNetwork > network ):
+            m_network( network )
+        {
+        }
+
+        HeadlessRenderer::~HeadlessRenderer()
+        {
+            finalize();
+        }
+
+        void HeadlessRenderer::prepare()
+        {
+            if( m_prepared )
+            {
+                return;
+            }
+
+            m_network->visitVisualizations(
+                []( SPtr< Visualization > vis )
+                {
+                    vis->prepare();
+                }
+            );
+            m_prepared = true;
+        }
+
+        SPtr< RGBA8Image > HeadlessRenderer::render( const glm::ivec2& resolution, const glm::mat4& orientation, int samples, float zoom )
+        {
+            prepare();
+
+            BoundingBox sceneBB;
+            m_network->visitVisualizations(
+                [ &sceneBB ]( SPtr< Visualization > vis )
+                {
+                    sceneBB.include( vis->getBoundingBox() );
+                }
+            );
+
+            // Same camera setup as used for the default views of the interactive widget.
+            double near = 0.3;
+            double far = zoom * sqrt( 3.0 ) + near;
+            Camera camera;
+            camera.setProjectionMatrix( Camera::buildProjectionMatrix( near, far, static_cast< float >( resolution.x ) / resolution.y ) );
+            camera.setViewMatrix( Camera::buildViewMatrix( sceneBB, orientation, zoom ) );
+
+            GLint maxSize = 0;
+            glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxSize );
+            ImageTiler tiler( resolution, std::min( m_tileSize, static_cast< int >( maxSize ) ), m_tileMargin );
+
+            // Each image counts as frame for the profiler.
+            GPUProfiler::getInstance().beginFrame();
+            GPUTimer imageTimer( "Image" );
+
+            // Fetch the pixels of a tile after the next one was issued. This keeps the GPU busy while copying.
+            SPtr< PixelReadback > pending = nullptr;
+            size_t pendingTile = 0;
+            for( size_t tile = 0; tile < tiler.getNumTiles(); ++tile )
+            {
+                auto view = tiler.createView( tile, camera, samples );
+                view->setHQMode( true );
+                view->prepare();
+                renderToView( view );
+                auto readback = view->readAsync();
+                view->finalize();
+                logGLError();
+
+                if( pending )
+                {
+                    tiler.insert( pendingTile, *pending->get() );
+                }
+                pending = readback;
+                pendingTile = tile;
+            }
+            tiler.insert( pendingTile, *pending->get() );
+            imageTimer.stop();
+            GPUProfiler::getInstance().endFrame();
+
+            // Each image counts as frame for the pool.
+            RenderTargetPool::getInstance().collect();
+
+            return tiler.getImage();
+        }
+
+        void HeadlessRenderer::renderToView( SPtr< OffscreenView > view )
+        {
+            // Update
+            m_network->visitVisualizations(
+                [ view ]( SPtr< Visualization > vis )
+                {
+                    if( vis->isRenderingActive() )
+                    {
+                        view->bind();
+                        vis->update( *view );
+                    }
+                }
+            );
+
+            // Draw
+            view->bind();
+            glViewport( view->getViewport().first.x, view->getViewport().first.y,
+                        view->getViewport().second.x, view->getViewport().second.y );
+            glClearColor( m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b, m_backgroundColor.a );
+            glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+
+            glDepthMask( GL_TRUE );
+            glEnable( GL_BLEND );
+            glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+            glEnable( GL_DEPTH_TEST );
+            glDepthFunc( GL_LESS );
+
+            m_network->visitVisualizations(
+                [ view ]( SPtr< Visualization > vis )
+                {
+                    if( vis->isRenderingActive() )
+                    {
+                        view->bind();
+                        vis->render( *view );
+                    }
+                }
+            );
+        }
+
+        void HeadlessRenderer::setBackgroundColor( const Color& color )
+        {
+            m_backgroundColor = color;
+        }
+
+        void HeadlessRenderer::setTileSize( int tileSize, int margin )
+        {
+            m_tileSize = tileSize;
+            m_tileMargin = margin;
+        }
+
+        void HeadlessRenderer::finalize()
+        {
+            if( !m_prepared )
+            {
+                return;
+            }
+
+            m_network->visitVisualizations(
+                []( SPtr< Visualization > vis )
+                {
+                    vis->finalize();
+                }
+            );
+            RenderTargetPool::getInstance().clear();
+            NoiseTextureCache::getInstance().clear();
+
+            // Report the pass timings of all images.
+            auto& profiler = GPUProfiler::getInstance();
+            if( profiler.isEnabled() )
+            {
+                profiler.flush();
+                LogI << "GPU timings per image:" << std::endl << profiler.getReport() << LogEnd;
+            }
+            profiler.clear();
+            m_prepared = false;
+        }
+    }
+}
+
@@ -0,0 +1,138 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_HEADLESSRENDERER_H
+#define DI_HEADLESSRENDERER_H
+
+#include <di/core/ProcessingNetwork.h>
+#include <di/gfx/PixelData.h>
+
+#include <di/Types.h>
+#include <di/GfxTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        class OffscreenView;
+
+        /**
+         * Renders the visualizations of a processing network to images without any window. This is the windowless counterpart of the
+         * screenshot code in the OpenGL widget. It drives \ref Visualization::prepare, \ref Visualization::update and
+         * \ref Visualization::render on an \ref OffscreenView and reads back the result.
+         *
+         * \note requires a current OpenGL 3.3 context, like the one provided by \ref HeadlessContext. All methods need to be called in the
+         * thread owning the context.
+         */
+        class HeadlessRenderer
+        {
+        public:
+            /**
+             * Create the renderer.
+             *
+             * \param network the network whose visualizations are rendered.
+             */
+            explicit HeadlessRenderer( SPtr< ProcessingNetwork > network );
+
+            /**
+             * Destructor. Finalizes the visualizations if not yet done.
+             */
+            virtual ~HeadlessRenderer();
+
+            /**
+             * Allow all visualizations to prepare their resources. Call once, before the first \ref render.
+             */
+            void prepare();
+
+            /**
+             * Render the scene. The visualizations get updated first. Images larger than the tile size are rendered in several tiles.
+             *
+             * \param resolution the image size in pixels
+             * \param orientation the orientation of the scene. The camera is placed to fit the scene bounding box, like for the default views.
+             * \param samples number of samples for anti-aliasing
+             * \param zoom the zoom factor. The default matches the initial zoom of the interactive view.
+             *
+             * \return the image
+             */
+            SPtr< RGBA8Image > render( const glm::ivec2& resolution, const glm::mat4& orientation, int samples = 1, float zoom = 1.732f );
+
+            /**
+             * Set the color used to clear the background.
+             *
+             * \param color the color. White by default.
+             */
+            void setBackgroundColor( const Color& color );
+
+            /**
+             * Set the size of the tiles used to render large images.
+             *
+             * \param tileSize the maximum size of a tile in pixels. Limited by GL_MAX_TEXTURE_SIZE.
+             * \param margin the overlap of the tiles in pixels. See \ref ImageTiler.
+             */
+            void setTileSize( int tileSize, int margin );
+
+            /**
+             * Free the resources of all visualizations and the shared render resources.
+             */
+            void finalize();
+
+        protected:
+            /**
+             * Update and render all active visualizations to the given view.
+             *
+             * \param view the prepared view
+             */
+            void renderToView( SPtr< OffscreenView > view );
+
+        private:
+            /**
+             * The network to render.
+             */
+            SPtr< ProcessingNetwork > m_network = nullptr;
+
+            /**
+             * The background color.
+             */
+            Color m_backgroundColor = Color( 1.0f, 1.0f, 1.0f, 1.0f );
+
+            /**
+             * True if \ref prepare was called and \ref finalize was not.
+             */
+            bool m_prepared = false;
+
+            /**
+             * Maximum tile size.
+             */
+            int m_tileSize = 2048;
+
+            /**
+             * Tile overlap.
+             */
+            int m_tileMargin = 256;
+        };
+    }
+}
+
+#endif  // DI_HEADLESSRENDERER_H
+
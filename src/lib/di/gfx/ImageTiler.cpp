@@ -0,0 +1,150 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <di/gfx/OffscreenView.h>
+
+#include "ImageTiler.h"
+
+#include <di/core/Logger.h>
+#define LogTag "gfx/ImageTiler"
+
+namespace di
+{
+    namespace core
+    {
+        ImageTiler::ImageTiler( const glm::ivec2& imageSize, int tileSize, int margin ):
+            m_imageSize( imageSize )
+        {
+            if( ( imageSize.x <= 0 ) || ( imageSize.y <= 0 ) )
+            {
+                throw std::invalid_argument( "Cannot tile an empty image." );
+            }
+
+            // Small enough? Render in one piece. No margin needed.
+            if( ( imageSize.x <= tileSize ) && ( imageSize.y <= tileSize ) )
+            {
+                m_coreSize = imageSize;
+                m_margin = 0;
+                m_numTiles = glm::ivec2( 1, 1 );
+            }
+            else
+            {
+                int core = tileSize - 2 * margin;
+                if( core <= 0 )
+                {
+                    throw std::invalid_argument( "Tile size " + std::to_string( tileSize ) + " too small for a margin of " +
+                                                 std::to_string( margin ) + "." );
+                }
+
+                m_coreSize = glm::ivec2( core, core );
+                m_margin = margin;
+                m_numTiles = ( imageSize + m_coreSize - glm::ivec2( 1 ) ) / m_coreSize;
+            }
+
+            m_image = std::make_shared< RGBA8Image >( m_imageSize.x, m_imageSize.y );
+
+            LogD << "Splitting " << m_imageSize.x << "x" << m_imageSize.y << " image into " << m_numTiles.x << "x" << m_numTiles.y
+                 << " tiles." << LogEnd;
+        }
+
+        ImageTiler::~ImageTiler()
+        {
+        }
+
+        size_t ImageTiler::getNumTiles() const
+        {
+            return m_numTiles.x * m_numTiles.y;
+        }
+
+        glm::ivec2 ImageTiler::getImageSize() const
+        {
+            return m_imageSize;
+        }
+
+        std::pair< glm::ivec2, glm::ivec2 > ImageTiler::getTileRegion( size_t tile ) const
+        {
+            if( tile >= getNumTiles() )
+            {
+                throw std::out_of_range( "Tile " + std::to_string( tile ) + " does not exist." );
+            }
+
+            glm::ivec2 index( tile % m_numTiles.x, tile / m_numTiles.x );
+            glm::ivec2 origin = index * m_coreSize;
+            glm::ivec2 size = glm::min( m_coreSize, m_imageSize - origin );
+            return std::make_pair( origin, size );
+        }
+
+        SPtr< OffscreenView > ImageTiler::createView( size_t tile, const Camera& camera, int samples ) const
+        {
+            auto region = getTileRegion( tile );
+            glm::ivec2 origin = region.first - glm::ivec2( m_margin );
+            glm::ivec2 size = region.second + glm::ivec2( 2 * m_margin );
+
+            auto view = std::make_shared< OffscreenView >( glm::vec2( size ), samples );
+            if( getNumTiles() == 1 )
+            {
+                view->setCamera( camera );
+                return view;
+            }
+
+            Camera tileCamera( camera );
+            tileCamera.setProjectionMatrix( Camera::buildTileProjectionMatrix( camera.getProjectionMatrix(), glm::vec2( m_imageSize ),
+                                                                               glm::vec2( origin ), glm::vec2( size ) ) );
+            view->setCamera( tileCamera );
+            view->setImageRegion( glm::vec2( m_imageSize ), glm::vec2( origin ) );
+            return view;
+        }
+
+        void ImageTiler::insert( size_t tile, const RGBA8Image& pixels )
+        {
+            auto region = getTileRegion( tile );
+            glm::ivec2 size = region.second + glm::ivec2( 2 * m_margin );
+            if( ( pixels.getWidth() != static_cast< size_t >( size.x ) ) || ( pixels.getHeight() != static_cast< size_t >( size.y ) ) )
+            {
+                throw std::invalid_argument( "Pixels do not match the size of tile " + std::to_string( tile ) + "." );
+            }
+
+            // Copy row by row, skipping the margins.
+            auto src = static_cast< const glm::u8vec4* >( pixels.data() );
+            auto dst = static_cast< glm::u8vec4* >( m_image->data() );
+            for( int y = 0; y < region.second.y; ++y )
+            {
+                auto srcRow = src + ( y + m_margin ) * pixels.getWidth() + m_margin;
+                auto dstRow = dst + ( region.first.y + y ) * m_imageSize.x + region.first.x;
+                std::copy( srcRow, srcRow + region.second.x, dstRow );
+            }
+        }
+
+        SPtr< RGBA8Image > ImageTiler::getImage() const
+        {
+            return m_image;
+        }
+    }
+}
+
@@ -0,0 +1,149 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_IMAGETILER_H
+#define DI_IMAGETILER_H
+
+#include <utility>
+
+#include <di/gfx/Camera.h>
+#include <di/gfx/PixelData.h>
+
+#include <di/Types.h>
+#include <di/MathTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        class OffscreenView;
+
+        /**
+         * Splits an image into tiles of bounded size, provides the views to render each tile, and assembles the rendered tiles into the final
+         * image. This allows images larger than GL_MAX_TEXTURE_SIZE with a constant amount of GPU memory. Each tile is rendered with an
+         * additional margin on each side, which is cut off afterwards. This keeps screen-space effects, like SSAO or LIC advection, free of
+         * seams. Images that fit into one tile are rendered as one tile without margin.
+         */
+        class ImageTiler
+        {
+        public:
+            /**
+             * Create the tiler.
+             *
+             * \param imageSize the size of the final image in pixels.
+             * \param tileSize the maximum size of a tile, including the margins. Power of two sizes work best with the visualizations.
+             * \param margin the overlap of neighbouring tiles in pixels.
+             *
+             * \throw std::invalid_argument if the tile size cannot hold the margins or the image is empty.
+             */
+            ImageTiler( const glm::ivec2& imageSize, int tileSize = 2048, int margin = 256 );
+
+            /**
+             * Destructor.
+             */
+            virtual ~ImageTiler();
+
+            /**
+             * The number of tiles needed.
+             *
+             * \return the number of tiles
+             */
+            size_t getNumTiles() const;
+
+            /**
+             * The size of the final image.
+             *
+             * \return the size in pixels
+             */
+            glm::ivec2 getImageSize() const;
+
+            /**
+             * Create the view to render the given tile to. The view is not prepared. Call \ref OffscreenView::prepare yourself.
+             *
+             * \param tile the tile index
+             * \param camera the camera for the whole image. The projection needs to use the aspect ratio of the whole image.
+             * \param samples the number of samples per pixel
+             *
+             * \return the view
+             */
+            SPtr< OffscreenView > createView( size_t tile, const Camera& camera, int samples = 1 ) const;
+
+            /**
+             * Copy the rendered tile into the final image. The margins are discarded.
+             *
+             * \param tile the tile index
+             * \param pixels the pixels read from the view created by \ref createView.
+             *
+             * \throw std::invalid_argument if the pixels do not match the size of the tile.
+             */
+            void insert( size_t tile, const RGBA8Image& pixels );
+
+            /**
+             * Get the final image. Only complete after all tiles have been inserted.
+             *
+             * \return the image
+             */
+            SPtr< RGBA8Image > getImage() const;
+
+        protected:
+        private:
+            /**
+             * Get the part of the image a tile covers, without margin.
+             *
+             * \param tile the tile index
+             *
+             * \return the origin and the size in pixels
+             */
+            std::pair< glm::ivec2, glm::ivec2 > getTileRegion( size_t tile ) const;
+
+            /**
+             * The size of the final image.
+             */
+            glm::ivec2 m_imageSize = glm::ivec2( 0, 0 );
+
+            /**
+             * The size of a tile without margins.
+             */
+            glm::ivec2 m_coreSize = glm::ivec2( 0, 0 );
+
+            /**
+             * The margin around each tile.
+             */
+            int m_margin = 0;
+
+            /**
+             * Number of tiles in x and y direction.
+             */
+            glm::ivec2 m_numTiles = glm::ivec2( 1, 1 );
+
+            /**
+             * The final image.
+             */
+            SPtr< RGBA8Image > m_image = nullptr;
+        };
+    }
+}
+
+#endif  // DI_IMAGETILER_H
+
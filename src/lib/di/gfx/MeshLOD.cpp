@@ -0,0 +1,186 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <exception>
+#include <vector>
+
+#include <di/core/data/MeshSimplifier.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/gfx/Buffer.h>
+#include <di/gfx/GL.h>
+#include <di/gfx/GLError.h>
+#include <di/gfx/View.h>
+
+#include "MeshLOD.h"
+
+#include <di/core/Logger.h>
+#define LogTag "gfx/MeshLOD"
+
+namespace di
+{
+    namespace core
+    {
+        MeshLOD::MeshLOD():
+            m_cancelBuild( false ),
+            m_triangleBudget( 500000 )
+        {
+        }
+
+        MeshLOD::~MeshLOD()
+        {
+            m_cancelBuild = true;
+            m_build.wait();
+        }
+
+        void MeshLOD::setMesh( ConstSPtr< TriangleMesh > mesh, std::function< void() > onReady )
+        {
+            size_t budget = 0;
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                if( m_mesh == mesh )
+                {
+                    return;
+                }
+                m_mesh = mesh;
+                m_levels = nullptr;
+                budget = m_triangleBudget;
+            }
+
+            // Only one build at a time. The result of the previous one is discarded as the mesh changed. Stop it instead of waiting for it.
+            if( !m_build.isDone() )
+            {
+                m_cancelBuild = true;
+                m_build.wait();
+                m_cancelBuild = false;
+            }
+
+            if( !mesh || ( mesh->getNumTriangles() <= budget ) )
+            {
+                return;
+            }
+
+            m_build.run(
+                [ this, mesh, onReady, budget ]()
+                {
+                    try
+                    {
+                        auto start = std::chrono::steady_clock::now();
+
+                        // Go a bit below the budget to have a fast level for slow GPUs too.
+                        auto levels = std::make_shared< std::vector< IndexVec3Array > >(
+                            buildLevelsOfDetail( *mesh, budget / 8, 0.5, &m_cancelBuild )
+                        );
+                        if( m_cancelBuild )
+                        {
+                            return;
+                        }
+
+                        auto duration = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - start );
+                        LogD << "Built " << levels->size() << " levels of detail for " << mesh->getNumTriangles() << " triangles in "
+                             << duration.count() << "ms." << LogEnd;
+
+                        {
+                            std::lock_guard< std::mutex > lock( m_mutex );
+                            if( m_mesh != mesh )
+                            {
+                                return;
+                            }
+                            m_levels = levels;
+                        }
+                        onReady();
+                    }
+                    catch( const std::exception& e )
+                    {
+                        LogE << "Building the levels of detail failed: " << e.what() << ". Rendering full resolution only." << LogEnd;
+                    }
+                }
+            );
+        }
+
+        void MeshLOD::update( ConstSPtr< TriangleMesh > mesh )
+        {
+            SPtr< std::vector< IndexVec3Array > > levels = nullptr;
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                if( m_mesh == mesh )
+                {
+                    levels = m_levels;
+                    m_levels = nullptr;
+                }
+            }
+
+            if( m_uploadedMesh != mesh )
+            {
+                m_levelSizes.clear();
+                m_uploadedMesh = mesh;
+            }
+
+            if( !levels )
+            {
+                return;
+            }
+
+            // Element array bindings are part of the VAO state. Do not modify the one of the caller.
+            glBindVertexArray( 0 );
+
+            m_levelSizes.clear();
+            for( size_t i = 0; i < levels->size(); ++i )
+            {
+                if( m_buffers.size() <= i )
+                {
+                    m_buffers.push_back( std::make_shared< Buffer >( Buffer::BufferType::ElementArray ) );
+                }
+                m_buffers[ i ]->realize();
+                m_buffers[ i ]->bind();
+                m_buffers[ i ]->data( ( *levels )[ i ] );
+                logGLError();
+                m_levelSizes.push_back( ( *levels )[ i ].size() );
+            }
+        }
+
+        size_t MeshLOD::bind( const View& view, SPtr< Buffer > indexBuffer, size_t numTriangles ) const
+        {
+            if( !view.isInteracting() || m_levelSizes.empty() )
+            {
+                indexBuffer->bind();
+                return numTriangles;
+            }
+
+            // The finest level within the budget. The coarsest one if simplification stopped early.
+            size_t level = 0;
+            while( ( level + 1 < m_levelSizes.size() ) && ( m_levelSizes[ level ] > m_triangleBudget ) )
+            {
+                ++level;
+            }
+            m_buffers[ level ]->bind();
+            return m_levelSizes[ level ];
+        }
+
+        void MeshLOD::setTriangleBudget( size_t triangles )
+        {
+            m_triangleBudget = triangles;
+        }
+    }
+}
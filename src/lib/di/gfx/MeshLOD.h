@@ -0,0 +1,154 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MESHLOD_H
+#define DI_MESHLOD_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <di/Types.h>
+#include <di/GfxTypes.h>
+#include <di/core/TaskGroup.h>
+
+namespace di
+{
+    namespace core
+    {
+        class Buffer;
+        class TriangleMesh;
+        class View;
+
+        /**
+         * Coarse versions of a triangle mesh for rendering during camera interaction. The levels are built by \ref buildLevelsOfDetail in a
+         * background thread. They index the vertices of the original mesh, so the vertex and attribute buffers of a visualization can be used
+         * unchanged. Only the index buffer is swapped while the view is interacting.
+         */
+        class MeshLOD
+        {
+        public:
+            /**
+             * Constructor. Does not create any GL resources.
+             */
+            MeshLOD();
+
+            /**
+             * Destructor. Cancels a running build and waits for it to stop.
+             */
+            virtual ~MeshLOD();
+
+            /**
+             * Set the mesh to build the levels for. Meshes smaller than the triangle budget do not need any. If the mesh changed, the levels are
+             * built in a background thread. Call this in \ref Algorithm::process.
+             *
+             * \param mesh the mesh. Can be nullptr.
+             * \param onReady called in the background thread when the levels are ready to be uploaded by \ref update. Use this to request
+             * rendering.
+             */
+            void setMesh( ConstSPtr< TriangleMesh > mesh, std::function< void() > onReady );
+
+            /**
+             * Upload finished levels and drop levels of other meshes.
+             *
+             * \note call in the OpenGL thread. Unbinds the current vertex array object.
+             *
+             * \param mesh the mesh whose vertices are currently uploaded by the visualization.
+             */
+            void update( ConstSPtr< TriangleMesh > mesh );
+
+            /**
+             * Bind the index buffer to use for the view. While the view is interacting, this is the finest level within the triangle budget.
+             * Otherwise, the given full resolution index buffer is bound.
+             *
+             * \note call in the OpenGL thread with the vertex array object of the mesh bound.
+             *
+             * \param view the view to render to
+             * \param indexBuffer the full resolution index buffer
+             * \param numTriangles the number of triangles in the full resolution index buffer
+             *
+             * \return the number of triangles to draw.
+             */
+            size_t bind( const View& view, SPtr< Buffer > indexBuffer, size_t numTriangles ) const;
+
+            /**
+             * Set the number of triangles that can be rendered interactively. Takes effect with the next \ref setMesh.
+             *
+             * \param triangles the number of triangles
+             */
+            void setTriangleBudget( size_t triangles );
+
+        protected:
+        private:
+            /**
+             * Protects the mesh and the levels shared with the build thread.
+             */
+            std::mutex m_mutex;
+
+            /**
+             * The mesh the levels are built for.
+             */
+            ConstSPtr< TriangleMesh > m_mesh = nullptr;
+
+            /**
+             * Levels built but not yet uploaded.
+             */
+            SPtr< std::vector< IndexVec3Array > > m_levels = nullptr;
+
+            /**
+             * The running build. Executed by the shared \ref ThreadPool.
+             */
+            TaskGroup m_build;
+
+            /**
+             * Set to stop the running build. Its result is not needed anymore.
+             */
+            std::atomic< bool > m_cancelBuild;
+
+            /**
+             * The mesh of the uploaded levels.
+             */
+            ConstSPtr< TriangleMesh > m_uploadedMesh = nullptr;
+
+            /**
+             * One index buffer per level. Re-used for later meshes.
+             */
+            std::vector< SPtr< Buffer > > m_buffers = {};
+
+            /**
+             * The number of triangles in each uploaded level. Finest first.
+             */
+            std::vector< size_t > m_levelSizes = {};
+
+            /**
+             * Number of triangles that can be rendered interactively. Half a million by default.
+             */
+            std::atomic< size_t > m_triangleBudget;
+        };
+    }
+}
+
+#endif  // DI_MESHLOD_H
+
@@ -0,0 +1,156 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/gfx/GLError.h>
+
+#include "NoiseTextureCache.h"
+
+#include <di/core/Logger.h>
+#define LogTag "gfx/NoiseTextureCache"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Counter-based random numbers. Maps the counter to a well mixed 64 bit value, using the SplitMix64 finalizer. Random access, so any
+         * part of the sequence can be generated independently.
+         *
+         * \param seed the seed
+         * \param counter the position in the sequence
+         *
+         * \return the random number
+         */
+        static inline uint64_t counterRandom( uint64_t seed, uint64_t counter )
+        {
+            uint64_t z = seed + ( counter + 1 ) * 0x9E3779B97F4A7C15ULL;
+            z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+            z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+            return z ^ ( z >> 31 );
+        }
+
+        /**
+         * Fill a range of the noise array. Each 64 bit random number provides 8 consecutive bytes.
+         *
+         * \param data the array
+         * \param begin the first block of 8 bytes to fill
+         * \param end the block behind the last to fill
+         * \param count the size of the whole array in bytes
+         * \param seed the seed
+         */
+        static void generateRange( uint8_t* data, size_t begin, size_t end, size_t count, uint64_t seed )
+        {
+            for( size_t block = begin; block < end; ++block )
+            {
+                uint64_t value = counterRandom( seed, block );
+                size_t offset = block * sizeof( value );
+                std::memcpy( data + offset, &value, std::min( sizeof( value ), count - offset ) );
+            }
+        }
+
+        NoiseTextureCache& NoiseTextureCache::getInstance()
+        {
+            static NoiseTextureCache cache;
+            return cache;
+        }
+
+        NoiseTextureCache::~NoiseTextureCache()
+        {
+            // The textures are finalized by their destructor. Call clear() while the context is current to free them properly.
+        }
+
+        std::vector< uint8_t > NoiseTextureCache::generate( size_t count, uint64_t seed )
+        {
+            std::vector< uint8_t > result( count );
+            size_t blocks = ( count + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t );
+
+            // Small amounts are not worth the threads.
+            parallelFor( blocks,
+                [ &result, count, seed ]( size_t begin, size_t end )
+                {
+                    generateRange( result.data(), begin, end, count, seed );
+                }, 1 << 14
+            );
+            return result;
+        }
+
+        SPtr< Texture > NoiseTextureCache::get( const glm::ivec3& size, size_t channels, uint64_t seed )
+        {
+            GLint internalFormat = GL_R8;
+            GLint format = GL_RED;
+            switch( channels )
+            {
+                case 1:
+                    internalFormat = GL_R8;
+                    format = GL_RED;
+                    break;
+                case 3:
+                    internalFormat = GL_RGB;
+                    format = GL_RGB;
+                    break;
+                case 4:
+                    internalFormat = GL_RGBA;
+                    format = GL_RGBA;
+                    break;
+                default:
+                    throw std::invalid_argument( "Noise textures support 1, 3 or 4 channels." );
+            }
+
+            auto key = std::make_tuple( size.x, size.y, size.z, channels, seed );
+            auto cached = m_textures.find( key );
+            if( cached != m_textures.end() )
+            {
+                return cached->second;
+            }
+
+            LogD << "Creating noise texture " << size.x << "x" << size.y << "x" << size.z << ", seed " << seed << "." << LogEnd;
+
+            auto data = generate( static_cast< size_t >( size.x ) * size.y * size.z * channels, seed );
+
+            bool is3D = ( size.z > 1 );
+            auto texture = std::make_shared< Texture >( is3D ? Texture::TextureType::Tex3D : Texture::TextureType::Tex2D );
+            texture->realize();
+            texture->bind();
+            // Rows of single channel or RGB data are not necessarily 4-byte aligned.
+            glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+            texture->data( data.data(), size.x, size.y, size.z, internalFormat, format, GL_UNSIGNED_BYTE );
+            glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+            logGLError();
+
+            m_textures[ key ] = texture;
+            return texture;
+        }
+
+        void NoiseTextureCache::clear()
+        {
+            m_textures.clear();
+        }
+    }
+}
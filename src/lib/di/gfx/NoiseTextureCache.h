@@ -0,0 +1,112 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_NOISETEXTURECACHE_H
+#define DI_NOISETEXTURECACHE_H
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <di/gfx/OpenGL.h>
+#include <di/gfx/Texture.h>
+
+#include <di/Types.h>
+#include <di/GfxTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Creates white noise textures and keeps them for re-use. The noise only depends on the size, the number of channels and the seed. It
+         * is generated with a counter-based random number generator, so the same seed always gives the same noise, no matter how the work is
+         * split across threads.
+         *
+         * \note \ref get must only be used in the OpenGL thread.
+         */
+        class NoiseTextureCache
+        {
+        public:
+            /**
+             * The cache used by the application.
+             *
+             * \return the cache.
+             */
+            static NoiseTextureCache& getInstance();
+
+            /**
+             * Destructor.
+             */
+            virtual ~NoiseTextureCache();
+
+            /**
+             * Get a noise texture. Created on first request, returned from the cache later. Do not modify the texture data, it is shared.
+             *
+             * \param size the size in voxels. If z is 1, a 2D texture is created, a 3D texture otherwise.
+             * \param channels the number of channels: 1, 3 or 4. The resulting texture uses GL_R8, GL_RGB or GL_RGBA.
+             * \param seed the seed
+             *
+             * \throw std::invalid_argument if the number of channels is not supported.
+             *
+             * \return the texture
+             */
+            SPtr< Texture > get( const glm::ivec3& size, size_t channels, uint64_t seed = 0 );
+
+            /**
+             * Remove all textures from the cache. Call while the context is current.
+             */
+            void clear();
+
+            /**
+             * Generate white noise on the CPU. Uses all available cores.
+             *
+             * \param count the number of bytes to generate
+             * \param seed the seed
+             *
+             * \return the noise, one uniformly distributed byte per element.
+             */
+            static std::vector< uint8_t > generate( size_t count, uint64_t seed = 0 );
+
+        protected:
+            /**
+             * Constructor. Use \ref getInstance.
+             */
+            NoiseTextureCache() = default;
+
+        private:
+            /**
+             * Cache key: size, channels and seed.
+             */
+            typedef std::tuple< int, int, int, size_t, uint64_t > Key;
+
+            /**
+             * All textures created so far.
+             */
+            std::map< Key, SPtr< Texture > > m_textures;
+        };
+    }
+}
+
+#endif  // DI_NOISETEXTURECACHE_H
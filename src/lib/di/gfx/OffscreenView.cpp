@@ -27,6 +27,8 @@
 #include <di/gfx/GL.h>
 #include <di/gfx/GLError.h>
 #include <di/gfx/PixelData.h>
+#include <di/gfx/PixelReadback.h>
+#include <di/gfx/Texture.h>
 
 #include "OffscreenView.h"
 
@@ -65,54 +67,62 @@ namespace di
         }
 
         SPtr< RGBA8Image > OffscreenView::read() const
+        {
+            return readAsync()->get();
+        }
+
+        SPtr< PixelReadback > OffscreenView::readAsync() const
         {
             LogD << "FBO read-back." << LogEnd;
-            auto pixels = std::make_shared< RGBA8Image >( getViewportSize().x, getViewportSize().y );
+            glm::ivec2 size( getViewportSize() );
 
             bool multisample = m_samples > 1;
-            if( multisample )
-            {
-                LogD << "Blending multi-sample FBO." << LogEnd;
-
-                // Now, blend all samples together
-
-                // Create target FBO for sampling
-                GLuint resultFBO = 0;
-                glGenFramebuffers( 1, &resultFBO );
-
-                // Bind target fbo and source fbo
-                glBindFramebuffer( GL_DRAW_FRAMEBUFFER, resultFBO );
-                glBindFramebuffer( GL_READ_FRAMEBUFFER, m_fbo ); // read from the multi-sample buffer
-
-                // Color output
-                auto resultTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-                resultTex->realize();
-                resultTex->bind();
-                resultTex->data( getViewportSize().x, getViewportSize().y, 1, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
-                resultTex->setTextureFilter( core::Texture::TextureFilter::Linear, core::Texture::TextureFilter::Linear );
-                logGLError();
-                glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, resultTex->getObjectID(), 0 );
-
-                // Set this attachment as result
-                GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
-                glDrawBuffers( 1, drawBuffers );
-                logGLError();
-
-                // Copy operation (blit).
-                glBlitFramebuffer( 0, 0, getViewportSize().x, getViewportSize().y,
-                                   0, 0, getViewportSize().x, getViewportSize().y, GL_COLOR_BUFFER_BIT, GL_NEAREST );
-
-                // read back
-                resultTex->bind();
-                resultTex->read( *pixels, GL_RGBA, GL_UNSIGNED_BYTE );
-            }
-            else
+            if( !multisample )
             {
-                m_outputTex->bind();
-                m_outputTex->read( *pixels, GL_RGBA, GL_UNSIGNED_BYTE );
+                glBindFramebuffer( GL_READ_FRAMEBUFFER, m_fbo );
+                auto readback = std::make_shared< PixelReadback >( size );
+                glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 );
+                return readback;
             }
 
-            return pixels;
+            LogD << "Blending multi-sample FBO." << LogEnd;
+
+            // Now, blend all samples together
+
+            // Create target FBO for sampling
+            GLuint resultFBO = 0;
+            glGenFramebuffers( 1, &resultFBO );
+
+            // Bind target fbo and source fbo
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, resultFBO );
+            glBindFramebuffer( GL_READ_FRAMEBUFFER, m_fbo ); // read from the multi-sample buffer
+
+            // Color output
+            auto resultTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
+            resultTex->realize();
+            resultTex->bind();
+            resultTex->data( size.x, size.y, 1, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
+            resultTex->setTextureFilter( core::Texture::TextureFilter::Linear, core::Texture::TextureFilter::Linear );
+            logGLError();
+            glFramebufferTexture2D( GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, resultTex->getObjectID(), 0 );
+
+            // Set this attachment as result
+            GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+            glDrawBuffers( 1, drawBuffers );
+            logGLError();
+
+            // Copy operation (blit).
+            glBlitFramebuffer( 0, 0, size.x, size.y, 0, 0, size.x, size.y, GL_COLOR_BUFFER_BIT, GL_NEAREST );
+
+            // Read back from the resolved FBO. GL keeps the FBO and texture alive until the pending copy is done, so we can delete them right away.
+            glBindFramebuffer( GL_READ_FRAMEBUFFER, resultFBO );
+            auto readback = std::make_shared< PixelReadback >( size );
+            glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 );
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 );
+            glDeleteFramebuffers( 1, &resultFBO );
+            logGLError();
+
+            return readback;
         }
 
         void OffscreenView::bind() const
@@ -35,6 +35,8 @@ namespace di
 {
     namespace core
     {
+        class PixelReadback;
+
         /**
          * Class represents the offscreen rendering view with a fixed size.
          */
@@ -99,12 +101,20 @@ namespace di
             void finalize();
 
             /**
-             * Read back the texture. Width and height are the viewport size.
+             * Read back the texture. Width and height are the viewport size. This waits for the GPU. See \ref readAsync.
              *
              * \return the image
              */
             SPtr< RGBA8Image > read() const;
 
+            /**
+             * Start reading back the texture. This returns immediately. Fetch the image using \ref PixelReadback::get later, while rendering
+             * something else in the meantime. The view can be finalized before that.
+             *
+             * \return the pending read-back
+             */
+            SPtr< PixelReadback > readAsync() const;
+
             /**
              * Get the state object representing this object at the moment of the call.
              *
@@ -0,0 +1,113 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <cstring>
+
+#include <di/gfx/Buffer.h>
+#include <di/gfx/GL.h>
+#include <di/gfx/GLError.h>
+
+#include "PixelReadback.h"
+
+#include <di/core/Logger.h>
+#define LogTag "gfx/PixelReadback"
+
+namespace di
+{
+    namespace core
+    {
+        PixelReadback::PixelReadback( const glm::ivec2& size ):
+            m_size( size )
+        {
+            m_buffer = std::make_shared< Buffer >( Buffer::BufferType::PixelPack );
+            m_buffer->realize();
+            m_buffer->bind();
+            m_buffer->data( 4 * static_cast< size_t >( size.x ) * static_cast< size_t >( size.y ), nullptr );
+
+            // With a pack buffer bound, the pointer is an offset into the buffer and the call returns without waiting for the GPU.
+            glReadBuffer( GL_COLOR_ATTACHMENT0 );
+            glReadPixels( 0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+            logGLError();
+
+            m_fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+            glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+            logGLError();
+        }
+
+        PixelReadback::~PixelReadback()
+        {
+            if( m_fence )
+            {
+                glDeleteSync( m_fence );
+            }
+        }
+
+        bool PixelReadback::isReady() const
+        {
+            if( !m_fence )
+            {
+                return true;
+            }
+
+            GLint status = GL_UNSIGNALED;
+            glGetSynciv( m_fence, GL_SYNC_STATUS, 1, nullptr, &status );
+            return status == GL_SIGNALED;
+        }
+
+        SPtr< RGBA8Image > PixelReadback::get()
+        {
+            if( m_image )
+            {
+                return m_image;
+            }
+
+            // Wait for the copy. Flush, in case nobody else did.
+            while( glClientWaitSync( m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000 ) == GL_TIMEOUT_EXPIRED )
+            {
+                LogD << "Still waiting for pixel read-back." << LogEnd;
+            }
+            glDeleteSync( m_fence );
+            m_fence = nullptr;
+
+            m_image = std::make_shared< RGBA8Image >( m_size.x, m_size.y );
+            m_buffer->bind();
+            auto mapped = glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, m_buffer->getSize(), GL_MAP_READ_BIT );
+            if( mapped )
+            {
+                std::memcpy( m_image->data(), mapped, m_buffer->getSize() );
+                glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+            }
+            else
+            {
+                LogE << "Mapping the pixel buffer failed." << LogEnd;
+            }
+            glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+            logGLError();
+
+            m_buffer = nullptr;
+            return m_image;
+        }
+    }
+}
+
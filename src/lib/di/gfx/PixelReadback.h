@@ -0,0 +1,102 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_PIXELREADBACK_H
+#define DI_PIXELREADBACK_H
+
+#include <di/gfx/OpenGL.h>
+#include <di/gfx/PixelData.h>
+
+#include <di/Types.h>
+#include <di/MathTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        class Buffer;
+
+        /**
+         * Asynchronous read-back of framebuffer contents. On construction, the pixels of the currently bound read framebuffer are copied to a
+         * pixel buffer object. This returns immediately. The copy runs on the GPU while the caller continues rendering. Use \ref get to fetch the
+         * image once it is needed.
+         *
+         * \note all methods need to be called in the OpenGL thread.
+         */
+        class PixelReadback
+        {
+        public:
+            /**
+             * Issue the read-back of the color attachment 0 of the currently bound GL_READ_FRAMEBUFFER.
+             *
+             * \param size the size of the area to read, starting at (0,0).
+             */
+            explicit PixelReadback( const glm::ivec2& size );
+
+            /**
+             * Destructor. Frees the buffer, even if the pixels were never fetched.
+             */
+            virtual ~PixelReadback();
+
+            /**
+             * Check whether the pixels arrived in the buffer. Does not block.
+             *
+             * \return true if \ref get will not wait.
+             */
+            bool isReady() const;
+
+            /**
+             * Get the image. Waits for the transfer if needed. The buffer is freed afterwards, so subsequent calls return the same image.
+             *
+             * \return the image
+             */
+            SPtr< RGBA8Image > get();
+
+        protected:
+        private:
+            /**
+             * The size of the image.
+             */
+            glm::ivec2 m_size = glm::ivec2( 0, 0 );
+
+            /**
+             * The pixel buffer object receiving the pixels.
+             */
+            SPtr< Buffer > m_buffer = nullptr;
+
+            /**
+             * Signaled once the copy is done.
+             */
+            GLsync m_fence = nullptr;
+
+            /**
+             * The image, once fetched.
+             */
+            SPtr< RGBA8Image > m_image = nullptr;
+        };
+    }
+}
+
+#endif  // DI_PIXELREADBACK_H
+
@@ -22,9 +22,18 @@
 //
 //---------------------------------------------------------------------------------------
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
 #include <string>
 #include <vector>
 
+#include <unistd.h>
+
+#include <di/core/Filesystem.h>
+#include <di/core/Hash.h>
 #include <di/gfx/Shader.h>
 
 #include "Program.h"
@@ -55,33 +64,11 @@ namespace di
             finalize();
         }
 
-        bool Program::isAttached( SPtr< Shader > shader )
-        {
-            GLsizei count = 0;
-            GLuint shaderIds[32];
-            glGetAttachedShaders( m_object, 32, &count, &shaderIds[0] );
-
-            bool found = false;
-            for( int i = 0; i < count; ++i )
-            {
-                found = found || ( shader->getObjectID() == shaderIds[ i ] );
-            }
-            return found;
-        }
-
-        bool Program::compileAndLink()
+        std::string Program::getPrefixCode() const
         {
-            if( !isRealized() )
-            {
-                return false;
-            }
-
-            m_needCompile = false;
-            m_uniformLocationCache.clear();
-
             // Add all defines to the string:
             std::string prefixCode = "";
-            for( auto define : m_defines )
+            for( const auto& define : m_defines )
             {
                 if( !define.second.first )
                 {
@@ -92,94 +79,238 @@ namespace di
                     prefixCode += "#define " + define.first + "\n";
                 }
             }
+            return prefixCode;
+        }
+
+        std::string Program::getBinaryCacheFilename( const std::string& prefixCode ) const
+        {
+            if( !GLEW_ARB_get_program_binary )
+            {
+                return "";
+            }
 
-            // LogD << "Prefix:" << LogEnd;
-            // LogD << prefixCode << LogEnd;
+            auto cachePath = getCachePath();
+            if( cachePath.empty() || !makeDirectory( cachePath + "shaders" ) )
+            {
+                return "";
+            }
 
-            // Realize all shaders and attach.
-            for( auto shader : m_shaders )
+            // Binaries are only valid for the exact same driver. Include it in the hash.
+            uint64_t hash = HashSeed;
+            std::vector< GLenum > driverStrings = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+            for( auto name : driverStrings )
             {
-                if( isAttached( shader ) )
+                auto value = reinterpret_cast< const char* >( glGetString( name ) );
+                if( value )
                 {
-                    glDetachShader( m_object, shader->getObjectID() );
-                    logGLError();
+                    hash = hashBytes( value, std::strlen( value ), hash );
                 }
+            }
+
+            hash = hashBytes( prefixCode.data(), prefixCode.size(), hash );
+            for( const auto& location : m_fragDataLocations )
+            {
+                hash = hashBytes( location.first.data(), location.first.size(), hash );
+                hash = hashBytes( &location.second, sizeof( location.second ), hash );
+            }
+            for( const auto& shader : m_shaders )
+            {
+                auto type = shader->getShaderType();
+                hash = hashBytes( &type, sizeof( type ), hash );
+                hash = hashBytes( shader->getCode().data(), shader->getCode().size(), hash );
+            }
+
+            std::stringstream ss;
+            ss << cachePath << "shaders/" << std::hex << std::setw( 16 ) << std::setfill( '0' ) << hash << ".bin";
+            return ss.str();
+        }
+
+        bool Program::loadBinary( GLuint program, const std::string& filename ) const
+        {
+            std::ifstream in( filename, std::ios::in | std::ios::binary );
+            if( !in )
+            {
+                return false;
+            }
+
+            uint32_t format = 0;
+            in.read( reinterpret_cast< char* >( &format ), sizeof( format ) );
+            std::vector< char > binary( ( std::istreambuf_iterator< char >( in ) ), std::istreambuf_iterator< char >() );
+            if( binary.empty() )
+            {
+                return false;
+            }
+
+            glProgramBinary( program, format, binary.data(), binary.size() );
+            // The driver rejects binaries it does not understand anymore. This is not an error.
+            glGetError();
+
+            GLint success = GL_FALSE;
+            glGetProgramiv( program, GL_LINK_STATUS, &success );
+            if( success == GL_FALSE )
+            {
+                LogD << "Ignoring outdated program binary \"" << filename << "\"." << LogEnd;
+                return false;
+            }
+            return true;
+        }
+
+        void Program::storeBinary( GLuint program, const std::string& filename ) const
+        {
+            GLint length = 0;
+            glGetProgramiv( program, GL_PROGRAM_BINARY_LENGTH, &length );
+            logGLError();
+            if( length <= 0 )
+            {
+                return;
+            }
+
+            std::vector< char > binary( length );
+            GLenum format = 0;
+            glGetProgramBinary( program, length, &length, &format, binary.data() );
+            logGLError();
+
+            // Write to a temporary file first. Other instances might read or write the cache concurrently.
+            std::string tempFilename = filename + ".tmp" + std::to_string( getpid() );
+            std::ofstream out( tempFilename, std::ios::out | std::ios::binary | std::ios::trunc );
+            uint32_t format32 = format;
+            out.write( reinterpret_cast< const char* >( &format32 ), sizeof( format32 ) );
+            out.write( binary.data(), length );
+            out.close();
+            if( !out || !replaceFile( tempFilename, filename ) )
+            {
+                LogW << "Could not write program binary \"" << filename << "\"." << LogEnd;
+                std::remove( tempFilename.c_str() );
+            }
+        }
 
+        bool Program::link( GLuint program, const std::string& prefixCode )
+        {
+            // Realize all shaders and attach.
+            for( auto shader : m_shaders )
+            {
                 shader->setPrefixCode( prefixCode );
                 if( !shader->realize() )
                 {
                     LogE << "Shader compilation failed." << LogEnd;
-                    m_needCompile = true;
                     return false;
                 }
 
-                glAttachShader( m_object, shader->getObjectID() );
+                glAttachShader( program, shader->getObjectID() );
+                logGLError();
+            }
+
+            if( GLEW_ARB_get_program_binary )
+            {
+                glProgramParameteri( program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+                logGLError();
+            }
+
+            // Output bindings only take effect when linking.
+            for( const auto& location : m_fragDataLocations )
+            {
+                glBindFragDataLocation( program, location.second, location.first.c_str() );
+                logGLError();
             }
-            glLinkProgram( m_object );
+
+            glLinkProgram( program );
             logGLError();
 
+            // The linked program does not need the shaders anymore. Detach to allow re-compiling them for other variants.
+            for( auto shader : m_shaders )
+            {
+                glDetachShader( program, shader->getObjectID() );
+                logGLError();
+            }
+
             GLint success = GL_FALSE;
-            glGetProgramiv( m_object, GL_LINK_STATUS, &success );
+            glGetProgramiv( program, GL_LINK_STATUS, &success );
             if( success == GL_FALSE )
             {
                 GLint maxLength = 0;
-                glGetProgramiv( m_object, GL_INFO_LOG_LENGTH, &maxLength );
+                glGetProgramiv( program, GL_INFO_LOG_LENGTH, &maxLength );
 
                 // The maxLength includes the NULL character
                 std::vector< GLchar > errorLog( maxLength );
-                glGetProgramInfoLog( m_object, maxLength, &maxLength, &errorLog[0] );
+                glGetProgramInfoLog( program, maxLength, &maxLength, &errorLog[0] );
 
                 LogE << "Program linker failed. Log: " << LogEnd
                 LogE << errorLog.data() << LogEnd;
 
-                m_object = 0;
                 return false;
             }
 
             return true;
         }
 
-        bool Program::realize()
+        bool Program::compileAndLink()
         {
-            if( isRealized() )
+            m_needCompile = false;
+            auto prefixCode = getPrefixCode();
+
+            // LogD << "Prefix:" << LogEnd;
+            // LogD << prefixCode << LogEnd;
+
+            // Already built this variant?
+            auto variant = m_variants.find( prefixCode );
+            if( variant != m_variants.end() )
             {
+                m_currentVariant = &variant->second;
+                m_object = m_currentVariant->m_object;
                 return true;
             }
 
-            m_object = glCreateProgram();
+            GLuint program = glCreateProgram();
             logGLError();
 
-            return compileAndLink();
+            auto binaryFilename = getBinaryCacheFilename( prefixCode );
+            bool fromBinary = !binaryFilename.empty() && loadBinary( program, binaryFilename );
+            if( !fromBinary )
+            {
+                if( !link( program, prefixCode ) )
+                {
+                    glDeleteProgram( program );
+                    m_needCompile = true;
+                    return false;
+                }
+
+                if( !binaryFilename.empty() )
+                {
+                    storeBinary( program, binaryFilename );
+                }
+            }
+
+            m_currentVariant = &m_variants[ prefixCode ];
+            m_currentVariant->m_object = program;
+            m_object = program;
+            return true;
         }
 
-        void Program::finalize()
+        bool Program::realize()
         {
             if( isRealized() )
             {
-                // Detach first
-                for( auto shader : m_shaders )
-                {
-                    if( isAttached( shader ) )
-                    {
-                        glDetachShader( m_object, shader->getObjectID() );
-                        logGLError();
-                    }
-                }
-
-                glDeleteProgram( m_object );
-                m_object = 0;
+                return true;
             }
+
+            return compileAndLink();
         }
 
-        void Program::bind()
+        void Program::finalize()
         {
-            if( !realize() )
+            for( const auto& variant : m_variants )
             {
-                LogE << "Bind: un-realized GLObject." << LogEnd;
-                return;
+                glDeleteProgram( variant.second.m_object );
             }
+            m_variants.clear();
+            m_currentVariant = nullptr;
+            m_object = 0;
+            m_needCompile = true;
+        }
 
-            if( m_needCompile )
+        void Program::bind()
+        {
+            if( m_needCompile || !isRealized() )
             {
                 if( !compileAndLink() )
                 {
@@ -216,7 +347,8 @@ namespace di
             GLint loc = -1;
 
             // Check the cache if there is a location stored already
-            if( !m_uniformLocationCache.count( name ) )
+            auto& uniformLocationCache = m_currentVariant->m_uniformLocationCache;
+            if( !uniformLocationCache.count( name ) )
             {
                 // Not yet existing. Add
                 loc = glGetUniformLocation( m_object, name.c_str() );
@@ -229,11 +361,11 @@ namespace di
                 }
 
                 // store.
-                m_uniformLocationCache[ name ] = loc;
+                uniformLocationCache[ name ] = loc;
             }
             else
             {
-                loc = m_uniformLocationCache[ name ];
+                loc = uniformLocationCache[ name ];
             }
 
             return loc;
@@ -245,7 +377,22 @@ namespace di
             if( m_defines.erase( name ) )
             {
                 m_needCompile = true;
-                m_uniformLocationCache.clear();
+            }
+        }
+
+        void Program::bindFragDataLocation( GLuint index, const std::string& name )
+        {
+            auto location = m_fragDataLocations.find( name );
+            if( ( location != m_fragDataLocations.end() ) && ( location->second == index ) )
+            {
+                return;
+            }
+            m_fragDataLocations[ name ] = index;
+
+            // All variants were linked with the old bindings.
+            if( !m_variants.empty() )
+            {
+                finalize();
             }
         }
 
@@ -268,7 +415,6 @@ namespace di
                 m_defines[ name ] = std::make_pair( defineOnly, value );
                 // LogD << "Defined " << name << " as \"" << value << "\" - " << defineOnly << LogEnd;
                 m_needCompile = true;
-                m_uniformLocationCache.clear();
             }
         }
     }
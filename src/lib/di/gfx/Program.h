@@ -30,6 +30,7 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 #include <di/gfx/OpenGL.h>
 #include <di/gfx/GLBindable.h>
@@ -294,6 +295,15 @@ namespace di
              */
             void unsetDefine( const std::string& name );
 
+            /**
+             * Bind a fragment shader output to a color attachment. The binding is applied to every variant when linking. Call this before
+             * \ref realize. Changing a binding later drops all variants linked so far.
+             *
+             * \param index the index of the draw buffer
+             * \param name the name of the fragment shader output
+             */
+            void bindFragDataLocation( GLuint index, const std::string& name );
+
         protected:
 
             /**
@@ -307,22 +317,78 @@ namespace di
             void setDefine( const std::string& name, bool defineOnly, std::string value );
 
             /**
-             * Compile and link the shader. Assumes the program ID was created previously.
+             * Activate the program variant matching the current set of defines. Variants are linked once and kept until \ref finalize, so
+             * switching between previously used define sets only requires a lookup.
              *
              * \return true if program was build properly.
              */
             virtual bool compileAndLink();
 
             /**
-             * The shader is attached to this program?
+             * Compile the shaders using the given prefix code and link them into the given program object. The shaders are detached after
+             * linking, so they can be re-compiled for other variants.
+             *
+             * \param program the program object to link
+             * \param prefixCode the code to inject into each shader
              *
-             * \param shader the shader to check
+             * \return true if successful.
+             */
+            bool link( GLuint program, const std::string& prefixCode );
+
+            /**
+             * Build the code to inject into each shader from the current defines. As the defines are sorted by name, equal define sets always
+             * produce the same code. This is used as key of the variant cache.
              *
-             * \return true if attached
+             * \return the prefix code
              */
-            bool isAttached( SPtr< Shader > shader );
+            std::string getPrefixCode() const;
+
+            /**
+             * Get the name of the file used to cache the binary of the variant with the given prefix code. The name depends on the shader code
+             * and the OpenGL implementation.
+             *
+             * \param prefixCode the code injected into each shader
+             *
+             * \return the filename. Empty if no binary cache is available.
+             */
+            std::string getBinaryCacheFilename( const std::string& prefixCode ) const;
+
+            /**
+             * Load a previously stored program binary into the given program object.
+             *
+             * \param program the program object
+             * \param filename the cache file
+             *
+             * \return true if the binary was accepted by the driver.
+             */
+            bool loadBinary( GLuint program, const std::string& filename ) const;
+
+            /**
+             * Store the binary of the given, successfully linked program object.
+             *
+             * \param program the program object
+             * \param filename the cache file
+             */
+            void storeBinary( GLuint program, const std::string& filename ) const;
 
         private:
+            /**
+             * A linked program object for one specific set of defines.
+             */
+            class Variant
+            {
+            public:
+                /**
+                 * The linked program object.
+                 */
+                GLuint m_object = 0;
+
+                /**
+                 * Keep track of queried uniform locations to avoid this every frame.
+                 */
+                std::map< std::string, GLint > m_uniformLocationCache;
+            };
+
             /**
              * The shaders to attach.
              */
@@ -334,9 +400,19 @@ namespace di
             bool m_needCompile = true;
 
             /**
-             * Keep track of queried uniform locations to avoid this every frame.
+             * The draw buffer index of each fragment shader output. Applied before each link.
+             */
+            std::map< std::string, GLuint > m_fragDataLocations;
+
+            /**
+             * All variants built so far, keyed by their prefix code.
+             */
+            std::unordered_map< std::string, Variant > m_variants;
+
+            /**
+             * The variant currently in use. Its program object is the one in m_object.
              */
-            mutable std::map< std::string, GLint > m_uniformLocationCache;
+            Variant* m_currentVariant = nullptr;
 
             /**
              * Collect all definitions that need to be applied when compiling. Similar to the -D flag of compilers.
@@ -0,0 +1,138 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <vector>
+
+#include <di/gfx/GLError.h>
+
+#include "RenderTargetPool.h"
+
+#include <di/core/Logger.h>
+#define LogTag "gfx/RenderTargetPool"
+
+namespace di
+{
+    namespace core
+    {
+        RenderTargetPool& RenderTargetPool::getInstance()
+        {
+            static RenderTargetPool pool;
+            return pool;
+        }
+
+        RenderTargetPool::~RenderTargetPool()
+        {
+            // The textures are finalized by their destructor. Call clear() while the context is current to free them properly.
+        }
+
+        SPtr< Texture > RenderTargetPool::acquire( const glm::ivec2& size, GLint internalFormat, GLint format, GLenum type )
+        {
+            auto entry = std::find_if( m_entries.begin(), m_entries.end(),
+                [ & ]( const Entry& e )
+                {
+                    return !e.m_inUse && ( e.m_size == size ) && ( e.m_internalFormat == internalFormat ) &&
+                           ( e.m_format == format ) && ( e.m_type == type );
+                }
+            );
+
+            if( entry == m_entries.end() )
+            {
+                LogD << "Creating render target " << size.x << "x" << size.y << ", format " << internalFormat << "." << LogEnd;
+
+                Entry created;
+                created.m_texture = std::make_shared< Texture >( Texture::TextureType::Tex2D );
+                created.m_size = size;
+                created.m_internalFormat = internalFormat;
+                created.m_format = format;
+                created.m_type = type;
+
+                created.m_texture->realize();
+                created.m_texture->bind();
+                // NOTE: to use an FBO, the texture needs to be initalized empty.
+                created.m_texture->data( nullptr, size.x, size.y, 1, internalFormat, format, type );
+                logGLError();
+
+                m_entries.push_back( created );
+                entry = m_entries.end() - 1;
+            }
+            else
+            {
+                // Reset the filter. Previous users might have changed it.
+                entry->m_texture->bind();
+                entry->m_texture->setTextureFilter();
+            }
+
+            entry->m_inUse = true;
+
+            // Hand out an alias of the texture. Once all copies are gone, the texture returns to the pool.
+            auto texture = entry->m_texture;
+            return SPtr< Texture >( texture.get(),
+                [ this, texture ]( Texture* )
+                {
+                    release( texture.get() );
+                }
+            );
+        }
+
+        void RenderTargetPool::release( const Texture* texture )
+        {
+            for( auto& entry : m_entries )
+            {
+                if( entry.m_texture.get() == texture )
+                {
+                    entry.m_inUse = false;
+                    entry.m_lastUse = m_frame;
+                    return;
+                }
+            }
+        }
+
+        void RenderTargetPool::collect( size_t maxIdleFrames )
+        {
+            m_frame++;
+            m_entries.erase( std::remove_if( m_entries.begin(), m_entries.end(),
+                [ this, maxIdleFrames ]( const Entry& e )
+                {
+                    return !e.m_inUse && ( m_frame - e.m_lastUse > maxIdleFrames );
+                }
+            ), m_entries.end() );
+        }
+
+        void RenderTargetPool::clear()
+        {
+            m_entries.erase( std::remove_if( m_entries.begin(), m_entries.end(),
+                []( const Entry& e )
+                {
+                    return !e.m_inUse;
+                }
+            ), m_entries.end() );
+        }
+
+        size_t RenderTargetPool::getSize() const
+        {
+            return m_entries.size();
+        }
+    }
+}
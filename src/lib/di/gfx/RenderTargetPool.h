@@ -0,0 +1,164 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_RENDERTARGETPOOL_H
+#define DI_RENDERTARGETPOOL_H
+
+#include <vector>
+
+#include <di/gfx/OpenGL.h>
+#include <di/gfx/Texture.h>
+
+#include <di/Types.h>
+#include <di/GfxTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A pool of render target textures, shared by all visualizations and views. Visualizations borrow the textures they render into during
+         * \ref Visualization::render and return them afterwards by releasing the returned pointer. Textures of the same size and format are
+         * re-used, even across visualizations, instead of each visualization keeping its own set.
+         *
+         * \note the pool must only be used in the OpenGL thread.
+         */
+        class RenderTargetPool
+        {
+        public:
+            /**
+             * The pool used by the application.
+             *
+             * \return the pool.
+             */
+            static RenderTargetPool& getInstance();
+
+            /**
+             * Destructor.
+             */
+            virtual ~RenderTargetPool();
+
+            /**
+             * Borrow a 2D texture of the given size and format. The texture returns to the pool once the returned pointer and all its copies are
+             * released. Its contents are undefined. The texture filter is reset to linear, other texture parameters might have been changed by
+             * previous users.
+             *
+             * \param size the size in pixels
+             * \param internalFormat the internal format, like GL_RGBA16F
+             * \param format the pixel format, like GL_RGBA
+             * \param type the pixel data type, like GL_FLOAT
+             *
+             * \return the texture. It is realized and bound.
+             */
+            SPtr< Texture > acquire( const glm::ivec2& size, GLint internalFormat, GLint format, GLenum type );
+
+            /**
+             * Free all textures that have not been borrowed for the given number of frames. Call this once per frame.
+             *
+             * \param maxIdleFrames the number of frames an unused texture is kept.
+             */
+            void collect( size_t maxIdleFrames = 2 );
+
+            /**
+             * Free all textures not currently borrowed.
+             */
+            void clear();
+
+            /**
+             * The number of textures currently owned by the pool.
+             *
+             * \return the number of textures, including the borrowed ones.
+             */
+            size_t getSize() const;
+
+        protected:
+            /**
+             * Constructor. Use \ref getInstance.
+             */
+            RenderTargetPool() = default;
+
+        private:
+            /**
+             * A texture and its format.
+             */
+            class Entry
+            {
+            public:
+                /**
+                 * The texture.
+                 */
+                SPtr< Texture > m_texture = nullptr;
+
+                /**
+                 * Size of the texture.
+                 */
+                glm::ivec2 m_size = glm::ivec2( 0, 0 );
+
+                /**
+                 * Internal format of the texture.
+                 */
+                GLint m_internalFormat = 0;
+
+                /**
+                 * Pixel format of the texture.
+                 */
+                GLint m_format = 0;
+
+                /**
+                 * Pixel data type of the texture.
+                 */
+                GLenum m_type = 0;
+
+                /**
+                 * True while borrowed.
+                 */
+                bool m_inUse = false;
+
+                /**
+                 * The frame in which the texture was returned the last time.
+                 */
+                size_t m_lastUse = 0;
+            };
+
+            /**
+             * Return the texture to the pool.
+             *
+             * \param texture the texture
+             */
+            void release( const Texture* texture );
+
+            /**
+             * All textures.
+             */
+            std::vector< Entry > m_entries;
+
+            /**
+             * Number of \ref collect calls so far.
+             */
+            size_t m_frame = 0;
+        };
+    }
+}
+
+#endif  // DI_RENDERTARGETPOOL_H
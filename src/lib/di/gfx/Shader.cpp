@@ -62,6 +62,16 @@ namespace di
             }
         }
 
+        Shader::ShaderType Shader::getShaderType() const
+        {
+            return m_shaderType;
+        }
+
+        const std::string& Shader::getCode() const
+        {
+            return m_code;
+        }
+
         bool Shader::compile()
         {
             if( !isRealized() )
@@ -64,6 +64,31 @@ namespace di
             m_hqMode = hq;
         }
 
+        bool View::isInteracting() const
+        {
+            return false;
+        }
+
+        glm::vec2 View::getImageSize() const
+        {
+            if( ( m_imageSize.x <= 0.0f ) || ( m_imageSize.y <= 0.0f ) )
+            {
+                return getViewportSize();
+            }
+            return m_imageSize;
+        }
+
+        glm::vec2 View::getImageOffset() const
+        {
+            return m_imageOffset;
+        }
+
+        void View::setImageRegion( const glm::vec2& imageSize, const glm::vec2& offset )
+        {
+            m_imageSize = imageSize;
+            m_imageOffset = offset;
+        }
+
         void View::pushEvent( SPtr< ViewEvent > event )
         {
             std::unique_lock< std::mutex > lock( m_eventListenerMutex );
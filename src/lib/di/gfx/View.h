@@ -103,6 +103,38 @@ namespace di
              */
             void setHQMode( bool hq = true );
 
+            /**
+             * True while the user moves the camera. Visualizations can reduce their quality to stay responsive, for example by rendering a
+             * coarse mesh. The view renders again in full quality once the interaction ends.
+             *
+             * \return true if interacting. The default implementation always returns false.
+             */
+            virtual bool isInteracting() const;
+
+            /**
+             * Get the size of the whole image this view renders. If the view renders only a tile of a larger image, this is the size of the
+             * larger image. Screen-space effects use this to stay consistent across tiles.
+             *
+             * \return the image size in pixels. Equals the viewport size if this view is not a tile.
+             */
+            glm::vec2 getImageSize() const;
+
+            /**
+             * Get the position of the viewport origin inside the whole image. See \ref getImageSize.
+             *
+             * \return the offset in pixels. Zero if this view is not a tile.
+             */
+            glm::vec2 getImageOffset() const;
+
+            /**
+             * Define this view to be a tile of a larger image. The camera of the view needs to be set accordingly. See
+             * \ref Camera::buildTileProjectionMatrix.
+             *
+             * \param imageSize the size of the whole image
+             * \param offset the position of the viewport origin in the whole image. Might be negative.
+             */
+            void setImageRegion( const glm::vec2& imageSize, const glm::vec2& offset );
+
             /**
              * Get the state object representing this object at the moment of the call.
              *
@@ -165,6 +197,16 @@ namespace di
              */
             bool m_hqMode = false;
 
+            /**
+             * The size of the whole image. Zero if this view is not a tile.
+             */
+            glm::vec2 m_imageSize = glm::vec2( 0.0f, 0.0f );
+
+            /**
+             * Offset of the viewport in the whole image.
+             */
+            glm::vec2 m_imageOffset = glm::vec2( 0.0f, 0.0f );
+
             /**
              * The actual list of event listeners.
              */
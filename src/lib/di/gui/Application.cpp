@@ -27,6 +27,7 @@
 #include <string>
 
 #include <QApplication>
+#include <QCoreApplication>
 #include <QWidget>
 #include <QLocale>
 #include <QSurfaceFormat>
@@ -88,6 +89,22 @@ namespace di
                 return -1;
             }
 
+            if( m_headless )
+            {
+                // A QCoreApplication does not need any windowing system. We only use it to find our resources.
+                QCoreApplication application( m_argc, m_argv );
+                setlocale( LC_ALL, "C" );
+                di::core::initRuntimePath( QCoreApplication::applicationDirPath().toStdString() );
+
+                m_processingNetwork = SPtr< core::ProcessingNetwork >( new core::ProcessingNetwork() );
+                m_processingNetwork->start();
+
+                int retVal = runHeadless();
+
+                m_processingNetwork->stop();
+                return retVal;
+            }
+
             // NOTE: this is an important call to ensure 3.3 Core OpenGL on OSX. It has to be called before QApplication.
             QSurfaceFormat format33Core;
             //format33Core.setSamples( 32 );
@@ -148,6 +165,22 @@ namespace di
             return retVal;
         }
 
+        void Application::setHeadless( bool headless )
+        {
+            m_headless = headless;
+        }
+
+        bool Application::isHeadless() const
+        {
+            return m_headless;
+        }
+
+        int Application::runHeadless()
+        {
+            LogE << "Headless mode is not supported by this application." << LogEnd;
+            return -1;
+        }
+
         void Application::onShutdown()
         {
             close();
@@ -191,6 +191,29 @@ namespace di
              */
             virtual bool handleCommandLine( const std::vector< std::string >& arguments, int argc, char** argv );
 
+            /**
+             * Request headless mode. Call this in \ref handleCommandLine. In headless mode, no UI and no windowing system is used. Instead of
+             * \ref prepareUI, \ref prepareNetwork and the event loop, \ref runHeadless gets called once the processing network is running.
+             *
+             * \param headless true to enable
+             */
+            void setHeadless( bool headless = true );
+
+            /**
+             * Check whether headless mode was requested.
+             *
+             * \return true if headless.
+             */
+            bool isHeadless() const;
+
+            /**
+             * Implement the headless mode here. Build the network, load the data and render. There is no QApplication and no main window. Do
+             * not use the UI related methods and settings. The default implementation reports that headless mode is not supported.
+             *
+             * \return the return code of the application.
+             */
+            virtual int runHeadless();
+
         private:
             /**
              * The application main window.
@@ -226,6 +249,11 @@ namespace di
              * The processing container managed by this application instance.
              */
             SPtr< core::ProcessingNetwork > m_processingNetwork = nullptr;
+
+            /**
+             * True if the application runs without UI.
+             */
+            bool m_headless = false;
         };
     }
 }
@@ -112,7 +112,8 @@ namespace di
         {
             QString lastPath =
                 Application::getSettings()->value( "LastProjectFilePath", Application::getSettings()->value( "LastFilePath", "" ) ).toString();
-            QString selected = QFileDialog::getOpenFileName( this, "Load File", lastPath, QString( "Project File (*.project)" ) );
+            QString selected = QFileDialog::getOpenFileName( this, "Load File", lastPath,
+                                                             QString( "Project File (*.project *.bproject)" ) );
             if( selected == "" )
             {
                 return;
@@ -147,7 +148,8 @@ namespace di
         {
             QString lastPath =
                 Application::getSettings()->value( "LastProjectFilePath", Application::getSettings()->value( "LastFilePath", "" ) ).toString();
-            QString selected = QFileDialog::getSaveFileName( this, "Save File", lastPath, QString( "Project File (*.project)" ) );
+            QString selected = QFileDialog::getSaveFileName( this, "Save File", lastPath,
+                                                             QString( "Project File (*.project);;Binary Project File (*.bproject)" ) );
             if( selected == "" )
             {
                 return;
@@ -155,7 +157,7 @@ namespace di
 
             // Store the last path
             QFileInfo fi( selected );
-            if( fi.suffix() != "project" )
+            if( ( fi.suffix() != "project" ) && ( fi.suffix() != "bproject" ) )
             {
                 selected += ".project";
             }
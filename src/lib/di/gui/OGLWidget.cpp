@@ -30,10 +30,18 @@
 #include <QMouseEvent>
 
 #include <di/core/Filesystem.h>
+#include <di/core/ObserverCallback.h>
 #include <di/core/BoundingBox.h>
 #include <di/core/State.h>
+#include <di/core/Visualization.h>
 #include <di/gfx/GL.h>
+#include <di/gfx/GPUProfiler.h>
+#include <di/gfx/GPUTimer.h>
+#include <di/gfx/ImageTiler.h>
+#include <di/gfx/NoiseTextureCache.h>
 #include <di/gfx/OffscreenView.h>
+#include <di/gfx/PixelReadback.h>
+#include <di/gfx/RenderTargetPool.h>
 #include <di/MathTypes.h>
 #include <di/GfxTypes.h>
 #include <di/gfx/ViewEvent.h>
@@ -57,13 +65,36 @@ namespace di
             setAutoBufferSwap( true );
             setFocusPolicy( Qt::StrongFocus );
 
-            m_redrawTimer = new QTimer();
-            m_redrawTimer->setInterval( 33 );
-            QObject::connect( m_redrawTimer, SIGNAL( timeout() ), this, SLOT( update() ), Qt::QueuedConnection );
+            // Redraw on demand only. The timer delays redraws to pace the frames.
+            m_frameTimer = new QTimer( this );
+            m_frameTimer->setSingleShot( true );
+            QObject::connect( m_frameTimer, SIGNAL( timeout() ), this, SLOT( update() ) );
+
+            // Render the full quality frame when zooming stopped.
+            m_interactionTimer = new QTimer( this );
+            m_interactionTimer->setSingleShot( true );
+            m_interactionTimer->setInterval( 250 );
+            QObject::connect( m_interactionTimer, SIGNAL( timeout() ), this, SLOT( scheduleRedraw() ) );
+
+            // Visualizations request rendering from arbitrary threads. Forward to the UI thread.
+            m_renderRequestObserver = std::make_shared< core::ObserverCallback >(
+                [ this ]()
+                {
+                    QMetaObject::invokeMethod( this, "scheduleRedraw", Qt::QueuedConnection );
+                }
+            );
+            core::Visualization::observeRenderRequests( m_renderRequestObserver );
+
+            m_profilerOverlay = new QLabel( this );
+            m_profilerOverlay->setStyleSheet( "QLabel { background-color: rgba( 0, 0, 0, 160 ); color: white; padding: 4px; }" );
+            m_profilerOverlay->setAttribute( Qt::WA_TransparentForMouseEvents );
+            m_profilerOverlay->move( 8, 8 );
+            m_profilerOverlay->hide();
         }
 
         OGLWidget::~OGLWidget()
         {
+            core::Visualization::removeRenderRequestObserver( m_renderRequestObserver );
         }
 
         QGLFormat OGLWidget::getDefaultFormat()
@@ -157,17 +188,13 @@ namespace di
                 GLint maxSamples = 0;
                 glGetIntegerv( GL_MAX_SAMPLES, &maxSamples );
                 m_screenShotWidget->setMaxSamples( maxSamples );
-
-                GLint maxSize = 0;
-                glGetIntegerv(  GL_MAX_TEXTURE_SIZE, &maxSize );
-                m_screenShotWidget->setMaxResolution( maxSize );
             }
             else
             {
                 LogW << "No ScreenShotWidget defined during initializeGL." << LogEnd;
             }
 
-            m_redrawTimer->start();
+            scheduleRedraw();
         }
 
         void OGLWidget::resizeGL( int w, int h )
@@ -175,6 +202,22 @@ namespace di
             // Use a basic viewport setup. Equal to window size.
             // NOTE: avoid issues with zero-sized widgets. This sometimes happen during creation.
             glViewport( 0, 0, std::max( 1, w ), std::max( 1, h ) );
+
+            // Qt repaints after resize. This needs a real frame.
+            m_redrawRequested = true;
+        }
+
+        void OGLWidget::scheduleRedraw()
+        {
+            m_redrawRequested = true;
+            if( m_frameTimer->isActive() )
+            {
+                return;
+            }
+
+            // Wait until the frame interval passed since the last frame.
+            auto elapsed = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - m_lastFrameTime );
+            m_frameTimer->start( static_cast< int >( std::max( std::chrono::milliseconds( 0 ), m_frameInterval - elapsed ).count() ) );
         }
 
         void OGLWidget::renderToView( core::View* view )
@@ -266,18 +309,27 @@ namespace di
 
         void OGLWidget::paintGL()
         {
-            auto now = std::chrono::system_clock::now();
-            auto duration = std::chrono::duration_cast< std::chrono::milliseconds >( now - m_fpsLastTime );
-            auto durationLastShow = std::chrono::duration_cast< std::chrono::milliseconds >( now - m_fpsLastShowTime );
-            m_fpsLastTime = now;
-
-            float fps = 1000.0 / static_cast< float >( duration.count() );
-
-            if( durationLastShow.count() >= 2000 )
+            // Nothing changed? Qt might still ask for a repaint, for example if the window was hidden. Re-use the last frame.
+            bool visRequest = false;
+            Application::getProcessingNetwork()->visitVisualizations(
+                [ &visRequest ]( SPtr< di::core::Visualization > vis )
+                {
+                    visRequest = visRequest || ( vis->isRenderingActive() && vis->isRenderingRequested() );
+                }
+            );
+            if( !m_redrawRequested && !visRequest && !m_screenShotRequest && !m_forceReload && m_frameCacheValid )
             {
-                m_fpsLastShowTime = now;
-                LogI << "FPS " << fps << LogEnd;
+                restoreFrameCache();
+                return;
             }
+            m_redrawRequested = false;
+
+            auto frameStart = std::chrono::steady_clock::now();
+            m_lastFrameTime = frameStart;
+
+            auto& profiler = core::GPUProfiler::getInstance();
+            profiler.beginFrame();
+            core::GPUTimer frameTimer( "Frame" );
 
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Get scene BB
@@ -307,11 +359,6 @@ namespace di
             // Define render target
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-            // A list of views to render to. Used for screenshots.
-            std::vector< SPtr< core::OffscreenView > > targetViews;
-            // Also keep a list of name hints for each view. Used for saving them to files.
-            std::map< SPtr< core::OffscreenView >, std::string > targetViewNameHints;
-
             // Screenshot?
             if( m_screenShotRequest && !m_screenShotWidget  )
             {
@@ -321,7 +368,7 @@ namespace di
 
             if( m_screenShotRequest )
             {
-                LogD << "Screenshot requested. Creating offscreen view." << LogEnd;
+                LogD << "Screenshot requested. Creating offscreen views." << LogEnd;
 
                 // A list of view matrices:
                 std::vector< std::tuple< glm::mat4, bool, std::string > > matrices;
@@ -333,19 +380,19 @@ namespace di
                 // Also add the user cam. NOTE: the bool is false, as the cam contains a whole view matrix already.
                 matrices.push_back( std::make_tuple( m_camera.getViewMatrix(), false, "User Camera" ) );
 
-                // Create views for each listed matrix
+                // Large images are split into tiles. Each tile needs to fit into a texture.
+                GLint maxSize = 0;
+                glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxSize );
+                glm::ivec2 resolution( m_screenShotWidget->getWidth(), m_screenShotWidget->getHeight() );
+
+                // Render each listed matrix
                 for( auto matrix : matrices )
                 {
-                    // Create the off-screen view
-                    auto screenshotView = std::make_shared< core::OffscreenView >(
-                        glm::vec2( m_screenShotWidget->getWidth(), m_screenShotWidget->getHeight() ), m_screenShotWidget->getSamples() );
-
-                    // Force high quality
-                    screenshotView->setHQMode( true );
+                    core::ImageTiler tiler( resolution, std::min( 2048, static_cast< int >( maxSize ) ) );
 
-                    // The screenshot view might have a different aspect:
+                    // The screenshot might have a different aspect:
                     core::Camera offCam( m_camera );
-                    offCam.setProjectionMatrix( buildProjectionMatrix( near, far, screenshotView->getAspectRatio() ) );
+                    offCam.setProjectionMatrix( buildProjectionMatrix( near, far, static_cast< float >( resolution.x ) / resolution.y ) );
 
                     // Get the desired view.
                     auto viewMatrix = std::get< 0 >( matrix );
@@ -355,98 +402,128 @@ namespace di
                         viewMatrix = buildViewMatrix( sceneBB, viewMatrix, 2.0, glm::vec2( 0.0 ) );
                     }
                     offCam.setViewMatrix( viewMatrix );
-                    screenshotView->setCamera( offCam );
-
-                    // Init the FBO
-                    screenshotView->prepare();
-
-                    // Done. Add to list
-                    targetViews.push_back( screenshotView );
-                    targetViewNameHints[ screenshotView ] = std::get< 2 >( matrix );
-                }
 
-
-                /* Some tiling demo code. Not perfect for our image space arrows.
-                double finalWidth = 4096.0;
-                double finalHeight = 3072.0;
-                double tileWidth = 1024.0;
-                double tileHeight = 1024.0;
-
-                // How much tiles to render?
-                auto numTilesX = static_cast< uint16_t >( std::ceil( finalWidth / tileWidth ) );
-                auto numTilesY = static_cast< uint16_t >( std::ceil( finalHeight / tileHeight ) );
-
-                LogD << "Splitting into " << numTilesX << "x" << numTilesY << " tiles." << LogEnd;
-
-                // create a lot of cameras, one for each tile
-                for( uint8_t tileY = 0; tileY < numTilesY; ++tileY )
-                {
-                    for( uint8_t tileX = 0; tileX < numTilesX; ++tileX )
+                    // Render tile by tile. Only one tile occupies GPU memory at a time. The read-back of a tile is fetched after the next tile
+                    // was issued, so the GPU renders while the CPU copies.
+                    SPtr< core::PixelReadback > pending = nullptr;
+                    size_t pendingTile = 0;
+                    for( size_t tile = 0; tile < tiler.getNumTiles(); ++tile )
                     {
-                        // The size of the tile
-                        auto tileAspect = tileWidth / tileHeight;
-
-                        auto tx = static_cast< double >( tileX ) / static_cast< double >( numTilesX );
-                        auto ty = static_cast< double >( tileY ) / static_cast< double >( numTilesY );
-                        auto sx = 1.0 / static_cast< double >( numTilesX );
-                        auto sy = 1.0 / static_cast< double >( numTilesY );
-
-                        // Create projection and move it a bit to match the tile's viewport
-                        auto moveMatrix = glm::translate( glm::dvec3( tx, ty, 0.0 ) );
-                        auto scaleMatrix = glm::scale( glm::dvec3( sx, sy, 1.0 ) );
-                        auto projMatrix = glm::ortho( -0.5 + tx, -0.5 + tx + sx , -0.5 + ty, -0.5 + ty + sy, near, far );
-
-                        // Create the off-screen view
-                        auto screenshotView = std::make_shared< core::OffscreenView >( glm::vec2( tileWidth, tileHeight ), 1 );
+                        auto screenshotView = tiler.createView( tile, offCam, m_screenShotWidget->getSamples() );
 
                         // Force high quality
                         screenshotView->setHQMode( true );
 
-                        // The screenshot view might have a different aspect:
-                        core::Camera offCam( m_camera );
-                        //offCam.setProjectionMatrix( projMatrix );
-                        screenshotView->setCamera( offCam );
-
                         // Init the FBO
                         screenshotView->prepare();
+                        renderToView( screenshotView.get() );
+                        auto readback = screenshotView->readAsync();
 
-                        // Done. Add to list
-                        targetViews.push_back( screenshotView );
+                        // cleanup the FBO. The read-back owns its own buffer.
+                        screenshotView->finalize();
+
+                        if( pending )
+                        {
+                            tiler.insert( pendingTile, *pending->get() );
+                        }
+                        pending = readback;
+                        pendingTile = tile;
                     }
-                }*/
+                    tiler.insert( pendingTile, *pending->get() );
 
+                    // get image and report back
+                    emit screenshotDone( tiler.getImage(), std::get< 2 >( matrix ), m_screenShotPathOverride );
+                }
+
+                // thats it.
+                emit allScreenshotsDone();
+                m_screenShotRequest = false;
 
+                // The screen itself did not change. Show the last frame again.
+                if( m_frameCacheValid )
+                {
+                    restoreFrameCache();
+                }
+                else
+                {
+                    scheduleRedraw();
+                }
             }
+            else
+            {
+                renderToView( this );
+                storeFrameCache();
+            }
+            // Free render targets no longer in use, like those of the screenshot views.
+            core::RenderTargetPool::getInstance().collect();
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Render to render target(s)
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            frameTimer.stop();
+            profiler.endFrame();
 
-            if( !targetViews.empty() )
+            // The results arrive some frames later. Keep measuring while the overlay is shown.
+            if( m_profilerOverlay->isVisible() )
             {
-                for( auto view : targetViews )
-                {
-                    renderToView( view.get() );
+                m_profilerOverlay->setText( QString::fromStdString( profiler.getReport() ) );
+                m_profilerOverlay->adjustSize();
+                scheduleRedraw();
+            }
 
-                    // if this is part of a screenshot -> submit
-                    if( m_screenShotRequest )
-                    {
-                        // get image and report back
-                        emit screenshotDone( view->read(), targetViewNameHints[ view ], m_screenShotPathOverride );
-                    }
+            // Adapt the frame pacing to the rendering time. This keeps the event loop responsive while interacting with heavy scenes.
+            auto frameEnd = std::chrono::steady_clock::now();
+            auto frameTime = std::chrono::duration_cast< std::chrono::milliseconds >( frameEnd - frameStart );
+            m_frameInterval = std::min( std::chrono::milliseconds( 100 ), std::max( std::chrono::milliseconds( 16 ), frameTime ) );
 
-                    // cleanup the FBO
-                    view->finalize();
+            if( std::chrono::duration_cast< std::chrono::milliseconds >( frameEnd - m_fpsLastShowTime ).count() >= 2000 )
+            {
+                m_fpsLastShowTime = frameEnd;
+                LogI << "Frame time " << frameTime.count() << "ms" << LogEnd;
+                if( profiler.isEnabled() )
+                {
+                    LogI << "GPU timings:" << std::endl << profiler.getReport() << LogEnd;
                 }
+            }
+        }
 
-                // thats it.
-                emit allScreenshotsDone();
-                m_screenShotRequest = false;
+        void OGLWidget::storeFrameCache()
+        {
+            glm::ivec2 size( std::max( 1, width() ), std::max( 1, height() ) );
+            if( !m_frameCacheFBO )
+            {
+                glGenFramebuffers( 1, &m_frameCacheFBO );
+                glGenRenderbuffers( 1, &m_frameCacheRenderbuffer );
             }
-            else
+
+            if( size != m_frameCacheSize )
             {
-                renderToView( this );
+                m_frameCacheSize = size;
+                glBindRenderbuffer( GL_RENDERBUFFER, m_frameCacheRenderbuffer );
+                glRenderbufferStorage( GL_RENDERBUFFER, GL_RGBA8, size.x, size.y );
+                glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+
+                glBindFramebuffer( GL_FRAMEBUFFER, m_frameCacheFBO );
+                glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_frameCacheRenderbuffer );
+                glBindFramebuffer( GL_FRAMEBUFFER, 0 );
             }
+
+            glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 );
+            glReadBuffer( GL_BACK );
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_frameCacheFBO );
+            glBlitFramebuffer( 0, 0, size.x, size.y, 0, 0, size.x, size.y, GL_COLOR_BUFFER_BIT, GL_NEAREST );
+            glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 );
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 );
+            m_frameCacheValid = true;
+            logGLError();
+        }
+
+        void OGLWidget::restoreFrameCache()
+        {
+            glBindFramebuffer( GL_READ_FRAMEBUFFER, m_frameCacheFBO );
+            glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 );
+            glDrawBuffer( GL_BACK );
+            glBlitFramebuffer( 0, 0, m_frameCacheSize.x, m_frameCacheSize.y, 0, 0, m_frameCacheSize.x, m_frameCacheSize.y,
+                               GL_COLOR_BUFFER_BIT, GL_NEAREST );
+            glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 );
+            logGLError();
         }
 
         void OGLWidget::bind() const
@@ -459,7 +536,8 @@ namespace di
 
         void OGLWidget::closeEvent( QCloseEvent* event )
         {
-            m_redrawTimer->stop();
+            m_frameTimer->stop();
+            core::Visualization::removeRenderRequestObserver( m_renderRequestObserver );
 
             // Allow all visualizations to finalize:
             Application::getProcessingNetwork()->visitVisualizations(
@@ -470,7 +548,13 @@ namespace di
             );
 
             // Clean up properly
+            core::RenderTargetPool::getInstance().clear();
+            core::NoiseTextureCache::getInstance().clear();
+            core::GPUProfiler::getInstance().clear();
             glDeleteBuffers( 1, &m_backgroundVBO );
+            glDeleteFramebuffers( 1, &m_frameCacheFBO );
+            glDeleteRenderbuffers( 1, &m_frameCacheRenderbuffer );
+            m_frameCacheValid = false;
             // glDeleteVertexArrays( 1, &m_backgroundVAO );
             // glDeleteProgram( m_backgroundShaderProgram );
 
@@ -494,6 +578,8 @@ namespace di
 
         void OGLWidget::mouseReleaseEvent( QMouseEvent* event )
         {
+            // The last frame was rendered while interacting. Render again in full quality.
+            bool interacting = isInteracting();
             if( event->button() == Qt::RightButton )
             {
                 m_dragState = 0;
@@ -502,6 +588,10 @@ namespace di
             {
                 m_arcballState = 0;
             }
+            if( interacting && !isInteracting() )
+            {
+                scheduleRedraw();
+            }
             event->accept();
         }
 
@@ -548,6 +638,7 @@ namespace di
                 m_dragOffset = glm::vec2( diff.x, diff.y ) + m_dragPrevOffset;
             }
 
+            scheduleRedraw();
             event->accept();
         }
 
@@ -565,6 +656,8 @@ namespace di
 
             // avoid values below 0.
             m_zoom = m_zoom < stepSize ? stepSize : m_zoom;
+            m_interactionTimer->start();
+            scheduleRedraw();
             event->accept();
         }
 
@@ -579,8 +672,14 @@ namespace di
                 case Qt::Key_F12:
                     m_screenShotRequest = true;
                     break;
+                case Qt::Key_F3:
+                    // toggle the GPU timing overlay
+                    m_profilerOverlay->setVisible( !m_profilerOverlay->isVisible() );
+                    core::GPUProfiler::getInstance().setEnabled( m_profilerOverlay->isVisible() );
+                    break;
             }
 
+            scheduleRedraw();
             event->accept();
         }
 
@@ -588,6 +687,7 @@ namespace di
         {
             m_arcballMatrix = m_viewPreset;
             m_dragOffset = glm::vec2();
+            scheduleRedraw();
         }
 
         glm::vec3 OGLWidget::toScreenCoord( double x, double y )
@@ -627,6 +727,11 @@ namespace di
             return glm::vec2( width(), height() );
         }
 
+        bool OGLWidget::isInteracting() const
+        {
+            return ( m_arcballState == 2 ) || ( m_dragState == 2 ) || m_interactionTimer->isActive();
+        }
+
         const core::Camera& OGLWidget::getCamera() const
         {
             return m_camera;
@@ -645,6 +750,7 @@ namespace di
                 LogD << "Requesting screenshot. Path: \"" << path << "\"" << LogEnd;
                 m_screenShotPathOverride = path;
             }
+            scheduleRedraw();
         }
 
         void OGLWidget::setResponsibleScreenShotWidget( ScreenShotWidget* screenShotWidget )
@@ -669,6 +775,7 @@ namespace di
             auto viewInfo = m_defaultViews[ std::min( id, m_defaultViews.size() - 1 ) ];
             LogD << "Setting view to \"" << std::get< 2 >( viewInfo ) << "\"." << LogEnd;
             m_arcballMatrix = std::get< 0 >( viewInfo );
+            scheduleRedraw();
         }
 
         void OGLWidget::setDefaultViews( const std::vector< std::tuple< glm::mat4, bool, std::string > >& defaultViews )
@@ -676,36 +783,36 @@ namespace di
             m_defaultViews = defaultViews;
         }
 
-        glm::mat4 OGLWidget::getOrientationMatrixAlongPosX() const
+        glm::mat4 OGLWidget::getOrientationMatrixAlongPosX()
         {
             return glm::rotate( glm::radians( 90.0f ), glm::vec3( 0.0f, 0.0f, 1.0f ) ) *
                    glm::rotate( glm::radians( 90.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
         }
 
-        glm::mat4 OGLWidget::getOrientationMatrixAlongNegX() const
+        glm::mat4 OGLWidget::getOrientationMatrixAlongNegX()
         {
             return glm::rotate( glm::radians( -90.0f ), glm::vec3( 0.0f, 0.0f, 1.0f ) ) *
                    glm::rotate( glm::radians( -90.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
         }
 
-        glm::mat4 OGLWidget::getOrientationMatrixAlongPosY() const
+        glm::mat4 OGLWidget::getOrientationMatrixAlongPosY()
         {
             return glm::rotate( glm::radians( -90.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
         }
 
-        glm::mat4 OGLWidget::getOrientationMatrixAlongNegY() const
+        glm::mat4 OGLWidget::getOrientationMatrixAlongNegY()
         {
             return glm::rotate( glm::radians( 180.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) ) *
                    glm::rotate( glm::radians( -90.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
         }
 
-        glm::mat4 OGLWidget::getOrientationMatrixAlongPosZ() const
+        glm::mat4 OGLWidget::getOrientationMatrixAlongPosZ()
         {
             return glm::rotate( glm::radians( 180.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) ) *
                    glm::rotate( glm::radians( 90.0f ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
         }
 
-        glm::mat4 OGLWidget::getOrientationMatrixAlongNegZ() const
+        glm::mat4 OGLWidget::getOrientationMatrixAlongNegZ()
         {
             // the default camera
             return glm::rotate( glm::radians( 90.0f ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
@@ -713,39 +820,12 @@ namespace di
 
         glm::mat4 OGLWidget::buildViewMatrix( const core::BoundingBox& sceneBB, const glm::mat4& orientation, float zoom, const glm::vec2& drag )
         {
-            double near = 0.3; // the near plane
-            // double far = zoom * sqrt( 3.0 ) + near;    // the diagonal of the cube needs to fit (sqrt(3))
-            if( sceneBB.isValid() )
-            {
-                // Calculate scene
-                double maxExtend = sqrt( 3.0 ) *
-                                   std::max( sceneBB.getSize().x,
-                                             std::max( sceneBB.getSize().y,
-                                                       sceneBB.getSize().z ) );
-
-                // Move scene to rotation point
-                glm::mat4 rotationPointTranslate = glm::translate( -sceneBB.getCenter() );
-                // Scale scene down to match screen size. The scene is now inside a unit sized cube
-                glm::mat4 scaleToFit = glm::scale( glm::vec3( 1.0 / ( 1.0 * maxExtend ) ) );
-                // Zoom
-                glm::mat4 zoomMatrix = glm::scale( glm::vec3( zoom ) );
-
-                // move scene into the visible area
-                glm::mat4 moveToVisibleArea = glm::translate( glm::vec3( 0.0, 0.0, -( zoom * 0.5 + near ) ) );
-
-                glm::mat4 dragMatrix = glm::translate( static_cast< float >( maxExtend ) *
-                                                       ( 1.0f / static_cast< float >( zoom ) ) *
-                                                       glm::vec3( drag.x, drag.y, 0.0 ) );
-
-                return moveToVisibleArea * scaleToFit * zoomMatrix * dragMatrix * orientation * rotationPointTranslate;
-            }
-
-            return glm::mat4();
+            return core::Camera::buildViewMatrix( sceneBB, orientation, zoom, drag );
         }
 
         glm::mat4 OGLWidget::buildProjectionMatrix( float near, float far, float aspect )
         {
-            return glm::ortho( -0.5f * aspect, 0.5f * aspect, -0.5f, 0.5f, near, far );
+            return core::Camera::buildProjectionMatrix( near, far, aspect );
         }
 
         di::core::State OGLWidget::getState() const
@@ -774,6 +854,7 @@ namespace di
 
             m_arcballMatrix = state.getValue< glm::mat4 >( "Arcball Matrix", glm::mat4() );
             m_dragOffset = state.getValue< glm::vec2 >( "Drag Offset", glm::vec2( 0.0, 0.0 ) );;
+            scheduleRedraw();
 
             return true;
         }
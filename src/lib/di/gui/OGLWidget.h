@@ -30,6 +30,7 @@
 
 #include <di/gfx/GL.h>
 
+#include <QLabel>
 #include <QTimer>
 #include <QWidget>
 // NOTE: QGLWidget is obsolete in Qt5, but the replacement QOpenGLWidget is only available in Qt 5.4+ - we keep QGLWidget for now.
@@ -38,6 +39,7 @@
 
 #include <di/core/State.h>
 #include <di/core/BoundingBox.h>
+#include <di/core/Observer.h>
 #include <di/gfx/PixelData.h>
 #include <di/GfxTypes.h>
 
@@ -101,6 +103,13 @@ namespace di
              */
             void bind() const override;
 
+            /**
+             * True while the camera is dragged and shortly after zooming with the wheel.
+             *
+             * \return true if interacting.
+             */
+            bool isInteracting() const override;
+
             /**
              * Set the screenshot widget responsible for this view. You should set this before showing the OGLWidget.
              *
@@ -146,42 +155,42 @@ namespace di
              *
              * \return the matrix.
              */
-            glm::mat4 getOrientationMatrixAlongPosX() const;
+            static glm::mat4 getOrientationMatrixAlongPosX();
 
             /**
              * Convenience function to get a orientation matrix matching the name of this method. Useful as base for further manipulations.
              *
              * \return the matrix.
              */
-            glm::mat4 getOrientationMatrixAlongNegX() const;
+            static glm::mat4 getOrientationMatrixAlongNegX();
 
             /**
              * Convenience function to get a orientation matrix matching the name of this method. Useful as base for further manipulations.
              *
              * \return the matrix.
              */
-            glm::mat4 getOrientationMatrixAlongPosY() const;
+            static glm::mat4 getOrientationMatrixAlongPosY();
 
             /**
              * Convenience function to get a orientation matrix matching the name of this method. Useful as base for further manipulations.
              *
              * \return the matrix.
              */
-            glm::mat4 getOrientationMatrixAlongNegY() const;
+            static glm::mat4 getOrientationMatrixAlongNegY();
 
             /**
              * Convenience function to get a orientation matrix matching the name of this method. Useful as base for further manipulations.
              *
              * \return the matrix.
              */
-            glm::mat4 getOrientationMatrixAlongPosZ() const;
+            static glm::mat4 getOrientationMatrixAlongPosZ();
 
             /**
              * Convenience function to get a orientation matrix matching the name of this method. Useful as base for further manipulations.
              *
              * \return the matrix.
              */
-            glm::mat4 getOrientationMatrixAlongNegZ() const;
+            static glm::mat4 getOrientationMatrixAlongNegZ();
 
             /**
              * Build a view matrix based on the _current_ scene. Use this method only if you want a matrix that is based on the current scene. If the
@@ -244,6 +253,12 @@ namespace di
              */
             void useDefaultView( size_t id );
 
+            /**
+             * Mark the view as damaged and schedule a redraw. Subsequent calls are merged into one frame. While rendering is slow, frames are
+             * spaced by the time the last frame needed to keep the UI responsive.
+             */
+            void scheduleRedraw();
+
         protected:
             /**
              * Do the necessary setup.
@@ -315,6 +330,16 @@ namespace di
              */
             glm::vec3 toScreenCoord( double x, double y );
 
+            /**
+             * Copy the current frame in the back buffer to the frame cache. Resizes the cache if needed.
+             */
+            void storeFrameCache();
+
+            /**
+             * Copy the cached frame to the back buffer.
+             */
+            void restoreFrameCache();
+
         private:
             /**
              * If true, all visualizations are asked to reload.
@@ -322,14 +347,19 @@ namespace di
             bool m_forceReload = false;
 
             /**
-             * Last time used for FPS counting.
+             * Start of the last rendered frame. Used for frame pacing.
+             */
+            std::chrono::time_point< std::chrono::steady_clock > m_lastFrameTime;
+
+            /**
+             * The minimum time between two frames. Adapts to the time needed to render a frame.
              */
-            std::chrono::time_point< std::chrono::system_clock > m_fpsLastTime;
+            std::chrono::milliseconds m_frameInterval = std::chrono::milliseconds( 16 );
 
             /**
              * Print FPS only once per second
              */
-            std::chrono::time_point< std::chrono::system_clock > m_fpsLastShowTime;
+            std::chrono::time_point< std::chrono::steady_clock > m_fpsLastShowTime;
 
             /**
              * The VBO used for the background.
@@ -357,9 +387,49 @@ namespace di
             SPtr< di::core::Shader > m_bgFragmentShader = nullptr;
 
             /**
-             * Redraw periodically. Only temporary solution.
+             * Triggers the scheduled redraw. Single-shot.
+             */
+            QTimer* m_frameTimer = nullptr;
+
+            /**
+             * Running while zooming with the wheel. Wheel events have no end, so the interaction ends when the timer runs out. Single-shot.
+             */
+            QTimer* m_interactionTimer = nullptr;
+
+            /**
+             * True if the view changed since the last frame and the cached frame is outdated.
+             */
+            bool m_redrawRequested = true;
+
+            /**
+             * Gets notified about render requests of the visualizations.
+             */
+            SPtr< core::Observer > m_renderRequestObserver = nullptr;
+
+            /**
+             * FBO holding the last rendered frame.
+             */
+            GLuint m_frameCacheFBO = 0;
+
+            /**
+             * Color buffer of the frame cache.
+             */
+            GLuint m_frameCacheRenderbuffer = 0;
+
+            /**
+             * Size of the frame cache.
+             */
+            glm::ivec2 m_frameCacheSize = glm::ivec2( 0, 0 );
+
+            /**
+             * True if the frame cache contains the last rendered frame.
+             */
+            bool m_frameCacheValid = false;
+
+            /**
+             * Shows the GPU timings of the render passes on top of the view. Toggled with F3.
              */
-            QTimer* m_redrawTimer;
+            QLabel* m_profilerOverlay = nullptr;
 
             /**
              * State of the mouse drag feature
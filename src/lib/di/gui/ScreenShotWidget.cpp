@@ -26,6 +26,7 @@
 #include <string>
 #include <chrono>
 #include <ctime>
+#include <fstream>
 #include <sstream>
 #include <iomanip>
 
@@ -41,7 +42,7 @@
 #include <di/gui/ScaleLabel.h>
 #include <di/gui/ColorPicker.h>
 
-#include <di/ext/bitmap_image.hpp>
+#include <di/io/ImageWriter.h>
 
 #include "icons/folder.xpm"
 #include "ScreenShotWidget.h"
@@ -64,8 +65,8 @@ namespace di
             m_resolutions.push_back( std::make_tuple( "4:3, QXGA",    2048, 1536 ) );
             m_resolutions.push_back( std::make_tuple( "4:3, QUXGA",   3200, 2400 ) );
             m_resolutions.push_back( std::make_tuple( "4:3, HXGA",    4096, 3072 ) );
-            /* m_resolutions.push_back( std::make_tuple( "4:3, HUXGA",   6400, 4800 ) );
-            m_resolutions.push_back( std::make_tuple( "4:3",          8192, 6144 ) );*/
+            m_resolutions.push_back( std::make_tuple( "4:3, HUXGA",   6400, 4800 ) );
+            m_resolutions.push_back( std::make_tuple( "4:3",          8192, 6144 ) );
 
             // Common 16:9 resolutions
             m_resolutions.push_back( std::make_tuple( "16:9",           1024, 576 ) );
@@ -75,10 +76,8 @@ namespace di
             m_resolutions.push_back( std::make_tuple( "16:9, 2K",       2048, 1152 ) );
             m_resolutions.push_back( std::make_tuple( "16:9, WQXGA+",   3200, 1800 ) );
             m_resolutions.push_back( std::make_tuple( "16:9, 4K",       4096, 2304 ) );
-            /*
             m_resolutions.push_back( std::make_tuple( "16:9, UHD+",     5120, 2880 ) );
             m_resolutions.push_back( std::make_tuple( "16:9, 8K",       8192, 4608 ) );
-            */
 
             // Samplings
             m_samples.push_back( std::make_tuple( "None", 1 ) );
@@ -192,12 +191,13 @@ namespace di
 
         int ScreenShotWidget::getWidth() const
         {
-            return std::min( std::get< 1 >( m_resolutions[ m_resolutionCombo->currentIndex() ] ), m_maxRes );
+            // NOTE: no need to limit this. Large images are rendered in tiles.
+            return std::get< 1 >( m_resolutions[ m_resolutionCombo->currentIndex() ] );
         }
 
         int ScreenShotWidget::getHeight() const
         {
-            return std::min( std::get< 2 >( m_resolutions[ m_resolutionCombo->currentIndex() ] ), m_maxRes );
+            return std::get< 2 >( m_resolutions[ m_resolutionCombo->currentIndex() ] );
         }
 
         int ScreenShotWidget::getSamples() const
@@ -210,11 +210,6 @@ namespace di
             m_maxSamples = samples;
         }
 
-        void ScreenShotWidget::setMaxResolution( int res )
-        {
-            m_maxRes = res;
-        }
-
         bool ScreenShotWidget::getBackgroundOverride() const
         {
             return m_bgColorOverride->isChecked();
@@ -252,7 +247,7 @@ namespace di
             uint16_t nb = 1;
             while( true )
             {
-                if( exists( fn.str() + std::to_string( nb ) + ".bmp" ) )
+                if( exists( fn.str() + std::to_string( nb ) + ".png" ) )
                 {
                     nb++;
                 }
@@ -261,43 +256,18 @@ namespace di
                     break;
                 }
             }
-            fn << nb << ".bmp";
+            fn << nb << ".png";
 
             LogD << "Saving screenshot to file \"" << fn.str() << "\"" << LogEnd;
-            // and store as image
-            bitmap_image image( pixels->getWidth(), pixels->getHeight() );
-
-            // set background to red. If we see a red pixel -> something was wrong
-            image.set_all_channels( 0, 0, 0 );
-
-            // Now write each pixel
-            for( size_t y = 0; y < pixels->getHeight(); ++y )
-            {
-                for( size_t x = 0; x < pixels->getWidth(); ++x )
-                {
-                    auto color = ( *pixels )( x, y );
 
-                    // Bitmap has its (0,0) in the upper left corner. Fix this:
-                    image.set_pixel( x, pixels->getHeight() - y - 1, color.x, color.y, color.z );
-                }
-            }
-
-            // finally, save the file
-            // We ensure we can open the target file before we use save_image as this only returns without any info on success:
+            // We ensure we can open the target file before queueing the image. Compression and writing are done in the background, so errors
+            // from there are only logged.
             std::ofstream file( fn.str().c_str(), std::ios::binary );
             auto status = file.good();
             file.close();
             if( status )
             {
-                try
-                {
-                    image.save_image( fn.str() );
-                }
-                catch( ... )
-                {
-                    LogE << "Cannot write file \"" + fn.str() + "\"." << LogEnd;
-                    return false;
-                }
+                io::ImageWriter::getInstance().write( pixels, fn.str() );
             }
             else
             {
@@ -94,20 +94,13 @@ namespace di
             void setMaxSamples( int samples );
 
             /**
-             * Set maximum resolution for screenshots.
-             *
-             * \param res the max resolution
-             */
-            void setMaxResolution( int res );
-
-            /**
-             * Save the pixel data as screenshot.
+             * Save the pixel data as PNG screenshot. The image is compressed and written in the background by \ref io::ImageWriter.
              *
              * \param pixels the image
              * \param nameHint hint how to name the file.
              * \param pathOverride the path where to store the image. Can be empty to use the user specified path.
              *
-             * \return false on error
+             * \return false if the file cannot be created.
              */
             bool saveScreenShot( SPtr< core::RGBA8Image > pixels, const std::string& nameHint, const std::string& pathOverride = "" );
 
@@ -152,11 +145,6 @@ namespace di
              */
             int m_maxSamples = 4;
 
-            /**
-             * Max amount of samples.
-             */
-            int m_maxRes = 4;
-
             /**
              * The resolutions to support.
              */
@@ -29,9 +29,11 @@
 #include <QMenu>
 #include <QMessageBox>
 
+#include <di/gui/Application.h>
 #include <di/gui/OGLWidget.h>
 #include <di/gui/ScaleLabel.h>
 #include <di/gui/ScreenShotWidget.h>
+#include <di/io/ImageWriter.h>
 
 #include "icons/screenshot.xpm"
 #include "icons/configure.xpm"
@@ -303,14 +305,20 @@ namespace di
 
         void ViewWidget::allScreenshotsDone()
         {
-            // Just re-emit a signal.
-            emit screenshotDone();
-
-            // And call all the functors
-            for( auto callback : m_screenshotDoneCallbacks )
-            {
-                callback();
-            }
+            // The images are still being written in the background. Notify when the writer is done with them.
+            io::ImageWriter::getInstance().callback( Application::getInstance()->runInUIThread(
+                [ this ]()
+                {
+                    // Just re-emit a signal.
+                    emit screenshotDone();
+
+                    // And call all the functors
+                    for( auto callback : m_screenshotDoneCallbacks )
+                    {
+                        callback();
+                    }
+                }
+            ) );
         }
 
         void ViewWidget::setViewPreset( const glm::mat4& view )
@@ -102,7 +102,7 @@ namespace di
 
         signals:
             /**
-             * Reports back whenever all screenshots were taken that have been requested by \ref screenshot().
+             * Reports back whenever all screenshots were taken that have been requested by \ref screenshot() and written to disk.
              */
             void screenshotDone();
 
@@ -0,0 +1,109 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include <di/commands/Callback.h>
+#include <di/commands/WriteImage.h>
+#include <di/io/PngWriter.h>
+
+#include "ImageWriter.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/ImageWriter"
+
+namespace di
+{
+    namespace io
+    {
+        ImageWriter& ImageWriter::getInstance()
+        {
+            static ImageWriter writer;
+            return writer;
+        }
+
+        ImageWriter::ImageWriter():
+            CommandQueue()
+        {
+            start();
+        }
+
+        ImageWriter::~ImageWriter()
+        {
+            stop();
+        }
+
+        SPtr< commands::WriteImage > ImageWriter::write( ConstSPtr< core::RGBA8Image > image, const std::string& filename,
+                                                         SPtr< core::CommandObserver > observer )
+        {
+            return commit( SPtr< commands::WriteImage >( new commands::WriteImage( image, filename, observer ) ) );
+        }
+
+        SPtr< commands::Callback > ImageWriter::callback( std::function< void() > callback )
+        {
+            return commit( SPtr< commands::Callback >( new commands::Callback( callback ) ) );
+        }
+
+        void ImageWriter::wait()
+        {
+            std::mutex mutex;
+            std::condition_variable condition;
+            bool done = false;
+
+            callback(
+                [ & ]()
+                {
+                    std::lock_guard< std::mutex > lock( mutex );
+                    done = true;
+                    condition.notify_one();
+                }
+            );
+
+            std::unique_lock< std::mutex > lock( mutex );
+            while( !done )
+            {
+                condition.wait( lock );
+            }
+        }
+
+        void ImageWriter::process( SPtr< core::Command > command )
+        {
+            SPtr< commands::WriteImage > writeCmd = std::dynamic_pointer_cast< commands::WriteImage >( command );
+            if( writeCmd )
+            {
+                // Errors are thrown and end up in the command's failure state.
+                PngWriter::write( *writeCmd->getImage(), writeCmd->getFilename() );
+                LogI << "Wrote \"" << writeCmd->getFilename() << "\"." << LogEnd;
+            }
+
+            SPtr< commands::Callback > callbackCmd = std::dynamic_pointer_cast< commands::Callback >( command );
+            if( callbackCmd )
+            {
+                callbackCmd->call();
+            }
+        }
+    }
+}
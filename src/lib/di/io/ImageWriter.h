@@ -0,0 +1,113 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_IMAGEWRITER_H
+#define DI_IMAGEWRITER_H
+
+#include <functional>
+#include <string>
+
+#include <di/core/CommandQueue.h>
+#include <di/core/CommandObserver.h>
+#include <di/gfx/PixelData.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace commands
+    {
+        class Callback;
+        class WriteImage;
+    }
+
+    namespace io
+    {
+        /**
+         * Writes images in the background. Images are compressed and written in the order of submission, so the caller can continue rendering
+         * the next image meanwhile. Images are written as PNG using \ref PngWriter.
+         */
+        class ImageWriter: public core::CommandQueue
+        {
+        public:
+            /**
+             * Get the writer instance. The queue is started on first use.
+             *
+             * \return the instance
+             */
+            static ImageWriter& getInstance();
+
+            /**
+             * Destructor. Writes all remaining images.
+             */
+            virtual ~ImageWriter();
+
+            /**
+             * Queue the image for writing. Errors are logged and mark the command as failed.
+             *
+             * \param image the image. Must not be modified afterwards.
+             * \param filename the file to write
+             * \param observer an object that gets notified upon changes in the command's state.
+             *
+             * \return the command
+             */
+            SPtr< commands::WriteImage > write( ConstSPtr< core::RGBA8Image > image, const std::string& filename,
+                                                SPtr< core::CommandObserver > observer = nullptr );
+
+            /**
+             * Call the given function once all images queued before were written.
+             *
+             * \note the function runs in the writer thread.
+             *
+             * \param callback the function to call
+             *
+             * \return the command
+             */
+            SPtr< commands::Callback > callback( std::function< void() > callback );
+
+            /**
+             * Block until all images queued so far were written.
+             */
+            void wait();
+
+        protected:
+            /**
+             * Constructor. Use \ref getInstance.
+             */
+            ImageWriter();
+
+            /**
+             * Process the specified command.
+             *
+             * \param command the command to handle
+             */
+            virtual void process( SPtr< core::Command > command );
+
+        private:
+        };
+    }
+}
+
+#endif  // DI_IMAGEWRITER_H
+
@@ -0,0 +1,526 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <di/core/Filesystem.h>
+#include <di/core/Hash.h>
+#include <di/core/MappedFile.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/core/data/TriangleDataSet.h>
+
+#include "MeshCache.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/MeshCache"
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Signature of cache files.
+         */
+        static const char g_meshCacheSignature[ 8 ] = { 'D', 'I', 'M', 'E', 'S', 'H', '\0', '\0' };
+
+        /**
+         * Version of the cache format. Increment on each change.
+         */
+        static const uint32_t g_meshCacheVersion = 1;
+
+        /**
+         * Used to detect cache files written on machines with different byte order.
+         */
+        static const uint32_t g_meshCacheByteOrderMark = 0x01020304;
+
+        /**
+         * Alignment of each section in the file.
+         */
+        static const uint64_t g_meshCacheAlignment = 64;
+
+        /**
+         * IDs of the sections in the file.
+         */
+        enum MeshCacheSection
+        {
+            Vertices = 1,
+            Triangles = 2,
+            Normals = 3,
+            Colors = 4,
+            AdjacencyOffsets = 5,
+            AdjacencyTriangles = 6
+        };
+
+        /**
+         * Size of the fixed header: signature, version, byte order mark, source size, source modification time, number of sections, reserved.
+         */
+        static const uint64_t g_meshCacheHeaderSize = 8 + 4 + 4 + 8 + 8 + 4 + 4;
+
+        /**
+         * Size of each entry in the section table: ID, element size, element count, offset.
+         */
+        static const uint64_t g_meshCacheSectionEntrySize = 4 + 4 + 8 + 8;
+
+        /**
+         * Append a value to a byte buffer.
+         *
+         * \tparam ValueType the type of the value. Needs to be trivially copyable.
+         * \param buffer the buffer
+         * \param value the value
+         */
+        template< typename ValueType >
+        static void appendValue( std::vector< char >& buffer, const ValueType& value )
+        {
+            const char* bytes = reinterpret_cast< const char* >( &value );
+            buffer.insert( buffer.end(), bytes, bytes + sizeof( ValueType ) );
+        }
+
+        /**
+         * Read a value from memory.
+         *
+         * \tparam ValueType the type of the value. Needs to be trivially copyable.
+         * \param pos the position. Advanced by the size of the value.
+         *
+         * \return the value
+         */
+        template< typename ValueType >
+        static ValueType readValue( const char*& pos )
+        {
+            ValueType value;
+            std::memcpy( &value, pos, sizeof( ValueType ) );
+            pos += sizeof( ValueType );
+            return value;
+        }
+
+        /**
+         * Describes a section in the file.
+         */
+        class MeshCacheSectionInfo
+        {
+        public:
+            /**
+             * Section ID.
+             */
+            uint32_t m_id = 0;
+
+            /**
+             * Size of each element in bytes.
+             */
+            uint32_t m_elementSize = 0;
+
+            /**
+             * Number of elements.
+             */
+            uint64_t m_count = 0;
+
+            /**
+             * Offset in the file.
+             */
+            uint64_t m_offset = 0;
+
+            /**
+             * The data to write. Only used while writing.
+             */
+            const void* m_data = nullptr;
+        };
+
+        /**
+         * Copy a section into the given array.
+         *
+         * \tparam ValueType the element type
+         * \param file the mapped file
+         * \param sections the section table
+         * \param id the section to copy
+         * \param values the target. Resized accordingly.
+         *
+         * \return true if the section exists and matches the element type.
+         */
+        template< typename ValueType >
+        static bool readSection( const core::MappedFile& file, const std::vector< MeshCacheSectionInfo >& sections, uint32_t id,
+                                 std::vector< ValueType >& values )
+        {
+            for( const auto& section : sections )
+            {
+                if( section.m_id != id )
+                {
+                    continue;
+                }
+
+                if( ( section.m_elementSize != sizeof( ValueType ) ) ||
+                    ( section.m_offset > file.size() ) ||
+                    ( section.m_count > ( file.size() - section.m_offset ) / sizeof( ValueType ) ) )
+                {
+                    return false;
+                }
+
+                values.resize( section.m_count );
+                if( section.m_count )
+                {
+                    std::memcpy( static_cast< void* >( values.data() ), file.begin() + section.m_offset, section.m_count * sizeof( ValueType ) );
+                }
+                return true;
+            }
+            return false;
+        }
+
+        std::string MeshCache::getLocalCacheFilename( const std::string& source )
+        {
+            return source + ".dimesh";
+        }
+
+        std::string MeshCache::getUserCacheFilename( const std::string& source )
+        {
+            auto cachePath = core::getCachePath();
+            if( cachePath.empty() )
+            {
+                return "";
+            }
+
+            // Name the file by the hash of the absolute source path.
+            std::string absolute = source;
+            char* resolved = realpath( source.c_str(), nullptr );
+            if( resolved )
+            {
+                absolute = resolved;
+                std::free( resolved );
+            }
+
+            std::stringstream ss;
+            ss << cachePath << std::hex << std::setw( 16 ) << std::setfill( '0' ) << core::hashBytes( absolute.data(), absolute.size() )
+               << ".dimesh";
+            return ss.str();
+        }
+
+        SPtr< core::TriangleDataSet > MeshCache::load( const std::string& source )
+        {
+            std::vector< std::string > candidates = { getLocalCacheFilename( source ), getUserCacheFilename( source ) };
+            for( auto cacheFilename : candidates )
+            {
+                if( cacheFilename.empty() )
+                {
+                    continue;
+                }
+
+                try
+                {
+                    auto result = loadCacheFile( source, cacheFilename );
+                    if( result )
+                    {
+                        return result;
+                    }
+                }
+                catch( const std::exception& e )
+                {
+                    LogW << "Ignoring cache file \"" << cacheFilename << "\": " << e.what() << LogEnd;
+                }
+            }
+            return nullptr;
+        }
+
+        bool MeshCache::write( const std::string& source, ConstSPtr< core::TriangleDataSet > dataSet )
+        {
+            // Prefer the local file. Use the cache directory if the source directory is not writable.
+            if( writeCacheFile( source, getLocalCacheFilename( source ), dataSet ) )
+            {
+                return true;
+            }
+
+            auto userCacheFilename = getUserCacheFilename( source );
+            return !userCacheFilename.empty() && writeCacheFile( source, userCacheFilename, dataSet );
+        }
+
+        SPtr< core::TriangleDataSet > MeshCache::loadCacheFile( const std::string& source, const std::string& cacheFilename )
+        {
+            uint64_t sourceSize = 0;
+            int64_t sourceTime = 0;
+            uint64_t cacheSize = 0;
+            int64_t cacheTime = 0;
+            if( !core::getFileStatus( source, sourceSize, sourceTime ) || !core::getFileStatus( cacheFilename, cacheSize, cacheTime ) )
+            {
+                return nullptr;
+            }
+
+            core::MappedFile file( cacheFilename );
+            if( file.size() < g_meshCacheHeaderSize )
+            {
+                return nullptr;
+            }
+
+            // Check header
+            const char* pos = file.begin();
+            if( !std::equal( g_meshCacheSignature, g_meshCacheSignature + sizeof( g_meshCacheSignature ), pos ) )
+            {
+                return nullptr;
+            }
+            pos += sizeof( g_meshCacheSignature );
+
+            if( ( readValue< uint32_t >( pos ) != g_meshCacheVersion ) || ( readValue< uint32_t >( pos ) != g_meshCacheByteOrderMark ) )
+            {
+                LogD << "Cache file \"" << cacheFilename << "\" was written by another version or machine." << LogEnd;
+                return nullptr;
+            }
+
+            if( ( readValue< uint64_t >( pos ) != sourceSize ) || ( readValue< int64_t >( pos ) != sourceTime ) )
+            {
+                LogD << "Cache file \"" << cacheFilename << "\" is outdated." << LogEnd;
+                return nullptr;
+            }
+
+            auto numSections = readValue< uint32_t >( pos );
+            readValue< uint32_t >( pos );  // reserved
+
+            if( numSections > ( file.size() - g_meshCacheHeaderSize ) / g_meshCacheSectionEntrySize )
+            {
+                return nullptr;
+            }
+
+            std::vector< MeshCacheSectionInfo > sections( numSections );
+            for( auto& section : sections )
+            {
+                section.m_id = readValue< uint32_t >( pos );
+                section.m_elementSize = readValue< uint32_t >( pos );
+                section.m_count = readValue< uint64_t >( pos );
+                section.m_offset = readValue< uint64_t >( pos );
+            }
+
+            // Copy each section.
+            Vec3Array vertices;
+            IndexVec3Array triangles;
+            NormalArray normals;
+            auto colors = std::make_shared< RGBAArray >();
+            std::vector< uint64_t > adjacencyOffsets;
+            std::vector< uint32_t > adjacencyTriangles;
+            if( !( readSection( file, sections, Vertices, vertices ) &&
+                   readSection( file, sections, Triangles, triangles ) &&
+                   readSection( file, sections, Normals, normals ) &&
+                   readSection( file, sections, Colors, *colors ) &&
+                   readSection( file, sections, AdjacencyOffsets, adjacencyOffsets ) &&
+                   readSection( file, sections, AdjacencyTriangles, adjacencyTriangles ) ) )
+            {
+                LogW << "Cache file \"" << cacheFilename << "\" is incomplete." << LogEnd;
+                return nullptr;
+            }
+
+            // The sizes match the header. The contents need to be checked too, as the consumers index with them without checks.
+            if( colors->size() != vertices.size() )
+            {
+                LogW << "Cache file \"" << cacheFilename << "\" contains invalid colors." << LogEnd;
+                return nullptr;
+            }
+
+            for( const auto& triangle : triangles )
+            {
+                for( int i = 0; i < 3; ++i )
+                {
+                    // Negative indices wrap around and are rejected too.
+                    if( static_cast< uint32_t >( triangle[ i ] ) >= vertices.size() )
+                    {
+                        LogW << "Cache file \"" << cacheFilename << "\" contains invalid triangles." << LogEnd;
+                        return nullptr;
+                    }
+                }
+            }
+
+            for( auto triangleID : adjacencyTriangles )
+            {
+                if( triangleID >= triangles.size() )
+                {
+                    LogW << "Cache file \"" << cacheFilename << "\" contains invalid adjacency." << LogEnd;
+                    return nullptr;
+                }
+            }
+
+            // Rebuild the adjacency from its compressed form.
+            if( ( adjacencyOffsets.size() != vertices.size() + 1 ) || ( adjacencyOffsets.back() != adjacencyTriangles.size() ) )
+            {
+                LogW << "Cache file \"" << cacheFilename << "\" contains invalid adjacency." << LogEnd;
+                return nullptr;
+            }
+
+            std::vector< std::vector< size_t > > inverseIndex( vertices.size() );
+            for( size_t vertexID = 0; vertexID < vertices.size(); ++vertexID )
+            {
+                if( adjacencyOffsets[ vertexID ] > adjacencyOffsets[ vertexID + 1 ] )
+                {
+                    LogW << "Cache file \"" << cacheFilename << "\" contains invalid adjacency." << LogEnd;
+                    return nullptr;
+                }
+                inverseIndex[ vertexID ].assign( adjacencyTriangles.begin() + adjacencyOffsets[ vertexID ],
+                                                 adjacencyTriangles.begin() + adjacencyOffsets[ vertexID + 1 ] );
+            }
+
+            auto mesh = std::make_shared< core::TriangleMesh >();
+            mesh->setVertices( std::move( vertices ) );
+            mesh->setTriangles( std::move( triangles ) );
+            mesh->setNormals( std::move( normals ) );
+            mesh->setInverseIndex( std::move( inverseIndex ) );
+
+            if( !mesh->sanityCheck() )
+            {
+                LogW << "Cache file \"" << cacheFilename << "\" contains an invalid mesh." << LogEnd;
+                return nullptr;
+            }
+
+            LogD << "Loaded \"" << source << "\" from cache file \"" << cacheFilename << "\"." << LogEnd;
+            return std::make_shared< core::TriangleDataSet >( source, mesh, colors );
+        }
+
+        bool MeshCache::writeCacheFile( const std::string& source, const std::string& cacheFilename,
+                                        ConstSPtr< core::TriangleDataSet > dataSet )
+        {
+            uint64_t sourceSize = 0;
+            int64_t sourceTime = 0;
+            if( !dataSet || !core::getFileStatus( source, sourceSize, sourceTime ) )
+            {
+                return false;
+            }
+
+            auto mesh = dataSet->getGrid();
+            auto colors = dataSet->getAttributes();
+
+            // Such a cache would be rejected when loading. Do not bother writing it.
+            if( colors->size() != mesh->getNumVertices() )
+            {
+                LogD << "Not caching \"" << source << "\". It does not have a color per vertex." << LogEnd;
+                return false;
+            }
+
+            // Compress the adjacency: one offset per vertex into a single triangle list.
+            const auto& inverseIndex = mesh->getInverseIndex();
+            std::vector< uint64_t > adjacencyOffsets;
+            std::vector< uint32_t > adjacencyTriangles;
+            adjacencyOffsets.reserve( inverseIndex.size() + 1 );
+            adjacencyTriangles.reserve( mesh->getNumTriangles() * 3 );
+            adjacencyOffsets.push_back( 0 );
+            for( const auto& triangles : inverseIndex )
+            {
+                adjacencyTriangles.insert( adjacencyTriangles.end(), triangles.begin(), triangles.end() );
+                adjacencyOffsets.push_back( adjacencyTriangles.size() );
+            }
+
+            // Describe the sections
+            std::vector< MeshCacheSectionInfo > sections( 6 );
+            sections[ 0 ].m_id = Vertices;
+            sections[ 0 ].m_elementSize = sizeof( Vec3Array::value_type );
+            sections[ 0 ].m_count = mesh->getVertices().size();
+            sections[ 0 ].m_data = mesh->getVertices().data();
+            sections[ 1 ].m_id = Triangles;
+            sections[ 1 ].m_elementSize = sizeof( IndexVec3Array::value_type );
+            sections[ 1 ].m_count = mesh->getTriangles().size();
+            sections[ 1 ].m_data = mesh->getTriangles().data();
+            sections[ 2 ].m_id = Normals;
+            sections[ 2 ].m_elementSize = sizeof( NormalArray::value_type );
+            sections[ 2 ].m_count = mesh->getNormals().size();
+            sections[ 2 ].m_data = mesh->getNormals().data();
+            sections[ 3 ].m_id = Colors;
+            sections[ 3 ].m_elementSize = sizeof( RGBAArray::value_type );
+            sections[ 3 ].m_count = colors->size();
+            sections[ 3 ].m_data = colors->data();
+            sections[ 4 ].m_id = AdjacencyOffsets;
+            sections[ 4 ].m_elementSize = sizeof( uint64_t );
+            sections[ 4 ].m_count = adjacencyOffsets.size();
+            sections[ 4 ].m_data = adjacencyOffsets.data();
+            sections[ 5 ].m_id = AdjacencyTriangles;
+            sections[ 5 ].m_elementSize = sizeof( uint32_t );
+            sections[ 5 ].m_count = adjacencyTriangles.size();
+            sections[ 5 ].m_data = adjacencyTriangles.data();
+
+            // Layout: header, section table, aligned sections
+            uint64_t offset = g_meshCacheHeaderSize + sections.size() * g_meshCacheSectionEntrySize;
+            for( auto& section : sections )
+            {
+                offset = ( offset + g_meshCacheAlignment - 1 ) / g_meshCacheAlignment * g_meshCacheAlignment;
+                section.m_offset = offset;
+                offset += section.m_count * section.m_elementSize;
+            }
+
+            std::vector< char > header;
+            header.insert( header.end(), g_meshCacheSignature, g_meshCacheSignature + sizeof( g_meshCacheSignature ) );
+            appendValue( header, g_meshCacheVersion );
+            appendValue( header, g_meshCacheByteOrderMark );
+            appendValue( header, sourceSize );
+            appendValue( header, sourceTime );
+            appendValue( header, static_cast< uint32_t >( sections.size() ) );
+            appendValue( header, static_cast< uint32_t >( 0 ) );
+            for( const auto& section : sections )
+            {
+                appendValue( header, section.m_id );
+                appendValue( header, section.m_elementSize );
+                appendValue( header, section.m_count );
+                appendValue( header, section.m_offset );
+            }
+
+            // Write to a temporary file first and move it in place afterwards. This way, others never see half-written files.
+            std::string tempFilename = cacheFilename + ".tmp" + std::to_string( getpid() );
+            {
+                std::ofstream fs( tempFilename, std::ios::binary | std::ios::trunc );
+                if( !fs.good() )
+                {
+                    LogD << "Cannot write cache file \"" << cacheFilename << "\"." << LogEnd;
+                    return false;
+                }
+
+                fs.write( header.data(), header.size() );
+                uint64_t written = header.size();
+                const char padding[ g_meshCacheAlignment ] = { 0 };
+                for( const auto& section : sections )
+                {
+                    fs.write( padding, section.m_offset - written );
+                    fs.write( static_cast< const char* >( section.m_data ), section.m_count * section.m_elementSize );
+                    written = section.m_offset + section.m_count * section.m_elementSize;
+                }
+
+                if( !fs.good() )
+                {
+                    LogW << "Failed to write cache file \"" << cacheFilename << "\"." << LogEnd;
+                    fs.close();
+                    std::remove( tempFilename.c_str() );
+                    return false;
+                }
+            }
+
+            if( !core::replaceFile( tempFilename, cacheFilename ) )
+            {
+                LogW << "Failed to move cache file to \"" << cacheFilename << "\"." << LogEnd;
+                std::remove( tempFilename.c_str() );
+                return false;
+            }
+
+            LogD << "Wrote cache file \"" << cacheFilename << "\"." << LogEnd;
+            return true;
+        }
+    }
+}
+
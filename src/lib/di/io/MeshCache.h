@@ -0,0 +1,117 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MESHCACHE_H
+#define DI_MESHCACHE_H
+
+#include <string>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        class TriangleDataSet;
+    }
+
+    namespace io
+    {
+        /**
+         * Implements the preprocessed mesh cache format (.dimesh). A cache file stores vertices, triangles, normals, colors and the
+         * vertex-triangle adjacency of a loaded mesh in aligned binary sections. Loading a cache file only maps it into memory and copies the
+         * sections. No parsing and no re-calculation of normals or adjacency is needed.
+         *
+         * Cache files are written next to the source file. If this is not possible, the user's cache directory is used. A cache file is only
+         * valid as long as size and modification time of the source file match the ones stored in the cache.
+         */
+        class MeshCache
+        {
+        public:
+            /**
+             * Try to load the cached version of the given source file.
+             *
+             * \param source the source mesh file
+             *
+             * \return the dataset or nullptr if there is no valid cache file.
+             */
+            static SPtr< core::TriangleDataSet > load( const std::string& source );
+
+            /**
+             * Write a cache file for the given source file and the dataset loaded from it. Errors are logged but not reported otherwise, as
+             * the cache is optional.
+             *
+             * \param source the source mesh file
+             * \param dataSet the loaded data.
+             *
+             * \return true if the cache file was written.
+             */
+            static bool write( const std::string& source, ConstSPtr< core::TriangleDataSet > dataSet );
+
+        protected:
+        private:
+            /**
+             * The cache file next to the source.
+             *
+             * \param source the source mesh file
+             *
+             * \return the cache filename
+             */
+            static std::string getLocalCacheFilename( const std::string& source );
+
+            /**
+             * The cache file inside the user's cache directory.
+             *
+             * \param source the source mesh file
+             *
+             * \return the cache filename. Empty if there is no cache directory.
+             */
+            static std::string getUserCacheFilename( const std::string& source );
+
+            /**
+             * Load the given cache file.
+             *
+             * \param source the source mesh file
+             * \param cacheFilename the cache file
+             *
+             * \return the dataset or nullptr if the cache file is invalid or outdated.
+             */
+            static SPtr< core::TriangleDataSet > loadCacheFile( const std::string& source, const std::string& cacheFilename );
+
+            /**
+             * Write the given cache file.
+             *
+             * \param source the source mesh file
+             * \param cacheFilename the cache file
+             * \param dataSet the loaded data.
+             *
+             * \return true on success.
+             */
+            static bool writeCacheFile( const std::string& source, const std::string& cacheFilename, ConstSPtr< core::TriangleDataSet > dataSet );
+        };
+    }
+}
+
+#endif  // DI_MESHCACHE_H
+
@@ -29,11 +29,13 @@
 #include <functional>
 #include <chrono>
 #include <thread>
+#include <unordered_set>
 
 #include <di/core/Filesystem.h>
 #include <di/core/StringUtils.h>
 #include <di/core/data/TriangleMesh.h>
 #include <di/core/data/TriangleDataSet.h>
+#include <di/io/MeshCache.h>
 
 #include <di/ext/rply/rply.h>
 
@@ -159,6 +161,13 @@ namespace di
 
         SPtr< di::core::DataSetBase > PlyReader::load( const std::string& filename ) const
         {
+            // Use the preprocessed cache if available and up-to-date.
+            auto cached = MeshCache::load( filename );
+            if( cached )
+            {
+                return cached;
+            }
+
             // Use C style numeric locale to ensure that all loaders work properly.
             // Keep old locale
             const char* oldLocale = setlocale( LC_NUMERIC, NULL );
@@ -206,6 +215,10 @@ namespace di
 
             LogD << "Going to load " << numTriangles << " triangles with " << numVertices << " vertices and " << numColors << " colors." << LogEnd;
 
+            // avoid re-allocations while reading
+            mesh->reserve( numVertices, numTriangles );
+            colors->reserve( numColors );
+
             // go
             if( !ply_read( ply ) )
             {
@@ -230,13 +243,12 @@ namespace di
 
             LogD << "Loading \"" << filename << "\" done." << LogEnd;
 
-            std::vector< glm::vec4 > diffColors;
-            for( auto c : *colors )
+            // Colors were loaded from 8 bit per channel. Pack them to count the different colors.
+            std::unordered_set< uint32_t > diffColors;
+            for( const auto& c : *colors )
             {
-                if( std::find( diffColors.begin(), diffColors.end(), c ) == diffColors.end() )
-                {
-                    diffColors.push_back( c );
-                }
+                glm::uvec4 rgba = glm::uvec4( glm::round( c * 255.0f ) );
+                diffColors.insert( ( rgba.r << 24 ) | ( rgba.g << 16 ) | ( rgba.b << 8 ) | rgba.a );
             }
             LogD << "From " << numColors << " specified colors, " << diffColors.size() << " different where found." << LogEnd;
 
@@ -248,7 +260,12 @@ namespace di
             mesh->calculateInverseIndex();
 
             // construct the dataset
-            return SPtr< di::core::TriangleDataSet >( new di::core::TriangleDataSet( filename, mesh, colors ) );
+            auto result = SPtr< di::core::TriangleDataSet >( new di::core::TriangleDataSet( filename, mesh, colors ) );
+
+            // Next time, load the preprocessed mesh.
+            MeshCache::write( filename, result );
+
+            return result;
         }
     }
 }
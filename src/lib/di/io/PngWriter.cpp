@@ -0,0 +1,404 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include <di/core/Parallel.h>
+
+#include "PngWriter.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/PngWriter"
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Minimum number of rows per stripe. Smaller stripes compress badly and are not worth a thread.
+         */
+        static const size_t g_pngMinStripeRows = 64;
+
+        /**
+         * Maximum size of a single IDAT chunk.
+         */
+        static const size_t g_pngMaxChunkSize = 1 << 23;
+
+        /**
+         * A stripe of rows, compressed as raw deflate data.
+         */
+        struct PngStripe
+        {
+            /**
+             * First row in PNG order (top-down).
+             */
+            size_t m_firstRow = 0;
+
+            /**
+             * Number of rows.
+             */
+            size_t m_numRows = 0;
+
+            /**
+             * True if this is the last stripe. It terminates the deflate stream.
+             */
+            bool m_last = false;
+
+            /**
+             * The compressed data.
+             */
+            std::vector< unsigned char > m_data;
+
+            /**
+             * Adler32 checksum of the uncompressed, filtered data.
+             */
+            uLong m_adler = 0;
+
+            /**
+             * Length of the uncompressed, filtered data.
+             */
+            size_t m_rawLength = 0;
+
+            /**
+             * Empty if everything went well.
+             */
+            std::string m_error;
+        };
+
+        /**
+         * Paeth predictor as defined by the PNG specification.
+         *
+         * \param a left
+         * \param b above
+         * \param c upper left
+         *
+         * \return the predictor
+         */
+        static inline int paeth( int a, int b, int c )
+        {
+            int p = a + b - c;
+            int pa = std::abs( p - a );
+            int pb = std::abs( p - b );
+            int pc = std::abs( p - c );
+            if( ( pa <= pb ) && ( pa <= pc ) )
+            {
+                return a;
+            }
+            return ( pb <= pc ) ? b : c;
+        }
+
+        /**
+         * Filter a row with all five PNG filters and keep the one with the smallest sum of absolute (signed) values. This is the heuristic
+         * recommended by the PNG specification.
+         *
+         * \param row the row, RGB
+         * \param prev the previous row or a row of zeros.
+         * \param best receives the best filtered row, including the filter type byte.
+         * \param candidate temporary storage of the same size as best.
+         */
+        static void filterRow( const std::vector< unsigned char >& row, const std::vector< unsigned char >& prev,
+                               std::vector< unsigned char >& best, std::vector< unsigned char >& candidate )
+        {
+            const size_t bpp = 3;
+            const size_t length = row.size();
+            uint64_t bestSum = ~uint64_t( 0 );
+            for( unsigned char type = 0; type < 5; ++type )
+            {
+                candidate[ 0 ] = type;
+                uint64_t sum = 0;
+                for( size_t i = 0; i < length; ++i )
+                {
+                    int a = ( i >= bpp ) ? row[ i - bpp ] : 0;
+                    int b = prev[ i ];
+                    int c = ( i >= bpp ) ? prev[ i - bpp ] : 0;
+                    int predictor = 0;
+                    switch( type )
+                    {
+                        case 1:
+                            predictor = a;
+                            break;
+                        case 2:
+                            predictor = b;
+                            break;
+                        case 3:
+                            predictor = ( a + b ) / 2;
+                            break;
+                        case 4:
+                            predictor = paeth( a, b, c );
+                            break;
+                        default:
+                            break;
+                    }
+                    unsigned char value = static_cast< unsigned char >( row[ i ] - predictor );
+                    candidate[ i + 1 ] = value;
+                    sum += static_cast< uint64_t >( std::abs( static_cast< int >( static_cast< signed char >( value ) ) ) );
+                }
+
+                if( sum < bestSum )
+                {
+                    bestSum = sum;
+                    best.swap( candidate );
+                }
+            }
+        }
+
+        /**
+         * Get a row of the image in PNG order as RGB.
+         *
+         * \param image the image, bottom-up
+         * \param pngRow the row in PNG order (top-down)
+         * \param row receives the RGB values. Needs 3 * width bytes.
+         */
+        static void getRow( const core::RGBA8Image& image, size_t pngRow, std::vector< unsigned char >& row )
+        {
+            const size_t width = image.getWidth();
+            const unsigned char* src = static_cast< const unsigned char* >( image.data() ) + ( image.getHeight() - 1 - pngRow ) * width * 4;
+            for( size_t x = 0; x < width; ++x )
+            {
+                row[ 3 * x + 0 ] = src[ 4 * x + 0 ];
+                row[ 3 * x + 1 ] = src[ 4 * x + 1 ];
+                row[ 3 * x + 2 ] = src[ 4 * x + 2 ];
+            }
+        }
+
+        /**
+         * Filter and compress a stripe of the image. The deflate stream ends on a byte boundary, so the compressed stripes can simply be
+         * concatenated. Only the last stripe finishes the stream.
+         *
+         * \param image the image
+         * \param stripe the stripe to compress. Receives the result.
+         */
+        static void compressStripe( const core::RGBA8Image& image, PngStripe& stripe )
+        {
+            const size_t rowLength = 3 * image.getWidth();
+            std::vector< unsigned char > row( rowLength, 0 );
+            std::vector< unsigned char > prev( rowLength, 0 );
+            std::vector< unsigned char > best( rowLength + 1, 0 );
+            std::vector< unsigned char > candidate( rowLength + 1, 0 );
+
+            // The filters use the previous row, even if it belongs to the previous stripe.
+            if( stripe.m_firstRow > 0 )
+            {
+                getRow( image, stripe.m_firstRow - 1, prev );
+            }
+
+            // Raw deflate. The zlib header and the checksum are written once for all stripes.
+            z_stream stream;
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+            if( deflateInit2( &stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+            {
+                stripe.m_error = "Cannot initialize zlib.";
+                return;
+            }
+
+            stripe.m_adler = adler32( 0L, Z_NULL, 0 );
+            stripe.m_rawLength = stripe.m_numRows * ( rowLength + 1 );
+            stripe.m_data.resize( deflateBound( &stream, static_cast< uLong >( stripe.m_rawLength ) ) + 16 );
+            stream.next_out = stripe.m_data.data();
+            stream.avail_out = static_cast< uInt >( stripe.m_data.size() );
+
+            for( size_t r = 0; r < stripe.m_numRows; ++r )
+            {
+                getRow( image, stripe.m_firstRow + r, row );
+                filterRow( row, prev, best, candidate );
+                row.swap( prev );
+
+                stripe.m_adler = adler32( stripe.m_adler, best.data(), static_cast< uInt >( best.size() ) );
+
+                bool lastRow = ( r + 1 == stripe.m_numRows );
+                int flush = lastRow ? ( stripe.m_last ? Z_FINISH : Z_SYNC_FLUSH ) : Z_NO_FLUSH;
+                stream.next_in = best.data();
+                stream.avail_in = static_cast< uInt >( best.size() );
+                int result = deflate( &stream, flush );
+                if( ( result == Z_STREAM_ERROR ) || ( stream.avail_in != 0 ) )
+                {
+                    stripe.m_error = "Compression failed.";
+                    break;
+                }
+            }
+
+            stripe.m_data.resize( stripe.m_data.size() - stream.avail_out );
+            deflateEnd( &stream );
+        }
+
+        /**
+         * Write a PNG chunk.
+         *
+         * \param file the file
+         * \param type the chunk type
+         * \param data the data
+         * \param length the data length
+         */
+        static void writeChunk( std::ofstream& file, const char* type, const unsigned char* data, size_t length )
+        {
+            unsigned char header[ 8 ] = {
+                static_cast< unsigned char >( length >> 24 ),
+                static_cast< unsigned char >( length >> 16 ),
+                static_cast< unsigned char >( length >> 8 ),
+                static_cast< unsigned char >( length ),
+                static_cast< unsigned char >( type[ 0 ] ),
+                static_cast< unsigned char >( type[ 1 ] ),
+                static_cast< unsigned char >( type[ 2 ] ),
+                static_cast< unsigned char >( type[ 3 ] )
+            };
+
+            uLong crc = crc32( 0L, Z_NULL, 0 );
+            crc = crc32( crc, header + 4, 4 );
+            if( length > 0 )
+            {
+                crc = crc32( crc, data, static_cast< uInt >( length ) );
+            }
+
+            unsigned char footer[ 4 ] = {
+                static_cast< unsigned char >( crc >> 24 ),
+                static_cast< unsigned char >( crc >> 16 ),
+                static_cast< unsigned char >( crc >> 8 ),
+                static_cast< unsigned char >( crc )
+            };
+
+            file.write( reinterpret_cast< const char* >( header ), 8 );
+            if( length > 0 )
+            {
+                file.write( reinterpret_cast< const char* >( data ), static_cast< std::streamsize >( length ) );
+            }
+            file.write( reinterpret_cast< const char* >( footer ), 4 );
+        }
+
+        /**
+         * Write the data as IDAT chunks, split to a sane chunk size.
+         *
+         * \param file the file
+         * \param data the data
+         * \param length the data length
+         */
+        static void writeImageData( std::ofstream& file, const unsigned char* data, size_t length )
+        {
+            for( size_t offset = 0; offset < length; offset += g_pngMaxChunkSize )
+            {
+                writeChunk( file, "IDAT", data + offset, std::min( g_pngMaxChunkSize, length - offset ) );
+            }
+        }
+
+        void PngWriter::write( const core::RGBA8Image& image, const std::string& filename, unsigned int threads )
+        {
+            const size_t width = image.getWidth();
+            const size_t height = image.getHeight();
+            if( ( width == 0 ) || ( height == 0 ) )
+            {
+                throw std::runtime_error( "Cannot write empty image to \"" + filename + "\"." );
+            }
+
+            // Split into stripes and compress them in parallel.
+            size_t numStripes = std::max( size_t( 1 ), std::min( size_t( core::getNumThreads( threads ) ), height / g_pngMinStripeRows ) );
+            size_t rowsPerStripe = ( height + numStripes - 1 ) / numStripes;
+            std::vector< PngStripe > stripes;
+            for( size_t firstRow = 0; firstRow < height; firstRow += rowsPerStripe )
+            {
+                PngStripe stripe;
+                stripe.m_firstRow = firstRow;
+                stripe.m_numRows = std::min( rowsPerStripe, height - firstRow );
+                stripe.m_last = ( firstRow + stripe.m_numRows == height );
+                stripes.push_back( stripe );
+            }
+
+            core::parallelFor( stripes.size(),
+                [ &image, &stripes ]( size_t begin, size_t end )
+                {
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        compressStripe( image, stripes[ i ] );
+                    }
+                }, 1, threads
+            );
+
+            // Combine the checksums.
+            uLong adler = adler32( 0L, Z_NULL, 0 );
+            for( const auto& stripe : stripes )
+            {
+                if( !stripe.m_error.empty() )
+                {
+                    throw std::runtime_error( "Cannot write \"" + filename + "\": " + stripe.m_error );
+                }
+                adler = adler32_combine( adler, stripe.m_adler, static_cast< z_off_t >( stripe.m_rawLength ) );
+            }
+
+            std::ofstream file( filename.c_str(), std::ios::binary );
+            if( !file.is_open() )
+            {
+                throw std::runtime_error( "Cannot open \"" + filename + "\" for writing." );
+            }
+
+            static const unsigned char signature[ 8 ] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+            file.write( reinterpret_cast< const char* >( signature ), 8 );
+
+            // 8 bit RGB, no interlacing
+            unsigned char ihdr[ 13 ] = {
+                static_cast< unsigned char >( width >> 24 ),
+                static_cast< unsigned char >( width >> 16 ),
+                static_cast< unsigned char >( width >> 8 ),
+                static_cast< unsigned char >( width ),
+                static_cast< unsigned char >( height >> 24 ),
+                static_cast< unsigned char >( height >> 16 ),
+                static_cast< unsigned char >( height >> 8 ),
+                static_cast< unsigned char >( height ),
+                8, 2, 0, 0, 0
+            };
+            writeChunk( file, "IHDR", ihdr, 13 );
+
+            // zlib header: deflate, 32k window, default compression.
+            static const unsigned char zlibHeader[ 2 ] = { 0x78, 0x9C };
+            writeChunk( file, "IDAT", zlibHeader, 2 );
+            for( const auto& stripe : stripes )
+            {
+                writeImageData( file, stripe.m_data.data(), stripe.m_data.size() );
+            }
+
+            unsigned char zlibFooter[ 4 ] = {
+                static_cast< unsigned char >( adler >> 24 ),
+                static_cast< unsigned char >( adler >> 16 ),
+                static_cast< unsigned char >( adler >> 8 ),
+                static_cast< unsigned char >( adler )
+            };
+            writeChunk( file, "IDAT", zlibFooter, 4 );
+            writeChunk( file, "IEND", nullptr, 0 );
+
+            if( !file.good() )
+            {
+                throw std::runtime_error( "Cannot write \"" + filename + "\"." );
+            }
+
+            LogD << "Wrote " << width << "x" << height << " image to \"" << filename << "\" using " << stripes.size() << " stripes." << LogEnd;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_PNGWRITER_H
+#define DI_PNGWRITER_H
+
+#include <string>
+
+#include <di/gfx/PixelData.h>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Writes images as PNG files. The image is split into horizontal stripes that get filtered and compressed in parallel. Each stripe is
+         * an independent part of the deflate stream, so the result is a standard PNG file that only compresses slightly worse than a serially
+         * encoded one.
+         */
+        class PngWriter
+        {
+        public:
+            /**
+             * Write the image as 8 bit RGB PNG. The alpha channel is dropped. The image rows are expected bottom-up, like OpenGL returns them.
+             *
+             * \throw std::runtime_error if the file cannot be written or compression fails.
+             *
+             * \param image the image to write
+             * \param filename the file to write. Overwritten if it exists.
+             * \param threads the maximum number of stripes compressed in parallel, like in \ref core::parallelFor.
+             */
+            static void write( const core::RGBA8Image& image, const std::string& filename, unsigned int threads = 0 );
+
+        protected:
+        private:
+        };
+    }
+}
+
+#endif  // DI_PNGWRITER_H
+
@@ -22,13 +22,20 @@
 //
 //---------------------------------------------------------------------------------------
 
-#include <iostream>
-#include <string>
-#include <stdexcept>
-#include <limits>
 #include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <zlib.h>
 
 #include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
 #include <di/core/StringUtils.h>
 
 #include "RegionLabelReader.h"
@@ -40,6 +47,327 @@ namespace di
 {
     namespace io
     {
+        /**
+         * Check whether the given char separates two values in a list of white space or comma separated values.
+         *
+         * \param c the char
+         *
+         * \return true if the char is a separator
+         */
+        static inline bool isLabelSeparator( char c )
+        {
+            return ( c == ',' ) || ( c == ' ' ) || ( c == '\n' ) || ( c == '\r' ) || ( c == '\t' ) || ( c == '\v' ) || ( c == '\f' );
+        }
+
+        /**
+         * Parse an integer at the given position like std::atoi: an optional sign followed by digits. Parsing stops at the first
+         * non-digit, so a fractional part is ignored and a value without digits is 0. Values outside the range of int are saturated.
+         *
+         * \param pos the start of the value
+         * \param end end of the buffer.
+         * \param value the parsed value
+         *
+         * \return the position behind the last digit
+         */
+        static inline const char* parseLabel( const char* pos, const char* end, int64_t& value )
+        {
+            bool negative = false;
+            if( ( pos < end ) && ( ( *pos == '-' ) || ( *pos == '+' ) ) )
+            {
+                negative = ( *pos == '-' );
+                ++pos;
+            }
+
+            const int64_t limit = negative ? -static_cast< int64_t >( std::numeric_limits< int >::min() ) :
+                                             static_cast< int64_t >( std::numeric_limits< int >::max() );
+            value = 0;
+            while( ( pos < end ) && ( *pos >= '0' ) && ( *pos <= '9' ) )
+            {
+                value = std::min( value * 10 + ( *pos - '0' ), limit );
+                ++pos;
+            }
+            value = negative ? -value : value;
+            return pos;
+        }
+
+        /**
+         * Parse all integer labels in a list of white space or comma separated values. Runs of separators count as one.
+         *
+         * \param pos the start
+         * \param end the end
+         * \param labels the target array. Labels are appended.
+         */
+        static void parseLabels( const char* pos, const char* end, RegionLabelReader::AttributeType& labels )
+        {
+            while( pos < end )
+            {
+                if( isLabelSeparator( *pos ) )
+                {
+                    ++pos;
+                    continue;
+                }
+
+                int64_t value;
+                pos = parseLabel( pos, end, value );
+                labels.push_back( static_cast< RegionLabelReader::value_type >( value ) );
+
+                // skip the remaining token
+                while( ( pos < end ) && !isLabelSeparator( *pos ) )
+                {
+                    ++pos;
+                }
+            }
+        }
+
+        /**
+         * Parse the labels of a text label file. The fields are separated by commas, or by line breaks if there is no comma in the file.
+         * Each separator ends one field, so empty fields and blank lines are label 0. A separator at the end of the file does not start
+         * another field. White space in front of a value and anything behind its digits are ignored. In comma separated files, a line
+         * break behind a value ends the field too.
+         *
+         * \param pos the start
+         * \param end the end
+         * \param labels the target array. Labels are appended.
+         */
+        static void parseLabelFields( const char* pos, const char* end, RegionLabelReader::AttributeType& labels )
+        {
+            const char separator = ( std::find( pos, end, ',' ) != end ) ? ',' : '\n';
+            while( pos < end )
+            {
+                while( ( pos < end ) && ( *pos != separator ) && std::isspace( static_cast< unsigned char >( *pos ) ) )
+                {
+                    ++pos;
+                }
+
+                int64_t value;
+                pos = parseLabel( pos, end, value );
+                labels.push_back( static_cast< RegionLabelReader::value_type >( value ) );
+
+                // skip the remaining field and its separator
+                while( ( pos < end ) && ( *pos != separator ) && ( *pos != '\n' ) )
+                {
+                    ++pos;
+                }
+                if( pos < end )
+                {
+                    ++pos;
+                }
+            }
+        }
+
+        /**
+         * Read a big endian 32 bit integer and advance the position.
+         *
+         * \param pos the position. Incremented by 4.
+         * \param end end of the buffer
+         * \param filename the file name for error reporting
+         *
+         * \throw std::ios_base::failure if the file is too short.
+         *
+         * \return the value
+         */
+        static int32_t readInt32BigEndian( const char*& pos, const char* end, const std::string& filename )
+        {
+            if( end - pos < 4 )
+            {
+                throw std::ios_base::failure( "Unexpected end of file in " + filename );
+            }
+
+            const unsigned char* bytes = reinterpret_cast< const unsigned char* >( pos );
+            uint32_t value = ( static_cast< uint32_t >( bytes[ 0 ] ) << 24 ) |
+                             ( static_cast< uint32_t >( bytes[ 1 ] ) << 16 ) |
+                             ( static_cast< uint32_t >( bytes[ 2 ] ) << 8 ) |
+                               static_cast< uint32_t >( bytes[ 3 ] );
+            pos += 4;
+            return static_cast< int32_t >( value );
+        }
+
+        /**
+         * Skip the given amount of bytes.
+         *
+         * \param pos the position. Incremented by count.
+         * \param end end of the buffer
+         * \param count number of bytes to skip. Negative values are treated as invalid.
+         * \param filename the file name for error reporting
+         *
+         * \throw std::ios_base::failure if the file is too short.
+         */
+        static void skipBytes( const char*& pos, const char* end, int32_t count, const std::string& filename )
+        {
+            if( ( count < 0 ) || ( end - pos < count ) )
+            {
+                throw std::ios_base::failure( "Unexpected end of file in " + filename );
+            }
+            pos += count;
+        }
+
+        /**
+         * Find a string in the given range.
+         *
+         * \param begin start of the range
+         * \param end end of the range
+         * \param needle what to find
+         *
+         * \return the position of the string or end if not found.
+         */
+        static const char* findString( const char* begin, const char* end, const std::string& needle )
+        {
+            return std::search( begin, end, needle.begin(), needle.end() );
+        }
+
+        /**
+         * Get the value of an XML attribute inside the given tag.
+         *
+         * \param begin start of the tag
+         * \param end end of the tag
+         * \param name the attribute name
+         *
+         * \return the value or an empty string if not found.
+         */
+        static std::string getXMLAttribute( const char* begin, const char* end, const std::string& name )
+        {
+            const char* pos = begin;
+            while( ( pos = findString( pos, end, name ) ) != end )
+            {
+                const char* afterName = pos + name.size();
+                // needs to be a whole word followed by ="
+                bool wordStart = ( pos == begin ) || isLabelSeparator( *( pos - 1 ) );
+                if( wordStart && ( end - afterName > 1 ) && ( afterName[ 0 ] == '=' ) && ( afterName[ 1 ] == '"' ) )
+                {
+                    const char* valueBegin = afterName + 2;
+                    const char* valueEnd = std::find( valueBegin, end, '"' );
+                    return std::string( valueBegin, valueEnd );
+                }
+                pos = afterName;
+            }
+            return "";
+        }
+
+        /**
+         * Decode base 64 encoded data. Whitespace is ignored.
+         *
+         * \param begin start of the encoded data
+         * \param end end of the encoded data
+         *
+         * \return the decoded bytes
+         */
+        static std::vector< unsigned char > decodeBase64( const char* begin, const char* end )
+        {
+            static const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+            // Build decoding table once.
+            static const std::vector< int > table = []()
+            {
+                std::vector< int > init( 256, -1 );
+                for( size_t i = 0; i < alphabet.size(); ++i )
+                {
+                    init[ static_cast< unsigned char >( alphabet[ i ] ) ] = static_cast< int >( i );
+                }
+                return init;
+            }();
+
+            std::vector< unsigned char > result;
+            result.reserve( ( ( end - begin ) / 4 ) * 3 );
+
+            uint32_t buffer = 0;
+            int bits = 0;
+            for( const char* pos = begin; pos < end; ++pos )
+            {
+                int value = table[ static_cast< unsigned char >( *pos ) ];
+                if( value < 0 )
+                {
+                    // whitespace, padding, ...
+                    continue;
+                }
+
+                buffer = ( buffer << 6 ) | static_cast< uint32_t >( value );
+                bits += 6;
+                if( bits >= 8 )
+                {
+                    bits -= 8;
+                    result.push_back( static_cast< unsigned char >( ( buffer >> bits ) & 0xFF ) );
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Inflate zlib or gzip compressed data, as used by the GZipBase64Binary encoding of GIFTI.
+         *
+         * \param data the compressed data
+         * \param filename the file the data is from. Used for error messages.
+         *
+         * \throw std::ios_base::failure if the data is not valid compressed data.
+         *
+         * \return the inflated bytes
+         */
+        static std::vector< unsigned char > inflateData( const std::vector< unsigned char >& data, const std::string& filename )
+        {
+            z_stream stream;
+            std::memset( &stream, 0, sizeof( stream ) );
+
+            // 15 + 32: maximum window size, detect zlib and gzip headers automatically.
+            if( inflateInit2( &stream, 15 + 32 ) != Z_OK )
+            {
+                throw std::ios_base::failure( "Could not initialize zlib to read " + filename );
+            }
+
+            // Labels compress very well. Start with a generous guess and grow as needed.
+            std::vector< unsigned char > result( std::max( size_t( 1024 ), 8 * data.size() ) );
+            stream.next_in = const_cast< unsigned char* >( data.data() );
+            stream.avail_in = static_cast< uInt >( data.size() );
+
+            int status = Z_OK;
+            while( status == Z_OK )
+            {
+                if( stream.total_out == result.size() )
+                {
+                    result.resize( 2 * result.size() );
+                }
+                stream.next_out = result.data() + stream.total_out;
+                stream.avail_out = static_cast< uInt >( result.size() - stream.total_out );
+                status = inflate( &stream, Z_NO_FLUSH );
+            }
+
+            size_t size = stream.total_out;
+            inflateEnd( &stream );
+            if( status != Z_STREAM_END )
+            {
+                throw std::ios_base::failure( "Invalid compressed data in GIFTI file " + filename );
+            }
+
+            result.resize( size );
+            return result;
+        }
+
+        /**
+         * Interpret binary GIFTI data as labels.
+         *
+         * \tparam T the type of each value in the data
+         * \param data the decoded data
+         * \param swap true if the byte order needs to be swapped.
+         * \param labels the target array
+         */
+        template< typename T >
+        static void convertBinaryLabels( const std::vector< unsigned char >& data, bool swap, RegionLabelReader::AttributeType& labels )
+        {
+            size_t count = data.size() / sizeof( T );
+            labels.reserve( count );
+            for( size_t i = 0; i < count; ++i )
+            {
+                unsigned char bytes[ sizeof( T ) ];
+                std::memcpy( bytes, data.data() + i * sizeof( T ), sizeof( T ) );
+                if( swap )
+                {
+                    std::reverse( bytes, bytes + sizeof( T ) );
+                }
+
+                T value;
+                std::memcpy( &value, bytes, sizeof( T ) );
+                labels.push_back( static_cast< RegionLabelReader::value_type >( value ) );
+            }
+        }
+
         RegionLabelReader::RegionLabelReader():
             Reader()
         {
@@ -51,33 +379,39 @@ namespace di
 
         bool RegionLabelReader::canLoad( const std::string& filename ) const
         {
-            std::string ext = di::core::getFileExtension( filename );
-            return ( di::core::toLower( ext ) == "labelorder" ) ||
-                   ( di::core::toLower( ext ) == "labels" ) ||
-                   ( di::core::toLower( ext ) == "csv" );
+            std::string ext = di::core::toLower( di::core::getFileExtension( filename ) );
+            return ( ext == "labelorder" ) ||
+                   ( ext == "labels" ) ||
+                   ( ext == "csv" ) ||
+                   ( ext == "annot" ) ||
+                   ( ext == "gii" );
         }
 
         di::SPtr< di::core::DataSetBase > RegionLabelReader::load( const std::string& filename ) const
         {
             LogD << "Loading \"" << filename << "\"." << LogEnd;
-            auto file = core::readTextFile( filename );
+            core::MappedFile file( filename );
 
             auto labels = std::make_shared< std::vector< value_type > >();
-            value_type min = std::numeric_limits< value_type >::max();
-            value_type max = std::numeric_limits< value_type >::min();
 
-            // each line
-            auto items = core::split( file, ',' );
-            if( items.size() <= 1 )
+            std::string ext = di::core::toLower( di::core::getFileExtension( filename ) );
+            if( ext == "annot" )
+            {
+                loadAnnot( file, *labels );
+            }
+            else if( ext == "gii" )
             {
-                items = core::split( file );
+                loadGifti( file, *labels );
             }
-            for( auto line : items )
+            else
             {
-                value_type l = std::atoi( line.c_str() );
-                // A line contains a region label - line number corresponds to the mesh vertex IDs
-                labels->push_back( l );
+                loadText( file, *labels );
+            }
 
+            value_type min = std::numeric_limits< value_type >::max();
+            value_type max = std::numeric_limits< value_type >::lowest();
+            for( auto l : *labels )
+            {
                 min = std::min( min, l );
                 max = std::max( max, l );
             }
@@ -85,7 +419,193 @@ namespace di
 
             return std::make_shared< DataSetType >( "Mesh Labels", labels );
         }
+
+        void RegionLabelReader::loadText( const core::MappedFile& file, AttributeType& labels ) const
+        {
+            // Labels usually take at least one digit and one separator. Reserving by this estimate avoids re-allocation. Give back the
+            // memory if the estimate was far off.
+            labels.reserve( file.size() / 2 + 1 );
+            parseLabelFields( file.begin(), file.end(), labels );
+            if( labels.capacity() > 2 * labels.size() )
+            {
+                labels.shrink_to_fit();
+            }
+        }
+
+        void RegionLabelReader::loadAnnot( const core::MappedFile& file, AttributeType& labels ) const
+        {
+            // Format: http://surfer.nmr.mgh.harvard.edu/fswiki/LabelsClutsAnnotationFiles
+            // All values are big endian 32 bit integers.
+            const std::string& filename = file.getFilename();
+            const char* pos = file.begin();
+            const char* end = file.end();
+
+            int32_t numVertices = readInt32BigEndian( pos, end, filename );
+            if( numVertices < 0 )
+            {
+                throw std::ios_base::failure( "Invalid vertex count in " + filename );
+            }
+
+            // Check the count before allocating by it. A broken header would request huge amounts of memory otherwise.
+            if( ( end - pos ) / 8 < numVertices )
+            {
+                throw std::ios_base::failure( "Unexpected end of file in " + filename );
+            }
+
+            // Vertex - annotation pairs. The annotation is an RGB color encoded as integer.
+            std::vector< int32_t > annotations( static_cast< size_t >( numVertices ), 0 );
+            for( int32_t i = 0; i < numVertices; ++i )
+            {
+                int32_t vertex = readInt32BigEndian( pos, end, filename );
+                int32_t annotation = readInt32BigEndian( pos, end, filename );
+                if( ( vertex < 0 ) || ( vertex >= numVertices ) )
+                {
+                    throw std::ios_base::failure( "Invalid vertex index in " + filename );
+                }
+                annotations[ vertex ] = annotation;
+            }
+
+            // Map each annotation to its structure ID in the color table.
+            std::unordered_map< int32_t, int32_t > structures;
+            bool hasColorTable = ( end - pos >= 4 ) && ( readInt32BigEndian( pos, end, filename ) == 1 );
+            if( hasColorTable )
+            {
+                int32_t numEntries = readInt32BigEndian( pos, end, filename );
+                if( numEntries > 0 )
+                {
+                    // Old format: entries are numbered implicitly.
+                    skipBytes( pos, end, readInt32BigEndian( pos, end, filename ), filename );  // original color table file name
+                    for( int32_t structure = 0; structure < numEntries; ++structure )
+                    {
+                        skipBytes( pos, end, readInt32BigEndian( pos, end, filename ), filename );  // structure name
+                        int32_t r = readInt32BigEndian( pos, end, filename );
+                        int32_t g = readInt32BigEndian( pos, end, filename );
+                        int32_t b = readInt32BigEndian( pos, end, filename );
+                        readInt32BigEndian( pos, end, filename );  // transparency
+                        structures[ r + g * 256 + b * 65536 ] = structure;
+                    }
+                }
+                else
+                {
+                    // New format: the negative count is the version.
+                    if( -numEntries != 2 )
+                    {
+                        throw std::ios_base::failure( "Unsupported color table version in " + filename );
+                    }
+                    readInt32BigEndian( pos, end, filename );  // max structure ID
+                    skipBytes( pos, end, readInt32BigEndian( pos, end, filename ), filename );  // original color table file name
+                    int32_t numStored = readInt32BigEndian( pos, end, filename );
+                    for( int32_t i = 0; i < numStored; ++i )
+                    {
+                        int32_t structure = readInt32BigEndian( pos, end, filename );
+                        skipBytes( pos, end, readInt32BigEndian( pos, end, filename ), filename );  // structure name
+                        int32_t r = readInt32BigEndian( pos, end, filename );
+                        int32_t g = readInt32BigEndian( pos, end, filename );
+                        int32_t b = readInt32BigEndian( pos, end, filename );
+                        readInt32BigEndian( pos, end, filename );  // transparency
+                        structures[ r + g * 256 + b * 65536 ] = structure;
+                    }
+                }
+            }
+            else
+            {
+                // Without color table, number the distinct annotations in order of appearance. Annotation 0 means "unlabeled".
+                LogW << "Annotation file " << filename << " has no color table. Numbering annotations in order of appearance." << LogEnd;
+                structures[ 0 ] = 0;
+                for( auto annotation : annotations )
+                {
+                    if( structures.find( annotation ) == structures.end() )
+                    {
+                        int32_t id = static_cast< int32_t >( structures.size() );
+                        structures[ annotation ] = id;
+                    }
+                }
+            }
+
+            // Vertices with annotations not in the color table are treated as structure 0 (usually "unknown").
+            labels.reserve( annotations.size() );
+            for( auto annotation : annotations )
+            {
+                auto structure = structures.find( annotation );
+                labels.push_back( static_cast< value_type >( ( structure == structures.end() ) ? 0 : structure->second ) );
+            }
+        }
+
+        void RegionLabelReader::loadGifti( const core::MappedFile& file, AttributeType& labels ) const
+        {
+            const std::string& filename = file.getFilename();
+            const char* end = file.end();
+
+            // Find the first data array with label intent.
+            const char* pos = file.begin();
+            const char* tagEnd = end;
+            while( true )
+            {
+                pos = findString( pos, end, "<DataArray" );
+                if( pos == end )
+                {
+                    throw std::ios_base::failure( "No label data array found in GIFTI file " + filename );
+                }
+                tagEnd = std::find( pos, end, '>' );
+                if( getXMLAttribute( pos, tagEnd, "Intent" ) == "NIFTI_INTENT_LABEL" )
+                {
+                    break;
+                }
+                pos = tagEnd;
+            }
+
+            std::string dataType = getXMLAttribute( pos, tagEnd, "DataType" );
+            std::string encoding = getXMLAttribute( pos, tagEnd, "Encoding" );
+            std::string endian = getXMLAttribute( pos, tagEnd, "Endian" );
+
+            // The data itself
+            const char* dataBegin = findString( tagEnd, end, "<Data>" );
+            if( dataBegin == end )
+            {
+                throw std::ios_base::failure( "No data found in label data array of GIFTI file " + filename );
+            }
+            dataBegin += std::strlen( "<Data>" );
+            const char* dataEnd = findString( dataBegin, end, "</Data>" );
+
+            if( encoding == "ASCII" )
+            {
+                parseLabels( dataBegin, dataEnd, labels );
+                return;
+            }
+
+            if( ( encoding != "Base64Binary" ) && ( encoding != "GZipBase64Binary" ) )
+            {
+                throw std::ios_base::failure( "Unsupported GIFTI data encoding \"" + encoding + "\" in " + filename +
+                                              ". Use ASCII, Base64Binary or GZipBase64Binary." );
+            }
+
+            auto data = decodeBase64( dataBegin, dataEnd );
+            if( encoding == "GZipBase64Binary" )
+            {
+                data = inflateData( data, filename );
+            }
+
+            const uint16_t endianTest = 1;
+            bool hostIsLittleEndian = ( *reinterpret_cast< const unsigned char* >( &endianTest ) == 1 );
+            bool swap = ( endian == "BigEndian" ) == hostIsLittleEndian;
+
+            if( dataType == "NIFTI_TYPE_INT32" )
+            {
+                convertBinaryLabels< int32_t >( data, swap, labels );
+            }
+            else if( dataType == "NIFTI_TYPE_UINT8" )
+            {
+                convertBinaryLabels< uint8_t >( data, swap, labels );
+            }
+            else if( dataType == "NIFTI_TYPE_FLOAT32" )
+            {
+                convertBinaryLabels< float >( data, swap, labels );
+            }
+            else
+            {
+                throw std::ios_base::failure( "Unsupported GIFTI data type \"" + dataType + "\" in " + filename );
+            }
+        }
     }
 }
 
-
@@ -36,10 +36,17 @@
 
 namespace di
 {
+    namespace core
+    {
+        class MappedFile;
+    }
+
     namespace io
     {
         /**
-         * Implements a loader for the region label data format. It implements the \ref di::core::Reader interface.
+         * Implements a loader for the region label data format. It implements the \ref di::core::Reader interface. Supported are plain text
+         * files (one integer label per vertex, separated by commas or line breaks), FreeSurfer annotation files (.annot) and GIFTI label
+         * files (.label.gii).
          */
         class RegionLabelReader: public di::core::Reader
         {
@@ -88,6 +95,35 @@ namespace di
             virtual di::SPtr< di::core::DataSetBase > load( const std::string& filename ) const;
         protected:
         private:
+            /**
+             * Parse a text label file. Labels are integers separated by commas or whitespace. This is done in a single pass, without any
+             * temporary strings.
+             *
+             * \param file the mapped file
+             * \param labels the target array
+             */
+            void loadText( const core::MappedFile& file, AttributeType& labels ) const;
+
+            /**
+             * Parse a FreeSurfer annotation file. The resulting labels are the indices of the structures in the embedded color table.
+             *
+             * \param file the mapped file
+             * \param labels the target array
+             *
+             * \throw std::ios_base::failure if the file is invalid.
+             */
+            void loadAnnot( const core::MappedFile& file, AttributeType& labels ) const;
+
+            /**
+             * Parse a GIFTI label file. The first data array with label intent is used. ASCII, Base64 and gzipped Base64 encoded data is
+             * supported.
+             *
+             * \param file the mapped file
+             * \param labels the target array
+             *
+             * \throw std::ios_base::failure if the file is invalid or uses an unsupported encoding.
+             */
+            void loadGifti( const core::MappedFile& file, AttributeType& labels ) const;
         };
     }
 }